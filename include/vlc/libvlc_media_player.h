@@ -473,7 +473,9 @@ typedef void (*libvlc_video_cleanup_cb)(void *opaque);
  *   cropping and/or picture re-orientation, must be performed by the CPU
  *   instead of the GPU.
  * - Memory copying is required between LibVLC reference picture buffers and
- *   application buffers (between lock and unlock callbacks).
+ *   application buffers (between lock and unlock callbacks), unless the
+ *   application provides the buffers with
+ *   libvlc_video_set_buffer_callbacks().
  *
  * \param mp the media player
  * \param lock callback to lock video memory (must not be NULL)
@@ -524,6 +526,71 @@ void libvlc_video_set_format_callbacks( libvlc_media_player_t *mp,
                                         libvlc_video_format_cb setup,
                                         libvlc_video_cleanup_cb cleanup );
 
+/**
+ * Callback prototype to provide a picture buffer for direct rendering.
+ *
+ * The video decoder renders directly into the buffers provided through this
+ * callback, saving the copy between the lock and unlock callbacks.
+ * The callback is invoked once for each buffer the decoder needs, when the
+ * video output is set up. The buffer remains in use by LibVLC until the
+ * @ref libvlc_video_buffer_release_cb callback is invoked for it.
+ *
+ * Each pixel plane must be laid out with the pitch and the number of lines
+ * set by the @ref libvlc_video_format_cb callback (or with the pitch set by
+ * libvlc_video_set_format()), and must be aligned on 32-bytes boundaries.
+ *
+ * \param[in] opaque private pointer as passed to libvlc_video_set_callbacks()
+ *               (and possibly modified by @ref libvlc_video_format_cb)
+ * \param[out] planes start address of the pixel planes (LibVLC allocates the
+ *             array of void pointers, this callback must initialize the array)
+ * \return a private pointer identifying the buffer, or NULL if no more
+ *         buffers are available
+ */
+typedef void *(*libvlc_video_buffer_acquire_cb)(void *opaque, void **planes);
+
+/**
+ * Callback prototype to give a picture buffer back to the application.
+ *
+ * LibVLC does not use the buffer anymore, the application can reuse or free
+ * it. This callback may be invoked from any thread.
+ *
+ * \param[in] opaque private pointer as passed to libvlc_video_set_callbacks()
+ *               (and possibly modified by @ref libvlc_video_format_cb)
+ * \param[in] buffer private pointer returned from the
+ *               @ref libvlc_video_buffer_acquire_cb callback
+ */
+typedef void (*libvlc_video_buffer_release_cb)(void *opaque, void *buffer);
+
+/**
+ * Set callbacks to provide the buffers the video is decoded into.
+ * This only works in combination with libvlc_video_set_callbacks().
+ *
+ * If the decoded pictures can be shown without conversion (same chroma and
+ * dimensions as selected by the format callback or libvlc_video_set_format())
+ * and without video filters, the decoder renders directly into the buffers
+ * provided by the application. The display callback then receives the
+ * identifier of the buffer returned by the acquire callback, and the lock
+ * callback is not invoked for that picture. The content of the buffer
+ * remains valid until the display callback is invoked for the next picture.
+ * Otherwise, the pictures are copied as usual between the lock and unlock
+ * callbacks.
+ *
+ * The buffer count returned by the @ref libvlc_video_format_cb callback is
+ * the maximum number of buffers that the decoder may use. If it needs more
+ * pictures than that, the buffers are not used.
+ *
+ * The cleanup callback is invoked once all the buffers have been released.
+ *
+ * \param mp the media player
+ * \param acquire callback to provide a picture buffer (or NULL to disable)
+ * \param release callback to release a picture buffer (or NULL if not needed)
+ * \version LibVLC 4.0.0 or later
+ */
+LIBVLC_API
+void libvlc_video_set_buffer_callbacks( libvlc_media_player_t *mp,
+                                        libvlc_video_buffer_acquire_cb acquire,
+                                        libvlc_video_buffer_release_cb release );
+
 
 typedef struct libvlc_video_setup_device_cfg_t
 {
@@ -189,6 +189,12 @@ enum demux_query_e
     DEMUX_SET_TIME,             /* arg1= vlc_tick_t arg2= bool b_precise   res=can fail    */
     /* Normal or original time, used mainly by the ts module */
     DEMUX_GET_NORMAL_TIME,      /* arg1= vlc_tick_t *   res= can fail, in that case VLC_TICK_0 will be used as NORMAL_TIME */
+    /** Retrieves the distance between the demuxed data and the live edge
+     * of a live stream.
+     * Can fail if the stream is not live or the edge is unknown.
+     *
+     * arg1= vlc_tick_t * */
+    DEMUX_GET_LIVE_DELAY,
 
     /**
      * \todo Document
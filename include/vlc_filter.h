@@ -366,6 +366,40 @@ static inline int filter_GetInputAttachments( filter_t *p_filter,
                                                ppp_attachment, pi_attachment );
 }
 
+/**
+ * Callback processing one horizontal slice of a picture.
+ *
+ * \param filter the filter running the slices
+ * \param opaque the data passed to filter_ExecuteSlices()
+ * \param first first row of the slice
+ * \param last row following the last row of the slice
+ */
+typedef void (*vlc_filter_slice_cb)(filter_t *filter, void *opaque,
+                                    unsigned first, unsigned last);
+
+/**
+ * This function runs a row-parallel operation of a video filter.
+ *
+ * The rows [0, rows) are split into contiguous horizontal slices, which are
+ * processed concurrently on the shared video filter thread pool. The calling
+ * thread processes one of the slices itself. The callback must only write
+ * within its own slice rows; it may read anything.
+ *
+ * The function returns once all the slices have been processed. If slice
+ * threading is disabled ("filter-threads" set to 1), or if the picture is too
+ * small to be worth splitting, the callback is invoked once for all rows on
+ * the calling thread.
+ *
+ * \param filter filter_t object
+ * \param cb slice callback
+ * \param opaque data passed to the callback
+ * \param rows total number of rows
+ * \param align slice boundaries alignment in rows (e.g. 2 for 4:2:0 chroma)
+ */
+VLC_API void filter_ExecuteSlices( filter_t *filter, vlc_filter_slice_cb cb,
+                                   void *opaque, unsigned rows,
+                                   unsigned align );
+
 /**
  * This function duplicates every variables from the filter, and adds a proxy
  * callback to trigger filter events from obj.
@@ -572,6 +572,12 @@ struct input_stats_t
     /* Aout */
     uint64_t i_played_abuffers;
     uint64_t i_lost_abuffers;
+
+    /* Live latency, 0 if the latency is not controlled */
+    vlc_tick_t i_live_latency;
+    vlc_tick_t i_live_latency_target;
+    float f_live_rate;
+    uint64_t i_live_rate_changes;
 };
 
 /**
@@ -0,0 +1,135 @@
+/*****************************************************************************
+ * vlc_seekindex.h: persistent time to byte offset index
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef VLC_SEEKINDEX_H
+#define VLC_SEEKINDEX_H 1
+
+#include <vlc_stream.h>
+
+# ifdef __cplusplus
+extern "C" {
+# endif
+
+/**
+ * \defgroup seekindex Seek index
+ * \ingroup input
+ *
+ * Sorted time to byte offset index for demuxers of containers without a
+ * usable index.
+ *
+ * Demuxers record the positions they learn while playing or bisecting and
+ * look them up before seeking. An index can be bound to the user cache
+ * directory, keyed by the stream location, size and modification time, so
+ * that it survives across sessions.
+ *
+ * An index is not thread-safe: it is meant to be owned by a single demuxer.
+ * @{
+ */
+
+/** Seek index (opaque) */
+typedef struct vlc_seekindex vlc_seekindex_t;
+
+/**
+ * Seek index entry.
+ */
+struct vlc_seekindex_entry
+{
+    vlc_tick_t time; /**< stream time, VLC_TICK_0 being the start */
+    uint64_t offset; /**< byte offset where decoding can start for time */
+};
+
+/**
+ * Creates an empty in-memory index.
+ *
+ * \param interval minimum time between two entries
+ * \return the index or NULL on allocation failure
+ */
+VLC_API vlc_seekindex_t *vlc_seekindex_New(vlc_tick_t interval) VLC_USED;
+
+/**
+ * Creates an index bound to the cache of a stream.
+ *
+ * Entries cached by a previous session for the same stream are loaded.
+ * The index is written back to the cache by vlc_seekindex_Delete() if it was
+ * modified. The least recently written indexes are removed from the cache
+ * when it grows too large.
+ *
+ * This fails if the cache is disabled (\c seek-index-cache option) or if the
+ * stream size or modification time cannot be determined.
+ *
+ * \param obj object for logging and options
+ * \param s stream to index
+ * \param tag container specific tag, to separate indexes of different
+ *            demuxers or programs of the same stream
+ * \param interval minimum time between two entries
+ * \return the index or NULL on failure
+ */
+VLC_API vlc_seekindex_t *vlc_seekindex_Open(vlc_object_t *obj, stream_t *s,
+                                            const char *tag,
+                                            vlc_tick_t interval) VLC_USED;
+#define vlc_seekindex_Open(o, s, t, i) \
+        vlc_seekindex_Open(VLC_OBJECT(o), s, t, i)
+
+/**
+ * Deletes an index, saving it to the cache first if needed.
+ */
+VLC_API void vlc_seekindex_Delete(vlc_seekindex_t *index);
+
+/**
+ * Adds an entry.
+ *
+ * The entry is ignored if it is closer than the index interval to an
+ * existing entry, or if it contradicts the ordering of the existing entries
+ * (e.g. after a timestamp discontinuity).
+ *
+ * \retval VLC_SUCCESS if the entry was added
+ * \retval VLC_EGENERIC if the entry was ignored
+ * \retval VLC_ENOMEM on allocation failure
+ */
+VLC_API int vlc_seekindex_Add(vlc_seekindex_t *index, vlc_tick_t time,
+                              uint64_t offset);
+
+/**
+ * Looks up the entries surrounding a time.
+ *
+ * Either output pointer may be NULL. An entry that does not exist is
+ * reported with a time of VLC_TICK_INVALID.
+ *
+ * \param before last entry at or before the time [OUT]
+ * \param after first entry after the time [OUT]
+ * \retval VLC_SUCCESS if at least one of the entries was found
+ * \retval VLC_EGENERIC if the index is empty
+ */
+VLC_API int vlc_seekindex_Lookup(const vlc_seekindex_t *index, vlc_tick_t time,
+                                 struct vlc_seekindex_entry *before,
+                                 struct vlc_seekindex_entry *after);
+
+/**
+ * Returns the number of entries in the index.
+ */
+VLC_API size_t vlc_seekindex_Count(const vlc_seekindex_t *index) VLC_USED;
+
+/** @} */
+
+# ifdef __cplusplus
+}
+# endif
+
+#endif
@@ -255,6 +255,9 @@ enum stream_query_e
     STREAM_CAN_FASTSEEK,                    /**< arg1=(bool *) res=cannot fail */
     STREAM_CAN_PAUSE,                       /**< arg1=(bool *) res=cannot fail */
     STREAM_CAN_CONTROL_PACE,                /**< arg1=(bool *) res=cannot fail */
+    STREAM_CAN_SKIP_CACHE,                  /**< arg1=(bool *) res=can fail
+                                                 Whether the access already returns large blocks, that
+                                                 the stream cache would only copy. */
     /* */
     STREAM_GET_SIZE=6,                      /**< arg1=(uint64_t *) res=can fail */
     STREAM_GET_MTIME,                       /**< arg1=(uint64_t *) res=can fail
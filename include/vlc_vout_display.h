@@ -323,6 +323,24 @@ struct vlc_display_operations
      */
     int (*update_format)(vout_display_t *, const video_format_t *fmt,
                          vlc_video_context *ctx);
+
+    /**
+     * Provides pictures for the decoder to render into.
+     *
+     * This lets a display hand out its own picture buffers, so that
+     * decoded pictures need not be copied before display.
+     * This is only requested if the decoded pictures need no conversion,
+     * i.e. if they have the chroma and dimensions of \ref vout_display_t::fmt.
+     * The pictures may still go through video filters, so the
+     * \ref vlc_display_operations::prepare "prepare" callback must check
+     * whether it got one of its own pictures.
+     *
+     * May be NULL.
+     *
+     * \param count number of pictures the decoder needs
+     * \return a pool of pictures, or NULL to use pictures from the heap
+     */
+    struct picture_pool_t *(*get_pool)(vout_display_t *, unsigned count);
 };
 
 struct vout_display_t {
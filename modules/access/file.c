@@ -44,6 +44,10 @@
 #   include <linux/magic.h>
 #endif
 
+#ifdef HAVE_MMAP
+#   include <sys/mman.h>
+#endif
+
 #if defined( _WIN32 )
 #   include <io.h>
 #   include <ctype.h>
@@ -61,11 +65,27 @@
 #include <vlc_fs.h>
 #include <vlc_url.h>
 
+/* Block mode reads start on this boundary, as required by O_DIRECT */
+#define FILE_ALIGN 4096
+/* Default size of the memory mapped windows */
+#define FILE_MAP_WINDOW (1 << 20)
+
 typedef struct
 {
     int fd;
 
     bool b_pace_control;
+
+    /* Block mode */
+    size_t   block_size;
+    size_t   align; /* boundary of the reads or of the mappings */
+    uint64_t offset; /* stream position */
+    size_t   skip; /* bytes between the file position and the stream one */
+    uint64_t advised; /* end of the readahead window */
+    uint64_t dropped; /* start of the window kept in the page cache */
+    bool     direct;
+    bool     map;
+    uint64_t size; /* file size when the mapping mode was chosen */
 } access_sys_t;
 
 #if !defined (_WIN32) && !defined (__OS2__)
@@ -166,6 +186,7 @@ static bool IsRemote (const char *path)
 #endif
 
 static ssize_t Read (stream_t *, void *, size_t);
+static block_t *ReadBlock (stream_t *, bool *);
 static int FileSeek (stream_t *, uint64_t);
 static int FileControl (stream_t *, int, va_list);
 
@@ -252,6 +273,9 @@ int FileOpen( vlc_object_t *p_this )
     p_access->pf_control = FileControl;
     p_access->p_sys = p_sys;
     p_sys->fd = fd;
+    p_sys->block_size = 0;
+    p_sys->direct = false;
+    p_sys->map = false;
 
     if (S_ISREG (st.st_mode) || S_ISBLK (st.st_mode))
     {
@@ -271,6 +295,52 @@ int FileOpen( vlc_object_t *p_this )
         else
             fcntl (fd, F_RDAHEAD, 1);
 #endif
+
+        size_t block_size = var_InheritInteger (p_access, "file-block-size");
+        if (S_ISREG (st.st_mode) && !IsRemote(fd, p_access->psz_filepath))
+        {
+            p_sys->align = FILE_ALIGN;
+            p_sys->offset = 0;
+            p_sys->skip = 0;
+            p_sys->advised = 0;
+            p_sys->dropped = 0;
+            p_sys->size = st.st_size;
+#ifdef O_DIRECT
+            if (block_size > 0 && var_InheritBool (p_access, "file-direct"))
+            {
+                if (fcntl (fd, F_SETFL, fcntl (fd, F_GETFL) | O_DIRECT) == 0)
+                    p_sys->direct = true;
+                else
+                    msg_Warn (p_access, "cannot bypass the page cache: %s",
+                              vlc_strerror_c(errno));
+            }
+#endif
+#ifdef HAVE_MMAP
+            /* Large files are mapped, unless they are read directly */
+            uint64_t map_size = var_InheritInteger (p_access, "file-mmap-size");
+            if (!p_sys->direct && map_size > 0
+             && (uint64_t)st.st_size >= (map_size << 20))
+            {
+                p_sys->map = true;
+                p_sys->align = sysconf (_SC_PAGESIZE);
+                if (block_size == 0)
+                    block_size = FILE_MAP_WINDOW >> 10;
+            }
+#endif
+        }
+        else
+            block_size = 0;
+
+        if (block_size > 0)
+        {
+            p_sys->block_size = (block_size << 10) + p_sys->align - 1;
+            p_sys->block_size -= p_sys->block_size % p_sys->align;
+            p_access->pf_read = NULL;
+            p_access->pf_block = ReadBlock;
+            msg_Dbg (p_access, "%s by blocks of %zu bytes%s",
+                     p_sys->map ? "mapping" : "reading", p_sys->block_size,
+                     p_sys->direct ? " (direct)" : "");
+        }
     }
     else
     {
@@ -292,7 +362,7 @@ void FileClose (vlc_object_t * p_this)
 {
     stream_t     *p_access = (stream_t*)p_this;
 
-    if (p_access->pf_read == NULL)
+    if (p_access->pf_read == NULL && p_access->pf_block == NULL)
     {
         DirClose (p_this);
         return;
@@ -326,6 +396,168 @@ static ssize_t Read (stream_t *p_access, void *p_buffer, size_t i_len)
     return val;
 }
 
+static block_t *AllocBlock (access_sys_t *sys)
+{
+#ifdef O_DIRECT
+    if (sys->direct)
+    {
+        void *buf = aligned_alloc (FILE_ALIGN, sys->block_size);
+        if (unlikely(buf == NULL))
+            return NULL;
+        return block_heap_Alloc (buf, sys->block_size);
+    }
+#endif
+    return block_Alloc (sys->block_size);
+}
+
+static void Advise (access_sys_t *sys, uint64_t start, uint64_t end)
+{
+    /* Keep the kernel a few blocks ahead of the reader... */
+    const uint64_t window = 4 * sys->block_size;
+
+    if (end + window / 2 > sys->advised)
+    {
+        posix_fadvise (sys->fd, end, window, POSIX_FADV_WILLNEED);
+        sys->advised = end + window;
+    }
+    /* ...and bound the page cache used by what it has read. */
+    if (start >= sys->dropped + window)
+    {
+        posix_fadvise (sys->fd, sys->dropped, start - sys->dropped,
+                       POSIX_FADV_DONTNEED);
+        sys->dropped = start;
+    }
+}
+
+#ifdef HAVE_MMAP
+static block_t *MapBlock (stream_t *p_access, bool *restrict eof)
+{
+    access_sys_t *sys = p_access->p_sys;
+    uint64_t start = sys->offset - sys->skip;
+    struct stat st;
+
+    /* Touching the pages of a truncated file would raise SIGBUS, which a
+     * library cannot catch safely: stop mapping files that change size. */
+    if (fstat (sys->fd, &st) || (uint64_t)st.st_size != sys->size)
+        return NULL;
+
+    if (start >= sys->size)
+    {
+        *eof = true;
+        return NULL;
+    }
+
+    /* Demuxers may modify blocks in place (descrambling, reordering...):
+     * map private writable pages, copied on write, never written back. */
+    size_t length = __MIN(sys->block_size, sys->size - start);
+    void *addr = mmap (NULL, length, PROT_READ|PROT_WRITE, MAP_PRIVATE,
+                       sys->fd, start);
+    if (addr == MAP_FAILED)
+        return NULL;
+#ifdef POSIX_MADV_SEQUENTIAL
+    posix_madvise (addr, length, POSIX_MADV_SEQUENTIAL);
+    posix_madvise (addr, length, POSIX_MADV_WILLNEED);
+#endif
+
+    block_t *block = block_mmap_Alloc (addr, length);
+    if (unlikely(block == NULL))
+        return NULL;
+
+    block->p_buffer += sys->skip;
+    block->i_buffer -= sys->skip;
+    sys->offset = start + length;
+    sys->skip = 0;
+    Advise (sys, start, sys->offset);
+    return block;
+}
+#endif
+
+static block_t *ReadBlock (stream_t *p_access, bool *restrict eof)
+{
+    access_sys_t *sys = p_access->p_sys;
+    int fd = sys->fd;
+
+#ifdef HAVE_MMAP
+    if (sys->map)
+    {
+        block_t *block = MapBlock (p_access, eof);
+        if (block != NULL || *eof)
+            return block;
+
+        msg_Warn (p_access, "cannot map file, reading it instead");
+        sys->map = false;
+        if (lseek (fd, sys->offset - sys->skip, SEEK_SET) == (off_t)-1)
+        {
+            *eof = true;
+            return NULL;
+        }
+    }
+#endif
+
+    block_t *block = AllocBlock (sys);
+    if (unlikely(block == NULL))
+        return NULL;
+
+    ssize_t val = vlc_read_i11e (fd, block->p_buffer, sys->block_size);
+#ifdef O_DIRECT
+    if (val < 0 && errno == EINVAL && sys->direct)
+    {
+        /* Some file systems accept O_DIRECT but not our alignment */
+        msg_Warn (p_access, "cannot read directly, using the page cache");
+        block_Release (block);
+        if (fcntl (fd, F_SETFL, fcntl (fd, F_GETFL) & ~O_DIRECT))
+        {
+            *eof = true;
+            return NULL;
+        }
+        sys->direct = false;
+        return ReadBlock (p_access, eof);
+    }
+#endif
+    if (val < 0)
+    {
+        block_Release (block);
+        switch (errno)
+        {
+            case EINTR:
+            case EAGAIN:
+                return NULL;
+        }
+
+        msg_Err (p_access, "read error: %s", vlc_strerror_c(errno));
+        *eof = true;
+        return NULL;
+    }
+
+    /* Reads start on an aligned boundary after a seek */
+    uint64_t start = sys->offset - sys->skip;
+    uint64_t end = start + val;
+
+    if ((size_t)val <= sys->skip)
+    {
+        block_Release (block);
+        *eof = true;
+        return NULL;
+    }
+    block->p_buffer += sys->skip;
+    block->i_buffer = val - sys->skip;
+    sys->offset = end;
+    sys->skip = 0;
+
+    /* After a short read, the next one must still start on a boundary */
+    if (end % sys->align)
+    {
+        uint64_t next = end - (end % sys->align);
+
+        if (lseek (fd, next, SEEK_SET) != (off_t)-1)
+            sys->skip = end - next;
+    }
+
+    if (!sys->direct)
+        Advise (sys, start, end);
+    return block;
+}
+
 /*****************************************************************************
  * Seek: seek to a specific location in a file
  *****************************************************************************/
@@ -333,6 +565,19 @@ static int FileSeek (stream_t *p_access, uint64_t i_pos)
 {
     access_sys_t *sys = p_access->p_sys;
 
+    if (sys->block_size > 0)
+    {
+        uint64_t start = i_pos - (i_pos % sys->align);
+
+        if (!sys->map && lseek(sys->fd, start, SEEK_SET) == (off_t)-1)
+            return VLC_EGENERIC;
+        sys->offset = i_pos;
+        sys->skip = i_pos - start;
+        sys->advised = start;
+        sys->dropped = start;
+        return VLC_SUCCESS;
+    }
+
     if (lseek(sys->fd, i_pos, SEEK_SET) == (off_t)-1)
         return VLC_EGENERIC;
     return VLC_SUCCESS;
@@ -361,6 +606,13 @@ static int FileControl( stream_t *p_access, int i_query, va_list args )
             *pb_bool = p_sys->b_pace_control;
             break;
 
+        case STREAM_CAN_SKIP_CACHE:
+            /* Only the block mode returns large enough blocks */
+            if (p_sys->block_size == 0)
+                return VLC_EGENERIC;
+            *va_arg( args, bool * ) = true;
+            break;
+
         case STREAM_GET_SIZE:
         case STREAM_GET_MTIME:
         {
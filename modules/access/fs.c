@@ -26,6 +26,8 @@
 # include "config.h"
 #endif
 
+#include <fcntl.h>
+
 #include <vlc_common.h>
 #include "fs.h"
 #include <vlc_plugin.h>
@@ -38,6 +40,29 @@ vlc_module_begin ()
     add_shortcut( "file", "fd", "stream" )
     set_callbacks( FileOpen, FileClose )
 
+    add_integer_with_range( "file-block-size", 0, 0, 65536,
+                            N_("Block size (KiB)"),
+                            N_("Read regular files by large aligned blocks of "
+                               "this size, which are handed over as is to the "
+                               "demuxer. 0 reads them into the stream cache.") )
+        change_safe()
+#ifdef HAVE_MMAP
+    add_integer_with_range( "file-mmap-size", 0, 0, 1 << 20,
+                            N_("Memory map threshold (MiB)"),
+                            N_("Map local files at least this large in "
+                               "memory, and hand the mapped blocks over to "
+                               "the demuxer instead of copying them. "
+                               "A mapped file truncated during playback "
+                               "crashes VLC, so only enable this for files "
+                               "that are not modified. "
+                               "0 disables memory mapping.") )
+#endif
+#ifdef O_DIRECT
+    add_bool( "file-direct", false, N_("Bypass the page cache"),
+              N_("Read regular files directly from the storage in block "
+                 "mode, without going through the operating system cache.") )
+#endif
+
     add_submodule()
     set_section( N_("Directory" ), NULL )
     set_capability( "access", 55 )
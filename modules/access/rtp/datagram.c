@@ -78,6 +78,40 @@ static ssize_t vlc_datagram_Recv(struct vlc_dtls *dgs, struct iovec *iov,
     return ret;
 }
 
+#ifdef HAVE_RECVMMSG
+# define VLC_DATAGRAM_BATCH 64
+
+static int vlc_datagram_RecvMulti(struct vlc_dtls *dgs,
+                                  struct vlc_dtls_buf *bufs, unsigned count)
+{
+    struct mmsghdr msgs[VLC_DATAGRAM_BATCH];
+    struct iovec iovs[VLC_DATAGRAM_BATCH];
+    int fd = container_of(dgs, struct vlc_dgram_sock, s)->fd;
+
+    if (count > VLC_DATAGRAM_BATCH)
+        count = VLC_DATAGRAM_BATCH;
+
+    for (unsigned i = 0; i < count; i++) {
+        iovs[i].iov_base = bufs[i].base;
+        iovs[i].iov_len = bufs[i].len;
+        msgs[i].msg_hdr = (struct msghdr) {
+            .msg_iov = &iovs[i],
+            .msg_iovlen = 1,
+        };
+    }
+
+    int ret = recvmmsg(fd, msgs, count, MSG_WAITFORONE, NULL);
+
+    for (int i = 0; i < ret; i++) {
+        bufs[i].len = msgs[i].msg_len;
+        bufs[i].truncated = (msgs[i].msg_hdr.msg_flags & MSG_TRUNC) != 0;
+    }
+    return ret;
+}
+#else
+# define vlc_datagram_RecvMulti NULL
+#endif
+
 static ssize_t vlc_datagram_Send(struct vlc_dtls *dgs,
                                  const struct iovec *iov, unsigned iovlen)
 {
@@ -95,6 +129,7 @@ static const struct vlc_dtls_operations vlc_datagram_ops = {
     vlc_datagram_GetPollFD,
     vlc_datagram_Recv,
     vlc_datagram_Send,
+    vlc_datagram_RecvMulti,
 };
 
 struct vlc_dtls *vlc_datagram_CreateFD(int fd)
@@ -146,6 +181,7 @@ static const struct vlc_dtls_operations vlc_dccp_ops = {
     vlc_datagram_GetPollFD,
     vlc_dccp_Recv,
     vlc_datagram_Send,
+    NULL, /* zero-length datagrams need checking one by one */
 };
 
 struct vlc_dtls *vlc_dccp_CreateFD(int fd)
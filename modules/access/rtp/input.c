@@ -48,8 +48,10 @@
 # include "srtp.h"
 #endif
 #include "input.h"
+#include "pool.h"
 
-#define DEFAULT_MRU (1500u - (20 + 8))
+/* Maximum number of packets received at once */
+#define RTP_BATCH 32
 
 /**
  * Processes a packet received from the RTP socket.
@@ -76,7 +78,7 @@ static void rtp_process (struct vlc_logger *logger, rtp_input_sys_t *sys,
     }
 #endif
 
-    rtp_queue (logger, session, block);
+    rtp_queue (logger, session, block, vlc_tick_now ());
     return;
 drop:
     block_Release (block);
@@ -97,6 +99,93 @@ static int rtp_timeout (vlc_tick_t deadline)
     return t;
 }
 
+/**
+ * Takes the buffers for a batch of packets.
+ *
+ * Buffers are taken from the pool, which grows as needed. If it cannot grow,
+ * a single buffer is allocated instead.
+ *
+ * @return the number of buffers
+ */
+static unsigned rtp_get_buffers (rtp_sys_t *sys, block_t **blocks,
+                                 struct vlc_dtls_buf *bufs)
+{
+    struct rtp_pool *pool = sys->input_sys.pool;
+    unsigned count = 0;
+
+    if (pool != NULL)
+    {
+        while (count < RTP_BATCH)
+        {
+            block_t *block = rtp_pool_Get (pool);
+            if (block == NULL)
+                break;
+            blocks[count++] = block;
+        }
+
+        if (count == 0)
+        {
+            vlc_tick_t now = vlc_tick_now ();
+
+            sys->pool_starved++;
+            if (now >= sys->pool_report)
+            {
+                vlc_warning (sys->logger, "cannot grow the packet buffer "
+                             "pool (%" PRIu64 " times)", sys->pool_starved);
+                sys->pool_report = now + VLC_TICK_FROM_SEC(5);
+            }
+        }
+    }
+
+    if (count == 0)
+    {
+        blocks[0] = block_Alloc (DEFAULT_MRU);
+        if (unlikely(blocks[0] == NULL))
+            return 0;
+        count = 1;
+    }
+
+    for (unsigned i = 0; i < count; i++)
+    {
+        bufs[i].base = blocks[i]->p_buffer;
+        bufs[i].len = blocks[i]->i_buffer;
+    }
+    return count;
+}
+
+/**
+ * Reports the playout delay when it changed.
+ */
+static void rtp_report_stats (rtp_sys_t *sys, vlc_tick_t now)
+{
+    if (now < sys->stats_report)
+        return;
+    sys->stats_report = now + VLC_TICK_FROM_SEC(5);
+
+    if (sys->input_sys.pool != NULL)
+    {
+        size_t size = rtp_pool_Size (sys->input_sys.pool);
+        if (size != sys->pool_size)
+        {
+            vlc_debug (sys->logger, "%zu packet buffers", size);
+            sys->pool_size = size;
+        }
+    }
+
+    struct rtp_session_stats stats;
+    rtp_session_get_stats (sys->session, &stats);
+    if (stats.delay == sys->stats_delay)
+        return;
+    sys->stats_delay = stats.delay;
+
+    vlc_debug (sys->logger, "playout delay %"PRId64" ms (jitter %"PRId64
+               " ms, reordering depth %"PRIu16"), %"PRIu64" late packet(s) "
+               "out of %"PRIu64" (%.2f%%)", MS_FROM_VLC_TICK(stats.delay),
+               MS_FROM_VLC_TICK(stats.jitter), stats.depth, stats.late,
+               stats.received,
+               stats.received ? 100. * stats.late / stats.received : 0.);
+}
+
 /**
  * RTP/RTCP session thread for datagram sockets
  */
@@ -108,6 +197,12 @@ void *rtp_dgram_thread (void *opaque)
 
     vlc_thread_set_name("vlc-rtp");
 
+    sys->pool_starved = 0;
+    sys->pool_report = VLC_TICK_INVALID;
+    sys->pool_size = 0;
+    sys->stats_report = VLC_TICK_INVALID;
+    sys->stats_delay = 0;
+
     for (;;)
     {
         struct pollfd ufd[1];
@@ -125,39 +220,49 @@ void *rtp_dgram_thread (void *opaque)
 
         if (ufd[0].revents)
         {
-            block_t *block = block_Alloc(DEFAULT_MRU);
-            if (unlikely(block == NULL))
+            block_t *blocks[RTP_BATCH];
+            struct vlc_dtls_buf bufs[RTP_BATCH];
+            unsigned count = rtp_get_buffers (sys, blocks, bufs);
+            if (unlikely(count == 0))
                 break; /* we are totallly screwed */
 
-            bool truncated;
-            ssize_t len = vlc_dtls_Recv(rtp_sock, block->p_buffer,
-                                       block->i_buffer, &truncated);
-            if (len >= 0) {
-                if (truncated) {
+            int received = vlc_dtls_RecvMulti(rtp_sock, bufs, count);
+            if (received < 0)
+            {
+                if (errno == EPIPE)
+                    break; /* connection terminated */
+                vlc_warning (sys->logger, "RTP network error: %s",
+                          vlc_strerror_c(errno));
+                received = 0;
+            }
+
+            for (int i = 0; i < received; i++)
+            {
+                block_t *block = blocks[i];
+
+                if (bufs[i].truncated) {
                     vlc_error (sys->logger, "packet truncated (MRU was %zu)",
                             block->i_buffer);
                     block->i_flags |= BLOCK_FLAG_CORRUPTED;
                 }
                 else
-                    block->i_buffer = len;
+                    block->i_buffer = bufs[i].len;
 
                 rtp_process (sys->logger, &sys->input_sys, sys->session, block);
             }
-            else
-            {
-                if (errno == EPIPE)
-                    break; /* connection terminated */
-                vlc_warning (sys->logger, "RTP network error: %s",
-                          vlc_strerror_c(errno));
-                block_Release (block);
-            }
+
+            /* Unused buffers go back to the pool */
+            for (unsigned i = received; i < count; i++)
+                block_Release (blocks[i]);
 
             n--;
         }
 
-    dequeue:
-        if (!rtp_dequeue (sys->logger, sys->session, vlc_tick_now(), &deadline))
+    dequeue:;
+        vlc_tick_t now = vlc_tick_now ();
+        if (!rtp_dequeue (sys->logger, sys->session, now, &deadline))
             deadline = VLC_TICK_INVALID;
+        rtp_report_stats (sys, now);
         vlc_restorecancel (canc);
     }
     return NULL;
@@ -21,6 +21,9 @@
  * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
  ****************************************************************************/
 
+#define DEFAULT_MRU (1500u - (20 + 8))
+#define RTP_BUFFERS_DEFAULT 1024
+
 typedef struct
 {
 #ifdef HAVE_SRTP
@@ -28,6 +31,7 @@ typedef struct
 #endif
     struct vlc_dtls *rtp_sock;
     struct vlc_dtls *rtcp_sock;
+    struct rtp_pool *pool; /* may be NULL */
 } rtp_input_sys_t;
 
 /* Global data */
@@ -37,4 +41,9 @@ typedef struct
     rtp_session_t *session;
     vlc_thread_t  thread;
     rtp_input_sys_t input_sys;
+    uint64_t      pool_starved; /* batches without pool buffers */
+    vlc_tick_t    pool_report;
+    size_t        pool_size; /* last reported pool size */
+    vlc_tick_t    stats_report;
+    vlc_tick_t    stats_delay; /* last reported playout delay */
 } rtp_sys_t;
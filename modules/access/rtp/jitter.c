@@ -0,0 +1,137 @@
+/**
+ * @file jitter.c
+ * @brief RTP adaptive playout delay
+ */
+/*****************************************************************************
+ * Copyright © 2026 VLC authors and VideoLAN
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ ****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <vlc_common.h>
+#include <vlc_tick.h>
+
+#include "jitter.h"
+
+/* Time constant of the playout delay decrease */
+#define RTP_JITTER_DECAY VLC_TICK_FROM_SEC(10)
+/* Minimum interval between two decrease steps (avoids rounding to zero) */
+#define RTP_JITTER_STEP VLC_TICK_FROM_MS(100)
+
+void rtp_jitter_init(struct rtp_jitter *j, vlc_tick_t min_delay,
+                     vlc_tick_t max_delay)
+{
+    if (max_delay < min_delay)
+        max_delay = min_delay;
+
+    j->min_delay = min_delay;
+    j->max_delay = max_delay;
+    j->delay = min_delay;
+    j->jitter = 0;
+    j->reorder = 0;
+    j->last_update = VLC_TICK_INVALID;
+    j->depth = 0;
+    j->received = 0;
+    j->late = 0;
+}
+
+static vlc_tick_t rtp_jitter_clamp(const struct rtp_jitter *j, vlc_tick_t d)
+{
+    return VLC_CLIP(d, j->min_delay, j->max_delay);
+}
+
+/* Moves a value down toward a floor, exponentially over time */
+static vlc_tick_t rtp_jitter_decay(vlc_tick_t value, vlc_tick_t floor,
+                                   vlc_tick_t elapsed)
+{
+    if (value <= floor)
+        return value;
+    if (elapsed >= RTP_JITTER_DECAY)
+        return floor;
+    return value - (value - floor) * elapsed / RTP_JITTER_DECAY;
+}
+
+static void rtp_jitter_update(struct rtp_jitter *j, vlc_tick_t now)
+{
+    vlc_tick_t elapsed = 0;
+
+    if (j->last_update == VLC_TICK_INVALID)
+        j->last_update = now;
+    else if (now - j->last_update >= RTP_JITTER_STEP)
+    {
+        elapsed = now - j->last_update;
+        j->last_update = now;
+    }
+
+    j->reorder = rtp_jitter_decay(j->reorder, 0, elapsed);
+
+    /* Wait for 3 times the interarrival jitter (about 99.7% match for
+     * random gaussian jitter), or for the recently observed reordering. */
+    vlc_tick_t target = 3 * j->jitter;
+    if (target < j->reorder)
+        target = j->reorder;
+    target = rtp_jitter_clamp(j, target);
+
+    if (target >= j->delay)
+        j->delay = target; /* grow at once */
+    else
+        j->delay = rtp_jitter_decay(j->delay, target, elapsed);
+}
+
+void rtp_jitter_receive(struct rtp_jitter *j, vlc_tick_t now,
+                        vlc_tick_t transit)
+{
+    if (transit < 0)
+        transit = -transit;
+
+    /* J(i) = J(i-1) + (|D(i-1,i)| - J(i-1))/16 */
+    j->jitter += (transit - j->jitter + 8) / 16;
+    j->received++;
+    rtp_jitter_update(j, now);
+}
+
+void rtp_jitter_reorder(struct rtp_jitter *j, vlc_tick_t now, uint16_t depth,
+                        vlc_tick_t lateness)
+{
+    if (depth > j->depth)
+        j->depth = depth;
+
+    /* Keep a margin, as the next reordered packet may well be later */
+    lateness += lateness / 4;
+    if (j->reorder < lateness)
+        j->reorder = lateness;
+    rtp_jitter_update(j, now);
+}
+
+void rtp_jitter_late(struct rtp_jitter *j, vlc_tick_t lateness)
+{
+    j->late++;
+
+    vlc_tick_t need;
+    if (lateness != VLC_TICK_INVALID && lateness > 0)
+        need = lateness + lateness / 4;
+    else
+        need = j->delay + j->delay / 2;
+
+    if (j->reorder < need)
+        j->reorder = need;
+    need = rtp_jitter_clamp(j, need);
+    if (j->delay < need)
+        j->delay = need;
+}
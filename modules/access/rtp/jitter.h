@@ -0,0 +1,101 @@
+/**
+ * @file jitter.h
+ * @brief RTP adaptive playout delay
+ */
+/*****************************************************************************
+ * Copyright © 2026 VLC authors and VideoLAN
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ ****************************************************************************/
+
+#ifndef VLC_RTP_JITTER_H
+# define VLC_RTP_JITTER_H
+
+/**
+ * \defgroup rtp_jitter RTP playout delay
+ * \ingroup rtp_session
+ *
+ * The playout delay is how long the session waits for a missing packet
+ * before giving up on it. It follows the measured network conditions:
+ * it grows immediately when packets arrive later than it allows for, and
+ * it shrinks back slowly once they do not anymore.
+ *
+ * @{
+ */
+
+/** Per-source playout delay state */
+struct rtp_jitter
+{
+    vlc_tick_t min_delay; /**< Lower bound of the playout delay */
+    vlc_tick_t max_delay; /**< Upper bound of the playout delay */
+    vlc_tick_t delay; /**< Current playout delay */
+    vlc_tick_t jitter; /**< RFC 3550 interarrival jitter estimate */
+    vlc_tick_t reorder; /**< Reordering delay estimate (decaying peak) */
+    vlc_tick_t last_update; /**< Time of the last estimate decay */
+    uint16_t depth; /**< Largest reordering depth seen (packets) */
+    uint64_t received; /**< Packets received */
+    uint64_t late; /**< Packets received after their playout deadline */
+};
+
+/**
+ * Initializes the playout delay state.
+ *
+ * The playout delay starts at the lower bound.
+ */
+void rtp_jitter_init(struct rtp_jitter *, vlc_tick_t min_delay,
+                     vlc_tick_t max_delay);
+
+/**
+ * Accounts for a received packet.
+ *
+ * @param now reception time
+ * @param transit difference of relative transit time with the previous
+ *                packet of the source (D(i-1,i) in RFC 3550), or
+ *                VLC_TICK_INVALID for the first packet
+ */
+void rtp_jitter_receive(struct rtp_jitter *, vlc_tick_t now,
+                        vlc_tick_t transit);
+
+/**
+ * Accounts for a packet received out of order, but in time.
+ *
+ * @param now reception time
+ * @param depth how many packets with higher sequence numbers were received
+ *              before this one
+ * @param lateness how long after the next packet in sequence this one
+ *                 was received
+ */
+void rtp_jitter_reorder(struct rtp_jitter *, vlc_tick_t now, uint16_t depth,
+                        vlc_tick_t lateness);
+
+/**
+ * Accounts for a packet received after the session gave up waiting for it.
+ *
+ * @param lateness how long the session should have waited for the packet,
+ *                 or VLC_TICK_INVALID if unknown
+ */
+void rtp_jitter_late(struct rtp_jitter *, vlc_tick_t lateness);
+
+/**
+ * Returns the proportion of packets lost because they arrived too late.
+ */
+static inline float rtp_jitter_late_loss(const struct rtp_jitter *j)
+{
+    return j->received ? (float)j->late / (float)j->received : 0.f;
+}
+
+/** @} */
+
+#endif
@@ -0,0 +1,213 @@
+/**
+ * @file pool.c
+ * @brief RTP packet buffer pool
+ */
+/*****************************************************************************
+ * Copyright © 2026 VLC authors and VideoLAN
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ ****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <assert.h>
+#include <stdlib.h>
+
+#include <vlc_common.h>
+#include <vlc_atomic.h>
+#include <vlc_block.h>
+
+#include "pool.h"
+
+/* Head and tail room of each buffer, as with block_Alloc() */
+#define RTP_POOL_PADDING 32
+
+struct rtp_pool_block
+{
+    block_t self;
+    struct rtp_pool *pool;
+    struct rtp_pool_block *next;
+    uint8_t *data;
+};
+
+/* Buffers are allocated in slabs, which stay until the pool is destroyed */
+struct rtp_pool_slab
+{
+    struct rtp_pool_slab *next;
+    uint8_t *data;
+    struct rtp_pool_block blocks[];
+};
+
+struct rtp_pool
+{
+    vlc_mutex_t lock;
+    struct rtp_pool_block *free;
+    struct rtp_pool_slab *slabs;
+    size_t available;
+    size_t total;
+    vlc_atomic_rc_t rc;
+
+    size_t step;
+    size_t mru;
+    size_t size;
+};
+
+static void rtp_pool_Destroy(struct rtp_pool *pool)
+{
+    struct rtp_pool_slab *slab = pool->slabs;
+
+    while (slab != NULL)
+    {
+        struct rtp_pool_slab *next = slab->next;
+
+        aligned_free(slab->data);
+        free(slab);
+        slab = next;
+    }
+    free(pool);
+}
+
+/**
+ * Adds a slab of buffers to the free list, with the pool lock held.
+ */
+static int rtp_pool_Grow(struct rtp_pool *pool)
+{
+    struct rtp_pool_slab *slab = malloc(sizeof (*slab)
+                                        + pool->step * sizeof (slab->blocks[0]));
+    if (unlikely(slab == NULL))
+        return -1;
+
+    slab->data = aligned_alloc(64, pool->step * pool->size);
+    if (unlikely(slab->data == NULL))
+    {
+        free(slab);
+        return -1;
+    }
+
+    for (size_t i = pool->step; i-- > 0;)
+    {
+        struct rtp_pool_block *pb = &slab->blocks[i];
+
+        pb->pool = pool;
+        pb->data = slab->data + i * pool->size;
+        pb->next = pool->free;
+        pool->free = pb;
+    }
+
+    slab->next = pool->slabs;
+    pool->slabs = slab;
+    pool->available += pool->step;
+    pool->total += pool->step;
+    return 0;
+}
+
+void rtp_pool_Release(struct rtp_pool *pool)
+{
+    if (vlc_atomic_rc_dec(&pool->rc))
+        rtp_pool_Destroy(pool);
+}
+
+static void rtp_pool_block_Release(block_t *block)
+{
+    struct rtp_pool_block *pb = container_of(block, struct rtp_pool_block,
+                                             self);
+    struct rtp_pool *pool = pb->pool;
+
+    vlc_mutex_lock(&pool->lock);
+    pb->next = pool->free;
+    pool->free = pb;
+    pool->available++;
+    vlc_mutex_unlock(&pool->lock);
+
+    rtp_pool_Release(pool);
+}
+
+static const struct vlc_block_callbacks rtp_pool_block_cbs =
+{
+    rtp_pool_block_Release,
+};
+
+struct rtp_pool *rtp_pool_Create(size_t count, size_t mru)
+{
+    assert(count > 0);
+
+    struct rtp_pool *pool = malloc(sizeof (*pool));
+    if (unlikely(pool == NULL))
+        return NULL;
+
+    vlc_mutex_init(&pool->lock);
+    vlc_atomic_rc_init(&pool->rc);
+    pool->free = NULL;
+    pool->slabs = NULL;
+    pool->available = 0;
+    pool->total = 0;
+    pool->step = count;
+    pool->mru = mru;
+    pool->size = (mru + 2 * RTP_POOL_PADDING + 63) & ~(size_t)63;
+
+    if (rtp_pool_Grow(pool))
+    {
+        free(pool);
+        return NULL;
+    }
+    return pool;
+}
+
+block_t *rtp_pool_Get(struct rtp_pool *pool)
+{
+    vlc_mutex_lock(&pool->lock);
+    /* Packets stay in use for the playout delay, so the pool settles at
+     * about the delay times the packet rate. */
+    if (pool->free == NULL)
+        rtp_pool_Grow(pool);
+
+    struct rtp_pool_block *pb = pool->free;
+    if (pb != NULL)
+    {
+        pool->free = pb->next;
+        pool->available--;
+    }
+    vlc_mutex_unlock(&pool->lock);
+
+    if (pb == NULL)
+        return NULL;
+
+    /* Each block in use holds a reference to the pool */
+    vlc_atomic_rc_inc(&pool->rc);
+
+    block_t *block = &pb->self;
+    block_Init(block, &rtp_pool_block_cbs, pb->data, pool->size);
+    block->p_buffer += RTP_POOL_PADDING;
+    block->i_buffer = pool->mru;
+    return block;
+}
+
+size_t rtp_pool_Available(struct rtp_pool *pool)
+{
+    vlc_mutex_lock(&pool->lock);
+    size_t available = pool->available;
+    vlc_mutex_unlock(&pool->lock);
+    return available;
+}
+
+size_t rtp_pool_Size(struct rtp_pool *pool)
+{
+    vlc_mutex_lock(&pool->lock);
+    size_t total = pool->total;
+    vlc_mutex_unlock(&pool->lock);
+    return total;
+}
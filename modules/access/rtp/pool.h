@@ -0,0 +1,70 @@
+/**
+ * @file pool.h
+ * @brief RTP packet buffer pool
+ */
+/*****************************************************************************
+ * Copyright © 2026 VLC authors and VideoLAN
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ ****************************************************************************/
+
+#ifndef VLC_RTP_POOL_H
+# define VLC_RTP_POOL_H
+
+/**
+ * Pool of preallocated packet buffers.
+ *
+ * The blocks handed out by the pool go back to it when they are released,
+ * from any thread. The pool grows by the initial number of buffers whenever
+ * they are all in use, and never shrinks. The pool itself is deleted once it has been released by
+ * its owner and all its blocks have been released.
+ */
+struct rtp_pool;
+
+/**
+ * Creates a pool.
+ *
+ * @param count initial number of buffers, and growth step
+ * @param mru size of each buffer (maximum receive unit)
+ * @return the pool or NULL on allocation failure
+ */
+struct rtp_pool *rtp_pool_Create(size_t count, size_t mru);
+
+/**
+ * Releases the pool from its owner.
+ */
+void rtp_pool_Release(struct rtp_pool *pool);
+
+/**
+ * Takes a buffer from the pool.
+ *
+ * The block payload size is the pool MRU. The block can be shrunk or
+ * reallocated as any other block.
+ *
+ * @return a block or NULL if the pool could not grow
+ */
+block_t *rtp_pool_Get(struct rtp_pool *pool);
+
+/**
+ * Returns the number of buffers that are not in use.
+ */
+size_t rtp_pool_Available(struct rtp_pool *pool);
+
+/**
+ * Returns the number of buffers allocated by the pool.
+ */
+size_t rtp_pool_Size(struct rtp_pool *pool);
+
+#endif
@@ -42,6 +42,7 @@
 #endif
 #include "sdp.h"
 #include "input.h"
+#include "pool.h"
 
 /*
  * TODO: so much stuff
@@ -260,6 +261,21 @@ static int Control (demux_t *demux, int query, va_list args)
     return VLC_EGENERIC;
 }
 
+/**
+ * Creates the packet buffer pool, if enabled
+ */
+static struct rtp_pool *rtp_pool_New(vlc_object_t *obj)
+{
+    unsigned count = var_InheritInteger(obj, "rtp-buffers");
+    if (count == 0)
+        return NULL;
+
+    struct rtp_pool *pool = rtp_pool_Create(count, DEFAULT_MRU);
+    if (pool == NULL)
+        msg_Warn(obj, "cannot allocate %u packet buffers", count);
+    return pool;
+}
+
 /**
  * Releases resources
  */
@@ -270,6 +286,8 @@ static void Close (vlc_object_t *obj)
 
     vlc_cancel(p_sys->thread);
     vlc_join(p_sys->thread, NULL);
+    if (p_sys->input_sys.pool != NULL)
+        rtp_pool_Release(p_sys->input_sys.pool);
 #ifdef HAVE_SRTP
     if (p_sys->input_sys.srtp)
         srtp_destroy (p_sys->input_sys.srtp);
@@ -423,7 +441,9 @@ static int OpenSDP(vlc_object_t *obj)
     sys->session = rtp_session_create_custom(var_InheritInteger(obj, "rtp-max-dropout"),
                                              var_InheritInteger(obj, "rtp-max-misorder"),
                                              var_InheritInteger(obj, "rtp-max-src"),
-                                             vlc_tick_from_sec(var_InheritInteger(obj, "rtp-timeout")));
+                                             vlc_tick_from_sec(var_InheritInteger(obj, "rtp-timeout")),
+                                             VLC_TICK_FROM_MS(var_InheritInteger(obj, "rtp-min-delay")),
+                                             VLC_TICK_FROM_MS(var_InheritInteger(obj, "rtp-max-delay")));
     if (sys->session == NULL)
         goto error;
 
@@ -437,7 +457,11 @@ static int OpenSDP(vlc_object_t *obj)
     if (err > 0 && module_exists("live555")) /* Bail out to live555 */
         goto error;
 
+    sys->input_sys.pool = rtp_pool_New(obj);
+
     if (vlc_clone(&sys->thread, rtp_dgram_thread, sys)) {
+        if (sys->input_sys.pool != NULL)
+            rtp_pool_Release(sys->input_sys.pool);
         rtp_session_destroy(obj->logger, sys->session);
         goto error;
     }
@@ -573,7 +597,9 @@ static int OpenURL(vlc_object_t *obj)
                         var_InheritInteger(obj, "rtp-max-dropout"),
                         var_InheritInteger(obj, "rtp-max-misorder"),
                         var_InheritInteger(obj, "rtp-max-src"),
-                        vlc_tick_from_sec(var_InheritInteger(obj, "rtp-timeout")) );
+                        vlc_tick_from_sec(var_InheritInteger(obj, "rtp-timeout")),
+                        VLC_TICK_FROM_MS(var_InheritInteger(obj, "rtp-min-delay")),
+                        VLC_TICK_FROM_MS(var_InheritInteger(obj, "rtp-max-delay")) );
     if (p_sys->session == NULL)
         goto error;
 
@@ -606,8 +632,14 @@ static int OpenURL(vlc_object_t *obj)
     }
 #endif
 
+    p_sys->input_sys.pool = rtp_pool_New(obj);
+
     if (vlc_clone (&p_sys->thread, rtp_dgram_thread, p_sys))
+    {
+        if (p_sys->input_sys.pool != NULL)
+            rtp_pool_Release(p_sys->input_sys.pool);
         goto error;
+    }
     return VLC_SUCCESS;
 
 error:
@@ -652,6 +684,22 @@ error:
     "RTP packets will be discarded if they are too much ahead (i.e. in the " \
     "future) by this many packets from the last received packet." )
 
+#define RTP_MIN_DELAY_TEXT N_("Minimum RTP playout delay (ms)")
+#define RTP_MIN_DELAY_LONGTEXT N_( \
+    "Shortest time to wait for a missing or reordered RTP packet. " \
+    "The delay adapts to the measured network jitter and reordering " \
+    "above this value.")
+
+#define RTP_MAX_DELAY_TEXT N_("Maximum RTP playout delay (ms)")
+#define RTP_MAX_DELAY_LONGTEXT N_( \
+    "Longest time to wait for a missing or reordered RTP packet. " \
+    "Packets arriving later are lost.")
+
+#define RTP_BUFFERS_TEXT N_("RTP packet buffers")
+#define RTP_BUFFERS_LONGTEXT N_( \
+    "Number of preallocated packet buffers. As many more are allocated " \
+    "whenever they are all in use. Zero disables the pool.")
+
 #define RTP_MAX_MISORDER_TEXT N_("Maximum RTP sequence number misordering")
 #define RTP_MAX_MISORDER_LONGTEXT N_( \
     "RTP packets will be discarded if they are too far behind (i.e. in the " \
@@ -694,6 +742,15 @@ vlc_module_begin()
     add_integer("rtp-max-misorder", RTP_MAX_MISORDER_DEFAULT, RTP_MAX_MISORDER_TEXT,
                 RTP_MAX_MISORDER_LONGTEXT)
         change_integer_range (0, 32767)
+    add_integer("rtp-min-delay", RTP_MIN_DELAY_DEFAULT, RTP_MIN_DELAY_TEXT,
+                RTP_MIN_DELAY_LONGTEXT)
+        change_integer_range (0, 60000)
+    add_integer("rtp-max-delay", RTP_MAX_DELAY_DEFAULT, RTP_MAX_DELAY_TEXT,
+                RTP_MAX_DELAY_LONGTEXT)
+        change_integer_range (0, 60000)
+    add_integer("rtp-buffers", RTP_BUFFERS_DEFAULT, RTP_BUFFERS_TEXT,
+                RTP_BUFFERS_LONGTEXT)
+        change_integer_range (0, 65536)
     add_obsolete_string("rtp-dynamic-pt") /* since 4.0.0 */
 
     /*add_shortcut ("sctp")*/
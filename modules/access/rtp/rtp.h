@@ -363,13 +363,28 @@ static inline uint8_t rtp_ptype (const block_t *block)
 #define RTP_MAX_DROPOUT_DEFAULT 3000
 #define RTP_MAX_TIMEOUT_DEFAULT 5
 #define RTP_MAX_MISORDER_DEFAULT 100
+#define RTP_MIN_DELAY_DEFAULT 25 /* ms */
+#define RTP_MAX_DELAY_DEFAULT 1000 /* ms */
+
+/** Playout delay statistics of an RTP session */
+struct rtp_session_stats
+{
+    vlc_tick_t delay; /**< Current playout delay */
+    vlc_tick_t jitter; /**< Interarrival jitter */
+    uint16_t depth; /**< Largest reordering depth (packets) */
+    uint64_t received; /**< Packets received */
+    uint64_t late; /**< Packets received too late to be played */
+};
 
 rtp_session_t *rtp_session_create (void);
 rtp_session_t *rtp_session_create_custom (uint16_t max_dropout, uint16_t max_misorder,
-                                          uint8_t max_src, vlc_tick_t timeout);
+                                          uint8_t max_src, vlc_tick_t timeout,
+                                          vlc_tick_t min_delay, vlc_tick_t max_delay);
 void rtp_session_destroy (struct vlc_logger *, rtp_session_t *);
-void rtp_queue (struct vlc_logger *, rtp_session_t *, block_t *);
+void rtp_queue (struct vlc_logger *, rtp_session_t *, block_t *, vlc_tick_t);
 bool rtp_dequeue (struct vlc_logger *, const rtp_session_t *, vlc_tick_t, vlc_tick_t *);
+void rtp_session_get_stats (const rtp_session_t *,
+                            struct rtp_session_stats *restrict);
 int rtp_add_type(rtp_session_t *ses, rtp_pt_t *pt);
 int vlc_rtp_add_media_types(vlc_object_t *obj, rtp_session_t *ses,
                             const struct vlc_sdp_media *media,
@@ -32,6 +32,7 @@
 #include <vlc_demux.h>
 
 #include "rtp.h"
+#include "jitter.h"
 
 typedef struct rtp_source_t rtp_source_t;
 
@@ -44,6 +45,8 @@ struct rtp_session_t
     rtp_pt_t     **ptv;
     /* params */
     vlc_tick_t    timeout;
+    vlc_tick_t    min_delay; /**< Min playout delay */
+    vlc_tick_t    max_delay; /**< Max playout delay */
     uint16_t      max_dropout; /**< Max packet forward misordering */
     uint16_t      max_misorder; /**< Max packet backward misordering */
     uint8_t       max_src; /**< Max simultaneous RTP sources */
@@ -60,7 +63,8 @@ static void rtp_decode (struct vlc_logger *, const rtp_session_t *, rtp_source_t
  */
 rtp_session_t *
 rtp_session_create_custom (uint16_t max_dropout, uint16_t max_misorder,
-                           uint8_t max_src, vlc_tick_t timeout)
+                           uint8_t max_src, vlc_tick_t timeout,
+                           vlc_tick_t min_delay, vlc_tick_t max_delay)
 {
     rtp_session_t *session = malloc (sizeof (*session));
     if (session == NULL)
@@ -71,6 +75,8 @@ rtp_session_create_custom (uint16_t max_dropout, uint16_t max_misorder,
     session->max_misorder = -1 * max_misorder;
     session->max_src = max_src;
     session->timeout = timeout;
+    session->min_delay = min_delay;
+    session->max_delay = max_delay;
 
     /* state variables */
     session->srcv = NULL;
@@ -87,7 +93,9 @@ rtp_session_create (void)
     return rtp_session_create_custom(RTP_MAX_DROPOUT_DEFAULT,
                                      RTP_MAX_MISORDER_DEFAULT,
                                      RTP_MAX_SRC_DEFAULT,
-                                     RTP_MAX_TIMEOUT_DEFAULT);
+                                     RTP_MAX_TIMEOUT_DEFAULT,
+                                     VLC_TICK_FROM_MS(RTP_MIN_DELAY_DEFAULT),
+                                     VLC_TICK_FROM_MS(RTP_MAX_DELAY_DEFAULT));
 }
 
 /**
@@ -129,7 +137,7 @@ int rtp_add_type(rtp_session_t *ses, rtp_pt_t *pt)
 struct rtp_source_t
 {
     uint32_t ssrc;
-    uint32_t jitter;  /* interarrival delay jitter estimate */
+    struct rtp_jitter jitter; /* playout delay state */
     vlc_tick_t  last_rx; /* last received packet local timestamp */
     uint32_t last_ts; /* last received packet RTP timestamp */
 
@@ -140,6 +148,10 @@ struct rtp_source_t
     uint16_t max_seq; /* next expected sequence */
 
     uint16_t last_seq; /* sequence of the next dequeued packet */
+    uint64_t missed; /* packets given up on, bit N for last_seq - N */
+    uint16_t gap_seq; /* first sequence of the last lost packets */
+    uint16_t gap_count; /* number of the last lost packets */
+    vlc_tick_t gap_rx; /* reception time of the packet after the gap */
     block_t *blocks; /* re-ordered blocks queue */
     struct {
         struct vlc_rtp_pt *instance; /* Per-source current payload format */
@@ -161,11 +173,13 @@ rtp_source_create (struct vlc_logger *logger, const rtp_session_t *session,
         return NULL;
 
     source->ssrc = ssrc;
-    source->jitter = 0;
+    rtp_jitter_init(&source->jitter, session->min_delay, session->max_delay);
     source->ref_rtp = 0;
     source->ref_ntp = UINT64_C (1) << 51;
     source->max_seq = source->bad_seq = init_seq;
     source->last_seq = init_seq - 1;
+    source->missed = 0;
+    source->gap_count = 0;
     source->blocks = NULL;
     source->pt.instance = NULL;
     vlc_debug (logger, "added RTP source (%08x)", ssrc);
@@ -218,9 +232,11 @@ static struct vlc_rtp_pt *rtp_find_ptype(const rtp_session_t *session,
  * @param logger VLC logger handle
  * @param session RTP session receiving the packet
  * @param block RTP packet including the RTP header
+ * @param now reception time of the packet (ex: vlc_tick_now())
  */
 void
-rtp_queue (struct vlc_logger *logger, rtp_session_t *session, block_t *block)
+rtp_queue (struct vlc_logger *logger, rtp_session_t *session, block_t *block,
+           vlc_tick_t now)
 {
     /* RTP header sanity checks (see RFC 3550) */
     if (block->i_buffer < 12)
@@ -238,7 +254,6 @@ rtp_queue (struct vlc_logger *logger, rtp_session_t *session, block_t *block)
         block->i_buffer -= padding;
     }
 
-    vlc_tick_t     now = vlc_tick_now ();
     rtp_source_t  *src  = NULL;
     const uint16_t seq  = rtp_seq (block);
     const uint32_t ssrc = GetDWBE (block->p_buffer + 8);
@@ -283,23 +298,23 @@ rtp_queue (struct vlc_logger *logger, rtp_session_t *session, block_t *block)
 
         tab[session->srcc++] = src;
         /* Cannot compute jitter yet */
+        rtp_jitter_receive (&src->jitter, now, 0);
     }
     else
     {
         const rtp_pt_t *pt = rtp_find_ptype(session, block);
+        vlc_tick_t d = 0;
 
         if (pt != NULL)
         {
             /* Recompute jitter estimate.
              * That is computed from the RTP timestamps and the system clock.
              * It is independent of RTP sequence. */
-            uint32_t freq = pt->frequency;
-            int64_t ts = rtp_timestamp (block);
-            int64_t d = samples_from_vlc_tick(now - src->last_rx, freq);
-            d        -=    ts - src->last_ts;
-            if (d < 0) d = -d;
-            src->jitter += ((d - src->jitter) + 8) >> 4;
+            int32_t ts_delta = rtp_timestamp (block) - src->last_ts;
+            d = (now - src->last_rx)
+              - vlc_tick_from_samples(ts_delta, pt->frequency);
         }
+        rtp_jitter_receive (&src->jitter, now, d);
     }
     src->last_rx = now;
     block->i_pts = now; /* store reception time until dequeued */
@@ -336,6 +351,9 @@ rtp_queue (struct vlc_logger *logger, rtp_session_t *session, block_t *block)
     if (delta_seq.s >= 0)
         src->max_seq = seq + 1;
 
+    const bool reordered = delta_seq.s < -1;
+    const uint16_t depth = -delta_seq.s - 1;
+
     /* Queues the block in sequence order,
      * hence there is a single queue for all payload types. */
     block_t **pp = &src->blocks;
@@ -351,6 +369,11 @@ rtp_queue (struct vlc_logger *logger, rtp_session_t *session, block_t *block)
         }
         pp = &prev->p_next;
     }
+    /* Measure how long the packet made the next one in sequence wait.
+     * If that one was already dequeued, the packet is too late. */
+    if (reordered && *pp != NULL)
+        rtp_jitter_reorder (&src->jitter, now, depth, now - (*pp)->i_pts);
+
     block->p_next = *pp;
     *pp = block;
 
@@ -411,19 +434,11 @@ bool rtp_dequeue (struct vlc_logger *logger, const rtp_session_t *session,
                 continue;
             }
 
-            /* Wait for 3 times the inter-arrival delay variance (about 99.7%
-             * match for random gaussian jitter).
+            /* Wait for the playout delay of the source. It adapts to the
+             * inter-arrival delay variance and to the reordering measured
+             * recently, within the session bounds (see jitter.c).
              */
-            vlc_tick_t deadline;
-            const rtp_pt_t *pt = rtp_find_ptype(session, block);
-            if (pt)
-                deadline = vlc_tick_from_samples(3 * src->jitter, pt->frequency);
-            else
-                deadline = 0; /* no jitter estimate with no frequency :( */
-
-            /* Make sure we wait at least for 25 msec */
-            if (deadline < VLC_TICK_FROM_MS(25))
-                deadline = VLC_TICK_FROM_MS(25);
+            vlc_tick_t deadline = src->jitter.delay;
 
             /* Additionally, we implicitly wait for the packetization time
              * multiplied by the number of missing packets. block is the first
@@ -465,11 +480,31 @@ rtp_decode (struct vlc_logger *logger, const rtp_session_t *session, rtp_source_
         {   /* Trash too late packets (and PIM Assert duplicates) */
             vlc_debug (logger, "ignoring late packet (sequence: %"PRIu16")",
                       rtp_seq (block));
+
+            /* Only count packets we gave up waiting for, not duplicates */
+            uint16_t back = src->last_seq - rtp_seq (block);
+            if (back < 64 && ((src->missed >> back) & 1))
+            {
+                src->missed &= ~(UINT64_C(1) << back);
+                /* The lateness is known for the last gap only */
+                rtp_jitter_late (&src->jitter,
+                    ((uint16_t)(rtp_seq (block) - src->gap_seq) < src->gap_count)
+                        ? block->i_pts - src->gap_rx : VLC_TICK_INVALID);
+            }
             goto drop;
         }
         vlc_warning (logger, "%"PRIu16" packet(s) lost", delta_seq);
         block->i_flags |= BLOCK_FLAG_DISCONTINUITY;
+        src->gap_seq = src->last_seq + 1;
+        src->gap_count = delta_seq;
+        src->gap_rx = block->i_pts; /* still the reception time */
     }
+
+    uint16_t advance = rtp_seq (block) - src->last_seq;
+    src->missed = (advance < 64) ? src->missed << advance : 0;
+    if (delta_seq != 0)
+        src->missed |= (delta_seq < 63)
+                     ? ((UINT64_C(1) << delta_seq) - 1) << 1 : ~UINT64_C(1);
     src->last_seq = rtp_seq (block);
 
     /* Match the payload type */
@@ -536,3 +571,33 @@ rtp_decode (struct vlc_logger *logger, const rtp_session_t *session, rtp_source_
 drop:
     block_Release (block);
 }
+
+/**
+ * Gets the playout delay statistics of an RTP session.
+ *
+ * The delay and jitter are the largest of all sources, the packet counts
+ * are the sums of all sources.
+ */
+void rtp_session_get_stats (const rtp_session_t *session,
+                            struct rtp_session_stats *restrict stats)
+{
+    stats->delay = 0;
+    stats->jitter = 0;
+    stats->depth = 0;
+    stats->received = 0;
+    stats->late = 0;
+
+    for (unsigned i = 0; i < session->srcc; i++)
+    {
+        const struct rtp_jitter *j = &session->srcv[i]->jitter;
+
+        if (stats->delay < j->delay)
+            stats->delay = j->delay;
+        if (stats->jitter < j->jitter)
+            stats->jitter = j->jitter;
+        if (stats->depth < j->depth)
+            stats->depth = j->depth;
+        stats->received += j->received;
+        stats->late += j->late;
+    }
+}
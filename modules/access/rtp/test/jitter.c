@@ -0,0 +1,270 @@
+/**
+ * @file jitter.c
+ */
+/*****************************************************************************
+ * Copyright © 2026 VLC authors and VideoLAN
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA.
+ ****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#undef NDEBUG
+#include <assert.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vlc_common.h>
+#include <vlc_block.h>
+#include "../rtp.h"
+
+const char vlc_module_name[] = "rtp_jitter_test";
+
+#define PT 96
+#define FREQ 90000
+#define PERIOD VLC_TICK_FROM_MS(10) /* packetization time */
+#define TRANSIT VLC_TICK_FROM_MS(40) /* fixed network delay */
+#define MIN_DELAY VLC_TICK_FROM_MS(25)
+#define MAX_DELAY VLC_TICK_FROM_MS(500)
+
+/* Replays the packets decoded by the session */
+struct sink
+{
+    unsigned decoded;
+    uint16_t last_seq;
+};
+
+void vlc_rtp_pt_release(struct vlc_rtp_pt *pt)
+{
+    free(pt);
+}
+
+static void *sink_init(struct vlc_rtp_pt *pt)
+{
+    return pt->opaque;
+}
+
+static void sink_decode(struct vlc_rtp_pt *pt, void *data, block_t *block,
+                        const struct vlc_rtp_pktinfo *restrict info)
+{
+    struct sink *sink = data;
+    uint16_t seq = GetWBE(block->p_buffer);
+
+    (void) pt; (void) info;
+    /* Packets come out in sequence order */
+    assert(sink->decoded == 0 || (int16_t)(seq - sink->last_seq) > 0);
+    sink->last_seq = seq;
+    sink->decoded++;
+    block_Release(block);
+}
+
+static const struct vlc_rtp_pt_operations sink_ops = {
+    NULL, sink_init, NULL, sink_decode,
+};
+
+/* Network conditions of a trace segment */
+struct conditions
+{
+    unsigned packets;
+    vlc_tick_t jitter; /**< Max extra transit time (uniform) */
+    unsigned loss; /**< Loss probability (per mille) */
+};
+
+struct packet
+{
+    vlc_tick_t arrival;
+    uint32_t timestamp;
+    uint16_t seq;
+};
+
+struct trace
+{
+    rtp_session_t *session;
+    struct sink sink;
+    uint64_t rand;
+    uint16_t seq;
+    vlc_tick_t sent;
+    vlc_tick_t deadline;
+};
+
+static unsigned trace_rand(struct trace *t, unsigned max)
+{
+    /* xorshift64: reproducible on all platforms */
+    t->rand ^= t->rand << 13;
+    t->rand ^= t->rand >> 7;
+    t->rand ^= t->rand << 17;
+    return t->rand % max;
+}
+
+static int packet_cmp(const void *a, const void *b)
+{
+    const struct packet *pa = a, *pb = b;
+
+    if (pa->arrival != pb->arrival)
+        return (pa->arrival < pb->arrival) ? -1 : 1;
+    return (int16_t)(pa->seq - pb->seq);
+}
+
+static void trace_dequeue(struct trace *t, vlc_tick_t now)
+{
+    if (!rtp_dequeue(NULL, t->session, now, &t->deadline))
+        t->deadline = VLC_TICK_MAX;
+}
+
+/* Sends packets under the given conditions, returns the delivered count */
+static unsigned trace_play(struct trace *t, const struct conditions *c)
+{
+    struct packet *pkts = malloc(c->packets * sizeof (*pkts));
+    unsigned count = 0;
+    unsigned decoded = t->sink.decoded;
+
+    assert(pkts != NULL);
+
+    for (unsigned i = 0; i < c->packets; i++) {
+        t->sent += PERIOD;
+        t->seq++;
+
+        if (trace_rand(t, 1000) < c->loss)
+            continue;
+
+        pkts[count].seq = t->seq;
+        pkts[count].timestamp = samples_from_vlc_tick(t->sent, FREQ);
+        pkts[count].arrival = t->sent + TRANSIT;
+        if (c->jitter > 0)
+            pkts[count].arrival += trace_rand(t, c->jitter);
+        count++;
+    }
+
+    /* Jitter larger than the packetization time reorders packets */
+    qsort(pkts, count, sizeof (*pkts), packet_cmp);
+
+    for (unsigned i = 0; i < count; i++) {
+        const struct packet *p = &pkts[i];
+
+        while (t->deadline <= p->arrival)
+            trace_dequeue(t, t->deadline);
+
+        block_t *block = block_Alloc(12 + 100);
+        assert(block != NULL);
+        block->p_buffer[0] = 0x80;
+        block->p_buffer[1] = PT;
+        SetWBE(block->p_buffer + 2, p->seq);
+        SetDWBE(block->p_buffer + 4, p->timestamp);
+        SetDWBE(block->p_buffer + 8, 0x12345678);
+        SetWBE(block->p_buffer + 12, p->seq);
+
+        rtp_queue(NULL, t->session, block, p->arrival);
+        trace_dequeue(t, p->arrival);
+    }
+
+    while (t->deadline != VLC_TICK_MAX)
+        trace_dequeue(t, t->deadline);
+
+    free(pkts);
+    return t->sink.decoded - decoded;
+}
+
+static void trace_init(struct trace *t, vlc_tick_t max_delay)
+{
+    struct vlc_rtp_pt *pt = malloc(sizeof (*pt));
+    assert(pt != NULL);
+
+    pt->ops = &sink_ops;
+    pt->opaque = &t->sink;
+    pt->frequency = FREQ;
+    pt->number = PT;
+    pt->channel_count = 0;
+
+    t->session = rtp_session_create_custom(RTP_MAX_DROPOUT_DEFAULT,
+                                           RTP_MAX_MISORDER_DEFAULT,
+                                           RTP_MAX_SRC_DEFAULT,
+                                           VLC_TICK_FROM_SEC(5),
+                                           MIN_DELAY, max_delay);
+    assert(t->session != NULL);
+    assert(rtp_add_type(t->session, pt) == 0);
+
+    t->sink.decoded = 0;
+    t->rand = 0x2545F4914F6CDD1D;
+    t->seq = 0xfff0; /* test wrapping */
+    t->sent = VLC_TICK_FROM_SEC(1);
+    t->deadline = VLC_TICK_MAX;
+}
+
+static void trace_stats(struct trace *t, struct rtp_session_stats *stats,
+                        const char *name)
+{
+    rtp_session_get_stats(t->session, stats);
+    printf("%-10s delay: %3"PRId64" ms, jitter: %2"PRId64" ms, depth: %2"
+           PRIu16", late: %4"PRIu64"/%"PRIu64"\n", name,
+           MS_FROM_VLC_TICK(stats->delay), MS_FROM_VLC_TICK(stats->jitter),
+           stats->depth, stats->late, stats->received);
+}
+
+int main(void)
+{
+    static const struct conditions lan = { 6000, VLC_TICK_FROM_MS(1), 0 };
+    static const struct conditions lossy = { 6000, VLC_TICK_FROM_MS(1), 50 };
+    static const struct conditions wan = { 6000, VLC_TICK_FROM_MS(80), 10 };
+    static const struct conditions worse = { 6000, VLC_TICK_FROM_MS(800), 0 };
+    struct rtp_session_stats stats;
+    struct trace t;
+    unsigned n;
+
+    /* Clean network: no extra delay, nothing late */
+    trace_init(&t, MAX_DELAY);
+    n = trace_play(&t, &lan);
+    trace_stats(&t, &stats, "LAN");
+    assert(n == lan.packets);
+    assert(stats.delay == MIN_DELAY);
+    assert(stats.late == 0);
+
+    /* Losses alone do not increase the delay */
+    n = trace_play(&t, &lossy);
+    trace_stats(&t, &stats, "lossy LAN");
+    assert(stats.received == lan.packets + n);
+    assert(stats.delay == MIN_DELAY);
+    assert(stats.late == 0);
+
+    /* Jitter and reordering increase the delay, few packets are late */
+    uint64_t received = stats.received;
+    n = trace_play(&t, &wan);
+    trace_stats(&t, &stats, "WAN");
+    assert(stats.received - received == n + stats.late);
+    assert(stats.delay > VLC_TICK_FROM_MS(80) && stats.delay <= MAX_DELAY);
+    assert(stats.depth >= 2);
+    assert(stats.late * 100 < stats.received); /* less than 1% */
+
+    /* Back to a clean network: the delay decreases again */
+    n = trace_play(&t, &lan);
+    trace_stats(&t, &stats, "LAN again");
+    assert(n == lan.packets);
+    assert(stats.delay < MIN_DELAY + VLC_TICK_FROM_MS(5));
+    rtp_session_destroy(NULL, t.session);
+
+    /* The delay is bounded, packets beyond are late */
+    trace_init(&t, MAX_DELAY);
+    n = trace_play(&t, &worse);
+    trace_stats(&t, &stats, "bounded");
+    assert(stats.delay == MAX_DELAY);
+    assert(stats.late * 100 > stats.received); /* more than 1% */
+    /* Packets older than the first one received are not counted as late */
+    assert(n + stats.late <= worse.packets);
+    assert(n + stats.late + stats.depth >= worse.packets);
+    rtp_session_destroy(NULL, t.session);
+
+    return 0;
+}
@@ -0,0 +1,199 @@
+/**
+ * @file pool.c
+ */
+/*****************************************************************************
+ * Copyright © 2026 VLC authors and VideoLAN
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA.
+ ****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#undef NDEBUG
+#include <assert.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#ifdef HAVE_POLL_H
+# include <poll.h>
+#endif
+#include <vlc_common.h>
+#include <vlc_block.h>
+#include <vlc_network.h>
+#include "../vlc_dtls.h"
+#include "../pool.h"
+
+const char vlc_module_name[] = "rtp_pool_test";
+
+#define MRU 1472
+#define COUNT 64
+#define PACKETS 100000
+#define PACKET_SIZE 1328 /* 7 TS packets and the RTP header */
+
+static void test_pool(void)
+{
+    struct rtp_pool *pool = rtp_pool_Create(COUNT, MRU);
+    block_t *blocks[COUNT];
+
+    assert(pool != NULL);
+    assert(rtp_pool_Available(pool) == COUNT);
+
+    for (size_t i = 0; i < COUNT; i++) {
+        blocks[i] = rtp_pool_Get(pool);
+        assert(blocks[i] != NULL);
+        assert(blocks[i]->i_buffer == MRU);
+        memset(blocks[i]->p_buffer, i, MRU);
+    }
+    assert(rtp_pool_Available(pool) == 0);
+    assert(rtp_pool_Size(pool) == COUNT);
+
+    /* Buffers do not overlap */
+    for (size_t i = 0; i < COUNT; i++)
+        for (size_t j = 0; j < MRU; j++)
+            assert(blocks[i]->p_buffer[j] == (uint8_t)i);
+
+    /* An exhausted pool grows */
+    block_t *extra = rtp_pool_Get(pool);
+    assert(extra != NULL && extra->i_buffer == MRU);
+    assert(rtp_pool_Size(pool) == 2 * COUNT);
+    assert(rtp_pool_Available(pool) == COUNT - 1);
+    block_Release(extra);
+
+    /* Recycling */
+    block_Release(blocks[0]);
+    assert(rtp_pool_Available(pool) == COUNT + 1);
+    blocks[0] = rtp_pool_Get(pool);
+    assert(blocks[0] != NULL && blocks[0]->i_buffer == MRU);
+
+    /* Growing a pool block moves it out of the pool */
+    block_t *big = block_Realloc(blocks[1], 0, 4 * MRU);
+    assert(big != NULL);
+    assert(rtp_pool_Available(pool) == COUNT + 1);
+    block_Release(big);
+
+    /* The pool outlives its owner while its blocks are in use */
+    rtp_pool_Release(pool);
+    for (size_t i = 2; i < COUNT; i++)
+        block_Release(blocks[i]);
+    block_Release(blocks[0]);
+}
+
+/* Sends RTP packets over loopback and receives them in batches */
+static void test_loopback(void)
+{
+    struct sockaddr_in addr = {
+        .sin_family = AF_INET,
+        .sin_addr.s_addr = htonl(INADDR_LOOPBACK),
+    };
+    socklen_t addrlen = sizeof (addr);
+
+    int rfd = vlc_socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP, false);
+    assert(rfd >= 0);
+    if (bind(rfd, (struct sockaddr *)&addr, addrlen)) {
+        fprintf(stderr, "loopback not available, skipped\n");
+        net_Close(rfd);
+        return;
+    }
+
+    int val = getsockname(rfd, (struct sockaddr *)&addr, &addrlen);
+    assert(val == 0);
+
+    int sfd = vlc_socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP, false);
+    assert(sfd >= 0);
+    val = connect(sfd, (struct sockaddr *)&addr, addrlen);
+    assert(val == 0);
+
+    struct vlc_dtls *sock = vlc_datagram_CreateFD(rfd);
+    struct rtp_pool *pool = rtp_pool_Create(COUNT, MRU);
+    assert(sock != NULL && pool != NULL);
+
+    uint8_t packet[PACKET_SIZE];
+    memset(packet, 0x47, sizeof (packet));
+    packet[0] = 0x80;
+    packet[1] = 33;
+
+    unsigned sent = 0, received = 0, calls = 0;
+    uint16_t expected = 0;
+    vlc_tick_t start = vlc_tick_now();
+
+    while (sent < PACKETS) {
+        /* Do not overflow the socket buffer */
+        for (unsigned i = 0; i < COUNT && sent < PACKETS; i++, sent++) {
+            SetWBE(&packet[2], sent);
+            val = send(sfd, packet, sizeof (packet), 0);
+            assert(val == (int)sizeof (packet));
+        }
+
+        /* Loopback does not lose packets, but may be slow to deliver */
+        vlc_tick_t deadline = vlc_tick_now() + VLC_TICK_FROM_SEC(30);
+
+        while (received < sent) {
+            struct pollfd ufd = { .fd = rfd, .events = POLLIN };
+            val = poll(&ufd, 1, 100);
+            if (val <= 0) {
+                assert(val == 0 || errno == EINTR);
+                assert(vlc_tick_now() < deadline);
+                continue;
+            }
+
+            block_t *blocks[COUNT];
+            struct vlc_dtls_buf bufs[COUNT];
+            unsigned count = 0;
+
+            while (count < COUNT
+                && (blocks[count] = rtp_pool_Get(pool)) != NULL) {
+                bufs[count].base = blocks[count]->p_buffer;
+                bufs[count].len = blocks[count]->i_buffer;
+                count++;
+            }
+            assert(count == COUNT);
+
+            int n = vlc_dtls_RecvMulti(sock, bufs, count);
+            assert(n > 0);
+            calls++;
+
+            for (int i = 0; i < n; i++) {
+                assert(!bufs[i].truncated);
+                assert(bufs[i].len == PACKET_SIZE);
+                /* loopback preserves the order */
+                assert(GetWBE(blocks[i]->p_buffer + 2) == expected);
+                expected++;
+            }
+            received += n;
+
+            for (unsigned i = 0; i < count; i++)
+                block_Release(blocks[i]);
+            assert(rtp_pool_Available(pool) == COUNT);
+        }
+    }
+
+    vlc_tick_t elapsed = vlc_tick_now() - start;
+    printf("%u packets received in %u calls, %.0f packets/s\n", received,
+           calls, received * (double)CLOCK_FREQ / (elapsed ? elapsed : 1));
+
+    rtp_pool_Release(pool);
+    vlc_dtls_Close(sock);
+    net_Close(sfd);
+}
+
+int main(void)
+{
+    test_pool();
+    test_loopback();
+    return 0;
+}
@@ -23,6 +23,15 @@
 
 struct iovec;
 
+/**
+ * Datagram reception buffer, see vlc_dtls_RecvMulti()
+ */
+struct vlc_dtls_buf {
+    void *base;
+    size_t len; /**< buffer size on input, datagram length on output */
+    bool truncated;
+};
+
 /**
  * Datagram socket
  */
@@ -37,6 +46,8 @@ struct vlc_dtls_operations {
     ssize_t (*readv)(struct vlc_dtls *, struct iovec *iov, unsigned len,
                      bool *restrict truncated);
     ssize_t (*writev)(struct vlc_dtls *, const struct iovec *iov, unsigned len);
+    /* optional, receives a batch of datagrams */
+    int (*readm)(struct vlc_dtls *, struct vlc_dtls_buf *bufs, unsigned count);
 };
 
 static inline void vlc_dtls_Close(struct vlc_dtls *dgs)
@@ -57,6 +68,29 @@ static inline ssize_t vlc_dtls_Recv(struct vlc_dtls *dgs, void *buf, size_t len,
     return dgs->ops->readv(dgs, &iov, 1, truncated);
 }
 
+/**
+ * Receives up to count datagrams.
+ *
+ * This blocks until at least one datagram is received, but does not wait
+ * for the following ones.
+ *
+ * @return the number of datagrams received or -1 on error
+ */
+static inline int vlc_dtls_RecvMulti(struct vlc_dtls *dgs,
+                                     struct vlc_dtls_buf *bufs, unsigned count)
+{
+    if (dgs->ops->readm != NULL)
+        return dgs->ops->readm(dgs, bufs, count);
+
+    (void) count;
+    ssize_t ret = vlc_dtls_Recv(dgs, bufs[0].base, bufs[0].len,
+                                &bufs[0].truncated);
+    if (ret < 0)
+        return -1;
+    bufs[0].len = ret;
+    return 1;
+}
+
 static inline ssize_t vlc_dtls_Send(struct vlc_dtls *dgs, const void *buf,
                                    size_t len)
 {
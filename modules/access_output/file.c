@@ -211,6 +211,11 @@ static int Control( sout_access_out_t *p_access, int i_query, va_list args )
             break;
         }
 
+        case ACCESS_OUT_GET_WRITE_SIZE:
+            /* Files are not paced: write large blocks */
+            *va_arg( args, size_t * ) = 65536;
+            break;
+
         default:
             return VLC_EGENERIC;
     }
@@ -368,7 +368,7 @@ out:
 
 static int Control( sout_access_out_t *p_access, int i_query, va_list args )
 {
-    VLC_UNUSED( p_access );
+    sout_access_out_sys_t *p_sys = p_access->p_sys;
 
     int i_ret = VLC_SUCCESS;
 
@@ -378,6 +378,10 @@ static int Control( sout_access_out_t *p_access, int i_query, va_list args )
             *va_arg( args, bool * ) = false;
             break;
 
+        case ACCESS_OUT_GET_WRITE_SIZE:
+            *va_arg( args, size_t * ) = p_sys->i_payload_size;
+            break;
+
         default:
             i_ret = VLC_EGENERIC;
             break;
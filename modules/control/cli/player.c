@@ -934,6 +934,21 @@ static int Statistics(struct cli_client *cl, const char *const *args,
                    item->p_stats->i_lost_abuffers);
         cli_printf(cl, "|");
 
+        /* Live */
+        if (item->p_stats->i_live_latency_target != 0)
+        {
+            cli_printf(cl, "%s", _("+-[Live Latency]"));
+            cli_printf(cl, _("| latency          :    %5"PRId64" ms"),
+                       MS_FROM_VLC_TICK(item->p_stats->i_live_latency));
+            cli_printf(cl, _("| latency target   :    %5"PRId64" ms"),
+                       MS_FROM_VLC_TICK(item->p_stats->i_live_latency_target));
+            cli_printf(cl, _("| playback rate    :    %5.2f"),
+                       item->p_stats->f_live_rate);
+            cli_printf(cl, _("| rate changes     :    %5"PRIu64),
+                       item->p_stats->i_live_rate_changes);
+            cli_printf(cl, "|");
+        }
+
         vlc_mutex_unlock(&item->lock);
         cli_printf(cl,  "+----[ end of statistical info ]" );
     }
@@ -619,6 +619,17 @@ int PlaylistManager::doControl(int i_query, va_list args)
             break;
         }
 
+        case DEMUX_GET_LIVE_DELAY:
+        {
+            vlc_mutex_locker locker(&cached.lock);
+            if(!cached.b_live || cached.i_time == VLC_TICK_INVALID ||
+               cached.playlistStart == cached.playlistEnd)
+                return VLC_EGENERIC;
+            vlc_tick_t delay = VLC_TICK_0 + cached.playlistEnd - cached.i_time;
+            *(va_arg (args, vlc_tick_t *)) = std::max(delay, vlc_tick_t(0));
+            break;
+        }
+
         case DEMUX_GET_POSITION:
         {
             vlc_mutex_locker locker(&cached.lock);
@@ -705,9 +716,6 @@ void PlaylistManager::setBufferingRunState(bool b)
 void PlaylistManager::Run()
 {
     mutex_locker locker {lock};
-    const vlc_tick_t i_min_buffering = bufferingLogic->getMinBuffering(playlist);
-    const vlc_tick_t i_max_buffering = bufferingLogic->getMaxBuffering(playlist);
-    const vlc_tick_t i_target_buffering = bufferingLogic->getStableBuffering(playlist);
     while(1)
     {
         while(!b_buffering && !b_canceled)
@@ -727,6 +735,11 @@ void PlaylistManager::Run()
         Times pcr = demux.times;
         vlc_mutex_unlock(&demux.lock);
 
+        /* can change once playlists are loaded (HLS low latency) */
+        const vlc_tick_t i_min_buffering = bufferingLogic->getMinBuffering(playlist);
+        const vlc_tick_t i_max_buffering = bufferingLogic->getMaxBuffering(playlist);
+        const vlc_tick_t i_target_buffering = bufferingLogic->getStableBuffering(playlist);
+
         AbstractStream::BufferingStatus i_return = bufferize(pcr, i_min_buffering,
                                                              i_max_buffering, i_target_buffering);
 
@@ -343,6 +343,7 @@ HTTPChunkBufferedSource::HTTPChunkBufferedSource(const std::string& url, Abstrac
     held = false;
     p_read = nullptr;
     inblockreadoffset = 0;
+    lastreadtime = VLC_TICK_INVALID;
 }
 
 HTTPChunkBufferedSource::~HTTPChunkBufferedSource()
@@ -384,8 +385,33 @@ void HTTPChunkBufferedSource::release()
     avail.signal();
 }
 
+/* A chunked transfer of a segment still being produced is paced by the
+ * live edge: only keep the reads faster than the whole transfer, as the
+ * other ones were waiting for data */
+static void getChunkedTransferRate(const std::vector<std::pair<size_t, vlc_tick_t>> &reads,
+                                   size_t *size, vlc_tick_t *time)
+{
+    size_t burstsize = 0;
+    vlc_tick_t bursttime = 0;
+    for(const auto &read : reads)
+    {
+        if(read.second == 0 ||
+           (double) read.first * *time > (double) *size * read.second)
+        {
+            burstsize += read.first;
+            bursttime += read.second;
+        }
+    }
+    if(burstsize && bursttime)
+    {
+        *size = burstsize;
+        *time = bursttime;
+    }
+}
+
 void HTTPChunkBufferedSource::bufferize(size_t readsize)
 {
+    bool b_chunked;
     {
         mutex_locker locker {lock};
         if(!prepare())
@@ -401,6 +427,10 @@ void HTTPChunkBufferedSource::bufferize(size_t readsize)
 
         if(contentLength && readsize > contentLength - buffered)
             readsize = contentLength - buffered;
+
+        /* Unknown length, likely a low latency segment still being
+         * produced: forward data as soon as it arrives */
+        b_chunked = !contentLength && type == ChunkType::Segment;
     }
 
     block_t *p_block = block_Alloc(readsize);
@@ -417,7 +447,8 @@ void HTTPChunkBufferedSource::bufferize(size_t readsize)
         vlc_tick_t latency;
     } rate = {0,0,0};
 
-    ssize_t ret = connection->read(p_block->p_buffer, readsize);
+    ssize_t ret = b_chunked ? connection->readPartial(p_block->p_buffer, readsize)
+                            : connection->read(p_block->p_buffer, readsize);
     if(ret <= 0)
     {
         block_Release(p_block);
@@ -428,6 +459,8 @@ void HTTPChunkBufferedSource::bufferize(size_t readsize)
         rate.size = buffered;
         rate.time = downloadEndTime - requestStartTime;
         rate.latency = responseTime - requestStartTime;
+        if(b_chunked)
+            getChunkedTransferRate(chunkedreads, &rate.size, &rate.time);
         avail.signal();
     }
     else
@@ -441,7 +474,15 @@ void HTTPChunkBufferedSource::bufferize(size_t readsize)
             p_read = p_block;
             inblockreadoffset = 0;
         }
-        if((size_t) ret < readsize)
+        if(b_chunked)
+        {
+            vlc_tick_t now = vlc_tick_now();
+            if(lastreadtime == VLC_TICK_INVALID)
+                lastreadtime = responseTime;
+            chunkedreads.push_back(std::make_pair((size_t) ret, now - lastreadtime));
+            lastreadtime = now;
+        }
+        else if((size_t) ret < readsize)
         {
             done = true;
             downloadEndTime = vlc_tick_now();
@@ -27,6 +27,7 @@
 
 #include <cstdint>
 #include <string>
+#include <vector>
 
 #include "BytesRange.hpp"
 #include "ConnectionParams.hpp"
@@ -186,6 +187,9 @@ namespace adaptive
                 bool                eof;
                 vlc::threads::condition_variable avail;
                 bool                held;
+                /* reads of a chunked transfer (size, duration) */
+                std::vector<std::pair<size_t, vlc_tick_t>> chunkedreads;
+                vlc_tick_t          lastreadtime;
         };
 
         class HTTPChunk : public AbstractChunk
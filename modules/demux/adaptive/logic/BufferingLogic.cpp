@@ -128,7 +128,12 @@ vlc_tick_t DefaultBufferingLogic::getMaxBuffering(const BasePlaylist *p) const
 vlc_tick_t DefaultBufferingLogic::getLiveDelay(const BasePlaylist *p) const
 {
     if(isLowLatency(p))
+    {
+        /* Honor the latency target, if any */
+        if(!userLiveDelay && p->suggestedPresentationDelay.Get())
+            return std::max(p->suggestedPresentationDelay.Get(), getMinBuffering(p));
         return getMinBuffering(p);
+    }
     vlc_tick_t delay = userLiveDelay ? userLiveDelay
                                      : DEFAULT_LIVE_BUFFERING;
     if(p->suggestedPresentationDelay.Get())
@@ -241,6 +246,8 @@ uint64_t DefaultBufferingLogic::getLiveStartSegmentNumber(BaseRepresentation *re
         {
             /* Compute playback offset and effective finished segment from wall time */
             vlc_tick_t now = vlc_tick_from_sec(time(nullptr));
+            /* Segments can be requested before completion (low latency chunked transfer) */
+            now += mediaSegmentTemplate->inheritAvailabilityTimeOffset();
             vlc_tick_t playbacktime = now - i_buffering;
             vlc_tick_t minavailtime = playlist->availabilityStartTime.Get() + rep->getPeriodStart();
             const uint64_t startnumber = mediaSegmentTemplate->inheritStartNumber();
@@ -342,14 +349,23 @@ uint64_t DefaultBufferingLogic::getLiveStartSegmentNumber(BaseRepresentation *re
         stime_t tobuffer = std::min(maxbufferizable, timescale.ToScaled(i_buffering));
         stime_t skipduration = totallistduration - safeedgeduration - tobuffer ;
         uint64_t start = safestartnumber;
+        auto startit = list.begin();
         for(auto it = list.begin(); it != list.end(); ++it)
         {
             start = (*it)->getSequenceNumber();
+            startit = it;
             if((*it)->duration.Get() > skipduration)
                 break;
             skipduration -= (*it)->duration.Get();
         }
 
+        /* Low latency parts can only be started from an independent one */
+        while(startit != list.begin() && !(*startit)->isIndependent())
+        {
+            --startit;
+            start = (*startit)->getSequenceNumber();
+        }
+
         return start;
     }
     else if(segmentBase)
@@ -124,6 +124,11 @@ bool ISegment::isTemplate() const
     return templated;
 }
 
+bool ISegment::isIndependent() const
+{
+    return true;
+}
+
 void ISegment::setByteRange(size_t start, size_t end)
 {
     startByte = start;
@@ -66,6 +66,10 @@ namespace adaptive
                 virtual void                            setDiscontinuitySequenceNumber(uint64_t);
                 virtual uint64_t                        getDiscontinuitySequenceNumber() const;
                 virtual bool                            isTemplate      () const;
+                /**
+                 *  @return true if decoding can start with this segment
+                 */
+                virtual bool                            isIndependent   () const;
                 virtual size_t                          getOffset       () const;
                 virtual void                            debug           (vlc_object_t *,int = 0) const;
                 virtual bool                            contains        (size_t byte) const;
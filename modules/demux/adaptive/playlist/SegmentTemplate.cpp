@@ -125,6 +125,11 @@ void SegmentTemplate::debug(vlc_object_t *obj, int indent) const
 }
 
 vlc_tick_t SegmentTemplate::getMinAheadTime(uint64_t number) const
+{
+    return getMinAheadTime(number, vlc_tick_from_sec(time(nullptr)));
+}
+
+vlc_tick_t SegmentTemplate::getMinAheadTime(uint64_t number, vlc_tick_t now) const
 {
     SegmentTimeline *timeline = inheritSegmentTimeline();
     if( timeline )
@@ -135,7 +140,8 @@ vlc_tick_t SegmentTemplate::getMinAheadTime(uint64_t number) const
     else
     {
         const Timescale timescale = inheritTimescale();
-        uint64_t current = getLiveTemplateNumber(vlc_tick_from_sec(time(nullptr)));
+        /* Segments can be requested before completion (low latency chunked transfer) */
+        uint64_t current = getLiveTemplateNumber(now + inheritAvailabilityTimeOffset());
         stime_t i_length = (current - number) * inheritDuration();
         return timescale.ToTime(i_length);
     }
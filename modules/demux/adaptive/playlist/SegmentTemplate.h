@@ -59,6 +59,8 @@ namespace adaptive
                 size_t pruneBySequenceNumber(uint64_t);
 
                 vlc_tick_t getMinAheadTime(uint64_t curnum) const override;
+                /* same, at the given wall clock time */
+                vlc_tick_t getMinAheadTime(uint64_t curnum, vlc_tick_t now) const;
                 Segment * getMediaSegment(uint64_t number) const override;
                 Segment * getNextMediaSegment(uint64_t, uint64_t *, bool *) const override;
                 uint64_t getStartSegmentNumber() const override;
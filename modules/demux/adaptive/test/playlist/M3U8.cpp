@@ -543,5 +543,169 @@ int M3U8Playlist_test()
         return 1;
     }
 
+    /* Manifest 6: low latency */
+    const char manifest6[] =
+    "#EXTM3U\n"
+    "#EXT-X-TARGETDURATION:4\n"
+    "#EXT-X-SERVER-CONTROL:CAN-BLOCK-RELOAD=YES,PART-HOLD-BACK=3.0,CAN-SKIP-UNTIL=24.0\n"
+    "#EXT-X-PART-INF:PART-TARGET=1.0\n"
+    "#EXT-X-MEDIA-SEQUENCE:10\n"
+    "#EXTINF:4.0,\n"
+    "seg10.mp4\n"
+    "#EXT-X-PART:DURATION=1.0,URI=\"part11.0.mp4\",INDEPENDENT=YES\n"
+    "#EXT-X-PART:DURATION=1.0,URI=\"part11.1.mp4\"\n"
+    "#EXT-X-PART:DURATION=1.0,URI=\"part11.2.mp4\"\n"
+    "#EXT-X-PART:DURATION=1.0,URI=\"part11.3.mp4\"\n"
+    "#EXTINF:4.0,\n"
+    "seg11.mp4\n"
+    "#EXT-X-PART:DURATION=1.0,URI=\"part12.0.mp4\",INDEPENDENT=YES\n"
+    "#EXT-X-PRELOAD-HINT:TYPE=PART,URI=\"part12.1.mp4\"\n";
+
+    /* Delta update */
+    const char manifest6update[] =
+    "#EXTM3U\n"
+    "#EXT-X-TARGETDURATION:4\n"
+    "#EXT-X-SERVER-CONTROL:CAN-BLOCK-RELOAD=YES,PART-HOLD-BACK=3.0,CAN-SKIP-UNTIL=24.0\n"
+    "#EXT-X-PART-INF:PART-TARGET=1.0\n"
+    "#EXT-X-MEDIA-SEQUENCE:10\n"
+    "#EXT-X-SKIP:SKIPPED-SEGMENTS=1\n"
+    "#EXT-X-PART:DURATION=1.0,URI=\"part11.0.mp4\",INDEPENDENT=YES\n"
+    "#EXT-X-PART:DURATION=1.0,URI=\"part11.1.mp4\"\n"
+    "#EXT-X-PART:DURATION=1.0,URI=\"part11.2.mp4\"\n"
+    "#EXT-X-PART:DURATION=1.0,URI=\"part11.3.mp4\"\n"
+    "#EXTINF:4.0,\n"
+    "seg11.mp4\n"
+    "#EXT-X-PART:DURATION=1.0,URI=\"part12.0.mp4\",INDEPENDENT=YES\n"
+    "#EXT-X-PART:DURATION=1.0,URI=\"part12.1.mp4\"\n"
+    "#EXT-X-PART:DURATION=1.0,URI=\"part12.2.mp4\",BYTERANGE=\"1000@0\"\n"
+    "#EXT-X-PRELOAD-HINT:TYPE=PART,URI=\"part12.3.mp4\"\n";
+
+    m3u = ParseM3U8(obj, manifest6, sizeof(manifest6));
+    try
+    {
+        bufferingLogic = DefaultBufferingLogic();
+        Expect(m3u);
+        Expect(m3u->isLive() == true);
+        Expect(m3u->isLowLatency() == true);
+        Expect(m3u->suggestedPresentationDelay.Get() == vlc_tick_from_sec(3));
+        HLSRepresentation *rep = static_cast<HLSRepresentation *>(m3u->getFirstPeriod()->
+                                 getAdaptationSets().front()->getRepresentations().front());
+        Expect(rep->isLowLatency());
+
+        /* parts replace their segment and are numbered in sequence */
+        HLSSegment *seg = static_cast<HLSSegment *>(rep->getMediaSegment(10));
+        Expect(seg);
+        Expect(seg->getMediaSequenceNumber() == 10);
+        Expect(seg->getPartIndex() == -1);
+        seg = static_cast<HLSSegment *>(rep->getMediaSegment(11));
+        Expect(seg);
+        Expect(seg->getMediaSequenceNumber() == 11);
+        Expect(seg->getPartIndex() == 0);
+        Expect(seg->isIndependent());
+        seg = static_cast<HLSSegment *>(rep->getMediaSegment(14));
+        Expect(seg);
+        Expect(seg->getMediaSequenceNumber() == 11);
+        Expect(seg->getPartIndex() == 3);
+        Expect(!seg->isIndependent());
+        seg = static_cast<HLSSegment *>(rep->getMediaSegment(15));
+        Expect(seg);
+        Expect(seg->getMediaSequenceNumber() == 12);
+        Expect(seg->getPartIndex() == 0);
+        /* preload hint */
+        seg = static_cast<HLSSegment *>(rep->getMediaSegment(16));
+        Expect(seg);
+        Expect(seg->getMediaSequenceNumber() == 12);
+        Expect(seg->getPartIndex() == 1);
+        Expect(seg->duration.Get() == rep->inheritTimescale().ToScaled(vlc_tick_from_sec(1)));
+        Expect(rep->getMediaSegment(17) == nullptr);
+
+        /* blocking reload of the hinted part */
+        const std::string url = rep->getPlaylistUpdateUrl().toString();
+        Expect(url.find("?_HLS_msn=12&_HLS_part=1") != std::string::npos);
+        Expect(url.find("_HLS_skip") == std::string::npos);
+        Expect(rep->needsUpdate(16));
+        Expect(!rep->needsUpdate(11));
+
+        /* live start, low latency buffering from the edge */
+        Expect(bufferingLogic.getMinBuffering(m3u) == DefaultBufferingLogic::BUFFERING_LOWEST_LIMIT);
+        Expect(bufferingLogic.getLiveDelay(m3u) == vlc_tick_from_sec(3)); /* PART-HOLD-BACK */
+        /* the edge part (13) is not independent, start at its segment */
+        uint64_t startnumber = bufferingLogic.getStartSegmentNumber(rep);
+        Expect(startnumber == 11);
+        seg = static_cast<HLSSegment *>(rep->getMediaSegment(startnumber));
+        Expect(seg);
+        Expect(seg->isIndependent());
+
+        /* switching from a non independent part */
+        Expect(rep->translateSegmentNumber(14, rep) == 11);
+        Expect(rep->translateSegmentNumber(15, rep) == 15);
+
+        M3U8Parser parser(nullptr);
+        stream_t *substream = vlc_stream_MemoryNew(obj, (uint8_t *) manifest6update,
+                                                   sizeof(manifest6update), true);
+        Expect(substream);
+        parser.appendSegmentsFromPlaylist(obj, rep, substream);
+        vlc_stream_Delete(substream);
+
+        /* known parts kept their number, new ones follow */
+        seg = static_cast<HLSSegment *>(rep->getMediaSegment(16));
+        Expect(seg);
+        Expect(seg->getPartIndex() == 1);
+        seg = static_cast<HLSSegment *>(rep->getMediaSegment(17));
+        Expect(seg);
+        Expect(seg->getMediaSequenceNumber() == 12);
+        Expect(seg->getPartIndex() == 2);
+        seg = static_cast<HLSSegment *>(rep->getMediaSegment(18));
+        Expect(seg);
+        Expect(seg->getPartIndex() == 3);
+        Expect(rep->getMediaSegment(19) == nullptr);
+        Expect(rep->getPlaylistUpdateUrl().toString().find("?_HLS_msn=12&_HLS_part=3") != std::string::npos);
+
+        delete m3u;
+    }
+    catch (...)
+    {
+        delete m3u;
+        return 1;
+    }
+
+    /* Manifest 7: low latency, AES-128 segments are not split in parts */
+    const char manifest7[] =
+    "#EXTM3U\n"
+    "#EXT-X-TARGETDURATION:4\n"
+    "#EXT-X-SERVER-CONTROL:CAN-BLOCK-RELOAD=YES,PART-HOLD-BACK=3.0\n"
+    "#EXT-X-PART-INF:PART-TARGET=1.0\n"
+    "#EXT-X-MEDIA-SEQUENCE:10\n"
+    "#EXT-X-KEY:METHOD=AES-128,URI=\"key.bin\"\n"
+    "#EXT-X-PART:DURATION=2.0,URI=\"part10.0.ts\",INDEPENDENT=YES\n"
+    "#EXT-X-PART:DURATION=2.0,URI=\"part10.1.ts\"\n"
+    "#EXTINF:4.0,\n"
+    "seg10.ts\n"
+    "#EXT-X-PART:DURATION=2.0,URI=\"part11.0.ts\",INDEPENDENT=YES\n"
+    "#EXT-X-PRELOAD-HINT:TYPE=PART,URI=\"part11.1.ts\"\n";
+
+    m3u = ParseM3U8(obj, manifest7, sizeof(manifest7));
+    try
+    {
+        Expect(m3u);
+        HLSRepresentation *rep = static_cast<HLSRepresentation *>(m3u->getFirstPeriod()->
+                                 getAdaptationSets().front()->getRepresentations().front());
+        Expect(rep->isLowLatency());
+
+        HLSSegment *seg = static_cast<HLSSegment *>(rep->getMediaSegment(10));
+        Expect(seg);
+        Expect(seg->getMediaSequenceNumber() == 10);
+        Expect(seg->getPartIndex() == -1);
+        Expect(seg->duration.Get() == rep->inheritTimescale().ToScaled(vlc_tick_from_sec(4)));
+        Expect(rep->getMediaSegment(11) == nullptr);
+
+        delete m3u;
+    }
+    catch (...)
+    {
+        delete m3u;
+        return 1;
+    }
+
     return 0;
 }
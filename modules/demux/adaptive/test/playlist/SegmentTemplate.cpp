@@ -33,6 +33,7 @@
 #include "../test.hpp"
 
 #include <limits>
+#include <ctime>
 
 using namespace adaptive;
 using namespace adaptive::playlist;
@@ -96,6 +97,16 @@ int SegmentTemplate_test()
         Expect(templ->getLiveTemplateNumber(now + timescale.ToTime(100) * 2 + 1, true) ==
                templ->getStartSegmentNumber() + 1);
 
+        /* availability time offset, segments requested before completion */
+        /* both lookups at the same time, so that a second boundary
+         * between them cannot change the result */
+        const vlc_tick_t wallclock = vlc_tick_from_sec(::time(nullptr));
+        pl->availabilityStartTime.Set(wallclock - timescale.ToTime(100 * 10));
+        vlc_tick_t ahead = templ->getMinAheadTime(11, wallclock);
+        Expect(ahead > 0);
+        rep->addAttribute(new AvailabilityTimeOffsetAttr(timescale.ToTime(100)));
+        Expect(templ->getMinAheadTime(11, wallclock) == ahead + timescale.ToTime(100));
+
         /* reset */
         pl->availabilityStartTime.Set(0);
         pl->availabilityEndTime.Set(0);
@@ -62,6 +62,11 @@
     "Recreate a index for the AVI file. Use this if your AVI file is damaged "\
     "or incomplete (not seekable)." )
 
+#define INDEX_BACKGROUND_TEXT N_("Create the index in the background")
+#define INDEX_BACKGROUND_LONGTEXT N_( \
+    "When the index has to be recreated, start playing at once and make " \
+    "seeking available as the file is scanned." )
+
 static int  Open ( vlc_object_t * );
 static void Close( vlc_object_t * );
 
@@ -84,6 +89,8 @@ vlc_module_begin ()
     add_integer( "avi-index", 0,
               INDEX_TEXT, INDEX_LONGTEXT )
         change_integer_list( pi_index, ppsz_indexes )
+    add_bool( "avi-index-background", true,
+              INDEX_BACKGROUND_TEXT, INDEX_BACKGROUND_LONGTEXT )
 
     set_callbacks( Open, Close )
 vlc_module_end ()
@@ -141,6 +148,38 @@ static void avi_index_Init( avi_index_t * );
 static void avi_index_Clean( avi_index_t * );
 static int64_t avi_index_Append( avi_index_t *, uint64_t *, avi_entry_t * );
 
+/* Chunk found by the background indexer */
+typedef struct
+{
+    uint64_t     i_pos;
+    uint32_t     i_size;
+    uint16_t     i_stream;
+    uint16_t     i_flags;
+} avi_indexer_chunk_t;
+
+typedef struct
+{
+    demux_t      *p_demux;
+    stream_t     *s;        /* private stream, the demuxer one is not shared */
+    vlc_thread_t thread;
+    atomic_bool  b_stop;
+
+    uint64_t     i_movi_end;
+    uint64_t     *pi_riff;  /* positions of the AVIX RIFF chunks */
+    size_t       i_riff;
+
+    /* Read window */
+    uint8_t      *p_buf;
+    uint64_t     i_buf_pos;
+    size_t       i_buf_size;
+
+    vlc_mutex_t  lock;
+    avi_indexer_chunk_t *p_chunks; /* found, not yet merged in the index */
+    size_t       i_chunks;
+    size_t       i_chunks_max;
+    bool         b_done;
+} avi_indexer_t;
+
 typedef struct
 {
     bool            b_activated;
@@ -214,6 +253,8 @@ typedef struct
 
     unsigned int       i_attachment;
     input_attachment_t **attachment;
+
+    avi_indexer_t *p_indexer;
 } demux_sys_t;
 
 #define __EVEN(x) (((x) & 1) ? (x) + 1 : (x))
@@ -238,6 +279,10 @@ static int AVI_PacketSearch   ( demux_t * );
 static void AVI_IndexLoad    ( demux_t * );
 static void AVI_IndexCreate  ( demux_t * );
 
+static int  AVI_IndexerStart( demux_t * );
+static void AVI_IndexerMerge( demux_t * );
+static void AVI_IndexerStop ( demux_t * );
+
 static void AVI_ExtractSubtitle( demux_t *, unsigned int i_stream, avi_chunk_list_t *, avi_chunk_STRING_t * );
 static avi_track_t * AVI_GetVideoTrackForXsub( demux_sys_t * );
 static int AVI_SeekSubtitleTrack( demux_sys_t *, avi_track_t * );
@@ -331,6 +376,8 @@ static void Close ( vlc_object_t * p_this )
     demux_t *    p_demux = (demux_t *)p_this;
     demux_sys_t *p_sys = p_demux->p_sys  ;
 
+    AVI_IndexerStop( p_demux );
+
     for( unsigned int i = 0; i < p_sys->i_track; i++ )
     {
         if( p_sys->track[i] )
@@ -775,7 +822,8 @@ static int Open( vlc_object_t * p_this )
 aviindex:
         if( p_sys->b_fastseekable )
         {
-            AVI_IndexCreate( p_demux );
+            if( AVI_IndexerStart( p_demux ) )
+                AVI_IndexCreate( p_demux );
         }
         else if( p_sys->b_seekable )
         {
@@ -1082,6 +1130,8 @@ static int Demux_Seekable( demux_t *p_demux )
 
     unsigned int i_track_count = 0;
 
+    AVI_IndexerMerge( p_demux );
+
     /* detect new selected/unselected streams */
     for( unsigned int i = 0; i < p_sys->i_track; i++ )
     {
@@ -1586,6 +1636,8 @@ static int Seek( demux_t *p_demux, vlc_tick_t i_date, double f_ratio, bool b_acc
     {
         uint64_t i_pos_backup = vlc_stream_Tell( p_demux->s );
 
+        AVI_IndexerMerge( p_demux );
+
         /* Check and lazy load indexes if it was not done (not fastseekable) */
         if ( !p_sys->b_indexloaded && ( p_sys->i_avih_flags & AVIF_HASINDEX ) )
         {
@@ -2879,6 +2931,413 @@ print_stat:
     }
 }
 
+/****************************************************************************
+ * Background index creation: the movi list is scanned by large windows in
+ * a separate thread, and the chunks found are merged into the tracks index
+ * by the demuxer as it goes.
+ ****************************************************************************/
+#define AVI_INDEXER_WINDOW (1 << 20)
+#define AVI_INDEXER_BATCH  1024
+
+/* Returns the track of a data chunk, or NULL */
+static avi_track_t *AVI_IndexerTrack( demux_sys_t *p_sys, vlc_fourcc_t i_fourcc,
+                                      unsigned int *pi_stream )
+{
+    enum es_format_category_e i_cat;
+
+    AVI_ParseStreamHeader( i_fourcc, pi_stream, &i_cat );
+    if( *pi_stream >= p_sys->i_track ||
+        i_cat != p_sys->track[*pi_stream]->fmt.i_cat )
+        return NULL;
+    return p_sys->track[*pi_stream];
+}
+
+/* Returns i_size bytes at i_pos, reading a new window if needed */
+static const uint8_t *AVI_IndexerPeek( avi_indexer_t *p_idx, uint64_t i_pos,
+                                       size_t i_size )
+{
+    if( i_pos >= p_idx->i_buf_pos &&
+        i_pos + i_size <= p_idx->i_buf_pos + p_idx->i_buf_size )
+        return &p_idx->p_buf[i_pos - p_idx->i_buf_pos];
+
+    p_idx->i_buf_pos = i_pos;
+    p_idx->i_buf_size = 0;
+    if( vlc_stream_Seek( p_idx->s, i_pos ) )
+        return NULL;
+
+    ssize_t i_read = vlc_stream_Read( p_idx->s, p_idx->p_buf,
+                                      AVI_INDEXER_WINDOW );
+    if( i_read < (ssize_t)i_size )
+        return NULL;
+    p_idx->i_buf_size = i_read;
+    return p_idx->p_buf;
+}
+
+static inline bool AVI_IsDigit( uint8_t c )
+{
+    return (unsigned)(c - '0') < 10;
+}
+
+/* Returns the offset of the first two consecutive ASCII digits, which start
+ * all the data chunk tags, or i_size - 1 if there are none */
+static size_t AVI_IndexerFindTag( const uint8_t *p, size_t i_size )
+{
+    size_t i = 0;
+
+    /* Check 8 bytes at once: a byte is a digit if (c ^ '0') < 10. This may
+     * give false positives, never false negatives */
+    for( ; i + 8 <= i_size; i += 7 )
+    {
+        uint64_t w = GetQWLE( &p[i] ) ^ UINT64_C(0x3030303030303030);
+        uint64_t m = ( w - UINT64_C(0x0a0a0a0a0a0a0a0a) ) & ~w &
+                     UINT64_C(0x8080808080808080);
+
+        if( m & ( m >> 8 ) )
+            for( size_t j = i; j < i + 7; j++ )
+                if( AVI_IsDigit( p[j] ) && AVI_IsDigit( p[j + 1] ) )
+                    return j;
+    }
+    for( ; i + 1 < i_size; i++ )
+        if( AVI_IsDigit( p[i] ) && AVI_IsDigit( p[i + 1] ) )
+            return i;
+    return i_size > 0 ? i_size - 1 : 0;
+}
+
+/* Checks a resync candidate: it must be a data chunk of a known track, and
+ * be followed by a valid chunk if that one is in the window too */
+static bool AVI_IndexerCheck( avi_indexer_t *p_idx, uint64_t i_pos,
+                              const uint8_t *p, size_t i_avail )
+{
+    demux_sys_t *p_sys = p_idx->p_demux->p_sys;
+    unsigned int i_stream;
+
+    if( !AVI_IndexerTrack( p_sys, VLC_FOURCC( p[0], p[1], p[2], p[3] ),
+                           &i_stream ) )
+        return false;
+
+    uint32_t i_size = GetDWLE( &p[4] );
+    if( i_size > p_idx->i_movi_end - i_pos - 8 )
+        return false;
+
+    uint64_t i_next = 8 + __EVEN( (uint64_t)i_size );
+    if( i_next + 8 > i_avail )
+        return true;
+
+    p += i_next;
+    vlc_fourcc_t i_fourcc = VLC_FOURCC( p[0], p[1], p[2], p[3] );
+    switch( i_fourcc )
+    {
+        case AVIFOURCC_LIST:
+        case AVIFOURCC_RIFF:
+        case AVIFOURCC_JUNK:
+        case AVIFOURCC_idx1:
+            return true;
+    }
+    return AVI_IndexerTrack( p_sys, i_fourcc, &i_stream ) != NULL;
+}
+
+/* Finds the next valid chunk after a broken one at *pi_pos */
+static int AVI_IndexerResync( avi_indexer_t *p_idx, uint64_t *pi_pos )
+{
+    uint64_t i_pos = *pi_pos + 1;
+
+    while( i_pos + 16 <= p_idx->i_movi_end &&
+           !atomic_load( &p_idx->b_stop ) )
+    {
+        const uint8_t *p = AVI_IndexerPeek( p_idx, i_pos, 16 );
+        if( p == NULL )
+            return VLC_EGENERIC;
+
+        size_t i_avail = p_idx->i_buf_pos + p_idx->i_buf_size - i_pos;
+        if( i_avail > p_idx->i_movi_end - i_pos )
+            i_avail = p_idx->i_movi_end - i_pos;
+
+        /* Candidates need a full header and peek in the window */
+        size_t i_off = 0;
+        while( i_off + 16 <= i_avail )
+        {
+            i_off += AVI_IndexerFindTag( &p[i_off], i_avail - 14 - i_off );
+            if( i_off + 16 > i_avail )
+                break;
+            if( AVI_IndexerCheck( p_idx, i_pos + i_off, &p[i_off],
+                                  i_avail - i_off ) )
+            {
+                *pi_pos = i_pos + i_off;
+                return VLC_SUCCESS;
+            }
+            i_off++;
+        }
+        i_pos += i_off;
+    }
+    return VLC_EGENERIC;
+}
+
+static void AVI_IndexerPublish( avi_indexer_t *p_idx,
+                                const avi_indexer_chunk_t *p_chunks,
+                                size_t i_chunks )
+{
+    vlc_mutex_lock( &p_idx->lock );
+    if( p_idx->i_chunks + i_chunks > p_idx->i_chunks_max )
+    {
+        size_t i_max = __MAX( p_idx->i_chunks_max * 2,
+                              p_idx->i_chunks + i_chunks );
+        avi_indexer_chunk_t *p_new =
+            vlc_reallocarray( p_idx->p_chunks, i_max, sizeof(*p_new) );
+        if( unlikely(p_new == NULL) )
+        {
+            vlc_mutex_unlock( &p_idx->lock );
+            return;
+        }
+        p_idx->p_chunks = p_new;
+        p_idx->i_chunks_max = i_max;
+    }
+    memcpy( &p_idx->p_chunks[p_idx->i_chunks], p_chunks,
+            i_chunks * sizeof(*p_chunks) );
+    p_idx->i_chunks += i_chunks;
+    vlc_mutex_unlock( &p_idx->lock );
+}
+
+static void *AVI_IndexerThread( void *data )
+{
+    avi_indexer_t *p_idx = data;
+    demux_t       *p_demux = p_idx->p_demux;
+    demux_sys_t   *p_sys = p_demux->p_sys;
+
+    vlc_thread_set_name( "vlc-avi-index" );
+
+    avi_indexer_chunk_t batch[AVI_INDEXER_BATCH];
+    size_t   i_batch = 0;
+    uint64_t i_count = 0;
+    uint64_t i_pos = p_idx->i_buf_pos;
+    size_t   i_riff = 0;
+    vlc_tick_t i_start = vlc_tick_now();
+
+    p_idx->i_buf_size = 0;
+
+    while( !atomic_load( &p_idx->b_stop ) )
+    {
+        if( i_batch == AVI_INDEXER_BATCH )
+        {
+            AVI_IndexerPublish( p_idx, batch, i_batch );
+            i_batch = 0;
+        }
+
+        const uint8_t *p = AVI_IndexerPeek( p_idx, i_pos, 16 );
+        if( p == NULL )
+            break;
+
+        vlc_fourcc_t i_fourcc = VLC_FOURCC( p[0], p[1], p[2], p[3] );
+        uint32_t     i_size = GetDWLE( &p[4] );
+        vlc_fourcc_t i_type = VLC_FOURCC( p[8], p[9], p[10], p[11] );
+        unsigned int i_stream;
+        avi_track_t *tk = AVI_IndexerTrack( p_sys, i_fourcc, &i_stream );
+
+        if( tk != NULL )
+        {
+            batch[i_batch].i_pos = i_pos;
+            batch[i_batch].i_size = i_size;
+            batch[i_batch].i_stream = i_stream;
+            batch[i_batch].i_flags = AVI_GetKeyFlag( tk, &p[8] );
+            i_batch++;
+            i_count++;
+        }
+        else if( i_fourcc == AVIFOURCC_LIST &&
+                 ( i_type == AVIFOURCC_rec || i_type == AVIFOURCC_movi ) )
+        {
+            i_pos += 12;
+            continue;
+        }
+        else if( i_fourcc == AVIFOURCC_RIFF && i_type == AVIFOURCC_AVIX )
+        {
+            msg_Dbg( p_demux, "new RIFF chunk found" );
+            i_pos += 24;
+            continue;
+        }
+        else if( i_fourcc == AVIFOURCC_idx1 )
+        {
+            if( !p_sys->b_odml || i_riff >= p_idx->i_riff )
+                break;
+            i_pos = p_idx->pi_riff[i_riff++] + 24;
+            continue;
+        }
+        else if( ( i_stream >= 100 && ( p[0] != 'i' || p[1] != 'x' ) &&
+                   i_fourcc != AVIFOURCC_LIST && i_fourcc != AVIFOURCC_JUNK ) ||
+                 i_size > UINT32_MAX - 9 )
+        {
+            /* Not a chunk of this file */
+            if( AVI_IndexerResync( p_idx, &i_pos ) )
+            {
+                msg_Warn( p_demux, "lost sync, abort index creation" );
+                break;
+            }
+            continue;
+        }
+
+        if( !p_sys->b_odml && i_pos + i_size >= p_idx->i_movi_end )
+            break;
+        i_pos += 8 + __EVEN( (uint64_t)i_size );
+    }
+
+    AVI_IndexerPublish( p_idx, batch, i_batch );
+
+    vlc_tick_t i_elapsed = vlc_tick_now() - i_start;
+    msg_Dbg( p_demux, "index created in background: %"PRIu64" chunks "
+             "in %"PRId64" ms", i_count, MS_FROM_VLC_TICK( i_elapsed ) );
+
+    vlc_mutex_lock( &p_idx->lock );
+    p_idx->b_done = true;
+    vlc_mutex_unlock( &p_idx->lock );
+    return NULL;
+}
+
+static int AVI_IndexerStart( demux_t *p_demux )
+{
+    demux_sys_t *p_sys = p_demux->p_sys;
+
+    if( !var_InheritBool( p_demux, "avi-index-background" ) ||
+        p_demux->psz_url == NULL )
+        return VLC_EGENERIC;
+
+    avi_chunk_list_t *p_riff = AVI_ChunkFind( &p_sys->ck_root,
+                                              AVIFOURCC_RIFF, 0, true );
+    avi_chunk_list_t *p_movi = AVI_ChunkFind( p_riff, AVIFOURCC_movi, 0, true );
+    if( !p_movi )
+        return VLC_EGENERIC;
+
+    avi_indexer_t *p_idx = malloc( sizeof(*p_idx) );
+    if( unlikely(p_idx == NULL) )
+        return VLC_ENOMEM;
+
+    p_idx->p_demux = p_demux;
+    p_idx->p_buf = malloc( AVI_INDEXER_WINDOW );
+    p_idx->pi_riff = NULL;
+    p_idx->i_riff = 0;
+    p_idx->p_chunks = NULL;
+    p_idx->i_chunks = 0;
+    p_idx->i_chunks_max = 0;
+    p_idx->b_done = false;
+    atomic_init( &p_idx->b_stop, false );
+    vlc_mutex_init( &p_idx->lock );
+
+    /* The demuxer stream is used for playback meanwhile */
+    p_idx->s = p_idx->p_buf ? vlc_stream_NewURL( p_demux, p_demux->psz_url )
+                            : NULL;
+    if( p_idx->s == NULL )
+        goto error;
+
+    for( int i = 1;; i++ )
+    {
+        avi_chunk_list_t *p_avix = AVI_ChunkFind( &p_sys->ck_root,
+                                                  AVIFOURCC_RIFF, i, true );
+        if( !p_avix )
+            break;
+
+        uint64_t *pi_riff = vlc_reallocarray( p_idx->pi_riff, i,
+                                              sizeof(*pi_riff) );
+        if( unlikely(pi_riff == NULL) )
+            goto error;
+        pi_riff[i - 1] = p_avix->i_chunk_pos;
+        p_idx->pi_riff = pi_riff;
+        p_idx->i_riff = i;
+    }
+
+    uint64_t i_size = stream_Size( p_demux->s );
+    p_idx->i_movi_end = p_sys->b_odml ? i_size
+                      : __MIN( p_movi->i_chunk_pos + p_movi->i_chunk_size,
+                               i_size );
+    /* Start of the scan, for the thread */
+    p_idx->i_buf_pos = p_movi->i_chunk_pos + 12;
+
+    for( unsigned i = 0; i < p_sys->i_track; i++ )
+    {
+        avi_index_Clean( &p_sys->track[i]->idx );
+        avi_index_Init( &p_sys->track[i]->idx );
+    }
+    p_sys->i_movi_lastchunk_pos = 0;
+
+    if( vlc_clone( &p_idx->thread, AVI_IndexerThread, p_idx ) )
+        goto error;
+
+    msg_Warn( p_demux, "creating index from LIST-movi in background" );
+    p_sys->p_indexer = p_idx;
+    return VLC_SUCCESS;
+
+error:
+    if( p_idx->s )
+        vlc_stream_Delete( p_idx->s );
+    free( p_idx->pi_riff );
+    free( p_idx->p_buf );
+    free( p_idx );
+    return VLC_EGENERIC;
+}
+
+static void AVI_IndexerMerge( demux_t *p_demux )
+{
+    demux_sys_t   *p_sys = p_demux->p_sys;
+    avi_indexer_t *p_idx = p_sys->p_indexer;
+
+    if( p_idx == NULL )
+        return;
+
+    vlc_mutex_lock( &p_idx->lock );
+    avi_indexer_chunk_t *p_chunks = p_idx->p_chunks;
+    size_t i_chunks = p_idx->i_chunks;
+    bool b_done = p_idx->b_done;
+    p_idx->p_chunks = NULL;
+    p_idx->i_chunks = 0;
+    p_idx->i_chunks_max = 0;
+    vlc_mutex_unlock( &p_idx->lock );
+
+    for( size_t i = 0; i < i_chunks; i++ )
+    {
+        const avi_indexer_chunk_t *ck = &p_chunks[i];
+        avi_track_t *tk = p_sys->track[ck->i_stream];
+
+        /* Both scan the movi list in order: skip the chunks the demuxer
+         * already indexed while reading */
+        if( tk->idx.i_size > 0 &&
+            tk->idx.p_entry[tk->idx.i_size - 1].i_pos >= ck->i_pos )
+            continue;
+
+        avi_entry_t index;
+        index.i_flags   = ck->i_flags;
+        index.i_pos     = ck->i_pos;
+        index.i_length  = ck->i_size;
+        index.i_lengthtotal = 0;
+        avi_index_Append( &tk->idx, &p_sys->i_movi_lastchunk_pos, &index );
+    }
+    free( p_chunks );
+
+    if( b_done )
+    {
+        AVI_IndexerStop( p_demux );
+        p_sys->i_length = AVI_MovieGetLength( p_demux );
+
+        for( unsigned i = 0; i < p_sys->i_track; i++ )
+            msg_Dbg( p_demux, "stream[%u] created %"PRIu32" index entries",
+                     i, p_sys->track[i]->idx.i_size );
+    }
+}
+
+static void AVI_IndexerStop( demux_t *p_demux )
+{
+    demux_sys_t   *p_sys = p_demux->p_sys;
+    avi_indexer_t *p_idx = p_sys->p_indexer;
+
+    if( p_idx == NULL )
+        return;
+
+    atomic_store( &p_idx->b_stop, true );
+    vlc_join( p_idx->thread, NULL );
+
+    vlc_stream_Delete( p_idx->s );
+    free( p_idx->p_chunks );
+    free( p_idx->pi_riff );
+    free( p_idx->p_buf );
+    free( p_idx );
+    p_sys->p_indexer = NULL;
+}
+
 /* */
 static void AVI_MetaLoad( demux_t *p_demux,
                           avi_chunk_list_t *p_riff, avi_chunk_avih_t *p_avih )
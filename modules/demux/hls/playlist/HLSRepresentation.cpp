@@ -44,6 +44,15 @@ HLSRepresentation::HLSRepresentation  ( BaseAdaptationSet *set ) :
     updateFailureCount = 0;
     lastUpdateTime = 0;
     targetDuration = 0;
+    partTarget = 0;
+    b_canblockreload = false;
+    canSkipUntil = 0;
+    nextPart.msn = 0;
+    nextPart.part = -1;
+    lastPart.msn = 0;
+    lastPart.part = -1;
+    lastPart.number = 0;
+    lastPart.valid = false;
     streamFormat = StreamFormat::Type::Unknown;
     channels = 0;
 }
@@ -62,6 +71,11 @@ bool HLSRepresentation::isLive() const
     return b_live;
 }
 
+bool HLSRepresentation::isLowLatency() const
+{
+    return partTarget != 0;
+}
+
 bool HLSRepresentation::initialized() const
 {
     return b_loaded;
@@ -87,6 +101,39 @@ Url HLSRepresentation::getPlaylistUrl() const
     }
 }
 
+Url HLSRepresentation::getPlaylistUpdateUrl() const
+{
+    Url url = getPlaylistUrl();
+    if(!b_loaded || !isLive())
+        return url;
+
+    std::string params;
+    if(b_canblockreload)
+    {
+        /* Server will hold the request until the next part is available */
+        params = "_HLS_msn=" + std::to_string(nextPart.msn);
+        if(isLowLatency() && nextPart.part >= 0)
+            params += "&_HLS_part=" + std::to_string(nextPart.part);
+    }
+
+    /* Delta update, as long as we still have the skipped segments */
+    const SegmentList *segmentList = inheritSegmentList();
+    if(canSkipUntil && segmentList && segmentList->hasRelativeMediaTimes() &&
+       vlc_tick_now() - lastUpdateTime < canSkipUntil / 2)
+    {
+        if(!params.empty())
+            params += "&";
+        params += "_HLS_skip=YES";
+    }
+
+    if(params.empty())
+        return url;
+
+    std::string str = url.toString();
+    str += (str.find('?') == std::string::npos) ? "?" : "&";
+    return Url(str + params);
+}
+
 void HLSRepresentation::debug(vlc_object_t *obj, int indent) const
 {
     BaseRepresentation::debug(obj, indent);
@@ -136,9 +183,12 @@ bool HLSRepresentation::needsUpdate(uint64_t number) const
         vlc_tick_t duration = targetDuration
                             ? vlc_tick_from_sec(targetDuration)
                             : VLC_TICK_FROM_SEC(2);
+        if(isLowLatency())
+            duration = partTarget;
         if(updateFailureCount)
             duration /= 2;
-        if(elapsed < duration)
+        /* Blocking reloads are paced by the server */
+        if(elapsed < duration && (!b_canblockreload || updateFailureCount))
             return false;
 
         if(number == std::numeric_limits<uint64_t>::max())
@@ -193,7 +243,9 @@ CodecDescription * HLSRepresentation::makeCodecDescription(const std::string &s)
 
 uint64_t HLSRepresentation::translateSegmentNumber(uint64_t num, const BaseRepresentation *from) const
 {
-    if(targetDuration == static_cast<const HLSRepresentation *>(from)->targetDuration)
+    const HLSRepresentation *fromHLS = static_cast<const HLSRepresentation *>(from);
+    if(targetDuration == fromHLS->targetDuration &&
+       !isLowLatency() && !fromHLS->isLowLatency())
         return num;
 
     ISegment *fromSeg = from->getMediaSegment(num);
@@ -201,6 +253,28 @@ uint64_t HLSRepresentation::translateSegmentNumber(uint64_t num, const BaseRepre
     if(!fromSeg || !segmentList)
         return std::numeric_limits<uint64_t>::max();
 
+    /* Parts numbering is local to each representation */
+    if(isLowLatency() || fromHLS->isLowLatency())
+    {
+        /* Only switch on an independent part or a full segment: the
+         * matching part if it is one, otherwise the last independent
+         * part before it, otherwise the parent segment start */
+        const HLSSegment *fromPart = static_cast<const HLSSegment *>(fromSeg);
+        uint64_t ret = std::numeric_limits<uint64_t>::max();
+        for(const Segment *seg : segmentList->getSegments())
+        {
+            const HLSSegment *part = static_cast<const HLSSegment *>(seg);
+            if(part->getMediaSequenceNumber() != fromPart->getMediaSequenceNumber())
+                continue;
+            if(fromPart->getPartIndex() >= 0 &&
+               part->getPartIndex() > fromPart->getPartIndex())
+                break;
+            if(part->isIndependent() || ret == std::numeric_limits<uint64_t>::max())
+                ret = seg->getSequenceNumber();
+        }
+        return ret;
+    }
+
     const uint64_t discontinuitySequence = fromSeg->getDiscontinuitySequenceNumber();
 
     if(!segmentList->hasRelativeMediaTimes())
@@ -45,7 +45,9 @@ namespace hls
 
                 void setPlaylistUrl(const std::string &);
                 Url getPlaylistUrl() const;
+                Url getPlaylistUpdateUrl() const;
                 bool isLive() const;
+                bool isLowLatency() const;
                 bool initialized() const;
                 void scheduleNextUpdate(uint64_t, bool) override;
                 bool needsUpdate(uint64_t) const override;
@@ -60,6 +62,7 @@ namespace hls
 
             protected:
                 time_t targetDuration;
+                vlc_tick_t partTarget;
                 Url playlistUrl;
 
             private:
@@ -70,6 +73,23 @@ namespace hls
                 unsigned updateFailureCount;
                 vlc_tick_t lastUpdateTime;
                 unsigned channels;
+                /* EXT-X-SERVER-CONTROL */
+                bool b_canblockreload;
+                vlc_tick_t canSkipUntil;
+                /* Next partial segment to be advertised, for blocking reloads */
+                struct
+                {
+                    uint64_t msn;
+                    int part;
+                } nextPart;
+                /* Last partial segment numbered, as parts get renumbered */
+                struct
+                {
+                    uint64_t msn;
+                    int part;
+                    uint64_t number;
+                    bool valid;
+                } lastPart;
         };
     }
 }
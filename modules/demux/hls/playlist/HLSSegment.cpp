@@ -31,19 +31,38 @@ HLSSegment::HLSSegment( ICanonicalUrl *parent, uint64_t seq ) :
     Segment( parent )
 {
     setSequenceNumber(seq);
+    mediaSequence = seq;
+    partIndex = -1;
+    independent = true;
 }
 
 HLSSegment::~HLSSegment()
 {
 }
 
+uint64_t HLSSegment::getMediaSequenceNumber() const
+{
+    return mediaSequence;
+}
+
+int HLSSegment::getPartIndex() const
+{
+    return partIndex;
+}
+
+bool HLSSegment::isIndependent() const
+{
+    return independent;
+}
+
 bool HLSSegment::prepareChunk(SharedResources *res, SegmentChunk *chunk, BaseRepresentation *rep)
 {
     if(encryption.method == CommonEncryption::Method::AES_128)
     {
         if (encryption.iv.size() != 16)
         {
-            uint64_t sequence = getSequenceNumber();
+            /* low latency lists are renumbered, use the media sequence */
+            uint64_t sequence = mediaSequence;
             encryption.iv.clear();
             encryption.iv.resize(16);
             encryption.iv[15] = (sequence >> 0) & 0xff;
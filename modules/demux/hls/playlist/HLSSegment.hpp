@@ -38,10 +38,16 @@ namespace hls
             public:
                 HLSSegment( ICanonicalUrl *parent, uint64_t sequence );
                 virtual ~HLSSegment();
+                uint64_t getMediaSequenceNumber() const;
+                int getPartIndex() const;
+                bool isIndependent() const override;
 
             protected:
                 bool prepareChunk(SharedResources *, SegmentChunk *,
                                   BaseRepresentation *) override;
+                uint64_t mediaSequence;
+                int partIndex; /* -1 for a full segment */
+                bool independent;
         };
     }
 }
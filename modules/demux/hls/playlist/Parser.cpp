@@ -225,18 +225,14 @@ void M3U8Parser::fillAdaptsetFromMediainfo(const AttributesTag *mediatag,
 
 bool M3U8Parser::appendSegmentsFromPlaylistURI(vlc_object_t *p_obj, HLSRepresentation *rep)
 {
-    block_t *p_block = Retrieve::HTTP(resources, ChunkType::Playlist, rep->getPlaylistUrl().toString());
+    block_t *p_block = Retrieve::HTTP(resources, ChunkType::Playlist, rep->getPlaylistUpdateUrl().toString());
     if(p_block)
     {
         stream_t *substream = vlc_stream_MemoryNew(p_obj, p_block->p_buffer, p_block->i_buffer, true);
         if(substream)
         {
-            std::list<Tag *> tagslist = parseEntries(substream);
+            appendSegmentsFromPlaylist(p_obj, rep, substream);
             vlc_stream_Delete(substream);
-
-            parseSegments(p_obj, rep, tagslist);
-
-            releaseTagsList(tagslist);
         }
         block_Release(p_block);
         return true;
@@ -244,6 +240,14 @@ bool M3U8Parser::appendSegmentsFromPlaylistURI(vlc_object_t *p_obj, HLSRepresent
     return false;
 }
 
+void M3U8Parser::appendSegmentsFromPlaylist(vlc_object_t *p_obj, HLSRepresentation *rep,
+                                            stream_t *substream)
+{
+    std::list<Tag *> tagslist = parseEntries(substream);
+    parseSegments(p_obj, rep, tagslist);
+    releaseTagsList(tagslist);
+}
+
 static bool parseEncryption(const AttributesTag *keytag, const Url &playlistUrl,
                             CommonEncryption &encryption)
 {
@@ -279,13 +283,86 @@ static bool parseEncryption(const AttributesTag *keytag, const Url &playlistUrl,
     }
 }
 
+static bool isPartAfter(const HLSSegment *seg, uint64_t msn, int part)
+{
+    return seg->getMediaSequenceNumber() > msn ||
+           (seg->getMediaSequenceNumber() == msn && part >= 0 && seg->getPartIndex() > part);
+}
+
+static bool isPartSuccessor(const HLSSegment *seg, uint64_t msn, int part)
+{
+    if(seg->getMediaSequenceNumber() == msn)
+        return part >= 0 && seg->getPartIndex() == part + 1;
+    return seg->getMediaSequenceNumber() == msn + 1 && seg->getPartIndex() <= 0;
+}
+
+void M3U8Parser::numberPartialSegments(HLSRepresentation *rep, std::list<HLSSegment *> &segments)
+{
+    /* Parts replace their parent segment in the list and a segment
+     * becomes a single entry once its parts expire. Media sequence can
+     * no longer be used as segment number: number entries from the last
+     * one we've seen, so updates can be merged without gaps. */
+    uint64_t number;
+    std::list<HLSSegment *>::iterator first = segments.begin();
+    if(!rep->lastPart.valid)
+    {
+        number = segments.front()->getMediaSequenceNumber();
+    }
+    else
+    {
+        while(first != segments.end() &&
+              !isPartAfter(*first, rep->lastPart.msn, rep->lastPart.part))
+            ++first;
+        number = rep->lastPart.number + 1;
+        /* we missed some parts */
+        if(first != segments.end() &&
+           !isPartSuccessor(*first, rep->lastPart.msn, rep->lastPart.part))
+            (*first)->discontinuity = true;
+    }
+
+    /* already known entries, numbered backwards */
+    uint64_t backward = number;
+    for(auto it = std::make_reverse_iterator(first); it != segments.rend();)
+    {
+        if(backward == 0)
+        {
+            /* can't be numbered, and won't be merged anyway */
+            for(auto del = segments.begin(); del != it.base(); ++del)
+                delete *del;
+            segments.erase(segments.begin(), it.base());
+            break;
+        }
+        (*it++)->setSequenceNumber(--backward);
+    }
+
+    for(auto it = first; it != segments.end(); ++it)
+        (*it)->setSequenceNumber(number++);
+
+    if(first != segments.end())
+    {
+        const HLSSegment *last = segments.back();
+        rep->lastPart.msn = last->getMediaSequenceNumber();
+        rep->lastPart.part = last->getPartIndex();
+        rep->lastPart.number = last->getSequenceNumber();
+        rep->lastPart.valid = true;
+    }
+}
+
 void M3U8Parser::parseSegments(vlc_object_t *, HLSRepresentation *rep, const std::list<Tag *> &tagslist)
 {
     bool b_pdt = tagslist.cend() != std::find_if(tagslist.cbegin(), tagslist.cend(),
                     [](const Tag *t){return t->getType() == SingleValueTag::EXTXPROGRAMDATETIME;});
     bool b_vod = tagslist.size() && tagslist.back()->getType() == SingleValueTag::EXTXENDLIST;
-
-    SegmentList *segmentList = new SegmentList(rep, !b_vod && !b_pdt);
+    /* Low latency, partial segments */
+    bool b_parts = tagslist.cend() != std::find_if(tagslist.cbegin(), tagslist.cend(),
+                    [](const Tag *t){return t->getType() == AttributesTag::EXTXPARTINF;});
+    /* Delta updates */
+    bool b_delta = tagslist.cend() != std::find_if(tagslist.cbegin(), tagslist.cend(),
+                    [](const Tag *t){return t->getType() == AttributesTag::EXTXSERVERCONTROL &&
+                            static_cast<const AttributesTag *>(t)->getAttributeByName("CAN-SKIP-UNTIL");});
+
+    /* Parts and skipped segments are only usable when merging updates */
+    SegmentList *segmentList = new SegmentList(rep, !b_vod && (!b_pdt || b_parts || b_delta));
     const Timescale timescale = rep->inheritTimescale();
 
     rep->b_loaded = true;
@@ -301,9 +378,34 @@ void M3U8Parser::parseSegments(vlc_object_t *, HLSRepresentation *rep, const std
     const SingleValueTag *ctx_byterange = nullptr;
     CommonEncryption encryption;
     const ValuesListTag *ctx_extinf = nullptr;
+    const AttributesTag *ctx_preloadhint = nullptr;
+    int partsCount = 0; /* parts listed for the current segment */
+    bool partsAppended = false; /* current segment is replaced by its parts */
 
     std::list<HLSSegment *> segmentstoappend;
 
+    auto appendSegment = [&](HLSSegment *segment, vlc_tick_t nzDuration)
+    {
+        segment->duration.Set(timescale.ToScaled(nzDuration));
+        segment->startTime.Set(timescale.ToScaled(nzStartTime));
+        nzStartTime += nzDuration;
+        totalduration += nzDuration;
+        if(absReferenceTime != VLC_TICK_INVALID)
+        {
+            segment->setDisplayTime(absReferenceTime);
+            absReferenceTime += nzDuration;
+        }
+
+        segmentstoappend.push_back(segment);
+
+        segment->setDiscontinuitySequenceNumber(discontinuitySequence);
+        segment->discontinuity = discontinuity;
+        discontinuity = false;
+
+        if(encryption.method != CommonEncryption::Method::None)
+            segment->setEncryption(encryption);
+    };
+
     std::list<Tag *>::const_iterator it;
     for(it = tagslist.begin(); it != tagslist.end(); ++it)
     {
@@ -333,6 +435,18 @@ void M3U8Parser::parseSegments(vlc_object_t *, HLSRepresentation *rep, const std
                     break;
                 }
 
+                /* Segment was already listed as parts */
+                const bool b_listed = partsAppended;
+                partsCount = 0;
+                partsAppended = false;
+                if(b_listed)
+                {
+                    sequenceNumber++;
+                    ctx_extinf = nullptr;
+                    ctx_byterange = nullptr;
+                    break;
+                }
+
                 HLSSegment *segment = new (std::nothrow) HLSSegment(rep, sequenceNumber++);
                 if(!segment)
                     break;
@@ -348,17 +462,6 @@ void M3U8Parser::parseSegments(vlc_object_t *, HLSRepresentation *rep, const std
                         nzDuration = vlc_tick_from_sec(durAttribute->floatingPoint());
                     ctx_extinf = nullptr;
                 }
-                segment->duration.Set(timescale.ToScaled(nzDuration));
-                segment->startTime.Set(timescale.ToScaled(nzStartTime));
-                nzStartTime += nzDuration;
-                totalduration += nzDuration;
-                if(absReferenceTime != VLC_TICK_INVALID)
-                {
-                    segment->setDisplayTime(absReferenceTime);
-                    absReferenceTime += nzDuration;
-                }
-
-                segmentstoappend.push_back(segment);
 
                 if(ctx_byterange)
                 {
@@ -369,12 +472,98 @@ void M3U8Parser::parseSegments(vlc_object_t *, HLSRepresentation *rep, const std
                     segment->setByteRange(range.first, prevbyterangeoffset - 1);
                     ctx_byterange = nullptr;
                 }
-                segment->setDiscontinuitySequenceNumber(discontinuitySequence);
-                segment->discontinuity = discontinuity;
-                discontinuity = false;
 
-                if(encryption.method != CommonEncryption::Method::None)
-                    segment->setEncryption(encryption);
+                appendSegment(segment, nzDuration);
+            }
+            break;
+
+            case AttributesTag::EXTXPART:
+            {
+                if(!b_parts)
+                    break;
+                const AttributesTag *parttag = static_cast<const AttributesTag *>(tag);
+                const Attribute *uriAttr = parttag->getAttributeByName("URI");
+                const Attribute *durAttr = parttag->getAttributeByName("DURATION");
+                const Attribute *gapAttr = parttag->getAttributeByName("GAP");
+                const int partIndex = partsCount++;
+                if(!uriAttr || !durAttr)
+                    break;
+                /* AES-128 CBC runs over the whole segment: only the first part
+                 * could be decrypted with the segment IV, use the segment */
+                if(encryption.method == CommonEncryption::Method::AES_128)
+                    break;
+
+                const vlc_tick_t nzDuration = vlc_tick_from_sec(durAttr->floatingPoint());
+                if(gapAttr && gapAttr->value == "YES")
+                {
+                    /* unavailable part, skip its time */
+                    nzStartTime += nzDuration;
+                    totalduration += nzDuration;
+                    if(absReferenceTime != VLC_TICK_INVALID)
+                        absReferenceTime += nzDuration;
+                    discontinuity = true;
+                    partsAppended = true;
+                    break;
+                }
+
+                HLSSegment *segment = new (std::nothrow) HLSSegment(rep, sequenceNumber);
+                if(!segment)
+                    break;
+
+                segment->partIndex = partIndex;
+                partsAppended = true;
+                const Attribute *indAttr = parttag->getAttributeByName("INDEPENDENT");
+                segment->independent = indAttr && indAttr->value == "YES";
+                segment->setSourceUrl(uriAttr->quotedString());
+
+                const Attribute *byterangeAttr = parttag->getAttributeByName("BYTERANGE");
+                if(byterangeAttr)
+                {
+                    std::pair<std::size_t,std::size_t> range = byterangeAttr->unescapeQuotes().getByteRange();
+                    if(range.first == 0) /* continues previous part */
+                        range.first = prevbyterangeoffset;
+                    prevbyterangeoffset = range.first + range.second;
+                    segment->setByteRange(range.first, prevbyterangeoffset - 1);
+                }
+
+                appendSegment(segment, nzDuration);
+            }
+            break;
+
+            case AttributesTag::EXTXPRELOADHINT:
+                ctx_preloadhint = static_cast<const AttributesTag *>(tag);
+                break;
+
+            case AttributesTag::EXTXPARTINF:
+            {
+                const Attribute *targetAttr = static_cast<const AttributesTag *>(tag)->
+                                              getAttributeByName("PART-TARGET");
+                if(targetAttr)
+                    rep->partTarget = vlc_tick_from_sec(targetAttr->floatingPoint());
+            }
+            break;
+
+            case AttributesTag::EXTXSERVERCONTROL:
+            {
+                const AttributesTag *controltag = static_cast<const AttributesTag *>(tag);
+                const Attribute *attr = controltag->getAttributeByName("CAN-BLOCK-RELOAD");
+                rep->b_canblockreload = attr && attr->value == "YES";
+                attr = controltag->getAttributeByName("CAN-SKIP-UNTIL");
+                rep->canSkipUntil = attr ? vlc_tick_from_sec(attr->floatingPoint()) : 0;
+                attr = controltag->getAttributeByName(b_parts ? "PART-HOLD-BACK" : "HOLD-BACK");
+                if(attr)
+                    rep->getPlaylist()->suggestedPresentationDelay.Set(
+                                vlc_tick_from_sec(attr->floatingPoint()));
+            }
+            break;
+
+            case AttributesTag::EXTXSKIP:
+            {
+                /* Delta update, skipped segments are already known */
+                const Attribute *skippedAttr = static_cast<const AttributesTag *>(tag)->
+                                               getAttributeByName("SKIPPED-SEGMENTS");
+                if(skippedAttr)
+                    sequenceNumber += skippedAttr->decimal();
             }
             break;
 
@@ -451,6 +640,33 @@ void M3U8Parser::parseSegments(vlc_object_t *, HLSRepresentation *rep, const std
         }
     }
 
+    if(b_parts && ctx_preloadhint &&
+       encryption.method != CommonEncryption::Method::AES_128)
+    {
+        /* Hinted part, its request will be held until it is available */
+        const Attribute *typeAttr = ctx_preloadhint->getAttributeByName("TYPE");
+        const Attribute *uriAttr = ctx_preloadhint->getAttributeByName("URI");
+        const Attribute *startAttr = ctx_preloadhint->getAttributeByName("BYTERANGE-START");
+        if(typeAttr && typeAttr->value == "PART" && uriAttr &&
+           (!startAttr || startAttr->decimal() == 0))
+        {
+            HLSSegment *segment = new (std::nothrow) HLSSegment(rep, sequenceNumber);
+            if(segment)
+            {
+                segment->partIndex = partsCount;
+                segment->independent = false;
+                segment->setSourceUrl(uriAttr->quotedString());
+                appendSegment(segment, rep->partTarget);
+            }
+        }
+    }
+
+    rep->nextPart.msn = sequenceNumber;
+    rep->nextPart.part = partsCount;
+
+    if(b_parts && !segmentstoappend.empty())
+        numberPartialSegments(rep, segmentstoappend);
+
     for(HLSSegment *seg : segmentstoappend)
         segmentList->addSegment(seg);
     segmentstoappend.clear();
@@ -50,6 +50,7 @@ namespace hls
         class AttributesTag;
         class Tag;
         class HLSRepresentation;
+        class HLSSegment;
 
         class M3U8Parser
         {
@@ -59,6 +60,7 @@ namespace hls
 
                 M3U8 *             parse  (vlc_object_t *p_obj, stream_t *p_stream, const std::string &);
                 bool appendSegmentsFromPlaylistURI(vlc_object_t *, HLSRepresentation *);
+                void appendSegmentsFromPlaylist(vlc_object_t *, HLSRepresentation *, stream_t *);
 
             private:
                 HLSRepresentation * createRepresentation(BaseAdaptationSet *, const AttributesTag *);
@@ -69,6 +71,7 @@ namespace hls
                 void fillAdaptsetFromMediainfo(const AttributesTag *, const std::string &,
                                                const std::string &, BaseAdaptationSet *);
                 void parseSegments(vlc_object_t *, HLSRepresentation *, const std::list<Tag *>&);
+                void numberPartialSegments(HLSRepresentation *, std::list<HLSSegment *> &);
                 std::list<Tag *> parseEntries(stream_t *);
                 adaptive::SharedResources *resources;
         };
@@ -99,6 +99,11 @@ namespace hls
                     EXTXSTART,
                     EXTXSTREAMINF,
                     EXTXSESSIONKEY,
+                    EXTXPARTINF,
+                    EXTXSERVERCONTROL,
+                    EXTXPART,
+                    EXTXPRELOADHINT,
+                    EXTXSKIP,
                 };
                 AttributesTag(int, const std::string &);
                 virtual ~AttributesTag();
@@ -115,7 +120,7 @@ namespace hls
             public:
                 enum
                 {
-                    EXTINF = 30
+                    EXTINF = 40
                 };
                 ValuesListTag(int, const std::string &);
                 virtual ~ValuesListTag();
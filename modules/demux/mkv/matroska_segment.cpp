@@ -899,6 +899,16 @@ bool matroska_segment_c::Seek( demux_t &demuxer, vlc_tick_t i_absolute_mk_date,
 }
 
 
+mkv_track_t * matroska_segment_c::FindTrackByBlock( const mkv_simpleblock_c *p_fastblock )
+{
+    tracks_map_t::iterator track_it = tracks.find( p_fastblock->TrackNum() );
+
+    if (track_it == tracks.end())
+        return NULL;
+
+    return track_it->second.get();
+}
+
 mkv_track_t * matroska_segment_c::FindTrackByBlock(
                                              const KaxBlock *p_block, const KaxSimpleBlock *p_simpleblock )
 {
@@ -1172,12 +1182,32 @@ void matroska_segment_c::ESDestroy( )
     }
 }
 
+/* Reads the payload of a SimpleBlock in a single block, without libebml.
+ * Returns false, with the stream back at the payload start, when the element
+ * has to go through the libebml parser instead */
+bool matroska_segment_c::ReadSimpleBlock( const KaxSimpleBlock & ksblock )
+{
+    if( !ksblock.IsFiniteSize() )
+        return false;
+
+    block_t *p_payload = es.I_O().readBlock( ksblock.GetSize() );
+    if( p_payload != NULL &&
+        fast_block.Parse( p_payload, ksblock.GetElementPosition(),
+                          cluster->GlobalTimestamp(), i_timescale ) )
+        return true;
+
+    es.I_O().setFilePointer( ksblock.GetElementPosition() + ksblock.HeadSize() );
+    return false;
+}
+
 int matroska_segment_c::BlockGet( KaxBlock * & pp_block, KaxSimpleBlock * & pp_simpleblock,
+                                  mkv_simpleblock_c * & pp_fastblock,
                                   KaxBlockAdditions * & pp_additions,
                                   bool *pb_key_picture, bool *pb_discardable_picture,
                                   int64_t *pi_duration )
 {
     pp_simpleblock = NULL;
+    pp_fastblock = NULL;
     pp_block = NULL;
     pp_additions = NULL;
 
@@ -1191,6 +1221,7 @@ int matroska_segment_c::BlockGet( KaxBlock * & pp_block, KaxSimpleBlock * & pp_s
         demux_t            * const p_demuxer;
         KaxBlock          *& block;
         KaxSimpleBlock    *& simpleblock;
+        mkv_simpleblock_c *& fastblock;
         KaxBlockAdditions *& additions;
 
         int64_t            & i_duration;
@@ -1199,7 +1230,7 @@ int matroska_segment_c::BlockGet( KaxBlock * & pp_block, KaxSimpleBlock * & pp_s
         bool                 b_cluster_timecode;
 
     } payload = {
-        this, &ep, &sys.demuxer, pp_block, pp_simpleblock, pp_additions,
+        this, &ep, &sys.demuxer, pp_block, pp_simpleblock, pp_fastblock, pp_additions,
         *pi_duration, *pb_key_picture, *pb_discardable_picture, true
     };
 
@@ -1254,6 +1285,20 @@ int matroska_segment_c::BlockGet( KaxBlock * & pp_block, KaxSimpleBlock * & pp_s
                 return;
             }
 
+            if( vars.obj->ReadSimpleBlock( ksblock ) )
+            {
+                vars.fastblock = &vars.obj->fast_block;
+                if( vars.fastblock->IsKeyframe() )
+                {
+                    bool const b_valid_track = vars.obj->FindTrackByBlock( vars.fastblock ) != NULL;
+                    if (b_valid_track)
+                        vars.obj->_seeker.add_seekpoint( vars.fastblock->TrackNum(),
+                            SegmentSeeker::Seekpoint( vars.fastblock->GetElementPosition(),
+                                                      VLC_TICK_FROM_NS(vars.fastblock->Timestamp()) ) );
+                }
+                return;
+            }
+
             vars.simpleblock = &ksblock;
             vars.simpleblock->ReadData( vars.obj->es.I_O() );
             vars.simpleblock->SetParent( *vars.obj->cluster );
@@ -1349,18 +1394,27 @@ int matroska_segment_c::BlockGet( KaxBlock * & pp_block, KaxSimpleBlock * & pp_s
         EbmlElement *el = NULL;
         int         i_level;
 
-        if( pp_simpleblock != NULL || ((el = ep.Get()) == NULL && pp_block != NULL) )
+        if( pp_simpleblock != NULL || pp_fastblock != NULL ||
+            ((el = ep.Get()) == NULL && pp_block != NULL) )
         {
             /* Check blocks validity to protect against broken files */
-            const mkv_track_t *p_track = FindTrackByBlock( pp_block , pp_simpleblock );
+            const mkv_track_t *p_track = pp_fastblock != NULL
+                                       ? FindTrackByBlock( pp_fastblock )
+                                       : FindTrackByBlock( pp_block , pp_simpleblock );
             if( p_track == NULL )
             {
                 ep.Unkeep();
                 pp_simpleblock = NULL;
+                pp_fastblock = NULL;
                 pp_block = NULL;
                 continue;
             }
-            if( pp_simpleblock != NULL )
+            if( pp_fastblock != NULL )
+            {
+                *pb_key_picture         = pp_fastblock->IsKeyframe();
+                *pb_discardable_picture = pp_fastblock->IsDiscardable();
+            }
+            else if( pp_simpleblock != NULL )
             {
                 *pb_key_picture         = pp_simpleblock->IsKeyframe();
                 *pb_discardable_picture = pp_simpleblock->IsDiscardable();
@@ -1432,6 +1486,7 @@ int matroska_segment_c::BlockGet( KaxBlock * & pp_block, KaxSimpleBlock * & pp_s
 
                         ep.Unkeep();
                         pp_simpleblock = NULL;
+                        pp_fastblock = NULL;
                         pp_block = NULL;
 
                         break;
@@ -1459,6 +1514,7 @@ int matroska_segment_c::BlockGet( KaxBlock * & pp_block, KaxSimpleBlock * & pp_s
             ep.Up();
             ep.Unkeep();
             pp_simpleblock = NULL;
+            pp_fastblock = NULL;
             pp_block = NULL;
         }
     }
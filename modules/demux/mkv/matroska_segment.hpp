@@ -27,6 +27,7 @@
 #include "demux.hpp"
 #include "mkv.hpp"
 #include "matroska_segment_seeker.hpp"
+#include "simpleblock.hpp"
 #include <vector>
 #include <string>
 
@@ -146,10 +147,11 @@ public:
 
     bool Seek( demux_t &, vlc_tick_t i_mk_date, vlc_tick_t i_mk_time_offset, bool b_accurate );
 
-    int BlockGet( KaxBlock * &, KaxSimpleBlock * &, KaxBlockAdditions * &,
-                  bool *, bool *, int64_t *);
+    int BlockGet( KaxBlock * &, KaxSimpleBlock * &, mkv_simpleblock_c * &,
+                  KaxBlockAdditions * &, bool *, bool *, int64_t *);
 
     mkv_track_t * FindTrackByBlock(const KaxBlock *, const KaxSimpleBlock * );
+    mkv_track_t * FindTrackByBlock(const mkv_simpleblock_c * );
 
     bool ESCreate( );
     void ESDestroy( );
@@ -174,8 +176,11 @@ private:
     bool TrackInit( mkv_track_t * p_tk );
     void ComputeTrackPriority();
     void EnsureDuration();
+    bool ReadSimpleBlock( const KaxSimpleBlock & );
 
     SegmentSeeker _seeker;
+    /* SimpleBlock read without libebml, reused for each block */
+    mkv_simpleblock_c fast_block;
 
     friend SegmentSeeker;
 };
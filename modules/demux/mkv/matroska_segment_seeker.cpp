@@ -363,26 +363,39 @@ SegmentSeeker::index_unsearched_range( matroska_segment_c& ms, Range search_area
     {
         KaxBlock * block;
         KaxSimpleBlock * simpleblock;
+        mkv_simpleblock_c * fastblock;
         KaxBlockAdditions *additions;
 
         bool     b_key_picture;
         bool     b_discardable_picture;
         int64_t  i_block_duration;
         track_id_t track_id;
+        bool     b_valid_track;
 
-        if( ms.BlockGet( block, simpleblock, additions,
+        if( ms.BlockGet( block, simpleblock, fastblock, additions,
                          &b_key_picture, &b_discardable_picture, &i_block_duration ) )
             break;
 
-        KaxInternalBlock& internal_block = simpleblock
-            ? static_cast<KaxInternalBlock&>( *simpleblock )
-            : static_cast<KaxInternalBlock&>( *block );
+        if( fastblock )
+        {
+            block_pos = fastblock->GetElementPosition();
+            block_pts = VLC_TICK_FROM_NS(fastblock->Timestamp());
+            track_id  = fastblock->TrackNum();
 
-        block_pos = internal_block.GetElementPosition();
-        block_pts = VLC_TICK_FROM_NS(internal_block.GlobalTimestamp());
-        track_id  = internal_block.TrackNum();
+            b_valid_track = ms.FindTrackByBlock( fastblock ) != NULL;
+        }
+        else
+        {
+            KaxInternalBlock& internal_block = simpleblock
+                ? static_cast<KaxInternalBlock&>( *simpleblock )
+                : static_cast<KaxInternalBlock&>( *block );
 
-        bool const b_valid_track = ms.FindTrackByBlock( block, simpleblock ) != NULL;
+            block_pos = internal_block.GetElementPosition();
+            block_pts = VLC_TICK_FROM_NS(internal_block.GlobalTimestamp());
+            track_id  = internal_block.TrackNum();
+
+            b_valid_track = ms.FindTrackByBlock( block, simpleblock ) != NULL;
+        }
 
         delete block;
 
@@ -544,20 +544,22 @@ static void ReleaseVpxAlpha(void *opaque)
 
 /* Needed by matroska_segment::Seek() and Seek */
 void BlockDecode( demux_t *p_demux, KaxBlock *block, KaxSimpleBlock *simpleblock,
-                  KaxBlockAdditions *additions,
+                  mkv_simpleblock_c *fastblock, KaxBlockAdditions *additions,
                   vlc_tick_t i_pts, int64_t i_duration, bool b_key_picture,
                   bool b_discardable_picture )
 {
     demux_sys_t *p_sys = (demux_sys_t *)p_demux->p_sys;
     matroska_segment_c *p_segment = p_sys->p_current_vsegment->CurrentSegment();
 
-    KaxInternalBlock& internal_block = simpleblock
-        ? static_cast<KaxInternalBlock&>( *simpleblock )
-        : static_cast<KaxInternalBlock&>( *block );
+    KaxInternalBlock *internal_block = simpleblock
+        ? static_cast<KaxInternalBlock*>( simpleblock )
+        : static_cast<KaxInternalBlock*>( block );
 
     if( !p_segment ) return;
 
-    mkv_track_t *p_track = p_segment->FindTrackByBlock( block, simpleblock );
+    mkv_track_t *p_track = fastblock
+        ? p_segment->FindTrackByBlock( fastblock )
+        : p_segment->FindTrackByBlock( block, simpleblock );
     if( p_track == NULL )
     {
         msg_Err( p_demux, "invalid track number" );
@@ -590,30 +592,56 @@ void BlockDecode( demux_t *p_demux, KaxBlock *block, KaxSimpleBlock *simpleblock
     }
 
     size_t frame_size = 0;
-    size_t block_size = internal_block.GetSize();
-    const unsigned i_number_frames = internal_block.NumberFrames();
+    size_t block_size = fastblock ? 0 : internal_block->GetSize();
+    const unsigned i_number_frames = fastblock ? fastblock->NumberFrames()
+                                               : internal_block->NumberFrames();
+
+    size_t extra_data = track.fmt.i_codec == VLC_CODEC_PRORES ? 8 : 0;
+    const bool b_header_compression =
+        track.i_compression_type == MATROSKA_COMPRESSION_HEADER &&
+        track.p_compression_data != NULL &&
+        track.i_encoding_scope & MATROSKA_ENCODING_SCOPE_ALL_FRAMES;
+    if( b_header_compression )
+        extra_data += track.p_compression_data->GetSize();
 
     for( unsigned int i_frame = 0; i_frame < i_number_frames; i_frame++ )
     {
         block_t *p_block;
-        DataBuffer *data = &internal_block.GetBuffer(i_frame);
 
-        frame_size += data->Size();
-        if( !data->Buffer() || data->Size() > frame_size || frame_size > block_size  )
+        if( fastblock )
         {
-            msg_Warn( p_demux, "Cannot read frame (too long or no frame)" );
-            break;
-        }
-        size_t extra_data = track.fmt.i_codec == VLC_CODEC_PRORES ? 8 : 0;
+            /* the frame references the block payload, no copy */
+            p_block = fastblock->TakeFrame( i_frame );
+            if( p_block == NULL )
+                break;
 
-        if( track.i_compression_type == MATROSKA_COMPRESSION_HEADER &&
-            track.p_compression_data != NULL &&
-            track.i_encoding_scope & MATROSKA_ENCODING_SCOPE_ALL_FRAMES )
-            p_block = MemToBlock( data->Buffer(), data->Size(), track.p_compression_data->GetSize() + extra_data );
-        else if( unlikely( track.fmt.i_codec == VLC_CODEC_WAVPACK ) )
-            p_block = packetize_wavpack( track, data->Buffer(), data->Size() );
+            if( !b_header_compression && unlikely( track.fmt.i_codec == VLC_CODEC_WAVPACK ) )
+            {
+                block_t *p_packed = packetize_wavpack( track, p_block->p_buffer, p_block->i_buffer );
+                block_Release( p_block );
+                p_block = p_packed;
+            }
+            else if( extra_data )
+                p_block = block_Realloc( p_block, extra_data, p_block->i_buffer );
+        }
         else
-            p_block = MemToBlock( data->Buffer(), data->Size(), extra_data );
+        {
+            DataBuffer *data = &internal_block->GetBuffer(i_frame);
+
+            frame_size += data->Size();
+            if( !data->Buffer() || data->Size() > frame_size || frame_size > block_size  )
+            {
+                msg_Warn( p_demux, "Cannot read frame (too long or no frame)" );
+                break;
+            }
+
+            if( b_header_compression )
+                p_block = MemToBlock( data->Buffer(), data->Size(), extra_data );
+            else if( unlikely( track.fmt.i_codec == VLC_CODEC_WAVPACK ) )
+                p_block = packetize_wavpack( track, data->Buffer(), data->Size() );
+            else
+                p_block = MemToBlock( data->Buffer(), data->Size(), extra_data );
+        }
 
         if( p_block == NULL )
         {
@@ -827,12 +855,13 @@ static int Demux( demux_t *p_demux)
 
     KaxBlock *block;
     KaxSimpleBlock *simpleblock;
+    mkv_simpleblock_c *fastblock;
     KaxBlockAdditions *additions;
     int64_t i_block_duration = 0;
     bool b_key_picture;
     bool b_discardable_picture;
 
-    if( p_segment->BlockGet( block, simpleblock, additions,
+    if( p_segment->BlockGet( block, simpleblock, fastblock, additions,
                              &b_key_picture, &b_discardable_picture, &i_block_duration ) )
     {
         if ( p_vsegment->CurrentEdition() && p_vsegment->CurrentEdition()->b_ordered )
@@ -854,12 +883,26 @@ static int Demux( demux_t *p_demux)
         return VLC_DEMUXER_EOF;
     }
 
-    KaxInternalBlock& internal_block = block
-        ? static_cast<KaxInternalBlock&>( *block )
-        : static_cast<KaxInternalBlock&>( *simpleblock );
+    uint64_t i_block_fpos, i_block_timestamp;
+    if( fastblock )
+    {
+        i_block_fpos = fastblock->GetElementPosition();
+        i_block_timestamp = fastblock->Timestamp();
+    }
+    else
+    {
+        KaxInternalBlock& internal_block = block
+            ? static_cast<KaxInternalBlock&>( *block )
+            : static_cast<KaxInternalBlock&>( *simpleblock );
+
+        i_block_fpos = internal_block.GetElementPosition();
+        i_block_timestamp = internal_block.GlobalTimestamp();
+    }
 
     {
-        mkv_track_t *p_track = p_segment->FindTrackByBlock( block, simpleblock );
+        mkv_track_t *p_track = fastblock
+            ? p_segment->FindTrackByBlock( fastblock )
+            : p_segment->FindTrackByBlock( block, simpleblock );
 
         if( p_track == NULL )
         {
@@ -874,9 +917,7 @@ static int Demux( demux_t *p_demux)
 
         if( track.i_skip_until_fpos != std::numeric_limits<uint64_t>::max() ) {
 
-            uint64_t block_fpos = internal_block.GetElementPosition();
-
-            if ( track.i_skip_until_fpos > block_fpos )
+            if ( track.i_skip_until_fpos > i_block_fpos )
             {
                 delete block;
                 delete additions;
@@ -896,7 +937,7 @@ static int Demux( demux_t *p_demux)
     /* set pts */
     {
         p_sys->i_pts = p_sys->i_mk_chapter_time + VLC_TICK_0;
-        p_sys->i_pts += VLC_TICK_FROM_NS(internal_block.GlobalTimestamp());
+        p_sys->i_pts += VLC_TICK_FROM_NS(i_block_timestamp);
     }
 
     if ( p_vsegment->CurrentEdition() &&
@@ -909,7 +950,7 @@ static int Demux( demux_t *p_demux)
         return VLC_DEMUXER_EOF;
     }
 
-    BlockDecode( p_demux, block, simpleblock, additions,
+    BlockDecode( p_demux, block, simpleblock, fastblock, additions,
                  p_sys->i_pts, i_block_duration, b_key_picture, b_discardable_picture );
 
     delete block;
@@ -120,8 +120,9 @@ enum
 
 using namespace libmatroska;
 
+class mkv_simpleblock_c;
 void BlockDecode( demux_t *p_demux, KaxBlock *block, KaxSimpleBlock *simpleblock,
-                  KaxBlockAdditions *additions,
+                  mkv_simpleblock_c *fastblock, KaxBlockAdditions *additions,
                   vlc_tick_t i_pts, vlc_tick_t i_duration, bool b_key_picture,
                   bool b_discardable_picture );
 
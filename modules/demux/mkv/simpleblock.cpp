@@ -0,0 +1,278 @@
+/*****************************************************************************
+ * simpleblock.cpp : matroska demuxer
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#include "simpleblock.hpp"
+
+#include <vlc_atomic.h>
+
+#include <new>
+
+namespace mkv {
+
+/* Payload shared by the frames of a laced block */
+struct mkv_lace
+{
+    vlc_atomic_rc_t rc;
+    block_t        *p_payload;
+};
+
+struct mkv_lace_frame
+{
+    block_t          self;
+    struct mkv_lace *p_lace;
+};
+
+static void LaceRelease( struct mkv_lace *p_lace )
+{
+    if( vlc_atomic_rc_dec( &p_lace->rc ) )
+    {
+        block_Release( p_lace->p_payload );
+        delete p_lace;
+    }
+}
+
+static void LaceFrameRelease( block_t *p_block )
+{
+    struct mkv_lace_frame *p_frame =
+        container_of( p_block, struct mkv_lace_frame, self );
+
+    LaceRelease( p_frame->p_lace );
+    delete p_frame;
+}
+
+static const struct vlc_frame_callbacks lace_frame_cbs =
+{
+    LaceFrameRelease,
+};
+
+/* Reads an EBML coded integer, returns its length or 0 if invalid */
+static size_t ReadVint( const uint8_t *p_buf, size_t i_buf, uint64_t *pi_value )
+{
+    if( i_buf == 0 || p_buf[0] == 0 )
+        return 0;
+
+    size_t i_len = 1;
+    uint8_t i_mask = 0x80;
+    while( !(p_buf[0] & i_mask) )
+    {
+        i_mask >>= 1;
+        i_len++;
+    }
+    if( i_len > i_buf )
+        return 0;
+
+    uint64_t i_value = p_buf[0] & (i_mask - 1);
+    for( size_t i = 1; i < i_len; i++ )
+        i_value = (i_value << 8) | p_buf[i];
+
+    *pi_value = i_value;
+    return i_len;
+}
+
+mkv_simpleblock_c::mkv_simpleblock_c()
+    :p_payload(NULL)
+    ,p_lace(NULL)
+    ,i_track(0)
+    ,i_position(0)
+    ,i_timestamp(0)
+    ,i_flags(0)
+    ,i_frames(0)
+{
+}
+
+mkv_simpleblock_c::~mkv_simpleblock_c()
+{
+    Reset();
+}
+
+void mkv_simpleblock_c::Reset()
+{
+    if( p_lace != NULL )
+        LaceRelease( p_lace );
+    else if( p_payload != NULL )
+        block_Release( p_payload );
+    p_lace = NULL;
+    p_payload = NULL;
+    i_frames = 0;
+}
+
+bool mkv_simpleblock_c::ParseLacing( const uint8_t *p_buf, size_t i_buf,
+                                     int i_lacing )
+{
+    /* the payload offset of the first frame is set by the caller */
+    size_t i_header = frames[0].i_offset;
+
+    if( i_lacing == 0 )
+    {
+        i_frames = 1;
+        frames[0].i_size = i_buf - i_header;
+        return true;
+    }
+
+    if( i_header >= i_buf )
+        return false;
+    i_frames = p_buf[i_header++] + 1;
+
+    size_t i_laced = 0; /* total size of the frames but the last one */
+    switch( i_lacing )
+    {
+        case 0x02: /* Xiph */
+            for( unsigned i = 0; i < i_frames - 1; i++ )
+            {
+                size_t i_size = 0;
+                uint8_t i_byte;
+                do
+                {
+                    if( i_header >= i_buf )
+                        return false;
+                    i_byte = p_buf[i_header++];
+                    i_size += i_byte;
+                } while( i_byte == 0xff );
+                frames[i].i_size = i_size;
+                i_laced += i_size;
+            }
+            break;
+
+        case 0x06: /* EBML */
+        {
+            uint64_t i_value;
+            size_t i_len = ReadVint( &p_buf[i_header], i_buf - i_header, &i_value );
+            if( i_len == 0 || i_value > i_buf )
+                return false;
+            i_header += i_len;
+
+            int64_t i_size = i_value;
+            frames[0].i_size = i_size;
+            i_laced = i_size;
+            for( unsigned i = 1; i < i_frames - 1; i++ )
+            {
+                i_len = ReadVint( &p_buf[i_header], i_buf - i_header, &i_value );
+                if( i_len == 0 )
+                    return false;
+                i_header += i_len;
+
+                /* signed difference with the previous size */
+                i_size += (int64_t)i_value - ((INT64_C(1) << (7 * i_len - 1)) - 1);
+                if( i_size < 0 || (uint64_t)i_size > i_buf )
+                    return false;
+                frames[i].i_size = i_size;
+                i_laced += i_size;
+            }
+            break;
+        }
+
+        case 0x04: /* fixed size */
+        {
+            size_t i_total = i_buf - i_header;
+            if( i_total % i_frames )
+                return false;
+            for( unsigned i = 0; i < i_frames - 1; i++ )
+                frames[i].i_size = i_total / i_frames;
+            i_laced = i_total - i_total / i_frames;
+            break;
+        }
+    }
+
+    if( i_header > i_buf || i_laced > i_buf - i_header )
+        return false;
+    frames[i_frames - 1].i_size = i_buf - i_header - i_laced;
+
+    size_t i_offset = i_header;
+    for( unsigned i = 0; i < i_frames; i++ )
+    {
+        frames[i].i_offset = i_offset;
+        i_offset += frames[i].i_size;
+    }
+    return true;
+}
+
+bool mkv_simpleblock_c::Parse( block_t *p_block, uint64_t i_pos,
+                               uint64_t i_cluster_timestamp,
+                               uint64_t i_timescale )
+{
+    Reset();
+
+    const uint8_t *p_buf = p_block->p_buffer;
+    size_t i_buf = p_block->i_buffer;
+
+    size_t i_len = ReadVint( p_buf, i_buf, &i_track );
+    if( i_len == 0 || i_buf - i_len < 3 )
+    {
+        block_Release( p_block );
+        return false;
+    }
+
+    int16_t i_local = (int16_t)GetWBE( &p_buf[i_len] );
+    i_flags = p_buf[i_len + 2];
+    frames[0].i_offset = i_len + 3;
+
+    if( !ParseLacing( p_buf, i_buf, i_flags & 0x06 ) )
+    {
+        i_frames = 0;
+        block_Release( p_block );
+        return false;
+    }
+
+    /* same computation as libmatroska */
+    i_timestamp = i_cluster_timestamp + (int64_t)i_local * (int64_t)i_timescale;
+    i_position = i_pos;
+    p_payload = p_block;
+    return true;
+}
+
+block_t *mkv_simpleblock_c::TakeFrame( unsigned i_frame )
+{
+    if( i_frame >= i_frames || p_payload == NULL )
+        return NULL;
+
+    if( i_frames == 1 )
+    {
+        /* the payload itself is the frame */
+        block_t *p_block = p_payload;
+        p_payload = NULL;
+        p_block->p_buffer += frames[0].i_offset;
+        p_block->i_buffer = frames[0].i_size;
+        return p_block;
+    }
+
+    if( p_lace == NULL )
+    {
+        p_lace = new (std::nothrow) mkv_lace;
+        if( unlikely(p_lace == NULL) )
+            return NULL;
+        vlc_atomic_rc_init( &p_lace->rc );
+        p_lace->p_payload = p_payload;
+    }
+
+    struct mkv_lace_frame *p_frame = new (std::nothrow) mkv_lace_frame;
+    if( unlikely(p_frame == NULL) )
+        return NULL;
+
+    vlc_atomic_rc_inc( &p_lace->rc );
+    p_frame->p_lace = p_lace;
+
+    block_t *p_block = &p_frame->self;
+    vlc_frame_Init( p_block, &lace_frame_cbs,
+                    p_payload->p_buffer + frames[i_frame].i_offset,
+                    frames[i_frame].i_size );
+    return p_block;
+}
+
+} // namespace
@@ -0,0 +1,84 @@
+/*****************************************************************************
+ * simpleblock.hpp : matroska demuxer
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef VLC_MKV_SIMPLEBLOCK_HPP_
+#define VLC_MKV_SIMPLEBLOCK_HPP_
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <vlc_common.h>
+#include <vlc_block.h>
+
+namespace mkv {
+
+/*****************************************************************************
+ * SimpleBlock parsed without libebml
+ *****************************************************************************
+ * The element payload is read from the stream into a single block and the
+ * frames are handed out as views of it: the frame data is never copied.
+ *****************************************************************************/
+class mkv_simpleblock_c
+{
+public:
+    mkv_simpleblock_c();
+    ~mkv_simpleblock_c();
+
+    /* Takes ownership of the payload, even on failure */
+    bool Parse( block_t *p_payload, uint64_t i_position,
+                uint64_t i_cluster_timestamp, uint64_t i_timescale );
+    void Reset();
+
+    uint64_t TrackNum() const { return i_track; }
+    uint64_t GetElementPosition() const { return i_position; }
+    uint64_t Timestamp() const { return i_timestamp; } /* ns */
+    bool     IsKeyframe() const { return i_flags & 0x80; }
+    bool     IsDiscardable() const { return i_flags & 0x01; }
+    unsigned NumberFrames() const { return i_frames; }
+
+    /* Returns a frame referencing the payload, each frame can be taken once */
+    block_t *TakeFrame( unsigned i_frame );
+
+private:
+    mkv_simpleblock_c( const mkv_simpleblock_c & ) = delete;
+    mkv_simpleblock_c & operator=( const mkv_simpleblock_c & ) = delete;
+
+    bool ParseLacing( const uint8_t *p_buf, size_t i_buf, int i_lacing );
+
+    block_t        *p_payload;
+    struct mkv_lace *p_lace;
+
+    uint64_t        i_track;
+    uint64_t        i_position;
+    uint64_t        i_timestamp;
+    uint8_t         i_flags;
+
+    unsigned        i_frames;
+    struct
+    {
+        size_t i_offset;
+        size_t i_size;
+    } frames[256];
+};
+
+} // namespace
+
+#endif
@@ -63,6 +63,9 @@ class vlc_stream_io_callback: public IOCallback
     size_t   write           ( const void *p_buffer, size_t i_size) override;
     uint64_t getFilePointer  ( void ) override;
     void     close           ( void ) override { return; }
+
+    /* Reads exactly i_size bytes in a block, NULL on short read */
+    block_t *readBlock       ( size_t i_size );
 };
 
 class matroska_iostream_c : public EbmlStream
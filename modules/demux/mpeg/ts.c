@@ -205,6 +205,8 @@ static void PCRFixHandle( demux_t *, ts_pmt_t *, block_t * );
 #define TS_PACKET_SIZE_MAX 204
 #define TS_HEADER_SIZE 4
 
+#define SEEKINDEX_INTERVAL VLC_TICK_FROM_SEC(1)
+
 #define PROBE_CHUNK_COUNT 500
 #define PROBE_MAX         (PROBE_CHUNK_COUNT * 10)
 
@@ -408,6 +410,8 @@ static int Open( vlc_object_t *p_this )
     p_sys->csa = NULL;
     p_sys->b_start_record = false;
     p_sys->record_dir_path = NULL;
+    p_sys->seekindex.p_index = NULL;
+    p_sys->seekindex.i_program = -1;
 
     vlc_dictionary_init( &p_sys->attachments, 0 );
 
@@ -597,6 +601,9 @@ static void Close( vlc_object_t *p_this )
     /* Clear up attachments */
     vlc_dictionary_clear( &p_sys->attachments, FreeDictAttachment, NULL );
 
+    if( p_sys->seekindex.p_index )
+        vlc_seekindex_Delete( p_sys->seekindex.p_index );
+
     free( p_sys->record_dir_path );
     free( p_sys );
 }
@@ -2004,6 +2011,40 @@ static void ReadyQueuesPostSeek( demux_t *p_demux )
     }
 }
 
+static vlc_seekindex_t *GetSeekIndex( demux_t *p_demux, const ts_pmt_t *p_pmt )
+{
+    demux_sys_t *p_sys = p_demux->p_sys;
+
+    if( p_sys->seekindex.i_program == p_pmt->i_number )
+        return p_sys->seekindex.p_index;
+
+    if( p_sys->seekindex.p_index )
+    {
+        vlc_seekindex_Delete( p_sys->seekindex.p_index );
+        p_sys->seekindex.p_index = NULL;
+    }
+    p_sys->seekindex.i_program = p_pmt->i_number;
+
+    /* Only index seekable files, not live feeds */
+    if( p_sys->b_access_control || p_demux->b_preparsing ||
+       !p_sys->b_canseek || !p_sys->b_canfastseek )
+        return NULL;
+
+    char psz_tag[16];
+    snprintf( psz_tag, sizeof(psz_tag), "ts/%d", p_pmt->i_number );
+    p_sys->seekindex.p_index = vlc_seekindex_Open( p_demux, p_sys->stream,
+                                                   psz_tag, SEEKINDEX_INTERVAL );
+    return p_sys->seekindex.p_index;
+}
+
+/* The seek index is on the PCR clock, starting from the first PCR */
+static vlc_tick_t SeekIndexTime( const ts_pmt_t *p_pmt, stime_t i_pcr )
+{
+    stime_t i_delta = TimeStampWrapAround( p_pmt->pcr.i_first, i_pcr ) -
+                      p_pmt->pcr.i_first;
+    return VLC_TICK_0 + FROM_SCALE_NZ( __MAX( i_delta, 0 ) );
+}
+
 static int SeekToTime( demux_t *p_demux, const ts_pmt_t *p_pmt, stime_t i_scaledtime )
 {
     demux_sys_t *p_sys = p_demux->p_sys;
@@ -2024,6 +2065,28 @@ static int SeekToTime( demux_t *p_demux, const ts_pmt_t *p_pmt, stime_t i_scaled
     if( i_head_pos >= i_tail_pos )
         return VLC_EGENERIC;
 
+    /* Narrow the search down to the positions already known */
+    vlc_seekindex_t *p_index = p_pmt->pcr.i_first > -1 ?
+                               GetSeekIndex( p_demux, p_pmt ) : NULL;
+    const vlc_tick_t i_indextime = p_index ?
+                                   SeekIndexTime( p_pmt, i_scaledtime ) : 0;
+    struct vlc_seekindex_entry before, after;
+    if( p_index &&
+        vlc_seekindex_Lookup( p_index, i_indextime,
+                              &before, &after ) == VLC_SUCCESS )
+    {
+        if( before.time != VLC_TICK_INVALID )
+        {
+            if( i_indextime - before.time < VLC_TICK_FROM_MS(500) )
+                return vlc_stream_Seek( p_sys->stream, before.offset );
+            if( before.offset > i_head_pos && before.offset < i_tail_pos )
+                i_head_pos = before.offset;
+        }
+        if( after.time != VLC_TICK_INVALID &&
+            after.offset > i_head_pos && after.offset < i_tail_pos )
+            i_tail_pos = after.offset;
+    }
+
     bool b_found = false;
     while( (i_head_pos + p_sys->i_packet_size) <= i_tail_pos && !b_found )
     {
@@ -2039,6 +2102,7 @@ static int SeekToTime( demux_t *p_demux, const ts_pmt_t *p_pmt, stime_t i_scaled
         while( i_pos < i_tail_pos )
         {
             stime_t i_pcr = -1;
+            bool b_pcr = false;
             block_t *p_pkt = ReadTSPacket( p_demux );
             if( !p_pkt )
             {
@@ -2058,7 +2122,10 @@ static int SeekToTime( demux_t *p_demux, const ts_pmt_t *p_pmt, stime_t i_scaled
                     if( p_pkt->i_buffer >= 4 + 2 + 5 )
                     {
                         if( p_pmt->i_pid_pcr == i_pid )
+                        {
                             i_pcr = GetPCR( p_pkt );
+                            b_pcr = i_pcr != -1;
+                        }
                         i_skip += 1 + __MIN(p_pkt->p_buffer[4], 182);
                     }
                 }
@@ -2085,6 +2152,12 @@ static int SeekToTime( demux_t *p_demux, const ts_pmt_t *p_pmt, stime_t i_scaled
 
             if( i_pcr != -1 )
             {
+                /* Data at the split position is not later than that. Only
+                 * PCR are indexed, as DTS are on a different clock. */
+                if( p_index && b_pcr )
+                    vlc_seekindex_Add( p_index, SeekIndexTime( p_pmt, i_pcr ),
+                                       i_splitpos );
+
                 stime_t i_diff = i_scaledtime - TimeStampWrapAround( p_pmt->pcr.i_first, i_pcr );
                 if ( i_diff < 0 )
                     i_tail_pos = (i_splitpos >= p_sys->i_packet_size) ? i_splitpos - p_sys->i_packet_size : 0;
@@ -2467,6 +2540,20 @@ static void PCRHandle( demux_t *p_demux, ts_pid_t *pid, stime_t i_pcr )
                 /* We've found a target group for update */
                 PCRCheckDTS( p_demux, p_pmt, i_pcr );
                 ProgramSetPCR( p_demux, p_pmt, i_program_pcr );
+
+                /* Remember where that PCR was while playing */
+                vlc_seekindex_t *p_index;
+                if( p_pmt->b_selected && p_pmt->pcr.i_first > -1 &&
+                   (p_sys->seekindex.i_program == -1 ||
+                    p_sys->seekindex.i_program == p_pmt->i_number) &&
+                    (p_index = GetSeekIndex( p_demux, p_pmt )) )
+                {
+                    uint64_t i_pos = vlc_stream_Tell( p_sys->stream );
+                    if( i_pos >= p_sys->i_packet_size )
+                        vlc_seekindex_Add( p_index,
+                                           SeekIndexTime( p_pmt, i_pcr ),
+                                           i_pos - p_sys->i_packet_size );
+                }
             }
         }
 
@@ -21,6 +21,7 @@
 #define VLC_TS_H
 
 #include <vlc_arrays.h>
+#include <vlc_seekindex.h>
 
 #ifdef HAVE_ARIBB24
     typedef struct arib_instance_t arib_instance_t;
@@ -144,6 +145,13 @@ struct demux_sys_t
     /* */
     bool        b_start_record;
     char        *record_dir_path;
+
+    /* Known PCR positions of the selected program */
+    struct
+    {
+        vlc_seekindex_t *p_index;
+        int i_program; /* -1 if not opened yet */
+    } seekindex;
 };
 
 void TsChangeStandard( demux_sys_t *, ts_standards_e );
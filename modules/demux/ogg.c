@@ -133,6 +133,7 @@ static int  Control( demux_t *, int, va_list );
 /* Bitstream manipulation */
 static int  Ogg_ReadPage     ( demux_t *, ogg_page * );
 static void Ogg_DecodePacket ( demux_t *, logical_stream_t *, ogg_packet *, bool );
+static bool Ogg_IsHeaderPacket( const logical_stream_t *, const ogg_packet * );
 static unsigned Ogg_OpusPacketDuration( ogg_packet * );
 static void Ogg_QueueBlocks( demux_t *, logical_stream_t *, block_t *, vlc_tick_t, bool );
 static void Ogg_SendQueuedBlock( demux_t *, logical_stream_t * );
@@ -555,8 +556,24 @@ static int Demux( demux_t * p_demux )
                     p_sys->current_page.body_len )
         );
 
+        /* the first packet out of a page just paged in starts on it,
+         * unless the page is continued */
+        bool b_page_start = !p_sys->b_page_waiting &&
+                            !ogg_page_continued( &p_sys->current_page );
+
         while( ogg_stream_packetout( &p_stream->os, &oggpacket ) > 0 )
         {
+            /* Record keyframes starting a page as we play them */
+            if( b_page_start && p_stream->fmt.i_cat == VIDEO_ES &&
+                !p_stream->b_initializing &&
+                !Ogg_IsHeaderPacket( p_stream, &oggpacket ) &&
+                Ogg_IsKeyFrame( p_stream, &oggpacket ) )
+            {
+                OggSeek_IndexKeyframe( p_demux, p_stream, date_Get( &p_stream->dts ),
+                                       p_sys->i_page_pos );
+            }
+            b_page_start = false;
+
             /* Read info from any secondary header packets, if there are any */
             if( p_stream->i_secondary_header_packets > 0 )
             {
@@ -976,6 +993,11 @@ static int Ogg_ReadPage( demux_t *p_demux, ogg_page *p_oggpage )
         ogg_sync_wrote( &p_ogg->oy, i_read );
     }
 
+    /* the page ends where the data still buffered by the sync layer starts */
+    p_ogg->i_page_pos = vlc_stream_Tell( p_demux->s )
+                      - ( p_ogg->oy.fill - p_ogg->oy.returned )
+                      - ( p_oggpage->header_len + p_oggpage->body_len );
+
     return VLC_SUCCESS;
 }
 
@@ -2304,7 +2326,9 @@ static int Ogg_BeginningOfStream( demux_t *p_demux )
         p_stream->p_es = NULL;
 
         /* initialise kframe index */
-        p_stream->idx=NULL;
+        p_stream->idx.p_entries = NULL;
+        p_stream->idx.i_count = 0;
+        p_stream->idx.i_alloc = 0;
 
         if ( p_stream->fmt.i_bitrate == 0  &&
              ( p_stream->fmt.i_cat == VIDEO_ES ||
@@ -2410,10 +2434,7 @@ static void Ogg_LogicalStreamDelete( demux_t *p_demux, logical_stream_t *p_strea
     es_format_Clean( &p_stream->fmt_old );
     es_format_Clean( &p_stream->fmt );
 
-    if ( p_stream->idx != NULL)
-    {
-        oggseek_index_entries_free( p_stream->idx );
-    }
+    oggseek_index_entries_free( p_stream );
 
     Ogg_FreeSkeleton( p_stream->p_skel );
     p_stream->p_skel = NULL;
@@ -99,8 +99,14 @@ typedef struct logical_stream_s
     /* offset of first keyframe for theora; can be 0 or 1 depending on version number */
     int8_t i_first_frame_index;
 
-    /* keyframe index for seeking, created as we discover keyframes */
-    demux_index_entry_t *idx;
+    /* keyframe index for seeking, created as we discover keyframes,
+     * sorted by both page position and time */
+    struct
+    {
+        demux_index_entry_t *p_entries;
+        size_t i_count;
+        size_t i_alloc;
+    } idx;
 
     /* Skeleton data */
     ogg_skeleton_t *p_skel;
@@ -201,8 +207,9 @@ typedef struct
     /* offset position in file (for reading) */
     int64_t i_input_position;
 
-    /* current page being parsed */
+    /* current page being parsed, and its position in file */
     ogg_page current_page;
+    int64_t i_page_pos;
 
     /* */
     vlc_meta_t          *p_meta;
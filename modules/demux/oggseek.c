@@ -50,6 +50,7 @@
 
 #define MAX_PAGE_SIZE 65307
 #define MIN_PAGE_SIZE 27
+#define OGGSEEK_INTERPOLATION_STEPS 4
 typedef struct packetStartCoordinates
 {
     int64_t i_pos;
@@ -61,94 +62,138 @@ typedef struct packetStartCoordinates
 * index entries
 *************************************************************/
 
-/* free all entries in index list */
+/* free all entries in index */
 
-void oggseek_index_entries_free ( demux_index_entry_t *idx )
+void oggseek_index_entries_free ( logical_stream_t *p_stream )
 {
-    demux_index_entry_t *idx_next;
+    free( p_stream->idx.p_entries );
+    p_stream->idx.p_entries = NULL;
+    p_stream->idx.i_count = 0;
+    p_stream->idx.i_alloc = 0;
+}
+
+
+/* returns the number of entries with a page position lower than i_pagepos */
 
-    while ( idx != NULL )
+static size_t index_lower_bound_pos( const logical_stream_t *p_stream, int64_t i_pagepos )
+{
+    size_t lo = 0, hi = p_stream->idx.i_count;
+    while ( lo < hi )
     {
-        idx_next = idx->p_next;
-        free( idx );
-        idx = idx_next;
+        size_t mid = lo + ( hi - lo ) / 2;
+        if ( p_stream->idx.p_entries[mid].i_pagepos < i_pagepos )
+            lo = mid + 1;
+        else
+            hi = mid;
     }
+    return lo;
 }
 
+/* returns the number of entries with a time lower or equal to i_timestamp */
 
-/* internal function to create a new list member */
-
-static demux_index_entry_t *index_entry_new( vlc_tick_t i_timestamp, int64_t i_pagepos )
+static size_t index_upper_bound_time( const logical_stream_t *p_stream, vlc_tick_t i_timestamp )
 {
-    if ( i_timestamp == VLC_TICK_INVALID || i_pagepos < 1 )
-        return NULL;
-
-    demux_index_entry_t *idx = malloc( sizeof(*idx) );
-    if ( idx )
+    size_t lo = 0, hi = p_stream->idx.i_count;
+    while ( lo < hi )
     {
-        idx->i_value = i_timestamp;
-        idx->i_pagepos = i_pagepos;
-        idx->p_next = NULL;
+        size_t mid = lo + ( hi - lo ) / 2;
+        if ( p_stream->idx.p_entries[mid].i_value <= i_timestamp )
+            lo = mid + 1;
+        else
+            hi = mid;
     }
-    return idx;
+    return lo;
 }
 
 /* We insert into index, sorting by pagepos (as a page can match multiple
-   time stamps) */
+   time stamps). Entries breaking the time ordering are rejected so that the
+   index can also be searched by time. */
 const demux_index_entry_t *OggSeek_IndexAdd ( logical_stream_t *p_stream,
                                              vlc_tick_t i_timestamp,
                                              int64_t i_pagepos )
 {
-    demux_index_entry_t **pp_next = &p_stream->idx;
-    for( ; *pp_next; )
-    {
-        if( (*pp_next)->i_pagepos >= i_pagepos )
-        {
-            if( (*pp_next)->i_pagepos == i_pagepos )
-                return NULL;
-            break;
-        }
-        pp_next = &((*pp_next)->p_next);
-    }
+    if ( i_timestamp == VLC_TICK_INVALID || i_pagepos < 1 )
+        return NULL;
 
-    demux_index_entry_t *ie = index_entry_new( i_timestamp, i_pagepos );
-    if ( ie )
+    size_t i_insert = index_lower_bound_pos( p_stream, i_pagepos );
+    demux_index_entry_t *p_entries = p_stream->idx.p_entries;
+
+    if ( i_insert < p_stream->idx.i_count &&
+         ( p_entries[i_insert].i_pagepos == i_pagepos ||
+           p_entries[i_insert].i_value < i_timestamp ) )
+        return NULL;
+    if ( i_insert > 0 && p_entries[i_insert - 1].i_value > i_timestamp )
+        return NULL;
+
+    if ( p_stream->idx.i_count == p_stream->idx.i_alloc )
     {
-        ie->p_next = *pp_next;
-        *pp_next = ie;
+        size_t i_alloc = p_stream->idx.i_alloc ? p_stream->idx.i_alloc * 2 : 16;
+        p_entries = realloc( p_entries, i_alloc * sizeof(*p_entries) );
+        if ( !p_entries )
+            return NULL;
+        p_stream->idx.p_entries = p_entries;
+        p_stream->idx.i_alloc = i_alloc;
     }
 
-    return ie;
+    memmove( &p_entries[i_insert + 1], &p_entries[i_insert],
+             ( p_stream->idx.i_count - i_insert ) * sizeof(*p_entries) );
+    p_entries[i_insert].i_value = i_timestamp;
+    p_entries[i_insert].i_pagepos = i_pagepos;
+    p_stream->idx.i_count++;
+
+    return &p_entries[i_insert];
+}
+
+/* minimum time between two index entries, growing with the duration */
+
+static vlc_tick_t OggSeekIndexInterval( const demux_sys_t *p_sys )
+{
+    return p_sys->i_length
+         ? vlc_tick_from_sec( ceil( sqrt( SEC_FROM_VLC_TICK( p_sys->i_length ) ) / 2 ) )
+         : vlc_tick_from_sec( 5 );
+}
+
+/* Adds a keyframe met during playback. i_timestamp is the start time of the
+   keyframe, which begins on the page at i_pagepos. */
+
+void OggSeek_IndexKeyframe ( demux_t *p_demux, logical_stream_t *p_stream,
+                             vlc_tick_t i_timestamp, int64_t i_pagepos )
+{
+    demux_sys_t *p_sys = p_demux->p_sys;
+
+    if ( i_timestamp == VLC_TICK_INVALID || i_pagepos < p_stream->i_data_start )
+        return;
+
+    vlc_tick_t i_interval = OggSeekIndexInterval( p_sys );
+    size_t i_upper = index_upper_bound_time( p_stream, i_timestamp );
+    if ( i_upper > 0 &&
+         i_timestamp - p_stream->idx.p_entries[i_upper - 1].i_value < i_interval )
+        return;
+    if ( i_upper < p_stream->idx.i_count &&
+         p_stream->idx.p_entries[i_upper].i_value - i_timestamp < i_interval )
+        return;
+
+    OggSeek_IndexAdd( p_stream, i_timestamp, i_pagepos );
 }
 
 static bool OggSeekIndexFind ( logical_stream_t *p_stream, vlc_tick_t i_timestamp,
                                int64_t *pi_pos_lower, int64_t *pi_pos_upper,
-                               vlc_tick_t *pi_lower_timestamp )
+                               vlc_tick_t *pi_lower_timestamp,
+                               vlc_tick_t *pi_upper_timestamp )
 {
-    demux_index_entry_t *idx = p_stream->idx;
+    size_t i_upper = index_upper_bound_time( p_stream, i_timestamp );
+    if ( i_upper == 0 )
+        return false;
 
-    while ( idx != NULL )
+    const demux_index_entry_t *p_lower = &p_stream->idx.p_entries[i_upper - 1];
+    *pi_pos_lower = p_lower->i_pagepos;
+    *pi_lower_timestamp = p_lower->i_value;
+    if ( i_upper < p_stream->idx.i_count )
     {
-        if ( idx->i_value <= i_timestamp )
-        {
-            if ( !idx->p_next ) /* found on last index */
-            {
-                *pi_pos_lower = idx->i_pagepos;
-                *pi_lower_timestamp = idx->i_value;
-                return true;
-            }
-            if ( idx->p_next->i_value > i_timestamp )
-            {
-                *pi_pos_lower = idx->i_pagepos;
-                *pi_lower_timestamp = idx->i_value;
-                *pi_pos_upper = idx->p_next->i_pagepos;
-                return true;
-            }
-        }
-        idx = idx->p_next;
+        *pi_pos_upper = p_stream->idx.p_entries[i_upper].i_pagepos;
+        *pi_upper_timestamp = p_stream->idx.p_entries[i_upper].i_value;
     }
-
-    return false;
+    return true;
 }
 
 /*********************************************************************
@@ -627,6 +672,77 @@ restart:
     return i_result;
 }
 
+/* Narrows the search bounds down by probing where the target time would be
+ * if the bitrate was constant between the bounds. This needs far fewer page
+ * reads than bisecting on long files with a steady bitrate, and the probed
+ * pages are checked so the bounds stay correct on any other file.
+ * A bound without a known time is only used at the data start or file end. */
+static void OggInterpolateBounds( demux_t *p_demux, logical_stream_t *p_stream,
+                                  vlc_tick_t i_targettime,
+                                  int64_t *pi_pos_lower, vlc_tick_t i_time_lower,
+                                  int64_t *pi_pos_upper, vlc_tick_t i_time_upper )
+{
+    demux_sys_t *p_sys = p_demux->p_sys;
+
+    if ( i_time_lower == VLC_TICK_INVALID )
+    {
+        if ( *pi_pos_lower > p_stream->i_data_start )
+            return;
+        i_time_lower = VLC_TICK_0;
+    }
+    if ( i_time_upper == VLC_TICK_INVALID )
+    {
+        if ( ( *pi_pos_upper >= 0 && *pi_pos_upper < p_sys->i_total_bytes ) ||
+             p_sys->i_length == 0 )
+            return;
+        *pi_pos_upper = p_sys->i_total_bytes;
+        i_time_upper = VLC_TICK_0 + p_sys->i_length;
+    }
+
+    for ( int i = 0; i < OGGSEEK_INTERPOLATION_STEPS; i++ )
+    {
+        const int64_t i_range = *pi_pos_upper - *pi_pos_lower;
+        if ( i_range <= 2 * MAX_PAGE_SIZE || i_time_upper <= i_time_lower ||
+             i_targettime < i_time_lower || i_targettime >= i_time_upper )
+            break;
+
+        /* Aim a page early, landing just before the target is the cheap case */
+        int64_t i_pos = *pi_pos_lower + (int64_t)( (double) i_range *
+                        ( i_targettime - i_time_lower ) / ( i_time_upper - i_time_lower ) );
+        i_pos = __MAX( i_pos - MAX_PAGE_SIZE, *pi_pos_lower );
+
+        int64_t i_granule;
+        int64_t i_pagepos = find_first_page_granule( p_demux, i_pos, *pi_pos_upper,
+                                                     p_stream, &i_granule );
+        if ( i_pagepos < 0 || i_granule == -1 )
+            break;
+
+        vlc_tick_t i_pagetime = Ogg_GranuleToTime( p_stream, i_granule,
+                                                   !p_stream->b_contiguous, false );
+        if ( i_pagetime == VLC_TICK_INVALID )
+            break;
+
+        OggDebug( msg_Dbg( p_demux, "Interpolated %"PRId64" at %"PRId64" for %"PRId64,
+                           i_pagetime, i_pagepos, i_targettime ) );
+
+        if ( i_pagetime <= i_targettime )
+        {
+            if ( i_pagepos <= *pi_pos_lower )
+                break;
+            *pi_pos_lower = i_pagepos;
+            i_time_lower = i_pagetime;
+        }
+        else
+        {
+            /* Pages of this stream from there on all end after the target */
+            if ( i_pagepos >= *pi_pos_upper )
+                break;
+            *pi_pos_upper = i_pagepos;
+            i_time_upper = i_pagetime;
+        }
+    }
+}
+
 /* returns pos */
 static int64_t OggBisectSearchByTime( demux_t *p_demux, logical_stream_t *p_stream,
             vlc_tick_t i_targettime, int64_t i_pos_lower, int64_t i_pos_upper, int64_t *pi_seek_time)
@@ -806,8 +922,8 @@ int Oggseek_BlindSeektoAbsoluteTime( demux_t *p_demux, logical_stream_t *p_strea
     if ( i_lowerpos != -1 ) b_found = true;
 
     /* And also search in our own index */
-    vlc_tick_t foo;
-    if ( !b_found && OggSeekIndexFind( p_stream, i_time, &i_lowerpos, &i_upperpos, &foo ) )
+    vlc_tick_t foo, bar;
+    if ( !b_found && OggSeekIndexFind( p_stream, i_time, &i_lowerpos, &i_upperpos, &foo, &bar ) )
     {
         b_found = true;
     }
@@ -818,8 +934,13 @@ int Oggseek_BlindSeektoAbsoluteTime( demux_t *p_demux, logical_stream_t *p_strea
     if ( !b_found && b_fastseek )
     {
         int64_t i_sync_time;
+        int64_t i_searchlower = p_stream->i_data_start;
+        int64_t i_searchupper = p_sys->i_total_bytes;
+        OggInterpolateBounds( p_demux, p_stream, i_time,
+                              &i_searchlower, VLC_TICK_INVALID,
+                              &i_searchupper, VLC_TICK_INVALID );
         i_lowerpos = OggBisectSearchByTime( p_demux, p_stream, i_time,
-                                            p_stream->i_data_start, p_sys->i_total_bytes,
+                                            i_searchlower, i_searchupper,
                                             &i_sync_time );
         b_found = ( i_lowerpos != -1 );
     }
@@ -891,6 +1012,7 @@ int Oggseek_SeektoAbsolutetime( demux_t *p_demux, logical_stream_t *p_stream,
     demux_sys_t *p_sys  = p_demux->p_sys;
 
     OggDebug( msg_Dbg( p_demux, "=================== Seeking To Absolute Time %"PRId64, i_time ) );
+    const vlc_tick_t i_seek_start = vlc_tick_now();
     int64_t i_offset_lower = -1;
     int64_t i_offset_upper = -1;
 
@@ -908,12 +1030,18 @@ int Oggseek_SeektoAbsolutetime( demux_t *p_demux, logical_stream_t *p_stream,
 
 
     vlc_tick_t i_lower_index;
-    if(!OggSeekIndexFind( p_stream, i_time, &i_offset_lower, &i_offset_upper, &i_lower_index ))
+    vlc_tick_t i_upper_index = VLC_TICK_INVALID;
+    if(!OggSeekIndexFind( p_stream, i_time, &i_offset_lower, &i_offset_upper,
+                          &i_lower_index, &i_upper_index ))
         i_lower_index = 0;
 
     i_offset_lower = __MAX( i_offset_lower, p_stream->i_data_start );
     i_offset_upper = __MIN( i_offset_upper, p_sys->i_total_bytes );
 
+    OggInterpolateBounds( p_demux, p_stream, i_time,
+                          &i_offset_lower, i_lower_index,
+                          &i_offset_upper, i_upper_index );
+
     int64_t i_sync_time;
     int64_t i_pagepos = OggBisectSearchByTime( p_demux, p_stream, i_time,
                                        i_offset_lower, i_offset_upper, &i_sync_time );
@@ -926,13 +1054,13 @@ int Oggseek_SeektoAbsolutetime( demux_t *p_demux, logical_stream_t *p_stream,
     }
 
     /* Insert keyframe position into index */
-    vlc_tick_t index_interval = p_sys->i_length
-              ? vlc_tick_from_sec( ceil( sqrt( SEC_FROM_VLC_TICK( p_sys->i_length ) ) / 2 ) )
-              : vlc_tick_from_sec( 5 );
-    if ( i_pagepos >= p_stream->i_data_start && ( i_sync_time - i_lower_index >= index_interval ) )
+    if ( i_pagepos >= p_stream->i_data_start &&
+         ( i_sync_time - i_lower_index >= OggSeekIndexInterval( p_sys ) ) )
         OggSeek_IndexAdd( p_stream, i_sync_time, i_pagepos );
 
     OggDebug( msg_Dbg( p_demux, "=================== Seeked To %"PRId64" time %"PRId64, i_pagepos, i_time ) );
+    msg_Dbg( p_demux, "seek took %"PRId64" us (%zu index entries)",
+             US_FROM_VLC_TICK( vlc_tick_now() - i_seek_start ), p_stream->idx.i_count );
     return i_pagepos;
 }
 
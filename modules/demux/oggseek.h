@@ -43,8 +43,8 @@
 /* this is typedefed to demux_index_entry_t in ogg.h */
 struct oggseek_index_entry
 {
-    demux_index_entry_t *p_next;
-    /* value is highest granulepos for theora, sync frame for dirac */
+    /* time of the keyframe decoding can restart from at i_pagepos
+     * (not the page granule for theora/daala) */
     vlc_tick_t i_value;
     int64_t i_pagepos;
 };
@@ -53,8 +53,9 @@ int     Oggseek_BlindSeektoAbsoluteTime ( demux_t *, logical_stream_t *, vlc_tic
 int     Oggseek_BlindSeektoPosition ( demux_t *, logical_stream_t *, double f, bool );
 int     Oggseek_SeektoAbsolutetime ( demux_t *, logical_stream_t *, vlc_tick_t );
 const demux_index_entry_t *OggSeek_IndexAdd ( logical_stream_t *, vlc_tick_t, int64_t );
+void    OggSeek_IndexKeyframe ( demux_t *, logical_stream_t *, vlc_tick_t, int64_t );
 void    Oggseek_ProbeEnd( demux_t * );
 
-void oggseek_index_entries_free ( demux_index_entry_t * );
+void oggseek_index_entries_free ( logical_stream_t * );
 
 int64_t oggseek_read_page ( demux_t * );
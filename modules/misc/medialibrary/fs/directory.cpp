@@ -39,6 +39,7 @@
 #include <medialibrary/filesystem/Errors.h>
 #include <sys/stat.h>
 #include <system_error>
+#include <unordered_map>
 #include <vector>
 
 using InputItemPtr = vlc_shared_data_ptr_type(input_item_t,
@@ -65,16 +66,16 @@ SDDirectory::mrl() const
 const std::vector<std::shared_ptr<IFile>> &
 SDDirectory::files() const
 {
-    if ( !m_read_done )
-        read();
+    read();
     return m_files;
 }
 
 const std::vector<std::shared_ptr<IDirectory>> &
 SDDirectory::dirs() const
 {
-    if ( !m_read_done )
-        read();
+    read();
+    // The sub-directories are most likely browsed next
+    readAheadDirs();
     return m_dirs;
 }
 
@@ -88,26 +89,43 @@ SDDirectory::device() const
 
 std::shared_ptr<IFile> SDDirectory::file(const std::string& mrl) const
 {
-    auto fs = files();
+    read();
     // Don't compare entire mrls, this might yield false negative when a
     // device has multiple mountpoints.
-    auto fileName = utils::fileName( mrl );
-    auto it = std::find_if( cbegin( fs ), cend( fs ),
-                            [&fileName]( const std::shared_ptr<fs::IFile> f ) {
-                                return f->name() == fileName;
-                            });
-    if ( it == cend( fs ) )
+    auto it = m_index.find( utils::fileName( mrl ) );
+    if ( it == m_index.cend() )
         throw medialibrary::fs::errors::NotFound( mrl, m_mrl );
-    return *it;
+    return it->second;
 }
 
 bool SDDirectory::contains(const std::string& fileName) const
 {
-    auto fs = files();
-    return std::find_if( cbegin( fs ), cend( fs ),
-                         [&fileName]( const std::shared_ptr<fs::IFile> f ) {
-                             return f->name() == fileName;
-                         }) != cend( fs );
+    read();
+    return m_index.find( fileName ) != m_index.cend();
+}
+
+void SDDirectory::readAhead() const
+{
+    try
+    {
+        read();
+    }
+    catch ( const std::exception& )
+    {
+        // Thrown again when the directory is actually accessed
+    }
+}
+
+void SDDirectory::readAheadDirs() const
+{
+    {
+        vlc::threads::mutex_locker lock( m_mutex );
+        if ( m_read_ahead_dirs )
+            return;
+        m_read_ahead_dirs = true;
+    }
+    for ( const auto& dir : m_dirs )
+        m_fs.readAhead( std::static_pointer_cast<const SDDirectory>( dir ) );
 }
 
 struct metadata_request {
@@ -119,6 +137,8 @@ struct metadata_request {
     std::vector<InputItemPtr> *children;
 };
 
+using StatMap = std::unordered_map<std::string, struct stat>;
+
   } /* namespace medialibrary */
 } /* namespace vlc */
 
@@ -189,25 +209,114 @@ static bool request_metadata_sync( libvlc_int_t *libvlc, input_item_t *media,
     return req.success;
 }
 
+/*
+ * Lists a local directory directly, rather than through a preparser task.
+ * The entries go through the same readdir helper as the directory access, so
+ * that hidden files, ignored extensions and subtitles are handled the same
+ * way, and each entry is only stat'ed once.
+ */
+static void read_local_sync( libvlc_int_t *libvlc, input_item_t *media,
+                             std::vector<InputItemPtr> *out_children,
+                             StatMap *out_stats )
+{
+    const auto path = vlc::wrap_cptr( vlc_uri2path( media->psz_uri ) );
+    if ( path == nullptr )
+        throw medialibrary::fs::errors::System(
+            EINVAL, "Failed to browse directory: Invalid path" );
+
+    const auto dir = vlc::wrap_cptr( vlc_opendir( path.get() ), &vlc_closedir );
+    if ( dir == nullptr )
+        throw medialibrary::fs::errors::System(
+            errno, "Failed to browse directory" );
+
+    const auto node = vlc::wrap_cptr( input_item_node_Create( media ),
+                                      &input_item_node_Delete );
+    if ( node == nullptr )
+        throw std::bad_alloc();
+
+    struct vlc_readdir_helper rdh;
+    vlc_readdir_helper_init( &rdh, libvlc, node.get() );
+
+    int ret = VLC_SUCCESS;
+    const char *entry;
+    while ( ret == VLC_SUCCESS && ( entry = vlc_readdir( dir.get() ) ) != nullptr )
+    {
+        struct stat st;
+
+#ifdef HAVE_FSTATAT
+        if ( fstatat( dirfd( dir.get() ), entry, &st, 0 ) != 0 )
+            continue;
+#else
+        std::string entryPath = std::string{ path.get() } + DIR_SEP + entry;
+        if ( vlc_stat( entryPath.c_str(), &st ) != 0 )
+            continue;
+#endif
+        int type;
+        if ( S_ISREG( st.st_mode ) )
+            type = ITEM_TYPE_FILE;
+        else if ( S_ISDIR( st.st_mode ) )
+            type = ITEM_TYPE_DIRECTORY;
+        else
+            continue;
+
+        const auto encoded = vlc::wrap_cptr( vlc_uri_encode( entry ) );
+        if ( encoded == nullptr )
+        {
+            ret = VLC_ENOMEM;
+            break;
+        }
+        // The directory mrl always ends with a '/'
+        std::string mrl = std::string{ media->psz_uri } + encoded.get();
+
+        ret = vlc_readdir_helper_additem( &rdh, mrl.c_str(), nullptr, entry,
+                                          type, ITEM_NET_UNKNOWN, nullptr );
+        if ( ret == VLC_SUCCESS && type == ITEM_TYPE_FILE )
+            out_stats->emplace( std::move( mrl ), st );
+    }
+    vlc_readdir_helper_finish( &rdh, ret == VLC_SUCCESS );
+
+    if ( ret != VLC_SUCCESS )
+        throw std::bad_alloc();
+
+    for ( int i = 0; i < node->i_children; ++i )
+        out_children->emplace_back( node->pp_children[i]->p_item );
+}
+
 void
 SDDirectory::read() const
 {
+    // Also waits for a read ahead of this directory in progress
+    vlc::threads::mutex_locker lock( m_mutex );
+    if ( m_read_done )
+        return;
+
     auto media =
         vlc::wrap_cptr( input_item_New( m_mrl.c_str(), m_mrl.c_str() ), &input_item_Release );
     if ( !media )
         throw std::bad_alloc();
 
     std::vector<InputItemPtr> children;
+    StatMap stats;
 
     input_item_AddOption( media.get(), "show-hiddenfiles", VLC_INPUT_OPTION_TRUSTED );
     input_item_AddOption( media.get(), "ignore-filetypes=''", VLC_INPUT_OPTION_TRUSTED );
     input_item_AddOption( media.get(), "sub-autodetect-fuzzy=2", VLC_INPUT_OPTION_TRUSTED );
-    auto status = request_metadata_sync( m_fs.libvlc(), media.get(), &children );
 
-    if ( status == false )
+    if ( m_fs.isNetworkFileSystem() == false )
+        read_local_sync( m_fs.libvlc(), media.get(), &children, &stats );
+    else if ( request_metadata_sync( m_fs.libvlc(), media.get(), &children ) == false )
         throw medialibrary::fs::errors::System(
             EIO, "Failed to browse directory: Unknown error" );
 
+    auto statOf = [&stats]( const char* mrl ) -> const struct stat* {
+        auto it = stats.find( mrl );
+        return it != stats.cend() ? &it->second : nullptr;
+    };
+
+    m_files.clear();
+    m_dirs.clear();
+    m_index.clear();
+
     for ( const InputItemPtr& m : children )
     {
         const char* mrl = m.get()->psz_uri;
@@ -218,7 +327,7 @@ SDDirectory::read() const
         }
         else if ( type == ITEM_TYPE_FILE )
         {
-            addFile( mrl, IFile::LinkedFileType::None, {} );
+            addFile( mrl, IFile::LinkedFileType::None, {}, statOf( mrl ) );
             for ( auto i = 0; i < m->i_slaves; ++i )
             {
                 const auto* slave = m->pp_slaves[i];
@@ -226,33 +335,43 @@ SDDirectory::read() const
                                              ? IFile::LinkedFileType::SoundTrack
                                              : IFile::LinkedFileType::Subtitles;
 
-                addFile( slave->psz_uri, linked_type, mrl );
+                addFile( slave->psz_uri, linked_type, mrl, statOf( slave->psz_uri ) );
             }
         }
     }
 
+    // Keep the first file of a given name, as the former linear lookup did
+    for ( const auto& f : m_files )
+        m_index.emplace( f->name(), f );
+
     m_read_done = true;
 }
 
 void
-SDDirectory::addFile(std::string mrl, IFile::LinkedFileType fType, std::string linkedFile) const
+SDDirectory::addFile(std::string mrl, IFile::LinkedFileType fType, std::string linkedFile,
+                     const struct stat *st) const
 {
     time_t lastModificationDate = 0;
     uint64_t fileSize = 0;
 
     if ( m_fs.isNetworkFileSystem() == false )
     {
-        const auto path = vlc::wrap_cptr( vlc_uri2path( mrl.c_str() ) );
         struct stat stat;
 
-        if ( vlc_stat( path.get(), &stat ) != 0 )
+        if ( st == nullptr )
         {
-            if ( errno == EACCES )
-                return;
-            throw errors::System{ errno, "Failed to get file info" };
+            const auto path = vlc::wrap_cptr( vlc_uri2path( mrl.c_str() ) );
+
+            if ( vlc_stat( path.get(), &stat ) != 0 )
+            {
+                if ( errno == EACCES )
+                    return;
+                throw errors::System{ errno, "Failed to get file info" };
+            }
+            st = &stat;
         }
-        lastModificationDate = stat.st_mtime;
-        fileSize = stat.st_size;
+        lastModificationDate = st->st_mtime;
+        fileSize = st->st_size;
     }
 
     if ( fType == IFile::LinkedFileType::None )
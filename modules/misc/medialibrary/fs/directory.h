@@ -24,6 +24,10 @@
 #include <medialibrary/filesystem/IDirectory.h>
 #include <medialibrary/filesystem/IFile.h>
 
+#include <string>
+#include <unordered_map>
+#include <sys/stat.h>
+
 #include "fs.h"
 
 namespace vlc {
@@ -42,16 +46,28 @@ public:
     std::shared_ptr<fs::IFile> file( const std::string& mrl ) const override;
     bool contains( const std::string& file ) const override;
 
+    /**
+     * Reads the directory from a worker thread, before it is accessed.
+     * Errors are ignored, and reported by the next regular access.
+     */
+    void readAhead() const;
+
 private:
     void read() const;
-    void addFile( std::string mrl, fs::IFile::LinkedFileType, std::string linkedWith ) const;
+    void readAheadDirs() const;
+    void addFile( std::string mrl, fs::IFile::LinkedFileType, std::string linkedWith,
+                  const struct stat *st ) const;
 
     std::string m_mrl;
     SDFileSystemFactory &m_fs;
 
+    mutable vlc::threads::mutex m_mutex;
     mutable bool m_read_done = false;
+    mutable bool m_read_ahead_dirs = false;
     mutable std::vector<std::shared_ptr<fs::IFile>> m_files;
     mutable std::vector<std::shared_ptr<fs::IDirectory>> m_dirs;
+    /* file name -> file */
+    mutable std::unordered_map<std::string, std::shared_ptr<fs::IFile>> m_index;
     mutable std::shared_ptr<IDevice> m_device;
 };
 
@@ -38,6 +38,17 @@ namespace vlc {
 
 using namespace ::medialibrary;
 
+/* Directories read ahead concurrently, the disk (or share) is the bottleneck */
+#define READ_AHEAD_THREADS 4
+
+struct SDFileSystemFactory::ReadAheadTask
+{
+    SDFileSystemFactory *fs;
+    std::shared_ptr<const SDDirectory> dir;
+    std::list<ReadAheadTask>::iterator self;
+    struct vlc_runnable runnable;
+};
+
 SDFileSystemFactory::SDFileSystemFactory(vlc_object_t *parent,
                                          const std::string &scheme)
     : m_parent(parent)
@@ -46,6 +57,28 @@ SDFileSystemFactory::SDFileSystemFactory(vlc_object_t *parent,
 {
     m_isNetwork = strncasecmp( m_scheme.c_str(), "file://",
                                m_scheme.length() ) != 0;
+    // Network shares are browsed through the preparser, one at a time
+    if ( m_isNetwork == false )
+        m_executor = vlc_executor_New( READ_AHEAD_THREADS );
+}
+
+SDFileSystemFactory::~SDFileSystemFactory()
+{
+    if ( m_executor == nullptr )
+        return;
+
+    {
+        vlc::threads::mutex_locker lock( m_readAheadMutex );
+        for ( auto it = m_readAheads.begin(); it != m_readAheads.end(); )
+        {
+            if ( vlc_executor_Cancel( m_executor, &it->runnable ) )
+                it = m_readAheads.erase( it );
+            else
+                ++it;
+        }
+    }
+    vlc_executor_WaitIdle( m_executor );
+    vlc_executor_Delete( m_executor );
 }
 
 bool SDFileSystemFactory::initialize(const IMediaLibrary* ml)
@@ -175,6 +208,33 @@ void vlc::medialibrary::SDFileSystemFactory::onDeviceUnmounted(const std::string
     m_callbacks->onDeviceUnmounted(*device, mountpoint);
 }
 
+void SDFileSystemFactory::readAhead(std::shared_ptr<const SDDirectory> dir)
+{
+    if ( m_executor == nullptr )
+        return;
+
+    vlc::threads::mutex_locker lock( m_readAheadMutex );
+    m_readAheads.emplace_front();
+
+    auto& task = m_readAheads.front();
+    task.fs = this;
+    task.dir = std::move( dir );
+    task.self = m_readAheads.begin();
+    task.runnable.run = []( void *data ) {
+        auto task = static_cast<ReadAheadTask *>( data );
+        task->dir->readAhead();
+        task->fs->readAheadDone( task );
+    };
+    task.runnable.userdata = &task;
+    vlc_executor_Submit( m_executor, &task.runnable );
+}
+
+void SDFileSystemFactory::readAheadDone(ReadAheadTask *task)
+{
+    vlc::threads::mutex_locker lock( m_readAheadMutex );
+    m_readAheads.erase( task->self );
+}
+
 bool SDFileSystemFactory::waitForDevice(const std::string& mrl,
                                         uint32_t timeout) const
 {
@@ -21,9 +21,11 @@
 #ifndef SD_FS_H
 #define SD_FS_H
 
+#include <list>
 #include <memory>
 #include <vector>
 #include <vlc_common.h>
+#include <vlc_executor.h>
 #include <vlc_threads.h>
 #include <vlc_cxx_helpers.hpp>
 #include <medialibrary/filesystem/IFileSystemFactory.h>
@@ -42,10 +44,13 @@ namespace vlc {
 using namespace ::medialibrary;
 using namespace ::medialibrary::fs;
 
+class SDDirectory;
+
 class SDFileSystemFactory : public IFileSystemFactory, private IDeviceListerCb {
 public:
     SDFileSystemFactory(vlc_object_t *m_parent,
                         const std::string &scheme);
+    ~SDFileSystemFactory();
 
     bool
     initialize( const IMediaLibrary* ml ) override;
@@ -92,7 +97,17 @@ public:
     bool
     waitForDevice(const std::string& mrl, uint32_t timeout) const override;
 
+    /**
+     * Reads the directory ahead on the worker pool, for local file systems.
+     */
+    void
+    readAhead(std::shared_ptr<const SDDirectory> dir);
+
 private:
+    struct ReadAheadTask;
+
+    void readAheadDone(ReadAheadTask *task);
+
     std::shared_ptr<fs::IDevice>
     deviceByUuid(const std::string& uuid);
 
@@ -110,6 +125,10 @@ private:
     mutable vlc::threads::condition_variable m_cond;
     std::vector<std::shared_ptr<IDevice>> m_devices;
     std::shared_ptr<IDeviceLister> m_deviceLister;
+
+    vlc_executor_t *m_executor = nullptr;
+    vlc::threads::mutex m_readAheadMutex;
+    std::list<ReadAheadTask> m_readAheads;
 };
 
   } /* namespace medialibrary */
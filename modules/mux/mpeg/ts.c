@@ -161,6 +161,12 @@ static const char *const ts_standards_list_text[] =
   "stream, compared to the PCRs. This allows for some buffering inside " \
   "the client decoder.")
 
+#define MUXRATE_TEXT N_("Mux rate (bits/s)")
+#define MUXRATE_LONGTEXT N_("Output a constant bitrate transport stream, " \
+  "padded with null packets, at the given rate. PCRs are then computed " \
+  "from the position of the packets in the output. 0 produces a variable " \
+  "bitrate stream.")
+
 #define ACRYPT_TEXT N_("Crypt audio")
 #define ACRYPT_LONGTEXT N_("Crypt audio using CSA")
 #define VCRYPT_TEXT N_("Crypt video")
@@ -222,6 +228,8 @@ vlc_module_begin ()
 
     add_integer( SOUT_CFG_PREFIX "pcr", 70, PCR_TEXT, PCR_LONGTEXT)
     add_integer( SOUT_CFG_PREFIX "dts-delay", 400, DTS_TEXT, DTS_LONGTEXT)
+    add_integer( SOUT_CFG_PREFIX "muxrate", 0, MUXRATE_TEXT, MUXRATE_LONGTEXT)
+        change_integer_range( 0, 1000000000 )
 
     add_obsolete_integer( "sout-ts-bmin" ) /* since 4.0.0 */
     add_obsolete_integer( "sout-ts-bmax" ) /* since 4.0.0 */
@@ -244,7 +252,7 @@ static const char *const ppsz_sout_options[] = {
     "pid-video", "pid-audio", "pid-spu", "pid-pmt", "tsid",
     "netid", "sdtdesc",
     "es-id-pid", "shaping", "pcr", "use-key-frames",
-    "dts-delay", "csa-ck", "csa2-ck", "csa-use", "csa-pkt", "crypt-audio", "crypt-video",
+    "dts-delay", "muxrate", "csa-ck", "csa2-ck", "csa-use", "csa-pkt", "crypt-audio", "crypt-video",
     "muxpmt", "program-pmt", "alignment",
     NULL
 };
@@ -301,6 +309,20 @@ static inline void BufferChainClean( sout_buffer_chain_t *c )
     BufferChainInit( c );
 }
 
+/* TS packet built in place in an output frame */
+typedef struct
+{
+    uint8_t    *p_buffer;
+    vlc_tick_t  i_dts;
+    vlc_tick_t  i_length;
+    uint32_t    i_flags;
+} ts_packet_t;
+
+/* Default output frame size when the access has no preference: one
+ * Ethernet datagram. Frames are dated by their first packet, so they must
+ * stay small for the outputs that pace or split them. */
+#define TS_FRAME_PACKETS 7
+
 typedef struct
 {
     sout_buffer_chain_t chain_pes;
@@ -356,6 +378,31 @@ typedef struct
 
     vlc_tick_t      i_pcr;  /* last PCR emitted */
 
+    /* Constant bitrate output */
+    struct
+    {
+        uint64_t    i_rate;     /* bits/s, 0 for variable bitrate */
+        bool        b_started;
+        uint64_t    i_clock;    /* 27MHz output clock of the next packet */
+        uint64_t    i_clock_rem;
+        uint64_t    i_step;     /* 27MHz duration of a packet */
+        uint64_t    i_step_rem;
+    } cbr;
+
+    /* TS packets of the current muxing round, written directly into the
+     * output frames */
+    struct
+    {
+        block_t     *p_first;   /* output frames */
+        block_t    **pp_last;
+        block_t     *p_frame;   /* frame being filled, NULL to start a new one */
+        size_t       i_frame_packets;
+        ts_packet_t *p_list;
+        size_t       i_count;
+        size_t       i_alloc;
+        bool         b_error;
+    } packets;
+
     csa_t           *csa;
     int             i_csa_pkt_size;
     bool            b_crypt_audio;
@@ -448,15 +495,18 @@ static int Mux      ( sout_mux_t * );
 
 static block_t *FixPES( sout_mux_t *p_mux, block_fifo_t *p_fifo );
 static block_t *Add_ADTS( block_t *, const es_format_t * );
-static int TSSchedule   ( sout_mux_t *p_mux, sout_buffer_chain_t *p_chain_ts,
+static void TSSchedule  ( sout_mux_t *p_mux, int i_first, int i_packet_count,
                           vlc_tick_t i_pcr_length, vlc_tick_t i_pcr_dts );
-static int TSDate       ( sout_mux_t *p_mux, sout_buffer_chain_t *p_chain_ts,
+static void TSDate      ( sout_mux_t *p_mux, int i_first, int i_packet_count,
                           vlc_tick_t i_pcr_length, vlc_tick_t i_pcr_dts );
-static void GetPAT( sout_mux_t *p_mux, sout_buffer_chain_t *c );
-static void GetPMT( sout_mux_t *p_mux, sout_buffer_chain_t *c );
+static void TSDateCBR   ( sout_mux_t *p_mux );
+static int TSSend       ( sout_mux_t *p_mux );
+static void GetPAT( sout_mux_t *p_mux );
+static void GetPMT( sout_mux_t *p_mux );
 
-static block_t *TSNew( sout_mux_t *p_mux, sout_input_sys_t *p_stream, bool b_pcr );
-static void TSSetPCR( block_t *p_ts, vlc_tick_t i_dts );
+static ts_packet_t *TSNew( sout_mux_t *p_mux, sout_input_sys_t *p_stream, bool b_pcr );
+static void TSSetPCR( uint8_t *p_ts, vlc_tick_t i_dts );
+static void TSWritePCR( uint8_t *p_ts, uint64_t i_pcr );
 
 static void csaSetup( vlc_object_t *p_this )
 {
@@ -702,6 +752,28 @@ static int Open( vlc_object_t *p_this )
 
     p_sys->b_use_key_frames = var_GetBool( p_mux, SOUT_CFG_PREFIX "use-key-frames" );
 
+    p_sys->cbr.i_rate = var_GetInteger( p_mux, SOUT_CFG_PREFIX "muxrate" );
+    if( p_sys->cbr.i_rate > 0 )
+    {
+        const uint64_t i_packet_bits = UINT64_C(188 * 8 * 27000000);
+
+        p_sys->cbr.i_step = i_packet_bits / p_sys->cbr.i_rate;
+        p_sys->cbr.i_step_rem = i_packet_bits % p_sys->cbr.i_rate;
+        msg_Dbg( p_mux, "constant bitrate %"PRIu64" bits/s", p_sys->cbr.i_rate );
+    }
+
+    /* Build the packets directly in frames of the size the access output
+     * prefers to write (e.g. one datagram) */
+    size_t i_write_size;
+    if( sout_AccessOutControl( p_mux->p_access, ACCESS_OUT_GET_WRITE_SIZE,
+                               &i_write_size ) == VLC_SUCCESS )
+        p_sys->packets.i_frame_packets = __MAX( i_write_size / 188, 1 );
+    else
+        p_sys->packets.i_frame_packets = TS_FRAME_PACKETS;
+    p_sys->packets.pp_last = &p_sys->packets.p_first;
+    msg_Dbg( p_mux, "writing %zu TS packets per frame",
+             p_sys->packets.i_frame_packets );
+
     p_mux->p_sys        = p_sys;
 
     csaSetup( p_this );
@@ -739,6 +811,7 @@ static void Close( vlc_object_t * p_this )
         free( p_sys->sdt.desc[i].psz_provider );
     }
 
+    free( p_sys->packets.p_list );
     free( p_sys );
 }
 
@@ -992,16 +1065,132 @@ static void DelStream( sout_mux_t *p_mux, sout_input_t *p_input )
     p_sys->i_pmt_version_number %= 32;
 }
 
-static void SetHeader( sout_buffer_chain_t *c,
-                        int depth )
+/* Flags a packet as stream header. It must start a frame of its own, as
+ * the access outputs handle the header flag per frame. */
+static void SetHeader( sout_mux_sys_t *p_sys, size_t i_packet )
 {
-    block_t *p_ts = BufferChainPeek( c );
-    while( depth > 0 )
+    if( likely(i_packet < p_sys->packets.i_count) )
+        p_sys->packets.p_list[i_packet].i_flags |= BLOCK_FLAG_HEADER;
+}
+
+/* Makes the next TS packet start a new output frame */
+static void TSBreak( sout_mux_sys_t *p_sys )
+{
+    p_sys->packets.p_frame = NULL;
+}
+
+/* Returns room for the next TS packet in the current output frame */
+static ts_packet_t *TSPacketNew( sout_mux_sys_t *p_sys )
+{
+    if( p_sys->packets.i_count == p_sys->packets.i_alloc )
     {
-        p_ts = p_ts->p_next;
-        depth--;
+        size_t i_alloc = p_sys->packets.i_alloc ? p_sys->packets.i_alloc * 2
+                                                : 256;
+        ts_packet_t *p_list = vlc_reallocarray( p_sys->packets.p_list,
+                                                i_alloc, sizeof(*p_list) );
+        if( unlikely(p_list == NULL) )
+            return NULL;
+        p_sys->packets.p_list = p_list;
+        p_sys->packets.i_alloc = i_alloc;
+    }
+
+    const size_t i_frame_size = p_sys->packets.i_frame_packets * 188;
+    block_t *p_frame = p_sys->packets.p_frame;
+    if( p_frame == NULL || p_frame->i_buffer >= i_frame_size )
+    {
+        p_frame = block_Alloc( i_frame_size );
+        if( unlikely(p_frame == NULL) )
+            return NULL;
+        p_frame->i_buffer = 0;
+        block_ChainLastAppend( &p_sys->packets.pp_last, p_frame );
+        p_sys->packets.p_frame = p_frame;
+    }
+
+    ts_packet_t *p_ts = &p_sys->packets.p_list[p_sys->packets.i_count++];
+    p_ts->p_buffer = &p_frame->p_buffer[p_frame->i_buffer];
+    p_ts->i_dts = 0;
+    p_ts->i_length = 0;
+    p_ts->i_flags = 0;
+    p_frame->i_buffer += 188;
+    return p_ts;
+}
+
+/* PSI tables callback: copies the packets into the output frames */
+static void TSPacketsAppend( void *p_opaque, block_t *p_chain )
+{
+    sout_mux_sys_t *p_sys = p_opaque;
+
+    for( block_t *p_ts = p_chain; p_ts != NULL; p_ts = p_ts->p_next )
+    {
+        ts_packet_t *p_packet = TSPacketNew( p_sys );
+        if( unlikely(p_packet == NULL) )
+        {
+            p_sys->packets.b_error = true;
+            break;
+        }
+        memcpy( p_packet->p_buffer, p_ts->p_buffer, 188 );
+        p_packet->i_dts = p_ts->i_dts;
+    }
+    block_ChainRelease( p_chain );
+}
+
+/* Constant bitrate: time at which a packet of the round will be output */
+static vlc_tick_t CBRSlotTime( sout_mux_sys_t *p_sys, size_t i_packet )
+{
+    return p_sys->first_dts + VLC_TICK_FROM_US(p_sys->cbr.i_clock / 27) +
+           vlc_tick_from_samples( i_packet * 188 * 8, p_sys->cbr.i_rate );
+}
+
+/* Constant bitrate: number of packets to output until a given time */
+static size_t CBRSlotCount( sout_mux_sys_t *p_sys, vlc_tick_t i_end )
+{
+    vlc_tick_t i_duration = i_end - CBRSlotTime( p_sys, 0 );
+    if( i_duration <= 0 )
+        return 0;
+    return samples_from_vlc_tick( i_duration, p_sys->cbr.i_rate ) / (188 * 8);
+}
+
+/* Constant bitrate: fills slots with null packets, or with PCR only
+ * packets on the PCR PID when a PCR is due */
+static void TSStuff( sout_mux_t *p_mux, size_t i_count )
+{
+    sout_mux_sys_t *p_sys = p_mux->p_sys;
+    sout_input_sys_t *p_pcr_stream = (sout_input_sys_t*)p_sys->p_pcr_input->p_sys;
+
+    while( i_count-- > 0 )
+    {
+        ts_packet_t *p_ts = TSPacketNew( p_sys );
+        if( unlikely(p_ts == NULL) )
+        {
+            p_sys->packets.b_error = true;
+            return;
+        }
+
+        uint8_t *p = p_ts->p_buffer;
+        vlc_tick_t i_time = CBRSlotTime( p_sys, p_sys->packets.i_count - 1 );
+        if( i_time >= p_sys->i_pcr + p_sys->i_pcr_delay )
+        {
+            /* adaptation field only: the continuity counter is not
+             * incremented */
+            p[0] = 0x47;
+            p[1] = ( p_pcr_stream->ts.i_pid >> 8 )&0x1f;
+            p[2] = p_pcr_stream->ts.i_pid & 0xff;
+            p[3] = 0x20 | ( ( p_pcr_stream->ts.i_continuity_counter + 15 )%16 );
+            p[4] = 183;
+            p[5] = 1 << 4; /* PCR_flag */
+            memset( &p[12], 0xff, 188 - 12 );
+            p_ts->i_flags = BLOCK_FLAG_FOR_PCR;
+            p_sys->i_pcr = i_time;
+        }
+        else
+        {
+            p[0] = 0x47;
+            p[1] = 0x1f; /* null PID */
+            p[2] = 0xff;
+            p[3] = 0x10;
+            memset( &p[4], 0xff, 188 - 4 );
+        }
     }
-    p_ts->i_flags |= BLOCK_FLAG_HEADER;
 }
 
 static block_t *Pack_Opus(block_t *p_data)
@@ -1151,7 +1340,6 @@ static int MuxStreams( sout_mux_t *p_mux )
     sout_mux_sys_t  *p_sys = p_mux->p_sys;
     sout_input_sys_t *p_pcr_stream = (sout_input_sys_t*)p_sys->p_pcr_input->p_sys;
 
-    sout_buffer_chain_t chain_ts;
     vlc_tick_t i_shaping_delay = p_pcr_stream->state.b_key_frame
         ? p_pcr_stream->state.i_pes_length
         : p_sys->i_shaping_delay;
@@ -1439,17 +1627,41 @@ static int MuxStreams( sout_mux_t *p_mux )
     /* add overhead for PCR (not really exact) */
     i_packet_count += (8 * i_pcr_length / p_sys->i_pcr_delay + 175) / 176;
 
+    const vlc_tick_t i_pcr_dts = p_pcr_stream->state.i_pes_dts;
+    size_t i_slots = 0;
+    int i_stuffing = 0;
+    if( p_sys->cbr.i_rate > 0 )
+    {
+        /* The output clock starts with the first round, then only moves
+         * with the number of packets written */
+        if( !p_sys->cbr.b_started ||
+            i_pcr_dts > CBRSlotTime( p_sys, 0 ) + p_sys->i_dts_delay )
+        {
+            if( p_sys->cbr.b_started )
+                msg_Warn( p_mux, "input gap, resetting the output clock" );
+            p_sys->cbr.i_clock = 27 * __MAX(i_pcr_dts - p_sys->first_dts, 0);
+            p_sys->cbr.i_clock_rem = 0;
+            p_sys->cbr.b_started = true;
+        }
+        i_slots = CBRSlotCount( p_sys, i_pcr_dts + i_pcr_length );
+    }
+
     /* 3: mux PES into TS */
-    BufferChainInit( &chain_ts );
     /* append PAT/PMT  -> FIXME with big pcr delay it won't have enough pat/pmt */
     bool pat_was_previous = true; //This is to prevent unnecessary double PAT/PMT insertions
-    GetPAT( p_mux, &chain_ts );
-    GetPMT( p_mux, &chain_ts );
+    GetPAT( p_mux );
+    /* The PAT may have to be flagged as header, keep it alone in its frame */
+    if( p_sys->b_use_key_frames )
+        TSBreak( p_sys );
+    GetPMT( p_mux );
     int i_packet_pos = 0;
-    i_packet_count += chain_ts.i_depth;
+    int i_stuffed = 0;
+    i_packet_count += p_sys->packets.i_count;
     /* msg_Dbg( p_mux, "estimated pck=%d", i_packet_count ); */
+    /* the PSI packets take slots too, count them before stuffing */
+    if( p_sys->cbr.i_rate > 0 )
+        i_stuffing = (int)i_slots - i_packet_count;
 
-    const vlc_tick_t i_pcr_dts = p_pcr_stream->state.i_pes_dts;
     for (;;)
     {
         int          i_stream = -1;
@@ -1479,9 +1691,22 @@ static int MuxStreams( sout_mux_t *p_mux )
         p_stream = (sout_input_sys_t*)p_mux->pp_inputs[i_stream]->p_sys;
         sout_input_t *p_input = p_mux->pp_inputs[i_stream];
 
+        /* spread the null packets evenly between the packets of the round */
+        if( i_stuffing > 0 )
+        {
+            int i_due = (int64_t)i_stuffing * i_packet_pos / i_packet_count;
+            if( i_due > i_stuffed )
+            {
+                TSStuff( p_mux, i_due - i_stuffed );
+                i_stuffed = i_due;
+            }
+        }
+
         /* do we need to issue pcr */
         bool b_pcr = false;
-        vlc_tick_t packet_length = i_pcr_length * i_packet_pos / i_packet_count;
+        vlc_tick_t packet_length = p_sys->cbr.i_rate > 0
+            ? CBRSlotTime( p_sys, p_sys->packets.i_count ) - i_pcr_dts
+            : i_pcr_length * i_packet_pos / i_packet_count;
         if( p_stream == p_pcr_stream &&
             i_pcr_dts + packet_length >=
             p_sys->i_pcr + p_sys->i_pcr_delay )
@@ -1490,39 +1715,59 @@ static int MuxStreams( sout_mux_t *p_mux )
             p_sys->i_pcr = i_pcr_dts + packet_length;
         }
 
-        /* Build the TS packet */
-        block_t *p_ts = TSNew( p_mux, p_stream, b_pcr );
-        if( p_stream->ts.b_scramble )
-            p_ts->i_flags |= BLOCK_FLAG_SCRAMBLED;
-
-        i_packet_pos++;
-
         /* Write PAT/PMT before every keyframe if use-key-frames is enabled,
          * this helps to do segmenting with livehttp-output so it can cut segment
          * and start new one with pat,pmt,keyframe*/
+        const block_t *p_pes = p_stream->state.chain_pes.p_first;
         if( ( p_sys->b_use_key_frames ) &&
             ( p_input->p_fmt->i_cat == VIDEO_ES ) &&
-            ( p_ts->i_flags & BLOCK_FLAG_TYPE_I ) )
+            p_stream->state.i_pes_used <= 0 &&
+            ( p_pes->i_flags & BLOCK_FLAG_TYPE_I ) &&
+            !( p_pes->i_flags & BLOCK_FLAG_NO_KEYFRAME ) )
         {
             if( likely( !pat_was_previous ) )
             {
-                int startcount = chain_ts.i_depth;
-                GetPAT( p_mux, &chain_ts );
-                GetPMT( p_mux, &chain_ts );
-                SetHeader( &chain_ts, startcount );
-                i_packet_count += (chain_ts.i_depth - startcount );
+                size_t startcount = p_sys->packets.i_count;
+                TSBreak( p_sys );
+                GetPAT( p_mux );
+                TSBreak( p_sys );
+                GetPMT( p_mux );
+                SetHeader( p_sys, startcount );
+                i_packet_count += p_sys->packets.i_count - startcount;
+                if( p_sys->cbr.i_rate > 0 )
+                    i_stuffing = (int)i_slots - i_packet_count;
             } else {
-                SetHeader( &chain_ts, 0); //We just inserted pat/pmt,so just flag it instead of adding new one
+                SetHeader( p_sys, 0); //We just inserted pat/pmt,so just flag it instead of adding new one
             }
         }
         pat_was_previous = false;
 
-        /* */
-        BufferChainAppend( &chain_ts, p_ts );
+        /* Build the TS packet */
+        ts_packet_t *p_ts = TSNew( p_mux, p_stream, b_pcr );
+        if( unlikely(p_ts == NULL) )
+        {
+            p_sys->packets.b_error = true;
+            break;
+        }
+        if( p_stream->ts.b_scramble )
+            p_ts->i_flags |= BLOCK_FLAG_SCRAMBLED;
+
+        i_packet_pos++;
     }
 
     /* 4: date and send */
-    return TSSchedule( p_mux, &chain_ts, i_pcr_length, i_pcr_dts );
+    if( p_sys->cbr.i_rate > 0 )
+    {
+        if( p_sys->packets.i_count < i_slots )
+            TSStuff( p_mux, i_slots - p_sys->packets.i_count );
+        else if( p_sys->packets.i_count > i_slots )
+            msg_Warn( p_mux, "muxrate too low, %zu packets late",
+                      p_sys->packets.i_count - i_slots );
+        TSDateCBR( p_mux );
+    }
+    else
+        TSSchedule( p_mux, 0, p_sys->packets.i_count, i_pcr_length, i_pcr_dts );
+    return TSSend( p_mux );
 }
 
 /*****************************************************************************
@@ -1656,14 +1901,11 @@ static block_t *Add_ADTS( block_t *p_data, const es_format_t *p_fmt )
     return p_new_block;
 }
 
-static int TSSchedule( sout_mux_t *p_mux, sout_buffer_chain_t *p_chain_ts,
-                       vlc_tick_t i_pcr_length, vlc_tick_t i_pcr_dts )
+static void TSSchedule( sout_mux_t *p_mux, int i_first, int i_packet_count,
+                        vlc_tick_t i_pcr_length, vlc_tick_t i_pcr_dts )
 {
     sout_mux_sys_t  *p_sys = p_mux->p_sys;
-    sout_buffer_chain_t new_chain;
-    int i_packet_count = p_chain_ts->i_depth;
-
-    BufferChainInit( &new_chain );
+    const ts_packet_t *p_list = &p_sys->packets.p_list[i_first];
 
     if ( unlikely(i_pcr_length <= 0) )
     {
@@ -1672,56 +1914,46 @@ static int TSSchedule( sout_mux_t *p_mux, sout_buffer_chain_t *p_chain_ts,
 
     for (int i = 0; i < i_packet_count; i++ )
     {
-        block_t *p_ts = BufferChainGet( p_chain_ts );
+        const ts_packet_t *p_ts = &p_list[i];
         vlc_tick_t i_new_dts = i_pcr_dts + i_pcr_length * i / i_packet_count;
 
-        BufferChainAppend( &new_chain, p_ts );
-
         if (!p_ts->i_dts || p_ts->i_dts + p_sys->i_dts_delay * 2/3 >= i_new_dts)
             continue;
 
         vlc_tick_t i_max_diff = i_new_dts - p_ts->i_dts;
         vlc_tick_t i_cut_dts = p_ts->i_dts;
+        int i_cut = i + 1;
 
-        while( (p_ts = BufferChainPeek( p_chain_ts )) )
+        for( int j = i; i_cut < i_packet_count; i_cut++ )
         {
-            i_new_dts = i_pcr_dts + i_pcr_length * i++ / i_packet_count;
+            p_ts = &p_list[i_cut];
+            i_new_dts = i_pcr_dts + i_pcr_length * j++ / i_packet_count;
             if( p_ts->i_dts >= i_pcr_dts &&
                 i_new_dts - p_ts->i_dts >= i_max_diff )
                break;
-            p_ts = BufferChainGet( p_chain_ts );
-            BufferChainAppend( &new_chain, p_ts );
             i_max_diff = i_new_dts - p_ts->i_dts;
             i_cut_dts = p_ts->i_dts;
         }
-        msg_Dbg( p_mux, "adjusting rate at %"PRId64"/%"PRId64" (%zu/%zu)",
-                 i_cut_dts - i_pcr_dts, i_pcr_length, new_chain.i_depth,
-                 p_chain_ts->i_depth );
-        int status = VLC_SUCCESS;
-        if( new_chain.i_depth )
+        msg_Dbg( p_mux, "adjusting rate at %"PRId64"/%"PRId64" (%d/%d)",
+                 i_cut_dts - i_pcr_dts, i_pcr_length, i_cut,
+                 i_packet_count - i_cut );
+        TSDate( p_mux, i_first, i_cut, i_cut_dts - i_pcr_dts, i_pcr_dts );
+        if( i_cut < i_packet_count )
         {
-            status = TSDate( p_mux, &new_chain, i_cut_dts - i_pcr_dts,
-                             i_pcr_dts );
+            TSSchedule( p_mux, i_first + i_cut, i_packet_count - i_cut,
+                        i_pcr_dts + i_pcr_length - i_cut_dts, i_cut_dts );
         }
-        if( p_chain_ts->i_depth && status == VLC_SUCCESS )
-        {
-            status = TSSchedule( p_mux, p_chain_ts,
-                                 i_pcr_dts + i_pcr_length - i_cut_dts,
-                                 i_cut_dts );
-        }
-        return status;
+        return;
     }
 
-    if ( new_chain.i_depth )
-        return TSDate( p_mux, &new_chain, i_pcr_length, i_pcr_dts );
-    return VLC_SUCCESS;
+    if ( i_packet_count > 0 )
+        TSDate( p_mux, i_first, i_packet_count, i_pcr_length, i_pcr_dts );
 }
 
-static int TSDate( sout_mux_t *p_mux, sout_buffer_chain_t *p_chain_ts,
-                   vlc_tick_t i_pcr_length, vlc_tick_t i_pcr_dts )
+static void TSDate( sout_mux_t *p_mux, int i_first, int i_packet_count,
+                    vlc_tick_t i_pcr_length, vlc_tick_t i_pcr_dts )
 {
     sout_mux_sys_t  *p_sys = p_mux->p_sys;
-    int i_packet_count = p_chain_ts->i_depth;
 
     if ( unlikely(i_pcr_length / 1000 <= 0) )
     {
@@ -1731,11 +1963,9 @@ static int TSDate( sout_mux_t *p_mux, sout_buffer_chain_t *p_chain_ts,
     }
 
     /* msg_Dbg( p_mux, "real pck=%d", i_packet_count ); */
-    block_t *p_list = NULL;
-    block_t **pp_last = &p_list;
     for (int i = 0; i < i_packet_count; i++ )
     {
-        block_t *p_ts = BufferChainGet( p_chain_ts );
+        ts_packet_t *p_ts = &p_sys->packets.p_list[i_first + i];
         vlc_tick_t i_new_dts = i_pcr_dts + i_pcr_length * i / i_packet_count;
 
         p_ts->i_dts    = i_new_dts;
@@ -1744,7 +1974,7 @@ static int TSDate( sout_mux_t *p_mux, sout_buffer_chain_t *p_chain_ts,
         if( p_ts->i_flags & BLOCK_FLAG_FOR_PCR )
         {
             /* msg_Dbg( p_mux, "pcr=%lld ms", p_ts->i_dts / 1000 ); */
-            TSSetPCR( p_ts, p_ts->i_dts - p_sys->first_dts );
+            TSSetPCR( p_ts->p_buffer, p_ts->i_dts - p_sys->first_dts );
         }
         if( p_ts->i_flags & BLOCK_FLAG_SCRAMBLED )
         {
@@ -1755,19 +1985,100 @@ static int TSDate( sout_mux_t *p_mux, sout_buffer_chain_t *p_chain_ts,
 
         /* latency */
         p_ts->i_dts += p_sys->i_shaping_delay * 3 / 2;
+    }
+}
 
-        block_ChainLastAppend( &pp_last, p_ts );
+/* Constant bitrate: dates the packets from their position in the output */
+static void TSDateCBR( sout_mux_t *p_mux )
+{
+    sout_mux_sys_t *p_sys = p_mux->p_sys;
+    const vlc_tick_t i_length = vlc_tick_from_samples( 188 * 8,
+                                                       p_sys->cbr.i_rate );
+    unsigned i_late = 0;
+
+    for( size_t i = 0; i < p_sys->packets.i_count; i++ )
+    {
+        ts_packet_t *p_ts = &p_sys->packets.p_list[i];
+        vlc_tick_t i_new_dts = p_sys->first_dts + VLC_TICK_FROM_US(p_sys->cbr.i_clock / 27);
+
+        /* T-STD: the data must reach the decoder before it is decoded */
+        if( p_ts->i_dts && p_ts->i_dts + p_sys->i_dts_delay < i_new_dts )
+            i_late++;
+
+        p_ts->i_dts    = i_new_dts;
+        p_ts->i_length = i_length;
+
+        if( p_ts->i_flags & BLOCK_FLAG_FOR_PCR )
+            TSWritePCR( p_ts->p_buffer, p_sys->cbr.i_clock );
+        if( p_ts->i_flags & BLOCK_FLAG_SCRAMBLED )
+        {
+            vlc_mutex_lock( &p_sys->csa_lock );
+            csa_Encrypt( p_sys->csa, p_ts->p_buffer, p_sys->i_csa_pkt_size );
+            vlc_mutex_unlock( &p_sys->csa_lock );
+        }
+
+        /* latency */
+        p_ts->i_dts += p_sys->i_shaping_delay * 3 / 2;
+
+        p_sys->cbr.i_clock += p_sys->cbr.i_step;
+        p_sys->cbr.i_clock_rem += p_sys->cbr.i_step_rem;
+        if( p_sys->cbr.i_clock_rem >= p_sys->cbr.i_rate )
+        {
+            p_sys->cbr.i_clock_rem -= p_sys->cbr.i_rate;
+            p_sys->cbr.i_clock++;
+        }
+    }
+
+    if( i_late > 0 )
+        msg_Warn( p_mux, "%u packets later than their DTS, the muxrate is too "
+                  "low for the dts-delay", i_late );
+}
+
+/* Dates the output frames from their packets and writes them at once.
+ * A frame only spans a few packets, its first packet date is the date at
+ * which the whole frame must be output. */
+static int TSSend( sout_mux_t *p_mux )
+{
+    sout_mux_sys_t *p_sys = p_mux->p_sys;
+    block_t *p_list = p_sys->packets.p_first;
+    const ts_packet_t *p_ts = p_sys->packets.p_list;
+    bool b_error = p_sys->packets.b_error;
+
+    p_sys->packets.p_first = NULL;
+    p_sys->packets.pp_last = &p_sys->packets.p_first;
+    p_sys->packets.p_frame = NULL;
+    p_sys->packets.i_count = 0;
+    p_sys->packets.b_error = false;
+
+    if( unlikely(b_error) )
+    {
+        block_ChainRelease( p_list );
+        return VLC_ENOMEM;
     }
+
+    for( block_t *p_frame = p_list; p_frame != NULL; p_frame = p_frame->p_next )
+    {
+        const size_t i_packets = p_frame->i_buffer / 188;
+
+        p_frame->i_dts   = p_ts[0].i_dts;
+        p_frame->i_flags = p_ts[0].i_flags &
+                           (BLOCK_FLAG_HEADER | BLOCK_FLAG_TYPE_I);
+        p_frame->i_length = 0;
+        for( size_t i = 0; i < i_packets; i++ )
+            p_frame->i_length += p_ts[i].i_length;
+        p_ts += i_packets;
+    }
+
     ssize_t written = 0;
     if ( p_list != NULL )
         written = sout_AccessOutWrite( p_mux->p_access, p_list );
     return ( written == -1 ) ? VLC_EGENERIC : VLC_SUCCESS;
 }
 
-static block_t *TSNew( sout_mux_t *p_mux, sout_input_sys_t *p_stream,
-                       bool b_pcr )
+static ts_packet_t *TSNew( sout_mux_t *p_mux, sout_input_sys_t *p_stream,
+                           bool b_pcr )
 {
-    VLC_UNUSED(p_mux);
+    sout_mux_sys_t *p_sys = p_mux->p_sys;
     block_t *p_pes = p_stream->state.chain_pes.p_first;
 
     bool b_new_pes = false;
@@ -1787,9 +2098,19 @@ static block_t *TSNew( sout_mux_t *p_mux, sout_input_sys_t *p_stream,
         b_adaptation_field = true;
     }
 
-    block_t *p_ts = block_Alloc( 188 );
+    const bool b_key_frame = b_new_pes &&
+        !(p_pes->i_flags & BLOCK_FLAG_NO_KEYFRAME) &&
+        (p_pes->i_flags & BLOCK_FLAG_TYPE_I);
+
+    /* Start keyframes on a new frame, for the segmenting access outputs */
+    if( b_key_frame )
+        TSBreak( p_sys );
+
+    ts_packet_t *p_ts = TSPacketNew( p_sys );
+    if( unlikely(p_ts == NULL) )
+        return NULL;
 
-    if (b_new_pes && !(p_pes->i_flags & BLOCK_FLAG_NO_KEYFRAME) && p_pes->i_flags & BLOCK_FLAG_TYPE_I)
+    if( b_key_frame )
     {
         p_ts->i_flags |= BLOCK_FLAG_TYPE_I;
     }
@@ -1867,31 +2188,38 @@ static block_t *TSNew( sout_mux_t *p_mux, sout_input_sys_t *p_stream,
     return p_ts;
 }
 
-static void TSSetPCR( block_t *p_ts, vlc_tick_t i_dts )
+static void TSSetPCR( uint8_t *p_ts, vlc_tick_t i_dts )
+{
+    /* we don't set PCR extension */
+    TSWritePCR( p_ts, TO_SCALE_NZ(i_dts) * 300 );
+}
+
+/* Writes a 27MHz PCR */
+static void TSWritePCR( uint8_t *p_ts, uint64_t i_pcr )
 {
-    int64_t i_pcr = TO_SCALE_NZ(i_dts);
-
-    p_ts->p_buffer[6]  = ( i_pcr >> 25 )&0xff;
-    p_ts->p_buffer[7]  = ( i_pcr >> 17 )&0xff;
-    p_ts->p_buffer[8]  = ( i_pcr >> 9  )&0xff;
-    p_ts->p_buffer[9]  = ( i_pcr >> 1  )&0xff;
-    p_ts->p_buffer[10] = ( i_pcr << 7  )&0x80;
-    p_ts->p_buffer[10] |= 0x7e;
-    p_ts->p_buffer[11] = 0; /* we don't set PCR extension */
+    uint64_t i_base = i_pcr / 300;
+    unsigned i_ext = i_pcr % 300;
+
+    p_ts[6]  = ( i_base >> 25 )&0xff;
+    p_ts[7]  = ( i_base >> 17 )&0xff;
+    p_ts[8]  = ( i_base >> 9  )&0xff;
+    p_ts[9]  = ( i_base >> 1  )&0xff;
+    p_ts[10] = ( ( i_base << 7 )&0x80 ) | 0x7e | ( i_ext >> 8 );
+    p_ts[11] = i_ext & 0xff;
 }
 
-void GetPAT( sout_mux_t *p_mux, sout_buffer_chain_t *c )
+void GetPAT( sout_mux_t *p_mux )
 {
     sout_mux_sys_t       *p_sys = p_mux->p_sys;
 
     BuildPAT( p_sys->p_dvbpsi,
-              c, (PEStoTSCallback)BufferChainAppend,
+              p_sys, TSPacketsAppend,
               p_sys->i_tsid, p_sys->i_pat_version_number,
               &p_sys->pat,
               p_sys->i_num_pmt, p_sys->pmt, p_sys->i_pmt_program_number );
 }
 
-static void GetPMT( sout_mux_t *p_mux, sout_buffer_chain_t *c )
+static void GetPMT( sout_mux_t *p_mux )
 {
     sout_mux_sys_t *p_sys = p_mux->p_sys;
     pes_mapped_stream_t mapped[p_mux->i_nb_inputs];
@@ -1913,7 +2241,7 @@ static void GetPMT( sout_mux_t *p_mux, sout_buffer_chain_t *c )
     }
 
     BuildPMT( p_sys->p_dvbpsi, VLC_OBJECT(p_mux), p_sys->standard,
-              c, (PEStoTSCallback)BufferChainAppend,
+              p_sys, TSPacketsAppend,
               p_sys->i_tsid, p_sys->i_pmt_version_number,
               ((sout_input_sys_t *)p_sys->p_pcr_input->p_sys)->ts.i_pid,
               &p_sys->sdt,
@@ -1710,6 +1710,31 @@ static ssize_t AccessOutGrabberWrite( sout_access_out_t *p_access,
 }
 
 
+static int AccessOutGrabberControl( sout_access_out_t *p_access,
+                                    int i_query, va_list args )
+{
+    sout_stream_t *p_stream = (sout_stream_t*)p_access->p_sys;
+
+    switch( i_query )
+    {
+        case ACCESS_OUT_GET_WRITE_SIZE:
+        {
+            /* Whole TS packets in each RTP packet (RFC 2250), with the MTU
+             * the RTP stream will use */
+            int i_mtu = var_InheritInteger( p_stream, "mtu" );
+            if( i_mtu <= 12 + 16 )
+                i_mtu = 576 - 20 - 8; /* pessimistic */
+            *va_arg( args, size_t * ) = __MAX( (i_mtu - 12) / 188, 1 ) * 188;
+            break;
+        }
+
+        default:
+            return VLC_EGENERIC;
+    }
+    return VLC_SUCCESS;
+}
+
+
 static sout_access_out_t *GrabberCreate( sout_stream_t *p_stream )
 {
     sout_access_out_t *p_grab;
@@ -1725,6 +1750,7 @@ static sout_access_out_t *GrabberCreate( sout_stream_t *p_stream )
     p_grab->p_sys       = p_stream;
     p_grab->pf_seek     = NULL;
     p_grab->pf_write    = AccessOutGrabberWrite;
+    p_grab->pf_control  = AccessOutGrabberControl;
     return p_grab;
 }
 
@@ -0,0 +1,726 @@
+/*****************************************************************************
+ * segments.c: segment-parallel video transcoding
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+/*****************************************************************************
+ * Preamble
+ *****************************************************************************/
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <vlc_common.h>
+#include <vlc_sout.h>
+
+#include "transcode.h"
+
+/* Segments queued, being transcoded or waiting to be sent, per worker */
+#define SEGMENTS_INFLIGHT_PER_WORKER 2
+/* Bounds of a segment waiting for a cut point, in segment lengths and in
+ * bytes of compressed video, before falling back to sequential encoding */
+#define SEGMENT_MAX_LENGTHS 8
+#define SEGMENT_MAX_SIZE (64 << 20)
+
+/*
+ * The compressed video is cut at the source keyframes starting a closed GOP
+ * into segments of at least the configured length. Each segment is decoded,
+ * filtered and encoded from scratch by one of the worker threads, with its
+ * own decoder and encoder, then the encoded segments are sent in order by
+ * the stream thread. If no such keyframe shows up for too long, the rest of
+ * the video is transcoded sequentially by the stream thread.
+ */
+struct transcode_video_segment
+{
+    block_t    *p_in;
+    block_t   **pp_in_last;
+    size_t      i_in_size;
+    vlc_tick_t  i_start;
+    vlc_tick_t  i_end; /**< date of the last block in */
+
+    block_t    *p_out;
+    es_format_t fmt_out; /**< encoder output format, once done */
+    bool        b_done;
+    bool        b_error;
+
+    struct transcode_video_segment *p_next;
+};
+
+struct transcode_video_segments
+{
+    sout_stream_t *p_stream;
+    es_format_t    fmt; /**< source format */
+    const char    *es_id;
+    const transcode_encoder_config_t *p_enccfg;
+    /* Shallow copy, the strings are owned by the stream configuration */
+    sout_filters_config_t filterscfg;
+    vlc_tick_t     i_length; /**< minimum segment length */
+    bool           b_intra_only; /**< every source frame is a keyframe */
+
+    vlc_mutex_t    lock;
+    vlc_cond_t     wait_request;
+    vlc_cond_t     wait_done;
+    struct transcode_video_segment *p_first; /**< oldest segment not sent */
+    struct transcode_video_segment **pp_last;
+    struct transcode_video_segment *p_pending; /**< first one not started */
+    size_t         i_inflight;
+    bool           b_closing;
+
+    /* Only accessed by the stream thread */
+    struct transcode_video_segment *p_current; /**< segment being cut */
+    block_t      **pp_cut; /**< link to the keyframe the next segment may
+                                start from, in the current segment */
+    vlc_tick_t     i_cut_pts;
+    vlc_tick_t     i_last_dts;
+    /* Transcoder used instead of the segments, when no closed GOP is found
+     * to cut the video at */
+    sout_stream_id_sys_t *p_sequential;
+
+    unsigned       i_workers;
+    vlc_thread_t   workers[];
+};
+
+static struct transcode_video_segment *segment_New( void )
+{
+    struct transcode_video_segment *seg = calloc( 1, sizeof(*seg) );
+    if( unlikely(seg == NULL) )
+        return NULL;
+
+    seg->pp_in_last = &seg->p_in;
+    seg->i_start = seg->i_end = VLC_TICK_INVALID;
+    es_format_Init( &seg->fmt_out, VIDEO_ES, 0 );
+    return seg;
+}
+
+static vlc_tick_t segment_BlockDate( const block_t *p_block )
+{
+    return p_block->i_dts != VLC_TICK_INVALID ? p_block->i_dts
+                                              : p_block->i_pts;
+}
+
+static void segment_Delete( struct transcode_video_segment *seg )
+{
+    block_ChainRelease( seg->p_in );
+    block_ChainRelease( seg->p_out );
+    es_format_Clean( &seg->fmt_out );
+    free( seg );
+}
+
+static void *segment_downstream_Add( sout_stream_t *p_stream,
+                                     const es_format_t *fmt_orig,
+                                     const es_format_t *fmt,
+                                     const char *es_id )
+{
+    /* The stream thread adds the output ES when it sends the first segment */
+    VLC_UNUSED(p_stream); VLC_UNUSED(fmt_orig);
+    VLC_UNUSED(fmt); VLC_UNUSED(es_id);
+    return NULL;
+}
+
+/* Creates a decoder, filters and encoder chain of its own */
+static sout_stream_id_sys_t *
+segments_NewTranscoder( struct transcode_video_segments *segs )
+{
+    sout_stream_t *p_stream = segs->p_stream;
+
+    sout_stream_id_sys_t *id = calloc( 1, sizeof(*id) );
+    if( unlikely(id == NULL) )
+        return NULL;
+
+    vlc_mutex_init( &id->fifo.lock );
+    id->pf_transcode_downstream_add = segment_downstream_Add;
+    id->p_filterscfg = &segs->filterscfg;
+    id->p_enccfg = segs->p_enccfg;
+    id->es_id = segs->es_id;
+
+    struct decoder_owner *p_owner = vlc_object_create( p_stream,
+                                                       sizeof(*p_owner) );
+    if( unlikely(p_owner == NULL) )
+    {
+        free( id );
+        return NULL;
+    }
+    p_owner->p_stream = p_stream;
+
+    id->p_decoder = &p_owner->dec;
+    decoder_Init( id->p_decoder, &p_owner->fmt_in, &segs->fmt );
+    es_format_SetMeta( &id->p_decoder->fmt_out, id->p_decoder->fmt_in );
+
+    if( transcode_video_init( p_stream, &segs->fmt, id ) != VLC_SUCCESS )
+    {
+        dec_Delete( id->p_decoder );
+        free( id );
+        return NULL;
+    }
+    return id;
+}
+
+static void segments_DeleteTranscoder( struct transcode_video_segments *segs,
+                                       sout_stream_id_sys_t *id )
+{
+    dec_Delete( id->p_decoder );
+    transcode_video_clean( segs->p_stream, id );
+    free( id );
+}
+
+static void segment_Transcode( struct transcode_video_segments *segs,
+                               struct transcode_video_segment *seg )
+{
+    sout_stream_t *p_stream = segs->p_stream;
+    block_t *p_in = seg->p_in;
+
+    seg->p_in = NULL;
+    seg->b_error = true;
+
+    sout_stream_id_sys_t *id = segments_NewTranscoder( segs );
+    if( id == NULL )
+    {
+        msg_Err( p_stream, "cannot transcode video segment at %"PRId64,
+                 seg->i_start );
+        block_ChainRelease( p_in );
+        return;
+    }
+
+    int i_ret = VLC_SUCCESS;
+    while( p_in != NULL && i_ret == VLC_SUCCESS )
+    {
+        block_t *p_next = p_in->p_next, *p_out;
+
+        p_in->p_next = NULL;
+        i_ret = transcode_video_process( p_stream, id, p_in, &p_out );
+        block_ChainAppend( &seg->p_out, p_out );
+        p_in = p_next;
+    }
+
+    if( i_ret == VLC_SUCCESS )
+    {
+        block_t *p_out;
+
+        i_ret = transcode_video_process( p_stream, id, NULL, &p_out );
+        block_ChainAppend( &seg->p_out, p_out );
+    }
+
+    if( i_ret == VLC_SUCCESS && id->encoder != NULL &&
+        transcode_encoder_opened( id->encoder ) )
+    {
+        es_format_Copy( &seg->fmt_out,
+                        transcode_encoder_format_out( id->encoder ) );
+        seg->b_error = false;
+    }
+    else
+        msg_Err( p_stream, "cannot transcode video segment at %"PRId64,
+                 seg->i_start );
+
+    segments_DeleteTranscoder( segs, id );
+    block_ChainRelease( p_in );
+}
+
+static void *segments_Thread( void *data )
+{
+    struct transcode_video_segments *segs = data;
+
+    vlc_thread_set_name( "vlc-transcode-seg" );
+
+    vlc_mutex_lock( &segs->lock );
+    for( ;; )
+    {
+        while( !segs->b_closing && segs->p_pending == NULL )
+            vlc_cond_wait( &segs->wait_request, &segs->lock );
+
+        struct transcode_video_segment *seg = segs->p_pending;
+        if( seg == NULL )
+            break;
+        segs->p_pending = seg->p_next;
+        vlc_mutex_unlock( &segs->lock );
+
+        segment_Transcode( segs, seg );
+
+        vlc_mutex_lock( &segs->lock );
+        seg->b_done = true;
+        vlc_cond_broadcast( &segs->wait_done );
+    }
+    vlc_mutex_unlock( &segs->lock );
+
+    return NULL;
+}
+
+/* Drops the segments no worker started yet, must be called locked */
+static void segments_Abort( struct transcode_video_segments *segs )
+{
+    for( struct transcode_video_segment *seg = segs->p_pending;
+         seg != NULL; seg = seg->p_next )
+    {
+        block_ChainRelease( seg->p_in );
+        seg->p_in = NULL;
+        seg->b_done = true;
+        seg->b_error = true;
+    }
+    segs->p_pending = NULL;
+}
+
+/**
+ * Queues the given segment, if any, then pops the leading transcoded
+ * segments in order, until at most i_max segments are in flight.
+ */
+static struct transcode_video_segment *
+segments_Dequeue( struct transcode_video_segments *segs,
+                  struct transcode_video_segment *p_queued, size_t i_max )
+{
+    struct transcode_video_segment *p_done = NULL, **pp_done = &p_done;
+
+    vlc_mutex_lock( &segs->lock );
+    if( p_queued != NULL )
+    {
+        *segs->pp_last = p_queued;
+        segs->pp_last = &p_queued->p_next;
+        if( segs->p_pending == NULL )
+            segs->p_pending = p_queued;
+        segs->i_inflight++;
+        vlc_cond_signal( &segs->wait_request );
+    }
+
+    for( ;; )
+    {
+        while( segs->p_first != NULL && segs->p_first->b_done )
+        {
+            struct transcode_video_segment *seg = segs->p_first;
+
+            segs->p_first = seg->p_next;
+            if( segs->p_first == NULL )
+                segs->pp_last = &segs->p_first;
+            segs->i_inflight--;
+
+            seg->p_next = NULL;
+            *pp_done = seg;
+            pp_done = &seg->p_next;
+        }
+
+        if( segs->i_inflight <= i_max )
+            break;
+        vlc_cond_wait( &segs->wait_done, &segs->lock );
+    }
+    vlc_mutex_unlock( &segs->lock );
+
+    return p_done;
+}
+
+/* Each segment starts with a new encoder, whose first DTS may be earlier than
+ * the last one of the previous segment if its reordering delay differs. The
+ * PTS stay on the source timeline, shared with the other ES: only the DTS
+ * overlapping the previous segment are moved, right after the last one. */
+static void segments_FixTimestamps( struct transcode_video_segments *segs,
+                                    block_t *p_first )
+{
+    unsigned i_moved = 0;
+
+    for( block_t *p_block = p_first; p_block != NULL; p_block = p_block->p_next )
+    {
+        if( p_block->i_dts == VLC_TICK_INVALID )
+            continue;
+        if( segs->i_last_dts != VLC_TICK_INVALID &&
+            p_block->i_dts <= segs->i_last_dts )
+        {
+            p_block->i_dts = segs->i_last_dts + 1;
+            if( p_block->i_pts != VLC_TICK_INVALID &&
+                p_block->i_pts < p_block->i_dts )
+                msg_Warn( segs->p_stream, "video segment PTS %"PRId64
+                          " before its DTS", p_block->i_pts );
+            i_moved++;
+        }
+        segs->i_last_dts = p_block->i_dts;
+    }
+    if( i_moved > 0 )
+        msg_Dbg( segs->p_stream, "moved %u DTS of a video segment", i_moved );
+}
+
+static int segments_Send( sout_stream_t *p_stream, sout_stream_id_sys_t *id,
+                          struct transcode_video_segment *p_done,
+                          block_t **out )
+{
+    struct transcode_video_segments *segs = id->p_segments;
+    int i_ret = VLC_SUCCESS;
+
+    while( p_done != NULL )
+    {
+        struct transcode_video_segment *seg = p_done;
+
+        p_done = seg->p_next;
+
+        if( seg->b_error )
+            i_ret = VLC_EGENERIC;
+        else if( i_ret == VLC_SUCCESS )
+        {
+            if( id->downstream_id == NULL )
+                id->downstream_id =
+                    id->pf_transcode_downstream_add( p_stream, &segs->fmt,
+                                                     &seg->fmt_out,
+                                                     id->es_id );
+            if( id->downstream_id == NULL )
+                i_ret = VLC_EGENERIC;
+            else
+            {
+                segments_FixTimestamps( segs, seg->p_out );
+                block_ChainAppend( out, seg->p_out );
+                seg->p_out = NULL;
+            }
+        }
+        segment_Delete( seg );
+    }
+    return i_ret;
+}
+
+/* Returns whether the next segment may start at this block */
+static bool segments_IsCutPoint( const struct transcode_video_segments *segs,
+                                 const block_t *p_block )
+{
+    if( segs->p_current == NULL || segs->p_current->p_in == NULL )
+        return false;
+    if( !segs->b_intra_only && !(p_block->i_flags & BLOCK_FLAG_TYPE_I) )
+        return false;
+
+    vlc_tick_t i_date = segment_BlockDate( p_block );
+    return i_date != VLC_TICK_INVALID &&
+           segs->p_current->i_start != VLC_TICK_INVALID &&
+           i_date - segs->p_current->i_start >= segs->i_length;
+}
+
+/**
+ * Checks the block following a cut point candidate. If it is a leading
+ * picture, shown before the keyframe but decoded after it, the GOP is open:
+ * it references the previous GOP, so it can't start a new segment. Otherwise
+ * the current segment is cut before the keyframe and returned.
+ */
+static int segments_CheckCut( struct transcode_video_segments *segs,
+                              const block_t *p_next,
+                              struct transcode_video_segment **pp_queued )
+{
+    block_t **pp_cut = segs->pp_cut;
+
+    segs->pp_cut = NULL;
+    if( p_next->i_pts != VLC_TICK_INVALID &&
+        segs->i_cut_pts != VLC_TICK_INVALID &&
+        p_next->i_pts < segs->i_cut_pts )
+        return VLC_SUCCESS;
+
+    struct transcode_video_segment *seg = segment_New();
+    if( unlikely(seg == NULL) )
+        return VLC_ENOMEM;
+
+    /* The keyframe and the blocks after it start the new segment */
+    seg->p_in = *pp_cut;
+    seg->pp_in_last = segs->p_current->pp_in_last;
+    seg->i_start = segment_BlockDate( seg->p_in );
+    seg->i_end = segs->p_current->i_end;
+    for( const block_t *p_block = seg->p_in; p_block != NULL;
+         p_block = p_block->p_next )
+        seg->i_in_size += p_block->i_buffer;
+    segs->p_current->i_in_size -= seg->i_in_size;
+    *pp_cut = NULL;
+    segs->p_current->pp_in_last = pp_cut;
+
+    *pp_queued = segs->p_current;
+    segs->p_current = seg;
+    return VLC_SUCCESS;
+}
+
+/* Returns whether the segment being cut waited too long for a cut point */
+static bool segments_IsOversized( const struct transcode_video_segments *segs )
+{
+    const struct transcode_video_segment *seg = segs->p_current;
+
+    if( seg->i_in_size > SEGMENT_MAX_SIZE )
+        return true;
+    return seg->i_start != VLC_TICK_INVALID && seg->i_end != VLC_TICK_INVALID
+        && seg->i_end - seg->i_start > SEGMENT_MAX_LENGTHS * segs->i_length;
+}
+
+static int segments_ProcessSequential( sout_stream_t *p_stream,
+                                       sout_stream_id_sys_t *id,
+                                       block_t *in, block_t **out )
+{
+    struct transcode_video_segments *segs = id->p_segments;
+    sout_stream_id_sys_t *seq = segs->p_sequential;
+    block_t *p_out = NULL;
+
+    int i_ret = transcode_video_process( p_stream, seq, in, &p_out );
+    if( p_out == NULL )
+        return i_ret;
+
+    if( id->downstream_id == NULL && seq->encoder != NULL &&
+        transcode_encoder_opened( seq->encoder ) )
+        id->downstream_id =
+            id->pf_transcode_downstream_add( p_stream, &segs->fmt,
+                                transcode_encoder_format_out( seq->encoder ),
+                                id->es_id );
+    if( id->downstream_id == NULL )
+    {
+        block_ChainRelease( p_out );
+        return VLC_EGENERIC;
+    }
+
+    segments_FixTimestamps( segs, p_out );
+    block_ChainAppend( out, p_out );
+    return i_ret;
+}
+
+/* Transcodes the rest of the video with a single transcoder, after the
+ * segments already cut */
+static int segments_StartSequential( sout_stream_t *p_stream,
+                                     sout_stream_id_sys_t *id,
+                                     block_t **out )
+{
+    struct transcode_video_segments *segs = id->p_segments;
+    struct transcode_video_segment *seg = segs->p_current;
+
+    msg_Warn( p_stream, "no closed GOP to cut the video at in %zu bytes "
+              "(%"PRId64" ms), transcoding it sequentially", seg->i_in_size,
+              seg->i_end != VLC_TICK_INVALID && seg->i_start != VLC_TICK_INVALID
+              ? MS_FROM_VLC_TICK(seg->i_end - seg->i_start) : 0 );
+
+    segs->p_current = NULL;
+    segs->pp_cut = NULL;
+
+    /* Keep the order: the segments in flight are sent first */
+    int i_ret = segments_Send( p_stream, id,
+                               segments_Dequeue( segs, NULL, 0 ), out );
+
+    block_t *p_in = seg->p_in;
+    seg->p_in = NULL;
+    segment_Delete( seg );
+
+    segs->p_sequential = segments_NewTranscoder( segs );
+    if( segs->p_sequential == NULL )
+    {
+        block_ChainRelease( p_in );
+        return VLC_EGENERIC;
+    }
+
+    while( p_in != NULL && i_ret == VLC_SUCCESS )
+    {
+        block_t *p_next = p_in->p_next;
+
+        p_in->p_next = NULL;
+        i_ret = segments_ProcessSequential( p_stream, id, p_in, out );
+        p_in = p_next;
+    }
+    block_ChainRelease( p_in );
+    return i_ret;
+}
+
+int transcode_video_segments_Process( sout_stream_t *p_stream,
+                                      sout_stream_id_sys_t *id,
+                                      block_t *in, block_t **out )
+{
+    struct transcode_video_segments *segs = id->p_segments;
+    struct transcode_video_segment *p_queued = NULL;
+
+    *out = NULL;
+
+    if( segs->p_sequential != NULL )
+        return segments_ProcessSequential( p_stream, id, in, out );
+
+    if( in == NULL )
+    {
+        p_queued = segs->p_current;
+        segs->p_current = NULL;
+        segs->pp_cut = NULL;
+    }
+    else if( segs->pp_cut != NULL )
+    {
+        if( segments_CheckCut( segs, in, &p_queued ) != VLC_SUCCESS )
+        {
+            block_Release( in );
+            return VLC_ENOMEM;
+        }
+    }
+    else if( segs->b_intra_only && segments_IsCutPoint( segs, in ) )
+    {
+        /* No reordering, cut right away */
+        p_queued = segs->p_current;
+        segs->p_current = NULL;
+    }
+
+    if( in != NULL )
+    {
+        if( segs->p_current == NULL )
+        {
+            segs->p_current = segment_New();
+            if( unlikely(segs->p_current == NULL) )
+            {
+                block_Release( in );
+                return VLC_ENOMEM;
+            }
+        }
+
+        vlc_tick_t i_date = segment_BlockDate( in );
+        if( segs->p_current->i_start == VLC_TICK_INVALID )
+            segs->p_current->i_start = i_date;
+        if( i_date != VLC_TICK_INVALID )
+            segs->p_current->i_end = i_date;
+        segs->p_current->i_in_size += in->i_buffer;
+
+        /* Only cut once the next block tells whether the GOP is closed */
+        if( !segs->b_intra_only && p_queued == NULL &&
+            segments_IsCutPoint( segs, in ) )
+        {
+            segs->pp_cut = segs->p_current->pp_in_last;
+            segs->i_cut_pts = in->i_pts;
+        }
+        block_ChainLastAppend( &segs->p_current->pp_in_last, in );
+    }
+
+    /* Wait for everything when draining, otherwise only bound the amount of
+     * segments in flight before cutting the next one. */
+    size_t i_max = in == NULL ? 0
+                 : segs->i_workers * SEGMENTS_INFLIGHT_PER_WORKER - 1;
+
+    struct transcode_video_segment *p_done =
+        segments_Dequeue( segs, p_queued, i_max );
+    int i_ret = segments_Send( p_stream, id, p_done, out );
+
+    /* Open GOPs only, or no keyframe flags: do not keep the whole stream in
+     * memory to transcode it at the end */
+    if( i_ret == VLC_SUCCESS && segs->p_current != NULL &&
+        segments_IsOversized( segs ) )
+        i_ret = segments_StartSequential( p_stream, id, out );
+    return i_ret;
+}
+
+void transcode_video_segments_Flush( sout_stream_id_sys_t *id )
+{
+    struct transcode_video_segments *segs = id->p_segments;
+
+    if( segs->p_current != NULL )
+    {
+        segment_Delete( segs->p_current );
+        segs->p_current = NULL;
+    }
+    segs->pp_cut = NULL;
+
+    vlc_mutex_lock( &segs->lock );
+    segments_Abort( segs );
+    vlc_mutex_unlock( &segs->lock );
+
+    struct transcode_video_segment *p_done = segments_Dequeue( segs, NULL, 0 );
+    while( p_done != NULL )
+    {
+        struct transcode_video_segment *seg = p_done;
+
+        p_done = seg->p_next;
+        segment_Delete( seg );
+    }
+    segs->i_last_dts = VLC_TICK_INVALID;
+
+    /* Try cutting segments again from the next keyframe */
+    if( segs->p_sequential != NULL )
+    {
+        segments_DeleteTranscoder( segs, segs->p_sequential );
+        segs->p_sequential = NULL;
+    }
+}
+
+int transcode_video_segments_New( sout_stream_t *p_stream,
+                                  const es_format_t *p_fmt,
+                                  sout_stream_id_sys_t *id )
+{
+    unsigned i_workers = id->p_filterscfg->video.i_segments;
+
+    struct transcode_video_segments *segs =
+        malloc( sizeof(*segs) + i_workers * sizeof(*segs->workers) );
+    if( unlikely(segs == NULL) )
+        return VLC_ENOMEM;
+
+    msg_Dbg( p_stream, "transcoding video in %u parallel segments of %"PRId64
+             " ms", i_workers,
+             MS_FROM_VLC_TICK(id->p_filterscfg->video.i_segment_length) );
+    if( id->i_ladder_cfg > 0 )
+        msg_Warn( p_stream, "video renditions are not supported with "
+                            "parallel segments" );
+
+    segs->p_stream = p_stream;
+    es_format_Copy( &segs->fmt, p_fmt );
+    segs->es_id = id->es_id;
+    segs->p_enccfg = id->p_enccfg;
+    segs->filterscfg = *id->p_filterscfg;
+    segs->filterscfg.video.i_segments = 0;
+    segs->i_length = id->p_filterscfg->video.i_segment_length;
+    /* Raw video has no keyframe flag, but can be cut anywhere */
+    segs->b_intra_only =
+        vlc_fourcc_GetChromaDescription( p_fmt->i_codec ) != NULL;
+
+    vlc_mutex_init( &segs->lock );
+    vlc_cond_init( &segs->wait_request );
+    vlc_cond_init( &segs->wait_done );
+    segs->p_first = NULL;
+    segs->pp_last = &segs->p_first;
+    segs->p_pending = NULL;
+    segs->i_inflight = 0;
+    segs->b_closing = false;
+    segs->p_current = NULL;
+    segs->pp_cut = NULL;
+    segs->i_cut_pts = VLC_TICK_INVALID;
+    segs->i_last_dts = VLC_TICK_INVALID;
+    segs->p_sequential = NULL;
+
+    for( segs->i_workers = 0; segs->i_workers < i_workers; segs->i_workers++ )
+        if( vlc_clone( &segs->workers[segs->i_workers], segments_Thread,
+                       segs ) )
+            break;
+
+    if( segs->i_workers == 0 )
+    {
+        es_format_Clean( &segs->fmt );
+        free( segs );
+        return VLC_EGENERIC;
+    }
+
+    id->p_segments = segs;
+    id->b_transcode = true;
+    return VLC_SUCCESS;
+}
+
+void transcode_video_segments_Delete( sout_stream_id_sys_t *id )
+{
+    struct transcode_video_segments *segs = id->p_segments;
+
+    vlc_mutex_lock( &segs->lock );
+    segments_Abort( segs );
+    segs->b_closing = true;
+    vlc_cond_broadcast( &segs->wait_request );
+    vlc_mutex_unlock( &segs->lock );
+
+    for( unsigned i = 0; i < segs->i_workers; i++ )
+        vlc_join( segs->workers[i], NULL );
+
+    /* Only the segments that were never sent are left */
+    while( segs->p_first != NULL )
+    {
+        struct transcode_video_segment *seg = segs->p_first;
+
+        segs->p_first = seg->p_next;
+        segment_Delete( seg );
+    }
+    if( segs->p_current != NULL )
+        segment_Delete( segs->p_current );
+    if( segs->p_sequential != NULL )
+        segments_DeleteTranscoder( segs, segs->p_sequential );
+
+    es_format_Clean( &segs->fmt );
+    free( segs );
+    id->p_segments = NULL;
+}
@@ -76,6 +76,19 @@
 #define MAXHEIGHT_TEXT N_("Maximum video height")
 #define MAXHEIGHT_LONGTEXT N_( \
     "Maximum output video height." )
+#define LADDER_TEXT N_("Video renditions")
+#define LADDER_LONGTEXT N_( \
+    "Additional renditions of the video, encoded from the same decoded and " \
+    "filtered pictures, as a comma-separated list of " \
+    "<width>x<height>@<bitrate>. A dimension can be 0 to keep the aspect " \
+    "ratio (eg: 1280x720@3000,0x360@800). The renditions are sent as " \
+    "separate streams, with \"/renditionN\" appended to the video ES ID." )
+#define LADDER_GOP_TEXT N_("Video renditions keyframe interval")
+#define LADDER_GOP_LONGTEXT N_( \
+    "Fixed number of frames between keyframes of all the video renditions, " \
+    "including the main one, with scene cut detection disabled, so that " \
+    "they all can be switched at the same pictures. It is not applied if " \
+    "the video encoder options already set keyint." )
 #define VFILTER_TEXT N_("Video filter")
 #define VFILTER_LONGTEXT N_( \
     "Video filters will be applied to the video streams (after overlays " \
@@ -132,6 +145,22 @@
 #define POOL_TEXT N_("Picture pool size")
 #define POOL_LONGTEXT N_( "Defines how many pictures we allow to be in pool "\
     "between decoder/encoder threads when threads > 0" )
+#define PIPELINE_TEXT N_("Pipelined video filters")
+#define PIPELINE_LONGTEXT N_( \
+    "Runs the deinterlace/fps filters and the user filters, conversion and " \
+    "encoding stages on separate threads, with up to this many pictures " \
+    "queued between stages. 0 processes all of them on the decoder thread." )
+#define SEGMENTS_TEXT N_("Parallel segments")
+#define SEGMENTS_LONGTEXT N_( \
+    "Cuts the video at keyframes into segments, and transcodes up to this " \
+    "many segments concurrently, each with its own decoder and encoder. " \
+    "This is meant for file to file transcoding: the output is delayed by " \
+    "several segments, PCR events are not forwarded and subtitles cannot " \
+    "be overlaid. 0 transcodes the video sequentially." )
+#define SEGMENT_LENGTH_TEXT N_("Parallel segments length")
+#define SEGMENT_LENGTH_LONGTEXT N_( \
+    "Minimum length of the parallel segments (in ms). Longer segments " \
+    "restart the encoder less often." )
 #define FORWARD_PCR_TEXT N_( "Forward PCR" )
 #define FORWARD_PCR_LONGTEXT N_( \
     "Enable PCR events forwarding to the next stream." )
@@ -186,6 +215,10 @@ vlc_module_begin ()
                  MAXHEIGHT_LONGTEXT )
     add_module_list(SOUT_CFG_PREFIX "vfilter", "video filter", NULL,
                     VFILTER_TEXT, VFILTER_LONGTEXT)
+    add_string( SOUT_CFG_PREFIX "ladder", NULL, LADDER_TEXT,
+                LADDER_LONGTEXT )
+    add_integer_with_range( SOUT_CFG_PREFIX "ladder-gop", 50, 1, 1000,
+                            LADDER_GOP_TEXT, LADDER_GOP_LONGTEXT )
 
     set_section( N_("Audio"), NULL )
     add_module(SOUT_CFG_PREFIX "aenc", "audio encoder", "none",
@@ -220,6 +253,15 @@ vlc_module_begin ()
         change_integer_range( 0, 32 )
     add_integer( SOUT_CFG_PREFIX "pool-size", 10, POOL_TEXT, POOL_LONGTEXT )
         change_integer_range( 1, 1000 )
+    add_integer( SOUT_CFG_PREFIX "pipeline", 0, PIPELINE_TEXT,
+                 PIPELINE_LONGTEXT )
+        change_integer_range( 0, 64 )
+    add_integer( SOUT_CFG_PREFIX "segments", 0, SEGMENTS_TEXT,
+                 SEGMENTS_LONGTEXT )
+        change_integer_range( 0, 64 )
+    add_integer( SOUT_CFG_PREFIX "segment-length", 10000, SEGMENT_LENGTH_TEXT,
+                 SEGMENT_LENGTH_LONGTEXT )
+        change_integer_range( 100, 3600000 )
     add_obsolete_bool( SOUT_CFG_PREFIX "high-priority" ) // Since 4.0.0
     add_bool( SOUT_CFG_PREFIX "forward-pcr", true, FORWARD_PCR_TEXT,
               FORWARD_PCR_LONGTEXT )
@@ -232,7 +274,8 @@ static const char *const ppsz_sout_options[] = {
     "deinterlace-module", "threads", "aenc", "acodec", "ab", "alang",
     "afilter", "samplerate", "channels", "senc", "scodec", "soverlay",
     "sfilter", "high-priority", "maxwidth", "maxheight", "pool-size",
-    "forward-pcr", NULL
+    "forward-pcr", "pipeline", "ladder", "ladder-gop", "segments",
+    "segment-length", NULL
 };
 
 /*****************************************************************************
@@ -332,6 +375,100 @@ static void SetVideoEncoderConfig( sout_stream_t *p_stream, transcode_encoder_co
     p_cfg->video.threads.pool_size = var_GetInteger( p_stream, SOUT_CFG_PREFIX "pool-size" );
 }
 
+/* Appends an encoder option, unless the user already set it */
+static void AddEncoderOption( config_chain_t **pp_chain, const char *psz_name,
+                              const char *psz_value )
+{
+    for( ; *pp_chain != NULL; pp_chain = &(*pp_chain)->p_next )
+        if( (*pp_chain)->psz_name != NULL &&
+            !strcmp( (*pp_chain)->psz_name, psz_name ) )
+            return;
+
+    config_chain_t *p_opt = malloc( sizeof(*p_opt) );
+    if( unlikely(p_opt == NULL) )
+        return;
+    p_opt->p_next = NULL;
+    p_opt->psz_name = strdup( psz_name );
+    p_opt->psz_value = strdup( psz_value );
+    *pp_chain = p_opt;
+}
+
+static void SetVideoLadderConfig( sout_stream_t *p_stream, sout_stream_sys_t *p_sys )
+{
+    char *psz_ladder = var_GetNonEmptyString( p_stream, SOUT_CFG_PREFIX "ladder" );
+    if( psz_ladder == NULL )
+        return;
+
+    /* The renditions can only be switched at keyframes common to all of
+     * them. Encoders placing keyframes on scene cuts or at a variable
+     * interval would not align them: ask for a fixed GOP. */
+    bool b_keyint = false;
+    for( const config_chain_t *p_opt = p_sys->venc_cfg.p_config_chain;
+         p_opt != NULL; p_opt = p_opt->p_next )
+        if( p_opt->psz_name != NULL && !strcmp( p_opt->psz_name, "keyint" ) )
+            b_keyint = true;
+    if( !b_keyint )
+    {
+        char psz_gop[12];
+        snprintf( psz_gop, sizeof(psz_gop), "%"PRId64,
+                  var_GetInteger( p_stream, SOUT_CFG_PREFIX "ladder-gop" ) );
+        AddEncoderOption( &p_sys->venc_cfg.p_config_chain, "keyint", psz_gop );
+        AddEncoderOption( &p_sys->venc_cfg.p_config_chain, "min-keyint", psz_gop );
+        AddEncoderOption( &p_sys->venc_cfg.p_config_chain, "scenecut", "0" );
+    }
+
+    size_t i_count = 1;
+    for( const char *psz = psz_ladder; *psz; psz++ )
+        if( *psz == ',' )
+            i_count++;
+
+    p_sys->p_vladder_cfg = vlc_alloc( i_count, sizeof(*p_sys->p_vladder_cfg) );
+    if( unlikely(p_sys->p_vladder_cfg == NULL) )
+    {
+        free( psz_ladder );
+        return;
+    }
+
+    char *psz_save;
+    for( char *psz_rung = strtok_r( psz_ladder, ",", &psz_save );
+         psz_rung != NULL; psz_rung = strtok_r( NULL, ",", &psz_save ) )
+    {
+        char *psz_end;
+        unsigned i_width = strtoul( psz_rung, &psz_end, 10 ), i_height = 0;
+        unsigned i_bitrate = p_sys->venc_cfg.video.i_bitrate;
+
+        if( *psz_end == 'x' )
+            i_height = strtoul( psz_end + 1, &psz_end, 10 );
+        if( *psz_end == '@' )
+        {
+            i_bitrate = strtoul( psz_end + 1, &psz_end, 10 );
+            if( i_bitrate < 16000 )
+                i_bitrate *= 1000;
+        }
+        if( *psz_end != '\0' || (i_width == 0 && i_height == 0) )
+        {
+            msg_Err( p_stream, "invalid video rendition `%s'", psz_rung );
+            continue;
+        }
+
+        /* The renditions share the encoder name and options */
+        transcode_encoder_config_t *p_cfg =
+            &p_sys->p_vladder_cfg[p_sys->i_vladder++];
+        *p_cfg = p_sys->venc_cfg;
+        p_cfg->video.f_scale = 0;
+        p_cfg->video.i_width = i_width;
+        p_cfg->video.i_height = i_height;
+        p_cfg->video.i_maxwidth = p_cfg->video.i_maxheight = 0;
+        p_cfg->video.i_bitrate = i_bitrate;
+        /* Each rendition already encodes on its own thread */
+        p_cfg->video.threads.i_count = 0;
+
+        msg_Dbg( p_stream, "video rendition %ux%u %ukb/s",
+                 i_width, i_height, i_bitrate / 1000 );
+    }
+    free( psz_ladder );
+}
+
 static void SetSPUEncoderConfig( sout_stream_t *p_stream, transcode_encoder_config_t *p_cfg )
 {
     char *psz_string = var_GetString( p_stream, SOUT_CFG_PREFIX "senc" );
@@ -415,6 +552,13 @@ static int Open( vlc_object_t *p_this )
 
     p_sys->pcr_forwarding_enabled =
         var_GetBool( p_stream, SOUT_CFG_PREFIX "forward-pcr" );
+    /* Parallel segments are sent long after they were received */
+    if( p_sys->pcr_forwarding_enabled &&
+        var_GetInteger( p_stream, SOUT_CFG_PREFIX "segments" ) > 1 )
+    {
+        msg_Warn( p_stream, "not forwarding PCR with parallel segments" );
+        p_sys->pcr_forwarding_enabled = false;
+    }
     if( p_sys->pcr_forwarding_enabled )
     {
         p_sys->pcr_sync = vlc_pcr_sync_New();
@@ -460,6 +604,9 @@ static int Open( vlc_object_t *p_this )
                  p_sys->venc_cfg.video.i_bitrate / 1000 );
     }
 
+    if( p_sys->venc_cfg.i_codec )
+        SetVideoLadderConfig( p_stream, p_sys );
+
     /* Video Filter Parameters */
     sout_filters_config_init( &p_sys->vfilters_cfg );
 
@@ -479,6 +626,13 @@ static int Open( vlc_object_t *p_this )
         free( psz_string );
     }
 
+    p_sys->vfilters_cfg.video.i_pipeline =
+        var_GetInteger( p_stream, SOUT_CFG_PREFIX "pipeline" );
+    p_sys->vfilters_cfg.video.i_segments =
+        var_GetInteger( p_stream, SOUT_CFG_PREFIX "segments" );
+    p_sys->vfilters_cfg.video.i_segment_length = VLC_TICK_FROM_MS(
+        var_GetInteger( p_stream, SOUT_CFG_PREFIX "segment-length" ) );
+
     /* Subpictures SOURCES parameters (not related to subtitles stream) */
     psz_string = var_GetString( p_stream, SOUT_CFG_PREFIX "sfilter" );
     if( psz_string && *psz_string )
@@ -515,6 +669,8 @@ static void Close( sout_stream_t *p_stream )
 {
     sout_stream_sys_t   *p_sys = p_stream->p_sys;
 
+    /* The renditions configurations do not own their strings */
+    free( p_sys->p_vladder_cfg );
     transcode_encoder_config_clean( &p_sys->venc_cfg );
     sout_filters_config_clean( &p_sys->vfilters_cfg );
 
@@ -653,6 +809,8 @@ Add( sout_stream_t *p_stream, const es_format_t *p_fmt, const char *es_id )
         case VIDEO_ES:
             id->p_filterscfg = &p_sys->vfilters_cfg;
             id->p_enccfg = &p_sys->venc_cfg;
+            id->p_ladder_cfg = p_sys->p_vladder_cfg;
+            id->i_ladder_cfg = p_sys->i_vladder;
             break;
         case SPU_ES:
             id->p_filterscfg = NULL;
@@ -681,7 +839,8 @@ Add( sout_stream_t *p_stream, const es_format_t *p_fmt, const char *es_id )
     {
         success = !transcode_video_init(p_stream, p_fmt, id);
         vlc_mutex_lock( &p_sys->lock );
-        if( success && !p_sys->id_video )
+        /* Segments have no single picture chain to overlay on */
+        if( success && !p_sys->id_video && id->p_segments == NULL )
             p_sys->id_video = id;
         vlc_mutex_unlock( &p_sys->lock );
     }
@@ -758,7 +917,7 @@ static void Del( sout_stream_t *p_stream, void *_id )
             if( id == p_sys->id_video )
                 p_sys->id_video = NULL;
             vlc_mutex_unlock( &p_sys->lock );
-            transcode_video_clean( id );
+            transcode_video_clean( p_stream, id );
             break;
         case SPU_ES:
             dec_Delete( id->p_decoder );
@@ -19,6 +19,9 @@ typedef struct
             config_chain_t  *p_deinterlace_cfg;
             char            *psz_spu_sources;
             bool             b_reorient;
+            unsigned         i_pipeline; /**< pipelined stages queue depth */
+            unsigned         i_segments; /**< parallel segments, or 0 */
+            vlc_tick_t       i_segment_length; /**< minimum segment length */
         } video;
     };
 } sout_filters_config_t;
@@ -54,6 +57,8 @@ typedef struct
     /* Video */
     transcode_encoder_config_t venc_cfg;
     sout_filters_config_t vfilters_cfg;
+    transcode_encoder_config_t *p_vladder_cfg; /**< additional renditions */
+    size_t          i_vladder;
 
     /* SPU */
     transcode_encoder_config_t senc_cfg;
@@ -74,6 +79,9 @@ typedef struct
 } sout_stream_sys_t;
 
 struct aout_filters;
+struct transcode_video_pipeline;
+struct transcode_video_ladder;
+struct transcode_video_segments;
 
 struct sout_stream_id_sys_t
 {
@@ -134,6 +142,9 @@ struct sout_stream_id_sys_t
              spu_t           *p_spu;
              vlc_decoder_device *dec_dev;
              vlc_video_context *enc_vctx_in;
+             struct transcode_video_pipeline *p_pipeline; /**< filter/encode stage threads, or NULL */
+             struct transcode_video_ladder *p_ladder; /**< additional renditions, or NULL */
+             struct transcode_video_segments *p_segments; /**< parallel segments, or NULL */
          };
          struct
          {
@@ -150,6 +161,8 @@ struct sout_stream_id_sys_t
     /* Encoder */
     const transcode_encoder_config_t *p_enccfg;
     transcode_encoder_t *encoder;
+    const transcode_encoder_config_t *p_ladder_cfg; /**< video renditions */
+    size_t i_ladder_cfg;
 
     /* Sync */
     date_t          next_input_pts; /**< Incoming calculated PTS */
@@ -225,7 +238,7 @@ int  transcode_audio_init   ( sout_stream_t *, const es_format_t *,
 
 /* VIDEO */
 
-void transcode_video_clean  ( sout_stream_id_sys_t * );
+void transcode_video_clean  ( sout_stream_t *, sout_stream_id_sys_t * );
 int  transcode_video_process( sout_stream_t *, sout_stream_id_sys_t *,
                                      block_t *, block_t ** );
 void transcode_video_flush  ( sout_stream_id_sys_t * );
@@ -234,3 +247,12 @@ int transcode_video_get_output_dimensions( sout_stream_id_sys_t *,
 void transcode_video_push_spu( sout_stream_t *, sout_stream_id_sys_t *, subpicture_t * );
 int  transcode_video_init    ( sout_stream_t *, const es_format_t *,
                                sout_stream_id_sys_t *);
+
+/* VIDEO SEGMENTS */
+
+int  transcode_video_segments_New    ( sout_stream_t *, const es_format_t *,
+                                       sout_stream_id_sys_t * );
+void transcode_video_segments_Delete ( sout_stream_id_sys_t * );
+int  transcode_video_segments_Process( sout_stream_t *, sout_stream_id_sys_t *,
+                                       block_t *, block_t ** );
+void transcode_video_segments_Flush  ( sout_stream_id_sys_t * );
@@ -80,6 +80,180 @@ static vlc_decoder_device * video_get_decoder_device( decoder_t *p_dec )
     return TranscodeHoldDecoderDevice(&p_dec->obj, p_owner->id);
 }
 
+/* Pipelined mode: the decoder thread only decodes, the deinterlace/fps
+ * filters run on the first stage thread, and the user filters, final
+ * conversion, subpicture blending and encoding run on the second one. */
+#define TRANSCODE_VIDEO_STAGES 2
+
+struct transcode_video_stage
+{
+    void *opaque;
+    void (*pf_process)( void *, picture_t * );
+
+    vlc_thread_t    thread;
+    vlc_mutex_t     lock;
+    vlc_cond_t      wait_request;
+    vlc_cond_t      wait_done;
+    picture_fifo_t *pics;
+    size_t          i_queued;
+    size_t          i_max;
+    bool            b_busy;
+    bool            b_closing;
+};
+
+struct transcode_video_pipeline
+{
+    struct transcode_video_stage stages[TRANSCODE_VIDEO_STAGES];
+};
+
+static void *transcode_video_stage_Thread( void *data )
+{
+    struct transcode_video_stage *stage = data;
+
+    vlc_thread_set_name( "vlc-transcode-vf" );
+
+    vlc_mutex_lock( &stage->lock );
+    for( ;; )
+    {
+        picture_t *p_pic;
+
+        while( !stage->b_closing &&
+               (p_pic = picture_fifo_Pop( stage->pics )) == NULL )
+            vlc_cond_wait( &stage->wait_request, &stage->lock );
+
+        if( stage->b_closing )
+            break;
+
+        stage->i_queued--;
+        stage->b_busy = true;
+        vlc_cond_broadcast( &stage->wait_done );
+        vlc_mutex_unlock( &stage->lock );
+
+        stage->pf_process( stage->opaque, p_pic );
+
+        vlc_mutex_lock( &stage->lock );
+        stage->b_busy = false;
+        vlc_cond_broadcast( &stage->wait_done );
+    }
+    vlc_mutex_unlock( &stage->lock );
+
+    return NULL;
+}
+
+static int transcode_video_stage_Start( struct transcode_video_stage *stage,
+                                        void (*pf_process)( void *, picture_t * ),
+                                        void *opaque, size_t i_max )
+{
+    stage->opaque = opaque;
+    stage->pf_process = pf_process;
+    vlc_mutex_init( &stage->lock );
+    vlc_cond_init( &stage->wait_request );
+    vlc_cond_init( &stage->wait_done );
+    stage->i_queued = 0;
+    stage->i_max = i_max;
+    stage->b_busy = false;
+    stage->b_closing = false;
+    stage->pics = picture_fifo_New();
+    if( stage->pics == NULL )
+        return VLC_ENOMEM;
+
+    if( vlc_clone( &stage->thread, transcode_video_stage_Thread, stage ) )
+    {
+        picture_fifo_Delete( stage->pics );
+        return VLC_EGENERIC;
+    }
+    return VLC_SUCCESS;
+}
+
+static void transcode_video_stage_Push( struct transcode_video_stage *stage,
+                                        picture_t *p_pic )
+{
+    vlc_mutex_lock( &stage->lock );
+    while( stage->i_queued >= stage->i_max )
+        vlc_cond_wait( &stage->wait_done, &stage->lock );
+    picture_fifo_Push( stage->pics, p_pic );
+    stage->i_queued++;
+    vlc_cond_signal( &stage->wait_request );
+    vlc_mutex_unlock( &stage->lock );
+}
+
+static void transcode_video_stage_WaitIdle( struct transcode_video_stage *stage,
+                                            bool b_discard )
+{
+    vlc_mutex_lock( &stage->lock );
+    if( b_discard )
+    {
+        picture_fifo_Flush( stage->pics, VLC_TICK_INVALID, true );
+        stage->i_queued = 0;
+        vlc_cond_broadcast( &stage->wait_done );
+    }
+    while( stage->i_queued > 0 || stage->b_busy )
+        vlc_cond_wait( &stage->wait_done, &stage->lock );
+    vlc_mutex_unlock( &stage->lock );
+}
+
+/**
+ * Wait until all the pictures queued in the pipeline went through all the
+ * stages, or have been discarded.
+ */
+static void transcode_video_pipeline_WaitIdle( sout_stream_id_sys_t *id,
+                                               bool b_discard )
+{
+    /* Stages only push forward: once a stage is idle, it will not feed the
+     * next one anymore. */
+    for( size_t i = 0; i < TRANSCODE_VIDEO_STAGES; i++ )
+        transcode_video_stage_WaitIdle( &id->p_pipeline->stages[i], b_discard );
+}
+
+static void transcode_video_stage_Stop( struct transcode_video_stage *stage )
+{
+    vlc_mutex_lock( &stage->lock );
+    stage->b_closing = true;
+    vlc_cond_signal( &stage->wait_request );
+    vlc_mutex_unlock( &stage->lock );
+
+    vlc_join( stage->thread, NULL );
+    picture_fifo_Delete( stage->pics );
+}
+
+static void transcode_video_pipeline_Delete( sout_stream_id_sys_t *id )
+{
+    for( size_t i = 0; i < TRANSCODE_VIDEO_STAGES; i++ )
+        transcode_video_stage_Stop( &id->p_pipeline->stages[i] );
+    free( id->p_pipeline );
+    id->p_pipeline = NULL;
+}
+
+static void transcode_video_filter_stage( void *, picture_t * );
+static void transcode_video_encode_stage( void *, picture_t * );
+
+static int transcode_video_pipeline_New( sout_stream_id_sys_t *id,
+                                         unsigned i_depth )
+{
+    struct transcode_video_pipeline *pipeline = malloc( sizeof(*pipeline) );
+    if( unlikely(pipeline == NULL) )
+        return VLC_ENOMEM;
+
+    void (*const process[TRANSCODE_VIDEO_STAGES])( void *, picture_t * ) = {
+        transcode_video_filter_stage, transcode_video_encode_stage,
+    };
+
+    size_t i;
+    for( i = 0; i < TRANSCODE_VIDEO_STAGES; i++ )
+        if( transcode_video_stage_Start( &pipeline->stages[i], process[i],
+                                         id, i_depth ) != VLC_SUCCESS )
+            goto error;
+
+    id->p_pipeline = pipeline;
+    return VLC_SUCCESS;
+
+error:
+    while( i-- > 0 )
+        transcode_video_stage_Stop( &pipeline->stages[i] );
+    free( pipeline );
+    return VLC_EGENERIC;
+}
+
 static void debug_format( vlc_object_t *p_obj, const es_format_t *fmt )
 {
     msg_Dbg( p_obj, "format now %4.4s/%4.4s %dx%d(%dx%d) ø%d",
@@ -107,6 +281,454 @@ static const struct filter_video_callbacks transcode_filter_video_cbs =
     transcode_video_filter_buffer_new, transcode_video_filter_hold_device,
 };
 
+static transcode_encoder_t *transcode_video_encoder_new( sout_stream_t *p_stream,
+                                                         sout_stream_id_sys_t *id,
+                                                         const es_format_t *p_fmt )
+{
+    struct encoder_owner *p_enc_owner =
+       (struct encoder_owner *)sout_EncoderCreate( VLC_OBJECT(p_stream), sizeof(struct encoder_owner) );
+    if ( unlikely(p_enc_owner == NULL))
+        return NULL;
+
+    transcode_encoder_t *encoder = transcode_encoder_new( &p_enc_owner->enc, p_fmt );
+    if( !encoder )
+    {
+        vlc_object_delete( &p_enc_owner->enc );
+        return NULL;
+    }
+
+    p_enc_owner->id = id;
+    p_enc_owner->enc.cbs = &encoder_video_transcode_cbs;
+    return encoder;
+}
+
+/* Converter (and scaler) from the filtered pictures to the encoder input */
+static int transcode_video_conv_new( sout_stream_t *p_stream,
+                                     sout_stream_id_sys_t *id,
+                                     filter_chain_t **pp_conv,
+                                     const es_format_t *p_src,
+                                     vlc_video_context *src_ctx,
+                                     const es_format_t *p_dst )
+{
+    if( video_format_IsSimilar( &p_dst->video, &p_src->video ) )
+        return VLC_SUCCESS;
+
+    filter_owner_t chain_owner = {
+       .video = &transcode_filter_video_cbs,
+       .sys = id,
+    };
+
+    if( !*pp_conv )
+    {
+        *pp_conv = filter_chain_NewVideo( p_stream, false, &chain_owner );
+        if( !*pp_conv )
+            return VLC_EGENERIC;
+    }
+    filter_chain_Reset( *pp_conv, p_src, src_ctx, p_dst );
+    return filter_chain_AppendConverter( *pp_conv, NULL );
+}
+
+/* Ladder mode: the filtered pictures are also scaled and encoded into
+ * additional renditions, each on its own thread. The decoding, the
+ * deinterlace/fps/user filters and the subpicture blending are shared with
+ * the main rendition. */
+
+#define LADDER_KEYFRAMES 16
+
+/* Dates of the keyframes not checked yet */
+struct transcode_video_keyframes
+{
+    vlc_tick_t dates[LADDER_KEYFRAMES];
+    size_t     i_count;
+};
+
+static void transcode_video_keyframes_Push( struct transcode_video_keyframes *k,
+                                            vlc_tick_t i_date )
+{
+    if( k->i_count == LADDER_KEYFRAMES )
+    {   /* too far ahead of the other side, forget the oldest */
+        memmove( &k->dates[0], &k->dates[1],
+                 (LADDER_KEYFRAMES - 1) * sizeof(k->dates[0]) );
+        k->i_count--;
+    }
+    k->dates[k->i_count++] = i_date;
+}
+
+static void transcode_video_keyframes_Drop( struct transcode_video_keyframes *k,
+                                            size_t i_drop )
+{
+    k->i_count -= i_drop;
+    memmove( &k->dates[0], &k->dates[i_drop], k->i_count * sizeof(k->dates[0]) );
+}
+
+struct transcode_video_rendition
+{
+    sout_stream_id_sys_t *id;
+    const transcode_encoder_config_t *p_enccfg;
+    transcode_encoder_t *encoder;
+    filter_chain_t  *p_conv; /**< scaler/converter to the encoder input */
+
+    char            *es_id;
+    void            *downstream_id;
+    vlc_fifo_t      *output_fifo;
+    struct transcode_video_keyframes main_keyframes;
+    struct transcode_video_keyframes keyframes;
+    vlc_tick_t       i_progress; /**< all the keyframes until this date are out */
+    bool             b_misaligned;
+    bool             b_ready; /**< only changed while the stage is idle */
+    bool             b_error;
+
+    struct transcode_video_stage stage;
+};
+
+struct transcode_video_ladder
+{
+    vlc_tick_t i_progress; /**< same as the renditions, for the main one */
+    size_t     i_count;
+    struct transcode_video_rendition renditions[];
+};
+
+static void transcode_video_rendition_queue_output( struct transcode_video_rendition *r,
+                                                    block_t *p_block )
+{
+    if( p_block == NULL )
+        return;
+
+    vlc_fifo_Lock( r->output_fifo );
+    if( r->b_error )
+    {
+        vlc_fifo_Unlock( r->output_fifo );
+        block_ChainRelease( p_block );
+        return;
+    }
+
+    vlc_fifo_QueueUnlocked( r->output_fifo, p_block );
+    vlc_fifo_Unlock( r->output_fifo );
+}
+
+static void transcode_video_rendition_stage( void *data, picture_t *p_pic )
+{
+    struct transcode_video_rendition *r = data;
+    block_t *p_block = NULL;
+
+    for( picture_t *p_in = p_pic;; p_in = NULL /* drain second time */ )
+    {
+        if( r->p_conv )
+            p_in = filter_chain_VideoFilter( r->p_conv, p_in );
+
+        if( !p_in )
+            break;
+
+        block_ChainAppend( &p_block, transcode_encoder_encode( r->encoder, p_in ) );
+        picture_Release( p_in );
+    }
+
+    transcode_video_rendition_queue_output( r, p_block );
+}
+
+static void transcode_video_ladder_Delete( sout_stream_t *p_stream,
+                                           sout_stream_id_sys_t *id )
+{
+    struct transcode_video_ladder *ladder = id->p_ladder;
+
+    for( size_t i = 0; i < ladder->i_count; i++ )
+    {
+        struct transcode_video_rendition *r = &ladder->renditions[i];
+
+        transcode_video_stage_Stop( &r->stage );
+
+        if( r->downstream_id )
+            sout_StreamIdDel( p_stream->p_next, r->downstream_id );
+        if( r->encoder )
+            transcode_encoder_delete( r->encoder );
+        transcode_remove_filters( &r->p_conv );
+        block_FifoRelease( r->output_fifo );
+        free( r->es_id );
+    }
+    free( ladder );
+    id->p_ladder = NULL;
+}
+
+static int transcode_video_ladder_New( sout_stream_t *p_stream,
+                                       sout_stream_id_sys_t *id,
+                                       unsigned i_depth )
+{
+    struct transcode_video_ladder *ladder =
+        malloc( sizeof(*ladder) + id->i_ladder_cfg * sizeof(ladder->renditions[0]) );
+    if( unlikely(ladder == NULL) )
+        return VLC_ENOMEM;
+
+    ladder->i_progress = VLC_TICK_INVALID;
+    ladder->i_count = 0;
+    id->p_ladder = ladder;
+
+    for( size_t i = 0; i < id->i_ladder_cfg; i++ )
+    {
+        struct transcode_video_rendition *r = &ladder->renditions[i];
+
+        r->id = id;
+        r->p_enccfg = &id->p_ladder_cfg[i];
+        r->encoder = NULL;
+        r->p_conv = NULL;
+        r->downstream_id = NULL;
+        r->main_keyframes.i_count = 0;
+        r->keyframes.i_count = 0;
+        r->i_progress = VLC_TICK_INVALID;
+        r->b_misaligned = false;
+        r->b_ready = false;
+        r->b_error = false;
+
+        if( asprintf( &r->es_id, "%s/rendition%zu", id->es_id, i + 1 ) == -1 )
+            goto error;
+
+        r->output_fifo = block_FifoNew();
+        if( r->output_fifo == NULL )
+        {
+            free( r->es_id );
+            goto error;
+        }
+
+        if( transcode_video_stage_Start( &r->stage, transcode_video_rendition_stage,
+                                         r, i_depth ) != VLC_SUCCESS )
+        {
+            block_FifoRelease( r->output_fifo );
+            free( r->es_id );
+            goto error;
+        }
+        ladder->i_count++;
+    }
+    return VLC_SUCCESS;
+
+error:
+    transcode_video_ladder_Delete( p_stream, id );
+    return VLC_EGENERIC;
+}
+
+/**
+ * Sets the renditions up for the new filtered format.
+ *
+ * The encoders are opened on the first call only: the following format
+ * changes are absorbed by the converters, as for the main rendition.
+ */
+static void transcode_video_ladder_Update( sout_stream_t *p_stream,
+                                           sout_stream_id_sys_t *id,
+                                           const es_format_t *p_src,
+                                           vlc_video_context *src_ctx )
+{
+    struct transcode_video_ladder *ladder = id->p_ladder;
+
+    for( size_t i = 0; i < ladder->i_count; i++ )
+    {
+        struct transcode_video_rendition *r = &ladder->renditions[i];
+
+        r->b_ready = false;
+        transcode_remove_filters( &r->p_conv );
+
+        if( r->encoder == NULL )
+        {
+            r->encoder = transcode_video_encoder_new( p_stream, id,
+                                                      &id->p_decoder->fmt_out );
+            if( r->encoder == NULL )
+                continue;
+        }
+
+        if( !transcode_encoder_opened( r->encoder ) )
+        {
+            transcode_encoder_update_format_in( r->encoder, p_src, r->p_enccfg );
+            transcode_encoder_video_configure( VLC_OBJECT(p_stream),
+                       &id->p_decoder->fmt_out.video,
+                       r->p_enccfg,
+                       &p_src->video,
+                       src_ctx,
+                       r->encoder );
+
+            if( transcode_encoder_open( r->encoder, r->p_enccfg ) != VLC_SUCCESS )
+            {
+                msg_Err( p_stream, "cannot open the encoder of rendition %s",
+                         r->es_id );
+                continue;
+            }
+        }
+
+        if( transcode_video_conv_new( p_stream, id, &r->p_conv, p_src, src_ctx,
+                    transcode_encoder_format_in( r->encoder ) ) != VLC_SUCCESS )
+        {
+            msg_Err( p_stream, "cannot convert to rendition %s", r->es_id );
+            continue;
+        }
+
+        if( !r->downstream_id )
+            r->downstream_id =
+                id->pf_transcode_downstream_add( p_stream,
+                                                 id->p_decoder->fmt_in,
+                                                 transcode_encoder_format_out( r->encoder ),
+                                                 r->es_id );
+        r->b_ready = r->downstream_id != NULL;
+    }
+}
+
+static void transcode_video_ladder_Push( sout_stream_id_sys_t *id,
+                                         picture_t *p_pic )
+{
+    struct transcode_video_ladder *ladder = id->p_ladder;
+
+    for( size_t i = 0; i < ladder->i_count; i++ )
+    {
+        struct transcode_video_rendition *r = &ladder->renditions[i];
+
+        if( r->b_ready )
+            transcode_video_stage_Push( &r->stage, picture_Hold( p_pic ) );
+    }
+}
+
+static void transcode_video_ladder_WaitIdle( sout_stream_id_sys_t *id,
+                                             bool b_discard )
+{
+    struct transcode_video_ladder *ladder = id->p_ladder;
+
+    for( size_t i = 0; i < ladder->i_count; i++ )
+        transcode_video_stage_WaitIdle( &ladder->renditions[i].stage, b_discard );
+}
+
+static void transcode_video_ladder_Drain( sout_stream_t *p_stream,
+                                          sout_stream_id_sys_t *id )
+{
+    struct transcode_video_ladder *ladder = id->p_ladder;
+
+    transcode_video_ladder_WaitIdle( id, false );
+
+    for( size_t i = 0; i < ladder->i_count; i++ )
+    {
+        struct transcode_video_rendition *r = &ladder->renditions[i];
+        block_t *p_block = NULL;
+
+        if( r->b_ready &&
+            transcode_encoder_drain( r->encoder, &p_block ) != VLC_SUCCESS )
+            msg_Warn( p_stream, "Draining rendition %s failed", r->es_id );
+        transcode_video_rendition_queue_output( r, p_block );
+    }
+}
+
+/**
+ * Records the keyframes of an encoder output.
+ *
+ * The blocks come out in decoding order: once a block is out, no keyframe
+ * can follow with a presentation date before its decoding date.
+ */
+static void ladder_scan_output( const block_t *p_block,
+                                struct transcode_video_keyframes *p_keys,
+                                vlc_tick_t *pi_progress )
+{
+    for( ; p_block != NULL; p_block = p_block->p_next )
+    {
+        vlc_tick_t i_date = p_block->i_dts != VLC_TICK_INVALID ? p_block->i_dts
+                                                                : p_block->i_pts;
+        if( (p_block->i_flags & BLOCK_FLAG_TYPE_I) &&
+            p_block->i_pts != VLC_TICK_INVALID )
+            transcode_video_keyframes_Push( p_keys, p_block->i_pts );
+        if( i_date != VLC_TICK_INVALID && i_date > *pi_progress )
+            *pi_progress = i_date;
+    }
+}
+
+/**
+ * Matches the keyframes of a rendition with the main ones, up to the date
+ * both encoders have reached.
+ *
+ * @return the first unmatched keyframe date or VLC_TICK_INVALID
+ */
+static vlc_tick_t transcode_video_rendition_CheckKeyframes(
+                struct transcode_video_rendition *r, vlc_tick_t i_main_progress )
+{
+    struct transcode_video_keyframes *m = &r->main_keyframes, *k = &r->keyframes;
+    vlc_tick_t i_limit = __MIN( i_main_progress, r->i_progress );
+    vlc_tick_t i_unmatched = VLC_TICK_INVALID;
+    size_t i_m = 0, i_k = 0;
+
+    for( ;; )
+    {
+        bool b_m = i_m < m->i_count && m->dates[i_m] <= i_limit;
+        bool b_k = i_k < k->i_count && k->dates[i_k] <= i_limit;
+
+        if( b_m && b_k && m->dates[i_m] == k->dates[i_k] )
+        {
+            i_m++;
+            i_k++;
+        }
+        else if( b_m && (!b_k || m->dates[i_m] < k->dates[i_k]) )
+        {
+            if( i_unmatched == VLC_TICK_INVALID )
+                i_unmatched = m->dates[i_m];
+            i_m++;
+        }
+        else if( b_k )
+        {
+            if( i_unmatched == VLC_TICK_INVALID )
+                i_unmatched = k->dates[i_k];
+            i_k++;
+        }
+        else
+            break;
+    }
+
+    transcode_video_keyframes_Drop( m, i_m );
+    transcode_video_keyframes_Drop( k, i_k );
+    return i_unmatched;
+}
+
+/* Sends the renditions output, and checks their keyframes against the
+ * main rendition ones */
+static void transcode_video_ladder_Send( sout_stream_t *p_stream,
+                                         sout_stream_id_sys_t *id,
+                                         const block_t *p_main )
+{
+    struct transcode_video_ladder *ladder = id->p_ladder;
+    const vlc_tick_t i_main_progress = ladder->i_progress;
+
+    for( size_t i = 0; i < ladder->i_count; i++ )
+    {
+        struct transcode_video_rendition *r = &ladder->renditions[i];
+
+        ladder->i_progress = i_main_progress;
+        ladder_scan_output( p_main, &r->main_keyframes, &ladder->i_progress );
+
+        vlc_fifo_Lock( r->output_fifo );
+        block_t *p_out = vlc_fifo_DequeueAllUnlocked( r->output_fifo );
+        vlc_fifo_Unlock( r->output_fifo );
+
+        ladder_scan_output( p_out, &r->keyframes, &r->i_progress );
+
+        vlc_tick_t i_unmatched =
+            transcode_video_rendition_CheckKeyframes( r, ladder->i_progress );
+        if( i_unmatched != VLC_TICK_INVALID && !r->b_misaligned )
+        {
+            msg_Warn( p_stream, "rendition %s keyframes are not aligned with "
+                      "the main ones (at %"PRId64"), set a fixed GOP to "
+                      "switch between them", r->es_id, i_unmatched );
+            r->b_misaligned = true;
+        }
+
+        while( p_out != NULL )
+        {
+            block_t *p_next = p_out->p_next;
+            p_out->p_next = NULL;
+
+            if( sout_StreamIdSend( p_stream->p_next, r->downstream_id,
+                                   p_out ) != VLC_SUCCESS )
+            {
+                msg_Err( p_stream, "rendition %s failed, dropping it",
+                         r->es_id );
+                vlc_fifo_Lock( r->output_fifo );
+                r->b_error = true;
+                vlc_fifo_Unlock( r->output_fifo );
+                block_ChainRelease( p_next );
+                break;
+            }
+            p_out = p_next;
+        }
+    }
+}
+
 static int transcode_video_filters_init( sout_stream_t *p_stream,
                                          const sout_filters_config_t *p_cfg,
                                          const es_format_t *p_src,
@@ -119,6 +741,13 @@ static int video_update_format_decoder( decoder_t *p_dec, vlc_video_context *vct
     struct decoder_owner *p_owner = dec_get_owner( p_dec );
     sout_stream_id_sys_t *id = p_owner->id;
 
+    /* Pictures of the previous format must go through the previous chains
+     * before they are replaced */
+    if( id->p_pipeline != NULL )
+        transcode_video_pipeline_WaitIdle( id, false );
+    if( id->p_ladder != NULL )
+        transcode_video_ladder_WaitIdle( id, false );
+
     vlc_mutex_lock(&id->fifo.lock);
     if( id->encoder != NULL && transcode_encoder_opened( id->encoder ) )
     {
@@ -134,20 +763,13 @@ static int video_update_format_decoder( decoder_t *p_dec, vlc_video_context *vct
     }
     else if( id->encoder == NULL )
     {
-        struct encoder_owner *p_enc_owner =
-           (struct encoder_owner *)sout_EncoderCreate( VLC_OBJECT(p_owner->p_stream), sizeof(struct encoder_owner) );
-        if ( unlikely(p_enc_owner == NULL))
-            return VLC_EGENERIC;
-
-        id->encoder = transcode_encoder_new( &p_enc_owner->enc, &p_dec->fmt_out );
+        id->encoder = transcode_video_encoder_new( p_owner->p_stream, id,
+                                                   &p_dec->fmt_out );
         if( !id->encoder )
         {
-            vlc_object_delete( &p_enc_owner->enc );
+            vlc_mutex_unlock(&id->fifo.lock);
             return VLC_EGENERIC;
         }
-
-        p_enc_owner->id = id;
-        p_enc_owner->enc.cbs = &encoder_video_transcode_cbs;
     }
 
 
@@ -198,27 +820,16 @@ static int video_update_format_decoder( decoder_t *p_dec, vlc_video_context *vct
             goto error;
     }
 
-    const es_format_t *encoder_fmt = transcode_encoder_format_in( id->encoder );
-
-    if( !video_format_IsSimilar(&encoder_fmt->video, &out_fmt->video) )
-    {
-        filter_owner_t chain_owner = {
-           .video = &transcode_filter_video_cbs,
-           .sys = id,
-        };
-
-        if ( !id->p_final_conv_static )
-            id->p_final_conv_static =
-               filter_chain_NewVideo( p_owner->p_stream, false, &chain_owner );
-         filter_chain_Reset( id->p_final_conv_static,
-               out_fmt,
-               enc_vctx,
-               encoder_fmt);
-         if( filter_chain_AppendConverter( id->p_final_conv_static, NULL ) != VLC_SUCCESS )
-             goto error;
-    }
+    if( transcode_video_conv_new( p_owner->p_stream, id,
+                                  &id->p_final_conv_static,
+                                  out_fmt, enc_vctx,
+                                  transcode_encoder_format_in( id->encoder ) ) != VLC_SUCCESS )
+        goto error;
     vlc_mutex_unlock(&id->fifo.lock);
 
+    if( id->p_ladder != NULL )
+        transcode_video_ladder_Update( p_owner->p_stream, id, out_fmt, enc_vctx );
+
     if( !id->downstream_id )
         id->downstream_id =
             id->pf_transcode_downstream_add( p_owner->p_stream,
@@ -249,22 +860,18 @@ static picture_t *video_new_buffer_encoder( transcode_encoder_t *p_enc )
     return picture_NewFromFormat( &transcode_encoder_format_in( p_enc )->video );
 }
 
-static int transcode_process_picture( sout_stream_id_sys_t *id,
-                                      picture_t *p_pic, block_t **out);
+static void transcode_process_picture( sout_stream_id_sys_t *id,
+                                       picture_t *p_pic, block_t **out);
+static void transcode_encode_picture( sout_stream_id_sys_t *id,
+                                      picture_t *p_pic, block_t **out );
 
-static void decoder_queue_video( decoder_t *p_dec, picture_t *p_pic )
+static void transcode_video_queue_output( sout_stream_id_sys_t *id,
+                                          block_t *p_block )
 {
-    struct decoder_owner *p_owner = dec_get_owner( p_dec );
-    sout_stream_id_sys_t *id = p_owner->id;
-
-    block_t *p_block = NULL;
-    int ret = transcode_process_picture( id, p_pic, &p_block );
-
     if( p_block == NULL )
         return;
 
     vlc_fifo_Lock( id->output_fifo );
-    id->b_error |= ret != VLC_SUCCESS;
     if( id->b_error )
     {
         vlc_fifo_Unlock( id->output_fifo );
@@ -276,9 +883,43 @@ static void decoder_queue_video( decoder_t *p_dec, picture_t *p_pic )
     vlc_fifo_Unlock( id->output_fifo );
 }
 
+static void transcode_video_filter_stage( void *data, picture_t *p_pic )
+{
+    sout_stream_id_sys_t *id = data;
+
+    transcode_process_picture( id, p_pic, NULL );
+}
+
+static void transcode_video_encode_stage( void *data, picture_t *p_pic )
+{
+    sout_stream_id_sys_t *id = data;
+    block_t *p_block = NULL;
+    transcode_encode_picture( id, p_pic, &p_block );
+    transcode_video_queue_output( id, p_block );
+}
+
+static void decoder_queue_video( decoder_t *p_dec, picture_t *p_pic )
+{
+    struct decoder_owner *p_owner = dec_get_owner( p_dec );
+    sout_stream_id_sys_t *id = p_owner->id;
+
+    if( id->p_pipeline != NULL )
+    {
+        transcode_video_stage_Push( &id->p_pipeline->stages[0], p_pic );
+        return;
+    }
+
+    block_t *p_block = NULL;
+    transcode_process_picture( id, p_pic, &p_block );
+    transcode_video_queue_output( id, p_block );
+}
+
 int transcode_video_init( sout_stream_t *p_stream, const es_format_t *p_fmt,
                           sout_stream_id_sys_t *id )
 {
+    if( id->p_filterscfg->video.i_segments > 1 )
+        return transcode_video_segments_New( p_stream, p_fmt, id );
+
     msg_Dbg( p_stream,
              "creating video transcoding from fcc=`%4.4s' to fcc=`%4.4s'",
              (char*)&p_fmt->i_codec, (char*)&id->p_enccfg->i_codec );
@@ -322,6 +963,17 @@ int transcode_video_init( sout_stream_t *p_stream, const es_format_t *p_fmt,
         es_format_Copy( &id->decoder_out, &id->p_decoder->fmt_out );
     }
 
+    if( id->p_filterscfg->video.i_pipeline > 0 &&
+        transcode_video_pipeline_New( id, id->p_filterscfg->video.i_pipeline )
+            != VLC_SUCCESS )
+        msg_Warn( p_stream, "cannot create video pipeline, "
+                            "filtering on the decoder thread" );
+
+    if( id->i_ladder_cfg > 0 &&
+        transcode_video_ladder_New( p_stream, id,
+                __MAX(id->p_filterscfg->video.i_pipeline, 1) ) != VLC_SUCCESS )
+        msg_Warn( p_stream, "cannot create the video renditions" );
+
     return VLC_SUCCESS;
 }
 
@@ -396,6 +1048,22 @@ static int transcode_video_filters_init( sout_stream_t *p_stream,
 
 void transcode_video_flush( sout_stream_id_sys_t *id )
 {
+    if( id->p_segments != NULL )
+    {
+        transcode_video_segments_Flush( id );
+        return;
+    }
+
+    if ( id->p_pipeline != NULL )
+        transcode_video_pipeline_WaitIdle( id, true );
+    if ( id->p_ladder != NULL )
+    {
+        transcode_video_ladder_WaitIdle( id, true );
+        for( size_t i = 0; i < id->p_ladder->i_count; i++ )
+            if( id->p_ladder->renditions[i].p_conv != NULL )
+                filter_chain_VideoFlush( id->p_ladder->renditions[i].p_conv );
+    }
+
     if ( id->p_f_chain != NULL )
         filter_chain_VideoFlush( id->p_f_chain );
     if ( id->p_uf_chain != NULL )
@@ -404,8 +1072,20 @@ void transcode_video_flush( sout_stream_id_sys_t *id )
         filter_chain_VideoFlush( id->p_final_conv_static );
 }
 
-void transcode_video_clean( sout_stream_id_sys_t *id )
+void transcode_video_clean( sout_stream_t *p_stream, sout_stream_id_sys_t *id )
 {
+    if( id->p_segments != NULL )
+    {
+        transcode_video_segments_Delete( id );
+        return;
+    }
+
+    /* Stop the stages before tearing down what they use */
+    if( id->p_pipeline != NULL )
+        transcode_video_pipeline_Delete( id );
+    if( id->p_ladder != NULL )
+        transcode_video_ladder_Delete( p_stream, id );
+
     /* Close encoder, but only if one was opened. */
     if ( id->encoder )
         transcode_encoder_delete( id->encoder );
@@ -447,7 +1127,8 @@ int transcode_video_get_output_dimensions( sout_stream_id_sys_t *id,
     return (*w && *h) ? VLC_SUCCESS : VLC_EGENERIC;
 }
 
-static picture_t * RenderSubpictures( sout_stream_id_sys_t *id, picture_t *p_pic )
+static picture_t * RenderSubpictures( sout_stream_id_sys_t *id,
+                                      picture_t *p_pic, bool b_writable )
 {
     if( !id->p_spu )
         return p_pic;
@@ -474,11 +1155,10 @@ static picture_t * RenderSubpictures( sout_stream_id_sys_t *id, picture_t *p_pic
     /* Overlay subpicture */
     if( p_subpic )
     {
-        if( filter_chain_IsEmpty( id->p_f_chain ) )
+        if( !b_writable )
         {
-            /* We can't modify the picture, we need to duplicate it,
-                 * in this point the picture is already p_encoder->fmt.in format*/
-            picture_t *p_tmp = video_new_buffer_encoder( id->encoder );
+            /* We can't modify the picture, we need to duplicate it */
+            picture_t *p_tmp = picture_NewFromFormat( &p_pic->format );
             if( likely( p_tmp ) )
             {
                 picture_Copy( p_tmp, p_pic );
@@ -509,8 +1189,50 @@ static void tag_last_block_with_flag( block_t **out, int i_flag )
     }
 }
 
-static int transcode_process_picture( sout_stream_id_sys_t *id,
-                                      picture_t *p_pic, block_t **out)
+static void transcode_encode_picture( sout_stream_id_sys_t *id,
+                                      picture_t *p_pic, block_t **out )
+{
+    for( picture_t *p_in = p_pic;; p_in = NULL /* drain second time */ )
+    {
+        /* Run user specified filter chain */
+        if( id->p_uf_chain )
+            p_in = filter_chain_VideoFilter( id->p_uf_chain, p_in );
+
+        /* The other renditions are scaled from the filtered pictures,
+         * with the subpictures blended once for all of them */
+        if( p_in && id->p_ladder )
+        {
+            p_in = RenderSubpictures( id, p_in,
+                                      !filter_chain_IsEmpty( id->p_f_chain ) ||
+                                      ( id->p_uf_chain &&
+                                        !filter_chain_IsEmpty( id->p_uf_chain ) ) );
+            transcode_video_ladder_Push( id, p_in );
+        }
+
+        if( id->p_final_conv_static )
+            p_in = filter_chain_VideoFilter( id->p_final_conv_static, p_in );
+
+        if( !p_in )
+            break;
+
+        /* Blend subpictures, on a copy of the picture if it may be shared
+         * with the decoder */
+        if( !id->p_ladder )
+            p_in = RenderSubpictures( id, p_in,
+                                      !filter_chain_IsEmpty( id->p_f_chain ) );
+
+        if( p_in )
+        {
+            /* If a packetizer is used, multiple blocks might be returned, in w */
+            block_t *p_encoded = transcode_encoder_encode( id->encoder, p_in );
+            picture_Release( p_in );
+            block_ChainAppend( out, p_encoded );
+        }
+    }
+}
+
+static void transcode_process_picture( sout_stream_id_sys_t *id,
+                                       picture_t *p_pic, block_t **out)
 {
     /* Run the filter and output chains; first with the picture,
      * and then with NULL as many times as we need until they
@@ -525,40 +1247,19 @@ static int transcode_process_picture( sout_stream_id_sys_t *id,
         if( !p_in )
             break;
 
-        for( ;; p_in = NULL /* drain second time */ )
-        {
-            /* Run user specified filter chain */
-            filter_chain_t * secondary_chains[] = { id->p_uf_chain,
-                                                    id->p_final_conv_static };
-            for( size_t i=0; i<ARRAY_SIZE(secondary_chains); i++ )
-            {
-                if( !secondary_chains[i] )
-                    continue;
-                p_in = filter_chain_VideoFilter( secondary_chains[i], p_in );
-            }
-
-            if( !p_in )
-                break;
-
-            /* Blend subpictures */
-            p_in = RenderSubpictures( id, p_in );
-
-            if( p_in )
-            {
-                /* If a packetizer is used, multiple blocks might be returned, in w */
-                block_t *p_encoded = transcode_encoder_encode( id->encoder, p_in );
-                picture_Release( p_in );
-                block_ChainAppend( out, p_encoded );
-            }
-        }
+        if( id->p_pipeline != NULL )
+            transcode_video_stage_Push( &id->p_pipeline->stages[1], p_in );
+        else
+            transcode_encode_picture( id, p_in, out );
     }
-
-    return VLC_SUCCESS;
 }
 
 int transcode_video_process( sout_stream_t *p_stream, sout_stream_id_sys_t *id,
                                     block_t *in, block_t **out )
 {
+    if( id->p_segments != NULL )
+        return transcode_video_segments_Process( p_stream, id, in, out );
+
     *out = NULL;
 
     bool b_eos = in && (in->i_flags & BLOCK_FLAG_END_OF_SEQUENCE);
@@ -574,6 +1275,12 @@ int transcode_video_process( sout_stream_t *p_stream, sout_stream_id_sys_t *id,
     if( id->encoder == NULL )
         return VLC_SUCCESS;
 
+    /* All the decoded pictures must reach the encoder before draining it */
+    if( unlikely( in == NULL ) && id->p_pipeline != NULL )
+        transcode_video_pipeline_WaitIdle( id, false );
+    if( unlikely( in == NULL ) && id->p_ladder != NULL )
+        transcode_video_ladder_Drain( p_stream, id );
+
     vlc_fifo_Lock( id->output_fifo );
     if( unlikely( !id->b_error && in == NULL ) && transcode_encoder_opened( id->encoder ) )
     {
@@ -594,5 +1301,9 @@ int transcode_video_process( sout_stream_t *p_stream, sout_stream_id_sys_t *id,
     if( b_eos )
         tag_last_block_with_flag( out, BLOCK_FLAG_END_OF_SEQUENCE );
 
+    /* Sent first, so that they are not late for the main rendition PCR */
+    if( id->p_ladder != NULL && !has_error )
+        transcode_video_ladder_Send( p_stream, id, *out );
+
     return has_error ? VLC_EGENERIC : VLC_SUCCESS;
 }
@@ -148,6 +148,23 @@ static int Control(sout_stream_t *stream, int query, va_list args)
     return VLC_SUCCESS;
 }
 
+static int AccessOutControl(sout_access_out_t *access, int query,
+                            va_list args)
+{
+    struct sout_stream_udp *sys = access->p_sys;
+
+    switch (query) {
+        case ACCESS_OUT_GET_WRITE_SIZE:
+            /* Whole TS packets in each datagram, without IP fragmentation */
+            *va_arg(args, size_t *) = __MAX(sys->mtu / 188, 1) * 188;
+            break;
+
+        default:
+            return VLC_EGENERIC;
+    }
+    return VLC_SUCCESS;
+}
+
 static ssize_t AccessOutWrite(sout_access_out_t *access, block_t *block)
 {
     struct sout_stream_udp *sys = access->p_sys;
@@ -310,7 +327,7 @@ static int Open(vlc_object_t *obj)
     access->pf_seek = NULL;
     access->pf_read = NULL;
     access->pf_write = AccessOutWrite;
-    access->pf_control = NULL;
+    access->pf_control = AccessOutControl;
     access->p_cfg = NULL;
     sys->access = access;
     sys->fd = fd;
@@ -41,12 +41,14 @@
 #include <vlc_subpicture.h>
 #include <vlc_text_style.h>                                   /* text_style_t*/
 #include <vlc_charset.h>
+#include <vlc_memstream.h>
 
 #include <assert.h>
 
 #include "platform_fonts.h"
 #include "freetype.h"
 #include "text_layout.h"
+#include "lru.h"
 #include "blend/rgb.h"
 #include "blend/yuv.h"
 
@@ -87,6 +89,9 @@ static void Destroy( filter_t * );
 #define SHADOW_DISTANCE_TEXT N_("Shadow distance")
 #define CACHE_SIZE_TEXT N_("Cache size")
 #define CACHE_SIZE_LONGTEXT N_("Cache size in kBytes")
+#define LAYOUT_CACHE_TEXT N_("Layout cache size")
+#define LAYOUT_CACHE_LONGTEXT N_("Number of shaped and laid out texts kept " \
+    "for reuse when the same text is rendered again (0 = disabled).")
 
 #define TEXT_DIRECTION_TEXT N_("Text direction")
 #define TEXT_DIRECTION_LONGTEXT N_("Paragraph base direction for the Unicode bi-directional algorithm.")
@@ -184,6 +189,9 @@ vlc_module_begin ()
     add_integer_with_range( "freetype-cache-size", 200, 25, (UINT32_MAX >> 10),
                             CACHE_SIZE_TEXT, CACHE_SIZE_LONGTEXT )
         change_safe()
+    add_integer_with_range( "freetype-layout-cache", 32, 0, 1024,
+                            LAYOUT_CACHE_TEXT, LAYOUT_CACHE_LONGTEXT )
+        change_safe()
 
     add_obsolete_integer( "freetype-fontsize" ) /* since 4.0.0 */
     add_obsolete_integer( "freetype-rel-fontsize" ) /* since 4.0.0 */
@@ -918,6 +926,106 @@ static size_t SegmentsToTextAndStyles( filter_t *p_filter, const text_segment_t
     return i_nb_char;
 }
 
+static void FreeTextBlock( layout_text_block_t *p_text_block )
+{
+    if( p_text_block->p_laid )
+        FreeLines( p_text_block->p_laid );
+
+    free( p_text_block->p_uchars );
+    FreeStylesArray( p_text_block->pp_styles, p_text_block->i_count );
+    if( p_text_block->pp_ruby )
+        FreeRubyBlockArray( p_text_block->pp_ruby, p_text_block->i_count );
+}
+
+/* Laid out text block kept in the layout cache */
+typedef struct
+{
+    layout_text_block_t text_block;
+    FT_BBox bbox;
+    int i_max_face_height;
+} layout_cache_entry_t;
+
+static void LayoutCacheRelease( void *priv, void *value )
+{
+    layout_cache_entry_t *p_entry = value;
+
+    VLC_UNUSED(priv);
+    FreeTextBlock( &p_entry->text_block );
+    free( p_entry );
+}
+
+static void LayoutCacheKeyStyle( struct vlc_memstream *ms,
+                                 const text_style_t *p_style )
+{
+    vlc_memstream_printf( ms, "|%s|%s|%"PRIx16",%"PRIx16",%a,%d,"
+                          "%"PRIx32",%"PRIx8",%d,%"PRIx32",%"PRIx8",%d,"
+                          "%"PRIx32",%"PRIx8",%d,%"PRIx32",%"PRIx8",%d|",
+                          p_style->psz_fontname ? p_style->psz_fontname : "",
+                          p_style->psz_monofontname ? p_style->psz_monofontname : "",
+                          p_style->i_features, p_style->i_style_flags,
+                          p_style->f_font_relsize, p_style->i_font_size,
+                          p_style->i_font_color, p_style->i_font_alpha,
+                          p_style->i_spacing,
+                          p_style->i_outline_color, p_style->i_outline_alpha,
+                          p_style->i_outline_width,
+                          p_style->i_shadow_color, p_style->i_shadow_alpha,
+                          p_style->i_shadow_width,
+                          p_style->i_background_color,
+                          p_style->i_background_alpha,
+                          (int)p_style->e_wrapinfo );
+}
+
+/**
+ * Builds the layout cache key of a text block.
+ *
+ * The key covers everything the layout depends on: the text and its styles,
+ * the layout constraints and the renderer state affecting the glyphs.
+ */
+static char *LayoutCacheKey( filter_t *p_filter,
+                             const layout_text_block_t *p_text_block )
+{
+    filter_sys_t *p_sys = p_filter->p_sys;
+    struct vlc_memstream ms;
+
+    if( vlc_memstream_open( &ms ) )
+        return NULL;
+
+    vlc_memstream_printf( &ms, "%p,%d,%d,%u,%d,%u,%u,%d,%d|",
+                          (void *)p_sys->p_faceid, p_sys->i_scale,
+                          p_sys->i_font_default_size,
+                          p_filter->fmt_out.video.i_height,
+                          p_sys->i_outline_thickness,
+                          p_text_block->i_max_width, p_text_block->i_max_height,
+                          p_text_block->b_balanced, p_text_block->b_grid );
+
+    const text_style_t *p_style = NULL;
+    const ruby_block_t *p_ruby = NULL;
+    for( size_t i = 0; i < p_text_block->i_count; i++ )
+    {
+        if( p_text_block->pp_styles[i] != p_style )
+        {
+            p_style = p_text_block->pp_styles[i];
+            LayoutCacheKeyStyle( &ms, p_style );
+        }
+        if( p_text_block->pp_ruby && p_text_block->pp_ruby[i] != p_ruby )
+        {
+            p_ruby = p_text_block->pp_ruby[i];
+            vlc_memstream_putc( &ms, '[' );
+            if( p_ruby )
+                for( size_t j = 0; j < p_ruby->i_count; j++ )
+                    vlc_memstream_printf( &ms, "%"PRIx32",",
+                                          (uint32_t)p_ruby->p_uchars[j] );
+            vlc_memstream_putc( &ms, ']' );
+        }
+        vlc_memstream_printf( &ms, "%"PRIx32",",
+                              (uint32_t)p_text_block->p_uchars[i] );
+    }
+
+    if( vlc_memstream_close( &ms ) )
+        return NULL;
+    return ms.ptr;
+}
+
 /**
  * This function renders a text subpicture region into another one.
  * It also calculates the size needed for this string, and renders the
@@ -979,7 +1087,32 @@ static subpicture_region_t *Render( filter_t *p_filter,
 
     text_block.i_max_width = i_max_width;
     text_block.i_max_height = i_max_height;
-    rv = LayoutTextBlock( p_filter, &text_block, &text_block.p_laid, &bbox, &i_max_face_height );
+
+    /* Reuse the shaping and layout of identical text */
+    char *psz_key = NULL;
+    const layout_cache_entry_t *p_cached = NULL;
+    if( p_sys->layout_cache )
+    {
+        psz_key = LayoutCacheKey( p_filter, &text_block );
+        if( psz_key )
+            p_cached = vlc_lru_Get( p_sys->layout_cache, psz_key );
+    }
+
+    const line_desc_t *p_lines;
+    if( p_cached )
+    {
+        p_sys->i_layout_cache_hits++;
+        p_lines = p_cached->text_block.p_laid;
+        bbox = p_cached->bbox;
+        i_max_face_height = p_cached->i_max_face_height;
+        rv = VLC_SUCCESS;
+    }
+    else
+    {
+        p_sys->i_layout_cache_misses++;
+        rv = LayoutTextBlock( p_filter, &text_block, &text_block.p_laid, &bbox, &i_max_face_height );
+        p_lines = text_block.p_laid;
+    }
 
     /* Don't attempt to render text that couldn't be laid out
      * properly. */
@@ -1093,7 +1226,7 @@ static subpicture_region_t *Render( filter_t *p_filter,
         region->fmt.i_sar_den = p_region_in->fmt.i_sar_den;
 
         if( *p_chroma == VLC_CODEC_YUVP )
-            RenderYUVP( p_region_in, region, text_block.p_laid,
+            RenderYUVP( p_region_in, region, p_lines,
                                 &renderbbox, &bbox );
         else
         {
@@ -1131,7 +1264,7 @@ static subpicture_region_t *Render( filter_t *p_filter,
                 continue;
             }
 
-            RenderAXYZ( p_filter, p_region_in, region, text_block.p_laid,
+            RenderAXYZ( p_filter, p_region_in, region, p_lines,
                                  &renderbbox, &paddedbbox, &bbox, func );
         }
 
@@ -1154,12 +1287,23 @@ static subpicture_region_t *Render( filter_t *p_filter,
         msg_Warn( p_filter, "no output chroma supported for rendering" );
 
 done:
-    FreeLines( text_block.p_laid );
-
-    free( text_block.p_uchars );
-    FreeStylesArray( text_block.pp_styles, text_block.i_count );
-    if( text_block.pp_ruby )
-        FreeRubyBlockArray( text_block.pp_ruby, text_block.i_count );
+    if( psz_key && !p_cached && rv == VLC_SUCCESS )
+    {
+        /* The cache takes ownership of the laid out text block */
+        layout_cache_entry_t *p_entry = malloc( sizeof(*p_entry) );
+        if( likely(p_entry) )
+        {
+            p_entry->text_block = text_block;
+            p_entry->bbox = bbox;
+            p_entry->i_max_face_height = i_max_face_height;
+            vlc_lru_Insert( p_sys->layout_cache, psz_key, p_entry );
+        }
+        else
+            FreeTextBlock( &text_block );
+    }
+    else
+        FreeTextBlock( &text_block );
+    free( psz_key );
 
     return region;
 }
@@ -1202,6 +1346,16 @@ static int Create( filter_t *p_filter )
     if( !p_sys->ftcache )
         goto error;
 
+    unsigned i_layout_cache = var_InheritInteger( p_filter, "freetype-layout-cache" );
+    if( i_layout_cache > 0 )
+    {
+        /* The LRU evicts when reaching its maximum */
+        p_sys->layout_cache = vlc_lru_New( i_layout_cache + 1,
+                                           LayoutCacheRelease, NULL );
+        if( !p_sys->layout_cache )
+            goto error;
+    }
+
     p_sys->i_scale = 100;
 
     /* default style to apply to incomplete segments styles */
@@ -1268,6 +1422,17 @@ static void Destroy( filter_t *p_filter )
         DumpFamilies( p_sys->fs );
 #endif
 
+    if( p_sys->layout_cache )
+    {
+        unsigned i_total = p_sys->i_layout_cache_hits
+                         + p_sys->i_layout_cache_misses;
+        if( i_total > 0 )
+            msg_Dbg( p_filter, "layout cache: %u hits, %u misses (%u%%)",
+                     p_sys->i_layout_cache_hits, p_sys->i_layout_cache_misses,
+                     p_sys->i_layout_cache_hits * 100 / i_total );
+        vlc_lru_Release( p_sys->layout_cache );
+    }
+
     if( p_sys->ftcache )
         vlc_ftcache_Delete( p_sys->ftcache );
 
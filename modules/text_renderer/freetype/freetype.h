@@ -113,6 +113,11 @@ typedef struct
     vlc_font_select_t *fs;
     vlc_ftcache_t     *ftcache;
 
+    /* Laid out text blocks, by text, styles and layout constraints */
+    struct vlc_lru    *layout_cache;
+    unsigned           i_layout_cache_hits;
+    unsigned           i_layout_cache_misses;
+
 } filter_sys_t;
 
 /**
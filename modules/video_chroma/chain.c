@@ -28,6 +28,8 @@
 # include "config.h"
 #endif
 
+#include <inttypes.h>
+
 #include <vlc_common.h>
 #include <vlc_plugin.h>
 #include <vlc_filter.h>
@@ -141,6 +143,156 @@ typedef struct
     filter_t *p_video_filter;
 } filter_sys_t;
 
+/*****************************************************************************
+ * Conversion path cache
+ *****************************************************************************
+ * Probing a path loads and opens converter modules for every candidate until
+ * one works. Remember, process-wide, which candidates failed for a given
+ * conversion so that the next chain (format change, vout restart, other
+ * transcode session) skips them, still in the preference order.
+ *
+ * Only software conversions are cached: the candidates that work with a
+ * video context depend on its decoder device. Only the failures of the top
+ * level chains are recorded: nested ones also fail on the recursion limit.
+ * The entries expire, as plugins may be (un)installed meanwhile.
+ *****************************************************************************/
+enum chain_path_kind
+{
+    CHAIN_PATH_CHROMA,        /* failed: index in the allowed chromas */
+    CHAIN_PATH_CHROMA_RESIZE, /* failed: CHAIN_ORDER_* */
+};
+
+enum
+{
+    CHAIN_ORDER_RESIZE_FIRST,
+    CHAIN_ORDER_CHROMA_FIRST,
+};
+
+#define CHAIN_PATH_CACHE_SIZE 32
+#define CHAIN_PATH_CACHE_TTL  VLC_TICK_FROM_SEC(300)
+
+struct chain_path_format
+{
+    vlc_fourcc_t chroma;
+    unsigned width, height;
+    video_orientation_t orientation;
+    video_color_primaries_t primaries;
+    video_transfer_func_t transfer;
+    video_color_space_t space;
+    video_color_range_t color_range;
+};
+
+struct chain_path_key
+{
+    enum chain_path_kind kind;
+    int64_t level;
+    bool allow_fmt_out_change;
+    struct chain_path_format in;
+    struct chain_path_format out;
+};
+
+static struct
+{
+    struct chain_path_key key;
+    uint32_t failed; /* bit mask of the failed candidates */
+    vlc_tick_t expiry;
+} path_cache[CHAIN_PATH_CACHE_SIZE];
+static size_t path_cache_count;
+static size_t path_cache_next;
+static vlc_mutex_t path_cache_lock = VLC_STATIC_MUTEX;
+
+static void PathCacheFormat( const video_format_t *fmt,
+                             struct chain_path_format *key )
+{
+    key->chroma = fmt->i_chroma;
+    key->width = fmt->i_width;
+    key->height = fmt->i_height;
+    key->orientation = fmt->orientation;
+    key->primaries = fmt->primaries;
+    key->transfer = fmt->transfer;
+    key->space = fmt->space;
+    key->color_range = fmt->color_range;
+}
+
+static bool PathCacheKey( filter_t *p_filter, enum chain_path_kind kind,
+                          struct chain_path_key *key )
+{
+    if( p_filter->vctx_in != NULL )
+        return false;
+
+    /* The key is compared as a whole, padding included */
+    memset( key, 0, sizeof (*key) );
+    key->kind = kind;
+    key->level = var_GetInteger( p_filter, "chain-level" );
+    key->allow_fmt_out_change = p_filter->b_allow_fmt_out_change;
+    PathCacheFormat( &p_filter->fmt_in.video, &key->in );
+    PathCacheFormat( &p_filter->fmt_out.video, &key->out );
+    return true;
+}
+
+static uint32_t PathCacheGet( filter_t *p_filter,
+                              enum chain_path_kind kind )
+{
+    struct chain_path_key key;
+    uint32_t failed = 0;
+
+    if( !PathCacheKey( p_filter, kind, &key ) )
+        return 0;
+
+    const vlc_tick_t now = vlc_tick_now();
+
+    vlc_mutex_lock( &path_cache_lock );
+    for( size_t i = 0; i < path_cache_count; i++ )
+    {
+        if( !memcmp( &path_cache[i].key, &key, sizeof (key) ) )
+        {
+            if( now < path_cache[i].expiry )
+                failed = path_cache[i].failed;
+            break;
+        }
+    }
+    vlc_mutex_unlock( &path_cache_lock );
+    return failed;
+}
+
+static void PathCacheFailed( filter_t *p_filter,
+                             enum chain_path_kind kind, unsigned candidate )
+{
+    struct chain_path_key key;
+    size_t i;
+
+    if( candidate >= 32 || !PathCacheKey( p_filter, kind, &key )
+     || key.level != 1 )
+        return;
+
+    const vlc_tick_t now = vlc_tick_now();
+
+    vlc_mutex_lock( &path_cache_lock );
+    for( i = 0; i < path_cache_count; i++ )
+    {
+        if( !memcmp( &path_cache[i].key, &key, sizeof (key) ) )
+            break;
+    }
+    if( i == path_cache_count )
+    {
+        /* Evict the oldest entry once full */
+        if( path_cache_count < CHAIN_PATH_CACHE_SIZE )
+            i = path_cache_count++;
+        else
+        {
+            i = path_cache_next;
+            path_cache_next = (path_cache_next + 1) % CHAIN_PATH_CACHE_SIZE;
+        }
+        memcpy( &path_cache[i].key, &key, sizeof (key) );
+        path_cache[i].failed = 0;
+    }
+    else if( now >= path_cache[i].expiry )
+        path_cache[i].failed = 0;
+    path_cache[i].failed |= UINT32_C(1) << candidate;
+    path_cache[i].expiry = now + CHAIN_PATH_CACHE_TTL;
+    vlc_mutex_unlock( &path_cache_lock );
+}
+
 /* Restart filter callback */
 static int RestartFilterCallback( vlc_object_t *obj, char const *psz_name,
                                   vlc_value_t oldval, vlc_value_t newval,
@@ -219,7 +371,15 @@ static int Activate( filter_t *p_filter, int (*pf_build)(filter_t *) )
     if( level < 0 || level > CHAIN_LEVEL_MAX )
         msg_Err( p_filter, "Too high level of recursion (%d)", level );
     else
+    {
+        vlc_tick_t start = vlc_tick_now();
         i_ret = pf_build( p_filter );
+        msg_Dbg( p_filter, "%4.4s->%4.4s chain %s in %"PRId64" us",
+                 (const char *)&p_filter->fmt_in.video.i_chroma,
+                 (const char *)&p_filter->fmt_out.video.i_chroma,
+                 i_ret == VLC_SUCCESS ? "built" : "failed",
+                 US_FROM_VLC_TICK(vlc_tick_now() - start) );
+    }
 
     var_Destroy( p_filter, "chain-level" );
 
@@ -331,7 +491,7 @@ static int BuildTransformChain( filter_t *p_filter )
     return i_ret;
 }
 
-static int BuildChromaResize( filter_t *p_filter )
+static int TryResizeChroma( filter_t *p_filter )
 {
     es_format_t fmt_mid;
     int i_ret;
@@ -341,50 +501,83 @@ static int BuildChromaResize( filter_t *p_filter )
     EsFormatMergeSize( &fmt_mid, &p_filter->fmt_in, &p_filter->fmt_out );
     i_ret = CreateResizeChromaChain( p_filter, &fmt_mid );
     es_format_Clean( &fmt_mid );
+    return i_ret;
+}
 
-    if( i_ret == VLC_SUCCESS )
-        return VLC_SUCCESS;
+static int TryChromaResize( filter_t *p_filter )
+{
+    es_format_t fmt_mid;
+    int i_ret;
 
     /* Lets try it the other way around (chroma and then resize) */
     msg_Dbg( p_filter, "Trying to build chroma+resize" );
     EsFormatMergeSize( &fmt_mid, &p_filter->fmt_out, &p_filter->fmt_in );
     i_ret = CreateChain( p_filter, &fmt_mid );
     es_format_Clean( &fmt_mid );
-    if( i_ret == VLC_SUCCESS )
-        return VLC_SUCCESS;
+    return i_ret;
+}
+
+static int BuildChromaResize( filter_t *p_filter )
+{
+    int (*const tries[2])( filter_t * ) = {
+        [CHAIN_ORDER_RESIZE_FIRST] = TryResizeChroma,
+        [CHAIN_ORDER_CHROMA_FIRST] = TryChromaResize,
+    };
+
+    /* Skip the orders known not to work */
+    const uint32_t failed = PathCacheGet( p_filter, CHAIN_PATH_CHROMA_RESIZE );
+
+    for( unsigned i = 0; i < ARRAY_SIZE(tries); i++ )
+    {
+        if( failed & (UINT32_C(1) << i) )
+            continue;
+        if( tries[i]( p_filter ) == VLC_SUCCESS )
+            return VLC_SUCCESS;
+        PathCacheFailed( p_filter, CHAIN_PATH_CHROMA_RESIZE, i );
+    }
 
     return VLC_EGENERIC;
 }
 
-static int BuildChromaChain( filter_t *p_filter )
+static int TryChromaChain( filter_t *p_filter, vlc_fourcc_t i_chroma )
 {
     es_format_t fmt_mid;
-    int i_ret = VLC_EGENERIC;
+    int i_ret;
+
+    msg_Dbg( p_filter, "Trying to use chroma %4.4s as middle man",
+             (char*)&i_chroma );
+
+    es_format_Copy( &fmt_mid, &p_filter->fmt_in );
+    fmt_mid.i_codec        =
+    fmt_mid.video.i_chroma = i_chroma;
+
+    i_ret = CreateChain( p_filter, &fmt_mid );
+    es_format_Clean( &fmt_mid );
+    return i_ret;
+}
+
+static int BuildChromaChain( filter_t *p_filter )
+{
+    /* Skip the middle men known not to work */
+    const uint32_t failed = PathCacheGet( p_filter, CHAIN_PATH_CHROMA );
 
     /* Now try chroma format list */
     const vlc_fourcc_t *pi_allowed_chromas = get_allowed_chromas( p_filter );
-    for( int i = 0; pi_allowed_chromas[i]; i++ )
+    for( unsigned i = 0; pi_allowed_chromas[i]; i++ )
     {
         const vlc_fourcc_t i_chroma = pi_allowed_chromas[i];
         if( i_chroma == p_filter->fmt_in.i_codec ||
             i_chroma == p_filter->fmt_out.i_codec )
             continue;
+        if( i < 32 && (failed & (UINT32_C(1) << i)) )
+            continue;
 
-        msg_Dbg( p_filter, "Trying to use chroma %4.4s as middle man",
-                 (char*)&i_chroma );
-
-        es_format_Copy( &fmt_mid, &p_filter->fmt_in );
-        fmt_mid.i_codec        =
-        fmt_mid.video.i_chroma = i_chroma;
-
-        i_ret = CreateChain( p_filter, &fmt_mid );
-        es_format_Clean( &fmt_mid );
-
-        if( i_ret == VLC_SUCCESS )
-            break;
+        if( TryChromaChain( p_filter, i_chroma ) == VLC_SUCCESS )
+            return VLC_SUCCESS;
+        PathCacheFailed( p_filter, CHAIN_PATH_CHROMA, i );
     }
 
-    return i_ret;
+    return VLC_EGENERIC;
 }
 
 static int ChainMouse( filter_t *p_filter, vlc_mouse_t *p_mouse,
@@ -38,6 +38,14 @@
 #include <libswscale/swscale.h>
 #include <libswscale/version.h>
 
+#if LIBSWSCALE_VERSION_MAJOR >= 6
+/* Slice threading through the frame API */
+# define SWSCALE_THREADS 1
+# include <libavutil/buffer.h>
+# include <libavutil/frame.h>
+# include <libavutil/opt.h>
+#endif
+
 #ifdef __APPLE__
 # include <TargetConditionals.h>
 #endif
@@ -53,6 +61,12 @@ static void CloseScaler( filter_t * );
 #define SCALEMODE_TEXT N_("Scaling mode")
 #define SCALEMODE_LONGTEXT NULL
 
+#define THREADS_TEXT N_("Threads")
+#define THREADS_LONGTEXT N_( \
+    "Number of threads scaling each picture in horizontal slices. " \
+    "Every scaler instance spawns its own threads, so keep this low " \
+    "when many conversions run at once (0 = one per CPU).")
+
 static const int pi_mode_values[] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
 static const char *const ppsz_mode_descriptions[] =
 { N_("Fast bilinear"), N_("Bilinear"), N_("Bicubic (good quality)"),
@@ -67,6 +81,8 @@ vlc_module_begin ()
     set_callback_video_converter( OpenScaler, 150 )
     add_integer( "swscale-mode", 2, SCALEMODE_TEXT, SCALEMODE_LONGTEXT )
         change_integer_list( pi_mode_values, ppsz_mode_descriptions )
+    add_integer( "swscale-threads", 1, THREADS_TEXT, THREADS_LONGTEXT )
+        change_integer_range( 0, 64 )
 vlc_module_end ()
 
 /* Version checking */
@@ -81,6 +97,7 @@ typedef struct
 {
     SwsFilter *p_filter;
     int i_sws_flags;
+    int i_threads;
 
     video_format_t fmt_in;
     video_format_t fmt_out;
@@ -98,11 +115,18 @@ typedef struct
     bool b_copy;
     bool b_swap_uvi;
     bool b_swap_uvo;
+#ifdef SWSCALE_THREADS
+    /* Frames wrapping the pictures for sws_scale_frame() */
+    AVFrame *frame_src;
+    AVFrame *frame_dst;
+    AVBufferRef *buf;
+#endif
 } filter_sys_t;
 
 static picture_t *Filter( filter_t *, picture_t * );
 static int  Init( filter_t * );
 static void Clean( filter_t * );
+static int  GetThreads( filter_t * );
 
 typedef struct
 {
@@ -130,6 +154,10 @@ static int GetParameters( ScalerConfiguration *,
 /* XXX is it always 3 even for BIG_ENDIAN (blend.c seems to think so) ? */
 #define OFFSET_A (3)
 
+/* Minimum number of output lines per slice with automatic threading */
+#define MINIMUM_SLICE_LINES (64)
+#define MAXIMUM_THREADS (16)
+
 static const struct vlc_filter_operations filter_ops = {
     .filter_video = Filter, .close = CloseScaler,
 };
@@ -221,6 +249,7 @@ static int OpenScaler( filter_t *p_filter )
     case 10: p_sys->i_sws_flags = SWS_SPLINE; break;
     default: p_sys->i_sws_flags = SWS_BICUBIC; i_sws_mode = 2; break;
     }
+    p_sys->i_threads = var_InheritInteger( p_filter, "swscale-threads" );
 
     /* Misc init */
     memset( &p_sys->fmt_in,  0, sizeof(p_sys->fmt_in) );
@@ -237,14 +266,14 @@ static int OpenScaler( filter_t *p_filter )
     /* */
     p_filter->ops = &filter_ops;
 
-    msg_Dbg( p_filter, "%ix%i (%ix%i) chroma: %4.4s colorspace: %s -> %ix%i (%ix%i) chroma: %4.4s colorspace: %s with scaling using %s",
+    msg_Dbg( p_filter, "%ix%i (%ix%i) chroma: %4.4s colorspace: %s -> %ix%i (%ix%i) chroma: %4.4s colorspace: %s with scaling using %s, %d thread(s)",
              p_filter->fmt_in.video.i_visible_width, p_filter->fmt_in.video.i_visible_height,
              p_filter->fmt_in.video.i_width, p_filter->fmt_in.video.i_height,
              (char *)&p_filter->fmt_in.video.i_chroma, GetColorspaceName( p_filter->fmt_in.video.space ),
              p_filter->fmt_out.video.i_visible_width, p_filter->fmt_out.video.i_visible_height,
              p_filter->fmt_out.video.i_width, p_filter->fmt_out.video.i_height,
              (char *)&p_filter->fmt_out.video.i_chroma, GetColorspaceName( p_filter->fmt_out.video.space ),
-             ppsz_mode_descriptions[i_sws_mode] );
+             ppsz_mode_descriptions[i_sws_mode], GetThreads( p_filter ) );
 
     return VLC_SUCCESS;
 }
@@ -366,6 +395,69 @@ static int GetParameters( ScalerConfiguration *p_cfg,
     return VLC_SUCCESS;
 }
 
+static int GetThreads( filter_t *p_filter )
+{
+#ifdef SWSCALE_THREADS
+    filter_sys_t *p_sys = p_filter->p_sys;
+    int i_threads = p_sys->i_threads;
+
+    /* Not worth it for the tiny pictures of the extend path */
+    if( p_sys->i_extend_factor > 1 )
+        return 1;
+
+    if( i_threads == 0 )
+    {
+        const int i_slices = p_filter->fmt_out.video.i_visible_height
+                             / MINIMUM_SLICE_LINES;
+        i_threads = __MIN( (int)vlc_GetCPUCount(), MAXIMUM_THREADS );
+        i_threads = __MIN( i_threads, i_slices );
+    }
+    return __MAX( i_threads, 1 );
+#else
+    VLC_UNUSED( p_filter );
+    return 1;
+#endif
+}
+
+static struct SwsContext *CreateContext( filter_sys_t *p_sys,
+                                         int i_src_width, int i_src_height,
+                                         enum AVPixelFormat i_src_format,
+                                         int i_dst_width, int i_dst_height,
+                                         enum AVPixelFormat i_dst_format,
+                                         int i_flags, int i_threads )
+{
+#ifdef SWSCALE_THREADS
+    if( i_threads > 1 )
+    {
+        /* libswscale runs its own slice threads */
+        struct SwsContext *ctx = sws_alloc_context();
+        if( !ctx )
+            return NULL;
+
+        av_opt_set_int( ctx, "srcw", i_src_width, 0 );
+        av_opt_set_int( ctx, "srch", i_src_height, 0 );
+        av_opt_set_int( ctx, "src_format", i_src_format, 0 );
+        av_opt_set_int( ctx, "dstw", i_dst_width, 0 );
+        av_opt_set_int( ctx, "dsth", i_dst_height, 0 );
+        av_opt_set_int( ctx, "dst_format", i_dst_format, 0 );
+        av_opt_set_int( ctx, "sws_flags", i_flags, 0 );
+        av_opt_set_int( ctx, "threads", i_threads, 0 );
+
+        if( sws_init_context( ctx, p_sys->p_filter, NULL ) < 0 )
+        {
+            sws_freeContext( ctx );
+            return NULL;
+        }
+        return ctx;
+    }
+#else
+    VLC_UNUSED( i_threads );
+#endif
+    return sws_getContext( i_src_width, i_src_height, i_src_format,
+                           i_dst_width, i_dst_height, i_dst_format,
+                           i_flags, p_sys->p_filter, NULL, 0 );
+}
+
 static int Init( filter_t *p_filter )
 {
     filter_sys_t *p_sys = p_filter->p_sys;
@@ -417,16 +509,16 @@ static int Init( filter_t *p_filter )
 
     const unsigned i_fmti_visible_width = p_fmti->i_visible_width * p_sys->i_extend_factor;
     const unsigned i_fmto_visible_width = p_fmto->i_visible_width * p_sys->i_extend_factor;
+    const int i_threads = GetThreads( p_filter );
     for( int n = 0; n < (cfg.b_has_a ? 2 : 1); n++ )
     {
         const int i_fmti = n == 0 ? cfg.i_fmti : AV_PIX_FMT_GRAY8;
         const int i_fmto = n == 0 ? cfg.i_fmto : AV_PIX_FMT_GRAY8;
         struct SwsContext *ctx;
 
-        ctx = sws_getContext( i_fmti_visible_width, p_fmti->i_visible_height, i_fmti,
-                              i_fmto_visible_width, p_fmto->i_visible_height, i_fmto,
-                              cfg.i_sws_flags,
-                              p_sys->p_filter, NULL, 0 );
+        ctx = CreateContext( p_sys, i_fmti_visible_width, p_fmti->i_visible_height, i_fmti,
+                             i_fmto_visible_width, p_fmto->i_visible_height, i_fmto,
+                             cfg.i_sws_flags, i_threads );
         if( n == 0 )
             p_sys->ctx = ctx;
         else
@@ -448,7 +540,22 @@ static int Init( filter_t *p_filter )
             memset( p_sys->p_dst_e->p[0].p_pixels, 0, p_sys->p_dst_e->p[0].i_pitch * p_sys->p_dst_e->p[0].i_lines );
     }
 
-    if( !p_sys->ctx ||
+#ifdef SWSCALE_THREADS
+    if( i_threads > 1 )
+    {
+        p_sys->frame_src = av_frame_alloc();
+        p_sys->frame_dst = av_frame_alloc();
+        /* Marks the frames as owning their data, so that libswscale
+         * neither allocates nor copies pictures. */
+        p_sys->buf = av_buffer_create( NULL, 0, NULL, NULL, 0 );
+    }
+    const bool b_frames_ok = i_threads <= 1 ||
+        ( p_sys->frame_src && p_sys->frame_dst && p_sys->buf );
+#else
+    const bool b_frames_ok = true;
+#endif
+
+    if( !p_sys->ctx || !b_frames_ok ||
         ( cfg.b_has_a && ( !p_sys->ctxA || !p_sys->p_src_a || !p_sys->p_dst_a ) ) ||
         ( p_sys->i_extend_factor != 1 && ( !p_sys->p_src_e || !p_sys->p_dst_e ) ) )
     {
@@ -509,6 +616,12 @@ static void Clean( filter_t *p_filter )
     if( p_sys->ctx )
         sws_freeContext( p_sys->ctx );
 
+#ifdef SWSCALE_THREADS
+    av_frame_free( &p_sys->frame_src );
+    av_frame_free( &p_sys->frame_dst );
+    av_buffer_unref( &p_sys->buf );
+#endif
+
     /* We have to set it to null has we call be called again :( */
     p_sys->ctx = NULL;
     p_sys->ctxA = NULL;
@@ -656,6 +769,36 @@ static void Convert( filter_t *p_filter, struct SwsContext *ctx,
     for (size_t i = 0; i < ARRAY_SIZE(src); i++)
         csrc[i] = src[i];
 
+#ifdef SWSCALE_THREADS
+    if( p_sys->buf )
+    {
+        AVFrame *frame_src = p_sys->frame_src;
+        AVFrame *frame_dst = p_sys->frame_dst;
+
+        for( size_t i = 0; i < ARRAY_SIZE(src); i++ )
+        {
+            frame_src->data[i] = src[i];
+            frame_src->linesize[i] = src_stride[i];
+            frame_dst->data[i] = dst[i];
+            frame_dst->linesize[i] = dst_stride[i];
+        }
+        frame_src->height = i_height;
+        frame_dst->height = p_filter->fmt_out.video.i_visible_height;
+        frame_src->buf[0] = av_buffer_ref( p_sys->buf );
+        frame_dst->buf[0] = av_buffer_ref( p_sys->buf );
+
+        const bool b_done = frame_src->buf[0] && frame_dst->buf[0] &&
+                            sws_scale_frame( ctx, frame_dst, frame_src ) >= 0;
+
+        /* Do not keep references to the pictures */
+        av_frame_unref( frame_src );
+        av_frame_unref( frame_dst );
+        if( b_done )
+            return;
+        msg_Warn( p_filter, "threaded scaling failed" );
+    }
+#endif
+
 #if LIBSWSCALE_VERSION_INT  >= ((0<<16)+(5<<8)+0)
     sws_scale( ctx, csrc, src_stride, 0, i_height,
                dst, dst_stride );
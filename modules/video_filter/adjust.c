@@ -221,64 +221,64 @@ static void Destroy( filter_t *p_filter )
 /*****************************************************************************
  * Run the filter on a Planar YUV picture
  *****************************************************************************/
-static void FilterPlanar( filter_t *p_filter, picture_t *p_pic, picture_t *p_outpic )
+struct planar_frame
 {
+    picture_t *p_pic;
+    picture_t *p_outpic;
+    const vlc_chroma_description_t *p_chroma;
+    unsigned i_lines;
+    bool b_16bit;
+
     /* The full range will only be used for 10-bit */
     int pi_luma[1024];
-    int pi_gamma[1024];
 
-    filter_sys_t *p_sys = p_filter->p_sys;
+    int (*pf_process_sat_hue)( picture_t *, picture_t *, int, int, int,
+                               int, int );
+    int i_sin, i_cos, i_sat, i_x, i_y;
+};
 
-    bool b_16bit;
-    float f_range;
-    switch( p_filter->fmt_in.video.i_chroma )
+/* Make a picture whose planes only cover rows [first, last) of the luma */
+static void SliceView( picture_t *p_view, const picture_t *p_pic,
+                       const vlc_chroma_description_t *p_chroma,
+                       unsigned i_lines, unsigned first, unsigned last )
+{
+    /* The sat/hue functions dispatch on the chroma */
+    p_view->format = p_pic->format;
+    p_view->i_planes = p_pic->i_planes;
+    for( int i = 0; i < p_pic->i_planes; i++ )
     {
-        CASE_PLANAR_YUV10
-            b_16bit = true;
-            f_range = 1024.f;
-            break;
-        CASE_PLANAR_YUV9
-            b_16bit = true;
-            f_range = 512.f;
-            break;
-        default:
-            b_16bit = false;
-            f_range = 256.f;
+        const plane_t *p_plane = &p_pic->p[i];
+        const vlc_rational_t h = p_chroma->p[i].h;
+        unsigned i_first = first * h.num / h.den;
+        unsigned i_last = last < i_lines ? last * h.num / h.den
+                                         : (unsigned)p_plane->i_visible_lines;
+
+        p_view->p[i] = *p_plane;
+        p_view->p[i].p_pixels += i_first * p_plane->i_pitch;
+        p_view->p[i].i_visible_lines = i_last - i_first;
+        p_view->p[i].i_lines = i_last - i_first;
     }
+}
 
-    const float f_max = f_range - 1.f;
-    const unsigned i_max = f_max;
-    const int i_range = f_range;
-    const unsigned i_size = i_range;
-    const unsigned i_mid = i_range >> 1;
-
-    /* Get variables */
-    int32_t i_cont = lroundf( atomic_load_explicit( &p_sys->f_contrast, memory_order_relaxed ) * f_max );
-    int32_t i_lum = lroundf( (atomic_load_explicit( &p_sys->f_brightness, memory_order_relaxed ) - 1.f) * f_max );
-    float f_hue = atomic_load_explicit( &p_sys->f_hue, memory_order_relaxed ) * (float)(M_PI / 180.);
-    int i_sat = (int)( atomic_load_explicit( &p_sys->f_saturation, memory_order_relaxed ) * f_range );
-    float f_gamma = 1.f / atomic_load_explicit( &p_sys->f_gamma, memory_order_relaxed );
+static void FilterPlanarSlice( filter_t *p_filter, void *opaque,
+                               unsigned first, unsigned last )
+{
+    const struct planar_frame *p_frame = opaque;
+    const int *pi_luma = p_frame->pi_luma;
+    picture_t pic, outpic;
+    picture_t *p_pic = &pic, *p_outpic = &outpic;
 
-    /* Contrast is a fast but kludged function, so I put this gap to be
-     * cleaner :) */
-    i_lum += i_mid - i_cont / 2;
+    VLC_UNUSED(p_filter);
 
-    /* Fill the gamma lookup table */
-    for( unsigned i = 0 ; i < i_size; i++ )
-    {
-        pi_gamma[ i ] = VLC_CLIP( powf(i / f_max, f_gamma) * f_max, 0, i_max );
-    }
-
-    /* Fill the luma lookup table */
-    for( unsigned i = 0 ; i < i_size; i++ )
-    {
-        pi_luma[ i ] = pi_gamma[VLC_CLIP( (int)(i_lum + i_cont * i / i_range), 0, (int) i_max )];
-    }
+    SliceView( p_pic, p_frame->p_pic, p_frame->p_chroma, p_frame->i_lines,
+               first, last );
+    SliceView( p_outpic, p_frame->p_outpic, p_frame->p_chroma,
+               p_frame->i_lines, first, last );
 
     /*
      * Do the Y plane
      */
-    if ( b_16bit )
+    if ( p_frame->b_16bit )
     {
         uint16_t *p_in, *p_in_end, *p_line_end;
         uint16_t *p_out;
@@ -355,27 +355,91 @@ static void FilterPlanar( filter_t *p_filter, picture_t *p_pic, picture_t *p_out
      * Do the U and V planes
      */
 
-    int i_sin = sinf(f_hue) * f_max;
-    int i_cos = cosf(f_hue) * f_max;
+    /* Currently no errors are implemented in the function, if any are added
+     * check them here */
+    p_frame->pf_process_sat_hue( p_pic, p_outpic, p_frame->i_sin,
+                                 p_frame->i_cos, p_frame->i_sat,
+                                 p_frame->i_x, p_frame->i_y );
+}
 
-    /* pow(2, (bpp * 2) - 1) */
-    int i_x = ( cosf(f_hue) + sinf(f_hue) ) * f_range * i_mid;
-    int i_y = ( cosf(f_hue) - sinf(f_hue) ) * f_range * i_mid;
+static void FilterPlanar( filter_t *p_filter, picture_t *p_pic, picture_t *p_outpic )
+{
+    int pi_gamma[1024];
+    struct planar_frame frame;
 
-    if ( i_sat > i_range )
+    filter_sys_t *p_sys = p_filter->p_sys;
+
+    float f_range;
+    switch( p_filter->fmt_in.video.i_chroma )
     {
-        /* Currently no errors are implemented in the function, if any are added
-         * check them here */
-        p_sys->pf_process_sat_hue_clip( p_pic, p_outpic, i_sin, i_cos, i_sat,
-                                        i_x, i_y );
+        CASE_PLANAR_YUV10
+            frame.b_16bit = true;
+            f_range = 1024.f;
+            break;
+        CASE_PLANAR_YUV9
+            frame.b_16bit = true;
+            f_range = 512.f;
+            break;
+        default:
+            frame.b_16bit = false;
+            f_range = 256.f;
     }
-    else
+
+    const float f_max = f_range - 1.f;
+    const unsigned i_max = f_max;
+    const int i_range = f_range;
+    const unsigned i_size = i_range;
+    const unsigned i_mid = i_range >> 1;
+
+    /* Get variables */
+    int32_t i_cont = lroundf( atomic_load_explicit( &p_sys->f_contrast, memory_order_relaxed ) * f_max );
+    int32_t i_lum = lroundf( (atomic_load_explicit( &p_sys->f_brightness, memory_order_relaxed ) - 1.f) * f_max );
+    float f_hue = atomic_load_explicit( &p_sys->f_hue, memory_order_relaxed ) * (float)(M_PI / 180.);
+    int i_sat = (int)( atomic_load_explicit( &p_sys->f_saturation, memory_order_relaxed ) * f_range );
+    float f_gamma = 1.f / atomic_load_explicit( &p_sys->f_gamma, memory_order_relaxed );
+
+    /* Contrast is a fast but kludged function, so I put this gap to be
+     * cleaner :) */
+    i_lum += i_mid - i_cont / 2;
+
+    /* Fill the gamma lookup table */
+    for( unsigned i = 0 ; i < i_size; i++ )
     {
-        /* Currently no errors are implemented in the function, if any are added
-         * check them here */
-        p_sys->pf_process_sat_hue( p_pic, p_outpic, i_sin, i_cos, i_sat,
-                                        i_x, i_y );
+        pi_gamma[ i ] = VLC_CLIP( powf(i / f_max, f_gamma) * f_max, 0, i_max );
     }
+
+    /* Fill the luma lookup table */
+    for( unsigned i = 0 ; i < i_size; i++ )
+    {
+        frame.pi_luma[ i ] = pi_gamma[VLC_CLIP( (int)(i_lum + i_cont * i / i_range), 0, (int) i_max )];
+    }
+
+    frame.i_sin = sinf(f_hue) * f_max;
+    frame.i_cos = cosf(f_hue) * f_max;
+
+    /* pow(2, (bpp * 2) - 1) */
+    frame.i_x = ( cosf(f_hue) + sinf(f_hue) ) * f_range * i_mid;
+    frame.i_y = ( cosf(f_hue) - sinf(f_hue) ) * f_range * i_mid;
+    frame.i_sat = i_sat;
+
+    if ( i_sat > i_range )
+        frame.pf_process_sat_hue = p_sys->pf_process_sat_hue_clip;
+    else
+        frame.pf_process_sat_hue = p_sys->pf_process_sat_hue;
+
+    frame.p_pic = p_pic;
+    frame.p_outpic = p_outpic;
+    frame.p_chroma =
+        vlc_fourcc_GetChromaDescription( p_filter->fmt_in.video.i_chroma );
+    frame.i_lines = p_pic->p[Y_PLANE].i_visible_lines;
+
+    /* Slices must not split subsampled chroma rows */
+    unsigned i_align = 1;
+    for( unsigned i = 0; i < frame.p_chroma->plane_count; i++ )
+        i_align = __MAX( i_align, frame.p_chroma->p[i].h.den );
+
+    filter_ExecuteSlices( p_filter, FilterPlanarSlice, &frame,
+                          frame.i_lines, i_align );
 }
 
 /*****************************************************************************
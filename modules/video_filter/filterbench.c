@@ -0,0 +1,269 @@
+/*****************************************************************************
+ * filterbench.c : video filter benchmark plugin for vlc
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+/*****************************************************************************
+ * Preamble
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <assert.h>
+
+#include <vlc_common.h>
+#include <vlc_configuration.h>
+#include <vlc_plugin.h>
+#include <vlc_modules.h>
+
+#include <vlc_filter.h>
+#include <vlc_picture.h>
+
+/*****************************************************************************
+ * Local prototypes
+ *****************************************************************************/
+static int Create( filter_t * );
+static void Destroy( filter_t * );
+
+static picture_t *Filter( filter_t *, picture_t * );
+
+/*****************************************************************************
+ * Module descriptor
+ *****************************************************************************/
+
+#define NAME_TEXT N_("Benchmarked video filter")
+#define NAME_LONGTEXT N_("Name of the video filter module to benchmark")
+
+#define LOOPS_TEXT N_("Number of pictures to filter")
+#define LOOPS_LONGTEXT N_("The number of pictures the filter will process")
+
+#define WIDTH_TEXT N_("Picture width")
+#define WIDTH_LONGTEXT N_("Width of the synthetic benchmark picture")
+
+#define HEIGHT_TEXT N_("Picture height")
+#define HEIGHT_LONGTEXT N_("Height of the synthetic benchmark picture")
+
+#define CHROMA_TEXT N_("Picture chroma")
+#define CHROMA_LONGTEXT N_("Chroma of the synthetic benchmark picture")
+
+#define CFG_PREFIX "filterbench-"
+
+vlc_module_begin ()
+    set_description( N_("Video filter benchmark filter") )
+    set_shortname( N_("Filterbench" ))
+    set_subcategory( SUBCAT_VIDEO_VFILTER )
+
+    set_section( N_("Benchmarking"), NULL )
+    add_string( CFG_PREFIX "name", "adjust", NAME_TEXT, NAME_LONGTEXT )
+    add_integer( CFG_PREFIX "loops", 100, LOOPS_TEXT, LOOPS_LONGTEXT )
+    add_integer_with_range( CFG_PREFIX "width", 3840, 16, 16384,
+                            WIDTH_TEXT, WIDTH_LONGTEXT )
+    add_integer_with_range( CFG_PREFIX "height", 2160, 16, 16384,
+                            HEIGHT_TEXT, HEIGHT_LONGTEXT )
+    add_string( CFG_PREFIX "chroma", "I420", CHROMA_TEXT, CHROMA_LONGTEXT )
+
+    set_callback_video_filter( Create )
+vlc_module_end ()
+
+static const char *const ppsz_filter_options[] = {
+    "name", "loops", "width", "height", "chroma", NULL
+};
+
+/*****************************************************************************
+ * filter_sys_t: filter method descriptor
+ *****************************************************************************/
+typedef struct
+{
+    bool b_done;
+    int i_loops;
+    char *psz_name;
+    video_format_t fmt;
+} filter_sys_t;
+
+static const struct vlc_filter_operations filter_ops =
+{
+    .filter_video = Filter, .close = Destroy,
+};
+
+/*****************************************************************************
+ * Create: allocates video thread output method
+ *****************************************************************************/
+static int Create( filter_t *p_filter )
+{
+    filter_sys_t *p_sys;
+    char *psz_chroma;
+
+    p_sys = malloc( sizeof( *p_sys ) );
+    if( p_sys == NULL )
+        return VLC_ENOMEM;
+
+    config_ChainParse( p_filter, CFG_PREFIX, ppsz_filter_options,
+                       p_filter->p_cfg );
+
+    psz_chroma = var_InheritString( p_filter, CFG_PREFIX "chroma" );
+    vlc_fourcc_t i_chroma = psz_chroma == NULL ? 0 :
+        vlc_fourcc_GetCodecFromString( VIDEO_ES, psz_chroma );
+    free( psz_chroma );
+    if( i_chroma == 0 || vlc_fourcc_GetChromaDescription( i_chroma ) == NULL )
+    {
+        msg_Err( p_filter, "invalid benchmark chroma" );
+        free( p_sys );
+        return VLC_EGENERIC;
+    }
+
+    p_sys->psz_name = var_InheritString( p_filter, CFG_PREFIX "name" );
+    if( p_sys->psz_name == NULL )
+    {
+        free( p_sys );
+        return VLC_EGENERIC;
+    }
+
+    unsigned i_width = var_InheritInteger( p_filter, CFG_PREFIX "width" );
+    unsigned i_height = var_InheritInteger( p_filter, CFG_PREFIX "height" );
+    video_format_Init( &p_sys->fmt, i_chroma );
+    video_format_Setup( &p_sys->fmt, i_chroma, i_width, i_height,
+                        i_width, i_height, 1, 1 );
+
+    p_sys->i_loops = var_InheritInteger( p_filter, CFG_PREFIX "loops" );
+    p_sys->b_done = false;
+
+    p_filter->p_sys = p_sys;
+    p_filter->ops = &filter_ops;
+
+    return VLC_SUCCESS;
+}
+
+/*****************************************************************************
+ * Destroy: destroy video thread output method
+ *****************************************************************************/
+static void Destroy( filter_t *p_filter )
+{
+    filter_sys_t *p_sys = p_filter->p_sys;
+
+    video_format_Clean( &p_sys->fmt );
+    free( p_sys->psz_name );
+    free( p_sys );
+}
+
+/* Fill the picture with a gradient so that the filters do real work.
+ * Samples stay within the chroma bit depth, as filters index lookup tables
+ * with them. */
+static void FillPicture( picture_t *p_pic )
+{
+    const vlc_chroma_description_t *p_dsc =
+        vlc_fourcc_GetChromaDescription( p_pic->format.i_chroma );
+    const bool b_wide = p_dsc != NULL && p_dsc->pixel_size == 2;
+    const unsigned i_mask = p_dsc != NULL && p_dsc->pixel_bits < 16 ?
+                            (1u << p_dsc->pixel_bits) - 1 : 0xffff;
+
+    for( int i = 0; i < p_pic->i_planes; i++ )
+    {
+        plane_t *p_plane = &p_pic->p[i];
+
+        for( int y = 0; y < p_plane->i_lines; y++ )
+        {
+            uint8_t *p_line = &p_plane->p_pixels[y * p_plane->i_pitch];
+
+            if( b_wide )
+            {
+                uint16_t *p_samples = (uint16_t *)p_line;
+
+                for( int x = 0; x < p_plane->i_pitch / 2; x++ )
+                    p_samples[x] = ((x + y) * (i + 1)) & i_mask;
+            }
+            else
+                for( int x = 0; x < p_plane->i_pitch; x++ )
+                    p_line[x] = (x + y) * (i + 1);
+        }
+    }
+}
+
+static void Benchmark( filter_t *p_filter )
+{
+    filter_sys_t *p_sys = p_filter->p_sys;
+
+    picture_t *p_src = picture_NewFromFormat( &p_sys->fmt );
+    if( p_src == NULL )
+        return;
+    FillPicture( p_src );
+
+    filter_t *p_bench = vlc_object_create( p_filter, sizeof(filter_t) );
+    if( p_bench == NULL )
+    {
+        picture_Release( p_src );
+        return;
+    }
+    es_format_InitFromVideo( &p_bench->fmt_in, &p_sys->fmt );
+    es_format_InitFromVideo( &p_bench->fmt_out, &p_sys->fmt );
+    p_bench->psz_name = p_sys->psz_name;
+
+    p_bench->p_module = module_need( p_bench, "video filter",
+                                     p_sys->psz_name, true );
+    if( p_bench->p_module == NULL )
+    {
+        msg_Err( p_filter, "cannot load video filter %s", p_sys->psz_name );
+        goto out;
+    }
+    assert( p_bench->ops != NULL );
+
+    vlc_tick_t time = vlc_tick_now();
+    for( int i_iter = 0; i_iter < p_sys->i_loops; ++i_iter )
+    {
+        picture_t *p_out = p_bench->ops->filter_video( p_bench,
+                                                       picture_Hold( p_src ) );
+        if( p_out != NULL )
+            picture_Release( p_out );
+    }
+    time = vlc_tick_now() - time;
+
+    msg_Info( p_filter, "Filtered %d %ux%u pictures through %s in %f sec",
+              p_sys->i_loops, p_sys->fmt.i_visible_width,
+              p_sys->fmt.i_visible_height, p_sys->psz_name,
+              secf_from_vlc_tick(time) );
+    if( time > 0 )
+        msg_Info( p_filter, "Speed is: %f pictures/second, %f pixels/second",
+                  (double) p_sys->i_loops / time * CLOCK_FREQ,
+                  (double) p_sys->i_loops / time * CLOCK_FREQ *
+                      p_sys->fmt.i_visible_width *
+                      p_sys->fmt.i_visible_height );
+
+    filter_Close( p_bench );
+    module_unneed( p_bench, p_bench->p_module );
+out:
+    es_format_Clean( &p_bench->fmt_in );
+    es_format_Clean( &p_bench->fmt_out );
+    vlc_object_delete( p_bench );
+    picture_Release( p_src );
+}
+
+/*****************************************************************************
+ * Filter: run the benchmark once, then pass pictures through
+ *****************************************************************************/
+static picture_t *Filter( filter_t *p_filter, picture_t *p_pic )
+{
+    filter_sys_t *p_sys = p_filter->p_sys;
+
+    if( !p_sys->b_done )
+    {
+        Benchmark( p_filter );
+        p_sys->b_done = true;
+    }
+    return p_pic;
+}
@@ -179,6 +179,92 @@ static void Destroy( filter_t *p_filter )
     free( p_sys );
 }
 
+struct gaussianblur_plane
+{
+    const type_t *pt_distribution;
+    type_t *pt_buffer;
+    const type_t *pt_scale;
+    int i_dim;
+
+    const uint8_t *p_in;
+    uint8_t *p_out;
+    int i_out_pitch;
+    int i_visible_lines;
+    int i_visible_pitch;
+    int i_in_pitch;
+    int x_factor;
+    int y_factor;
+};
+
+static void FilterHorizontal( filter_t *p_filter, void *opaque,
+                              unsigned first, unsigned last )
+{
+    const struct gaussianblur_plane *plane = opaque;
+    const type_t *pt_distribution = plane->pt_distribution;
+    type_t *pt_buffer = plane->pt_buffer;
+    const uint8_t *p_in = plane->p_in;
+    const int i_dim = plane->i_dim;
+    const int i_visible_pitch = plane->i_visible_pitch;
+    const int i_in_pitch = plane->i_in_pitch;
+    const int x_factor = plane->x_factor;
+
+    VLC_UNUSED(p_filter);
+
+    for( int i_line = first; i_line < (int)last; i_line++ )
+    {
+        for( int i_col = 0; i_col < i_visible_pitch; i_col++ )
+        {
+            type_t t_value = 0;
+            const int c = i_line*i_in_pitch+i_col;
+            for( int x = __MAX( -i_dim, -i_col*(x_factor+1) );
+                 x <= __MIN( i_dim, (i_visible_pitch - i_col)*(x_factor+1) + 1 );
+                 x++ )
+            {
+                t_value += pt_distribution[x+i_dim] *
+                           p_in[c+(x>>x_factor)];
+            }
+            pt_buffer[c] = t_value;
+        }
+    }
+}
+
+static void FilterVertical( filter_t *p_filter, void *opaque,
+                            unsigned first, unsigned last )
+{
+    const struct gaussianblur_plane *plane = opaque;
+    const type_t *pt_distribution = plane->pt_distribution;
+    const type_t *pt_buffer = plane->pt_buffer;
+    const type_t *pt_scale = plane->pt_scale;
+    uint8_t *p_out = plane->p_out;
+    const int i_dim = plane->i_dim;
+    const int i_visible_lines = plane->i_visible_lines;
+    const int i_visible_pitch = plane->i_visible_pitch;
+    const int i_in_pitch = plane->i_in_pitch;
+    const int x_factor = plane->x_factor;
+    const int y_factor = plane->y_factor;
+
+    VLC_UNUSED(p_filter);
+
+    for( int i_line = first; i_line < (int)last; i_line++ )
+    {
+        for( int i_col = 0; i_col < i_visible_pitch; i_col++ )
+        {
+            type_t t_value = 0;
+            const int c = i_line*i_in_pitch+i_col;
+            for( int y = __MAX( -i_dim, (-i_line)*(y_factor+1) );
+                 y <= __MIN( i_dim, (i_visible_lines - i_line)*(y_factor+1) - 1 );
+                 y++ )
+            {
+                t_value += pt_distribution[y+i_dim] *
+                           pt_buffer[c+(y>>y_factor)*i_in_pitch];
+            }
+
+            const type_t t_scale = pt_scale[(i_line<<y_factor)*(i_in_pitch<<x_factor)+(i_col<<x_factor)];
+            p_out[i_line * plane->i_out_pitch + i_col] = (uint8_t)(t_value / t_scale); // FIXME wouldn't it be better to round instead of trunc ?
+        }
+    }
+}
+
 static void Filter( filter_t *p_filter, picture_t *p_pic, picture_t *p_outpic )
 {
     filter_sys_t *p_sys = p_filter->p_sys;
@@ -227,53 +313,31 @@ static void Filter( filter_t *p_filter, picture_t *p_pic, picture_t *p_outpic )
         }
     }
 
-    pt_scale = p_sys->pt_scale;
+    struct gaussianblur_plane plane = {
+        .pt_distribution = pt_distribution,
+        .pt_buffer = pt_buffer,
+        .pt_scale = p_sys->pt_scale,
+        .i_dim = i_dim,
+    };
+
     for( int i_plane = 0 ; i_plane < p_pic->i_planes ; i_plane++ )
     {
-
-        uint8_t *p_in = p_pic->p[i_plane].p_pixels;
-        uint8_t *p_out = p_outpic->p[i_plane].p_pixels;
-
-        const int i_visible_lines = p_pic->p[i_plane].i_visible_lines;
-        const int i_visible_pitch = p_pic->p[i_plane].i_visible_pitch;
-        const int i_in_pitch = p_pic->p[i_plane].i_pitch;
-
-        const int x_factor = p_pic->p[Y_PLANE].i_visible_pitch/i_visible_pitch-1;
-        const int y_factor = p_pic->p[Y_PLANE].i_visible_lines/i_visible_lines-1;
-
-        for( int i_line = 0; i_line < i_visible_lines; i_line++ )
-        {
-            for( int i_col = 0; i_col < i_visible_pitch; i_col++ )
-            {
-                type_t t_value = 0;
-                const int c = i_line*i_in_pitch+i_col;
-                for( int x = __MAX( -i_dim, -i_col*(x_factor+1) );
-                     x <= __MIN( i_dim, (i_visible_pitch - i_col)*(x_factor+1) + 1 );
-                     x++ )
-                {
-                    t_value += pt_distribution[x+i_dim] *
-                               p_in[c+(x>>x_factor)];
-                }
-                pt_buffer[c] = t_value;
-            }
-        }
-        for( int i_line = 0; i_line < i_visible_lines; i_line++ )
-        {
-            for( int i_col = 0; i_col < i_visible_pitch; i_col++ )
-            {
-                type_t t_value = 0;
-                const int c = i_line*i_in_pitch+i_col;
-                for( int y = __MAX( -i_dim, (-i_line)*(y_factor+1) );
-                     y <= __MIN( i_dim, (i_visible_lines - i_line)*(y_factor+1) - 1 );
-                     y++ )
-                {
-                    t_value += pt_distribution[y+i_dim] *
-                               pt_buffer[c+(y>>y_factor)*i_in_pitch];
-                }
-
-                const type_t t_scale = pt_scale[(i_line<<y_factor)*(i_in_pitch<<x_factor)+(i_col<<x_factor)];
-                p_out[i_line * p_outpic->p[i_plane].i_pitch + i_col] = (uint8_t)(t_value / t_scale); // FIXME wouldn't it be better to round instead of trunc ?
-            }
-        }
+        plane.p_in = p_pic->p[i_plane].p_pixels;
+        plane.p_out = p_outpic->p[i_plane].p_pixels;
+        plane.i_out_pitch = p_outpic->p[i_plane].i_pitch;
+
+        plane.i_visible_lines = p_pic->p[i_plane].i_visible_lines;
+        plane.i_visible_pitch = p_pic->p[i_plane].i_visible_pitch;
+        plane.i_in_pitch = p_pic->p[i_plane].i_pitch;
+
+        plane.x_factor = p_pic->p[Y_PLANE].i_visible_pitch/plane.i_visible_pitch-1;
+        plane.y_factor = p_pic->p[Y_PLANE].i_visible_lines/plane.i_visible_lines-1;
+
+        /* The vertical pass reads the horizontal pass output of the
+         * neighbouring rows: all of it must be done first */
+        filter_ExecuteSlices( p_filter, FilterHorizontal, &plane,
+                              plane.i_visible_lines, 1 );
+        filter_ExecuteSlices( p_filter, FilterVertical, &plane,
+                              plane.i_visible_lines, 1 );
     }
 }
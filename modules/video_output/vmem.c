@@ -30,9 +30,14 @@
 #endif
 
 #include <assert.h>
+#include <limits.h>
 
 #include <vlc_common.h>
+#include <vlc_atomic.h>
+#include <vlc_list.h>
 #include <vlc_plugin.h>
+#include <vlc_picture_pool.h>
+#include <vlc_threads.h>
 #include <vlc_vout_display.h>
 
 /*****************************************************************************
@@ -76,11 +81,6 @@ vlc_module_end()
 /*****************************************************************************
  * Local prototypes
  *****************************************************************************/
-typedef struct
-{
-    void *id;
-} picture_sys_t;
-
 /* NOTE: the callback prototypes must match those of LibVLC */
 typedef struct vout_display_sys_t {
     void *opaque;
@@ -89,17 +89,35 @@ typedef struct vout_display_sys_t {
     void (*unlock)(void *sys, void *id, void *const *plane);
     void (*display)(void *sys, void *id);
     void (*cleanup)(void *sys);
+    void *(*acquire)(void *sys, void **plane);
+    void (*release)(void *sys, void *id);
 
     unsigned pitches[PICTURE_PLANE_MAX];
     unsigned lines[PICTURE_PLANE_MAX];
+    unsigned count; /* maximum number of application buffers */
+
+    /* The application buffers may outlive the display */
+    vlc_atomic_rc_t rc;
+    vlc_mutex_t buffers_lock;
+    struct vlc_list buffers;
 } vout_display_sys_t;
 
+/* Application buffer backing a decoder picture */
+typedef struct
+{
+    vout_display_sys_t *owner;
+    struct vlc_list node;
+    void *id;
+    void *planes[PICTURE_PLANE_MAX];
+} picture_sys_t;
+
 typedef unsigned (*vlc_format_cb)(void **, char *, unsigned *, unsigned *,
                                   unsigned *, unsigned *);
 
 static void           Prepare(vout_display_t *, picture_t *, const struct vlc_render_subpicture *, vlc_tick_t);
 static void           Display(vout_display_t *, picture_t *);
 static int            Control(vout_display_t *, int);
+static picture_pool_t *GetPool(vout_display_t *, unsigned);
 
 static const struct vlc_display_operations ops = {
     .close = Close,
@@ -108,6 +126,25 @@ static const struct vlc_display_operations ops = {
     .control = Control,
 };
 
+static const struct vlc_display_operations ops_direct = {
+    .close = Close,
+    .prepare = Prepare,
+    .display = Display,
+    .control = Control,
+    .get_pool = GetPool,
+};
+
+static void Release(vout_display_sys_t *sys)
+{
+    if (!vlc_atomic_rc_dec(&sys->rc))
+        return;
+
+    assert(vlc_list_is_empty(&sys->buffers));
+    if (sys->cleanup)
+        sys->cleanup(sys->opaque);
+    free(sys);
+}
+
 /*****************************************************************************
  * Open: allocates video thread
  *****************************************************************************
@@ -133,6 +170,12 @@ static int Open(vout_display_t *vd,
     sys->display = var_InheritAddress(vd, "vmem-display");
     sys->cleanup = var_InheritAddress(vd, "vmem-cleanup");
     sys->opaque = var_InheritAddress(vd, "vmem-data");
+    sys->acquire = var_InheritAddress(vd, "vmem-acquire");
+    sys->release = var_InheritAddress(vd, "vmem-release");
+    sys->count = UINT_MAX;
+    vlc_atomic_rc_init(&sys->rc);
+    vlc_mutex_init(&sys->buffers_lock);
+    vlc_list_init(&sys->buffers);
 
     /* Define the video format */
     video_format_t fmt;
@@ -153,8 +196,9 @@ static int Open(vout_display_t *vd,
         heights[0] = fmt.i_height;
         heights[1] = fmt.i_visible_height;
 
-        if (setup(&sys->opaque, chroma, widths, heights,
-                           sys->pitches, sys->lines) == 0) {
+        sys->count = setup(&sys->opaque, chroma, widths, heights,
+                           sys->pitches, sys->lines);
+        if (sys->count == 0) {
             msg_Err(vd, "video format setup failure (no pictures)");
             free(sys);
             return VLC_EGENERIC;
@@ -179,9 +223,19 @@ static int Open(vout_display_t *vd,
         }
         sys->cleanup = NULL;
     }
-    fmt.i_x_offset = fmt.i_y_offset = 0;
-    fmt.i_visible_width = fmt.i_width;
-    fmt.i_visible_height = fmt.i_height;
+
+    /* Keep the source visible area if the decoded pictures can be rendered
+     * directly into the application buffers */
+    bool direct = sys->acquire != NULL
+               && fmt.i_chroma == vd->source->i_chroma
+               && fmt.i_width == vd->source->i_width
+               && fmt.i_height == vd->source->i_height
+               && fmt.orientation == vd->source->orientation;
+    if (!direct) {
+        fmt.i_x_offset = fmt.i_y_offset = 0;
+        fmt.i_visible_width = fmt.i_width;
+        fmt.i_visible_height = fmt.i_height;
+    }
 
     if (!fmt.i_chroma) {
         msg_Err(vd, "vmem-chroma should be 4 characters long");
@@ -193,19 +247,158 @@ static int Open(vout_display_t *vd,
     *fmtp = fmt;
 
     vd->sys     = sys;
-    vd->ops     = &ops;
+    vd->ops     = direct ? &ops_direct : &ops;
 
     (void) context;
     return VLC_SUCCESS;
 }
 
 static void Close(vout_display_t *vd)
+{
+    Release(vd->sys);
+}
+
+static void ReleaseBuffer(picture_sys_t *p_sys)
+{
+    vout_display_sys_t *sys = p_sys->owner;
+
+    vlc_mutex_lock(&sys->buffers_lock);
+    vlc_list_remove(&p_sys->node);
+    sys->count++;
+    vlc_mutex_unlock(&sys->buffers_lock);
+
+    if (sys->release != NULL)
+        sys->release(sys->opaque, p_sys->id);
+    free(p_sys);
+    Release(sys);
+}
+
+static void DestroyBuffer(picture_t *pic)
+{
+    ReleaseBuffer(pic->p_sys);
+}
+
+static picture_t *NewBuffer(vout_display_t *vd)
 {
     vout_display_sys_t *sys = vd->sys;
+    picture_sys_t *p_sys = malloc(sizeof (*p_sys));
+    if (unlikely(p_sys == NULL))
+        return NULL;
+
+    memset(p_sys->planes, 0, sizeof (p_sys->planes));
+    p_sys->id = sys->acquire(sys->opaque, p_sys->planes);
+    if (p_sys->id == NULL) {
+        free(p_sys);
+        return NULL;
+    }
 
-    if (sys->cleanup)
-        sys->cleanup(sys->opaque);
-    free(sys);
+    picture_resource_t rsc = {
+        .p_sys = p_sys,
+        .pf_destroy = DestroyBuffer,
+    };
+
+    for (unsigned i = 0; i < PICTURE_PLANE_MAX; i++) {
+        rsc.p[i].p_pixels = p_sys->planes[i];
+        rsc.p[i].i_lines = sys->lines[i];
+        rsc.p[i].i_pitch = sys->pitches[i];
+    }
+
+    p_sys->owner = sys;
+    vlc_atomic_rc_inc(&sys->rc);
+    vlc_mutex_lock(&sys->buffers_lock);
+    vlc_list_append(&p_sys->node, &sys->buffers);
+    sys->count--;
+    vlc_mutex_unlock(&sys->buffers_lock);
+
+    picture_t *pic = picture_NewFromResource(vd->fmt, &rsc);
+    if (unlikely(pic == NULL)) {
+        ReleaseBuffer(p_sys);
+        return NULL;
+    }
+
+    for (int i = 0; i < pic->i_planes; i++)
+        if (((uintptr_t)pic->p[i].p_pixels) & 31) {
+            msg_Warn(vd, "misaligned buffer for direct rendering");
+            picture_Release(pic);
+            return NULL;
+        }
+    return pic;
+}
+
+/* Checks that the application buffers can hold the decoded pictures */
+static bool CheckBuffers(vout_display_t *vd)
+{
+    vout_display_sys_t *sys = vd->sys;
+    const video_format_t *fmt = vd->fmt;
+    const vlc_chroma_description_t *desc =
+        vlc_fourcc_GetChromaDescription(fmt->i_chroma);
+
+    if (desc == NULL || desc->plane_count == 0)
+        return false;
+
+    for (unsigned i = 0; i < desc->plane_count; i++) {
+        unsigned width = (fmt->i_width * desc->p[i].w.num
+                          + desc->p[i].w.den - 1) / desc->p[i].w.den;
+        unsigned height = (fmt->i_height * desc->p[i].h.num
+                           + desc->p[i].h.den - 1) / desc->p[i].h.den;
+
+        if (sys->pitches[i] < width * desc->pixel_size
+         || sys->lines[i] < height)
+            return false;
+    }
+    return true;
+}
+
+static picture_pool_t *GetPool(vout_display_t *vd, unsigned count)
+{
+    vout_display_sys_t *sys = vd->sys;
+    picture_t *pics[64];
+
+    vlc_mutex_lock(&sys->buffers_lock);
+    bool enough = count <= sys->count;
+    vlc_mutex_unlock(&sys->buffers_lock);
+
+    if (!enough || count > ARRAY_SIZE(pics)) {
+        msg_Dbg(vd, "not enough buffers for direct rendering (%u needed)",
+                count);
+        return NULL;
+    }
+    if (!CheckBuffers(vd)) {
+        msg_Warn(vd, "buffers too small for direct rendering");
+        return NULL;
+    }
+
+    for (unsigned i = 0; i < count; i++) {
+        pics[i] = NewBuffer(vd);
+        if (pics[i] == NULL) {
+            msg_Dbg(vd, "only %u buffers for direct rendering (%u needed)",
+                    i, count);
+            while (i > 0)
+                picture_Release(pics[--i]);
+            return NULL;
+        }
+    }
+
+    picture_pool_t *pool = picture_pool_New(count, pics);
+    if (unlikely(pool == NULL))
+        for (unsigned i = 0; i < count; i++)
+            picture_Release(pics[i]);
+    return pool;
+}
+
+/* Returns the application buffer of a picture, if any */
+static picture_sys_t *GetBuffer(vout_display_sys_t *sys, const picture_t *pic)
+{
+    picture_sys_t *p_sys, *found = NULL;
+
+    vlc_mutex_lock(&sys->buffers_lock);
+    vlc_list_foreach(p_sys, &sys->buffers, node)
+        if (p_sys == pic->p_sys) {
+            found = p_sys;
+            break;
+        }
+    vlc_mutex_unlock(&sys->buffers_lock);
+    return found;
 }
 
 static void Prepare(vout_display_t *vd, picture_t *pic,
@@ -217,6 +410,16 @@ static void Prepare(vout_display_t *vd, picture_t *pic,
     picture_resource_t rsc = { .p_sys = NULL };
     void *planes[PICTURE_PLANE_MAX];
 
+    /* Decoded directly into an application buffer: nothing to copy */
+    picture_sys_t *buffer = GetBuffer(sys, pic);
+    if (buffer != NULL) {
+        sys->pic_opaque = buffer->id;
+        if (sys->unlock != NULL)
+            sys->unlock(sys->opaque, buffer->id, buffer->planes);
+        (void) subpic;
+        return;
+    }
+
     sys->pic_opaque = sys->lock(sys->opaque, planes);
 
     picture_t *locked = picture_NewFromResource(vd->fmt, &rsc);
@@ -0,0 +1,106 @@
+/*****************************************************************************
+ * live_latency.c: Live edge latency controller
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <math.h>
+
+#include <vlc_common.h>
+#include "live_latency.h"
+
+/* Weight of a new measure in the smoothed latency (1/N) */
+#define LIVE_LATENCY_SMOOTHING 4
+
+/* Time to absorb the latency error without the rate limits: one second of
+ * error gives a 5% rate change */
+#define LIVE_LATENCY_CATCHUP VLC_TICK_FROM_SEC(20)
+
+/* Rates are changed by steps of 1% */
+#define LIVE_LATENCY_RATE_STEP 100.f
+
+/* Error tolerated before correcting, relative to the target */
+#define LIVE_LATENCY_TOLERANCE_DIV 8
+#define LIVE_LATENCY_TOLERANCE_MIN VLC_TICK_FROM_MS(50)
+
+void live_latency_Init(struct live_latency *ctl, vlc_tick_t target,
+                       float rate_min, float rate_max)
+{
+    ctl->target = target;
+    ctl->rate_min = rate_min;
+    ctl->rate_max = rate_max;
+    ctl->rate = 1.f;
+    live_latency_Reset(ctl);
+}
+
+void live_latency_Reset(struct live_latency *ctl)
+{
+    ctl->has_latency = false;
+    ctl->latency = VLC_TICK_INVALID;
+    ctl->correcting = false;
+}
+
+float live_latency_Update(struct live_latency *ctl, vlc_tick_t latency)
+{
+    if (latency < 0)
+        latency = 0;
+
+    if (!ctl->has_latency)
+    {
+        ctl->latency = latency;
+        ctl->has_latency = true;
+    }
+    else
+        ctl->latency += (latency - ctl->latency) / LIVE_LATENCY_SMOOTHING;
+
+    const vlc_tick_t error = ctl->latency - ctl->target;
+    const vlc_tick_t abs_error = error < 0 ? -error : error;
+    vlc_tick_t tolerance = ctl->target / LIVE_LATENCY_TOLERANCE_DIV;
+    if (tolerance < LIVE_LATENCY_TOLERANCE_MIN)
+        tolerance = LIVE_LATENCY_TOLERANCE_MIN;
+
+    /* Hysteresis: start correcting outside of the tolerance, and stop once
+     * close to the target */
+    if (!ctl->correcting)
+        ctl->correcting = abs_error > tolerance;
+    else if (abs_error < tolerance / 4)
+        ctl->correcting = false;
+
+    if (!ctl->correcting)
+    {
+        ctl->rate = 1.f;
+        return ctl->rate;
+    }
+
+    float rate = 1.f + (float)error / LIVE_LATENCY_CATCHUP;
+    rate = roundf(rate * LIVE_LATENCY_RATE_STEP) / LIVE_LATENCY_RATE_STEP;
+    /* Always make progress while correcting */
+    if (rate == 1.f)
+        rate += (error > 0 ? 1.f : -1.f) / LIVE_LATENCY_RATE_STEP;
+
+    if (rate > ctl->rate_max)
+        rate = ctl->rate_max;
+    else if (rate < ctl->rate_min)
+        rate = ctl->rate_min;
+
+    ctl->rate = rate;
+    return rate;
+}
@@ -0,0 +1,82 @@
+/*****************************************************************************
+ * live_latency.h: Live edge latency controller
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef LIBVLC_LIVE_LATENCY_H
+#define LIBVLC_LIVE_LATENCY_H 1
+
+#include <vlc_common.h>
+#include <vlc_tick.h>
+
+/**
+ * Live edge latency controller
+ *
+ * It is fed with measures of the distance between the playback and the live
+ * edge and returns the playback rate that brings this distance back to the
+ * target. The rate stays within a narrow band so that the audio can be time
+ * stretched without audible artifacts, and it is quantized so that small
+ * variations of the measures do not keep changing it.
+ *
+ * This API is reentrant but not thread-safe.
+ */
+struct live_latency
+{
+    vlc_tick_t target;
+    float rate_min;
+    float rate_max;
+
+    bool has_latency;
+    vlc_tick_t latency; /* smoothed measure */
+    bool correcting;
+    float rate;
+};
+
+/**
+ * Initializes a controller.
+ *
+ * \param target latency to hold
+ * \param rate_min slowest rate, in ]0, 1]
+ * \param rate_max fastest rate, >= 1
+ */
+void live_latency_Init(struct live_latency *ctl, vlc_tick_t target,
+                       float rate_min, float rate_max);
+
+/**
+ * Forgets the measures, after a seek or a buffering for instance.
+ *
+ * The current rate is kept until the next update.
+ */
+void live_latency_Reset(struct live_latency *ctl);
+
+/**
+ * Feeds a new latency measure.
+ *
+ * \return the playback rate to use
+ */
+float live_latency_Update(struct live_latency *ctl, vlc_tick_t latency);
+
+/**
+ * Returns the smoothed latency or VLC_TICK_INVALID without measures.
+ */
+static inline vlc_tick_t live_latency_Get(const struct live_latency *ctl)
+{
+    return ctl->has_latency ? ctl->latency : VLC_TICK_INVALID;
+}
+
+#endif
@@ -324,7 +324,14 @@ stream_t *stream_AccessNew(vlc_object_t *parent, input_thread_t *input,
         s->pf_control = AStreamControl;
         s->p_sys = access;
 
-        s = stream_FilterChainNew(s, "prefetch,cache");
+        /* Some accesses, such as local files read by blocks, already return
+         * large blocks: caching them would only add a copy. */
+        bool skip_cache = false;
+        if (vlc_stream_Control(access, STREAM_CAN_SKIP_CACHE,
+                               &skip_cache) != VLC_SUCCESS)
+            skip_cache = false;
+        if (!skip_cache)
+            s = stream_FilterChainNew(s, "prefetch,cache");
     }
     else
         s = access;
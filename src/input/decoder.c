@@ -630,6 +630,7 @@ static int ModuleThread_UpdateVideoFormat( decoder_t *p_dec, vlc_video_context *
     p_owner->vctx = vctx ? vlc_video_context_Hold(vctx) : NULL;
 
     // configure the new vout
+    unsigned pool_size = 0;
     vlc_fifo_Lock(p_owner->p_fifo);
     if ( p_owner->out_pool == NULL )
     {
@@ -655,19 +656,8 @@ static int ModuleThread_UpdateVideoFormat( decoder_t *p_dec, vlc_video_context *
             dpb_size = 2;
             break;
         }
-        picture_pool_t *pool = picture_pool_NewFromFormat( &p_dec->fmt_out.video,
-                            dpb_size + p_dec->i_extra_picture_buffers + 1 );
-
-        if( pool == NULL)
-        {
-            msg_Err(p_dec, "Failed to create a pool of %d %4.4s pictures",
-                           dpb_size + p_dec->i_extra_picture_buffers + 1,
-                           (char*)&p_dec->fmt_out.video.i_chroma);
-            vlc_fifo_Unlock(p_owner->p_fifo);
-            goto error;
-        }
-
-        p_owner->out_pool = pool;
+        /* The pool is created once the display is known */
+        pool_size = dpb_size + p_dec->i_extra_picture_buffers + 1;
     }
 
     vout_configuration_t cfg = {
@@ -687,6 +677,51 @@ static int ModuleThread_UpdateVideoFormat( decoder_t *p_dec, vlc_video_context *
         assert(vout_state == INPUT_RESOURCE_VOUT_NOTCHANGED ||
                vout_state == INPUT_RESOURCE_VOUT_STARTED);
 
+        if (pool_size > 0)
+        {
+            /* Decode directly into the display buffers if it provides
+             * them, otherwise into pictures from the heap */
+            picture_pool_t *pool = NULL;
+            if (vctx == NULL)
+                pool = vout_GetDisplayPool(p_vout, &p_dec->fmt_out.video,
+                                           pool_size);
+            if (pool != NULL)
+                msg_Dbg(p_dec, "decoding into %u display buffers", pool_size);
+            else
+                pool = picture_pool_NewFromFormat(&p_dec->fmt_out.video,
+                                                  pool_size);
+            if (pool == NULL)
+            {
+                msg_Err(p_dec, "Failed to create a pool of %u %4.4s pictures",
+                               pool_size,
+                               (char*)&p_dec->fmt_out.video.i_chroma);
+
+                /* The vout can't be used without pictures, stop it so
+                 * that the next update requests a new one */
+                vlc_fifo_Lock(p_owner->p_fifo);
+                p_owner->p_vout = NULL;
+                p_owner->vout_started = false;
+                vlc_fifo_Unlock(p_owner->p_fifo);
+
+                /* Hold the vout since PutVout will likely release it and a
+                 * last reference is needed for notify callbacks. Only
+                 * notify the stop if the start was notified before. */
+                const bool notified = vout_state != INPUT_RESOURCE_VOUT_STARTED;
+                vout_Hold(p_vout);
+                input_resource_PutVout(p_owner->p_resource, p_vout,
+                                       &vout_state);
+                if (notified && vout_state == INPUT_RESOURCE_VOUT_STOPPED)
+                    decoder_Notify(p_owner, on_vout_stopped, p_vout);
+                vout_Release(p_vout);
+                goto error;
+            }
+
+            vlc_fifo_Lock(p_owner->p_fifo);
+            assert(p_owner->out_pool == NULL);
+            p_owner->out_pool = pool;
+            vlc_fifo_Unlock(p_owner->p_fifo);
+        }
+
         vlc_fifo_Lock(p_owner->p_fifo);
         p_owner->vout_started = true;
 
@@ -380,6 +380,8 @@ int demux_vaControl( demux_t *demux, int query, va_list args )
                 return demux->ops->demux.get_normal_time(demux, normal_time);
             }
             return VLC_EGENERIC;
+        case DEMUX_GET_LIVE_DELAY:
+            return VLC_EGENERIC;
         case DEMUX_GET_FPS:
             if (demux->ops->demux.get_fps != NULL) {
                 double *fps = va_arg(args, double *);
@@ -607,6 +609,7 @@ int demux_vaControlHelper( stream_t *s,
             }
             return VLC_EGENERIC;
         case DEMUX_GET_NORMAL_TIME:
+        case DEMUX_GET_LIVE_DELAY:
             return VLC_EGENERIC;
 
         case DEMUX_SET_POSITION:
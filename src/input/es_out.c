@@ -3876,6 +3876,14 @@ static int EsOutVaPrivControlLocked( es_out_t *out, input_source_t *source,
     case ES_OUT_PRIV_SET_FRAME_NEXT:
         EsOutFrameNext( out );
         return VLC_SUCCESS;
+    case ES_OUT_PRIV_GET_BUFFERED_DURATION:
+    {
+        vlc_tick_t *pi_duration = va_arg( args, vlc_tick_t * );
+        if( p_sys->b_buffering || !p_sys->p_pgrm )
+            return VLC_EGENERIC;
+        *pi_duration = EsOutGetBuffering( out );
+        return VLC_SUCCESS;
+    }
     case ES_OUT_PRIV_SET_TIMES:
     {
         double f_position = va_arg( args, double );
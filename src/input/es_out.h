@@ -96,7 +96,10 @@ enum es_out_query_private_e
     ES_OUT_PRIV_SET_VBI_PAGE,                       /* arg1=unsigned res=can fail */
 
     /* Set VBI/Teletext menu transparent */
-    ES_OUT_PRIV_SET_VBI_TRANSPARENCY                /* arg1=bool res=can fail */
+    ES_OUT_PRIV_SET_VBI_TRANSPARENCY,               /* arg1=bool res=can fail */
+
+    /* Get the duration of the data buffered ahead of the playback */
+    ES_OUT_PRIV_GET_BUFFERED_DURATION               /* arg1=vlc_tick_t * res=can fail */
 };
 
 static inline int es_out_vaPrivControl( es_out_t *out, int query, va_list args )
@@ -241,6 +244,12 @@ static inline int es_out_SetVbiTransparency( es_out_t *p_out, vlc_es_id_t *id,
     return es_out_PrivControl( p_out, ES_OUT_PRIV_SET_VBI_TRANSPARENCY, id,
                                enabled );
 }
+static inline int es_out_GetBufferedDuration( es_out_t *p_out,
+                                              vlc_tick_t *pi_duration )
+{
+    return es_out_PrivControl( p_out, ES_OUT_PRIV_GET_BUFFERED_DURATION,
+                               pi_duration );
+}
 
 es_out_t  *input_EsOutNew( input_thread_t *, input_source_t *main_source, float rate,
                            enum input_type input_type );
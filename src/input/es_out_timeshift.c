@@ -773,6 +773,11 @@ static int PrivControlLocked( es_out_t *p_tsout, input_source_t *in, int i_query
     }
     case ES_OUT_PRIV_GET_GROUP_FORCED:
         return es_out_in_vaPrivControl( p_sys->p_out, in, i_query, args );
+    case ES_OUT_PRIV_GET_BUFFERED_DURATION:
+        /* The timeshift buffer is not a live latency */
+        if( p_sys->b_delayed )
+            return VLC_EGENERIC;
+        return es_out_in_vaPrivControl( p_sys->p_out, in, i_query, args );
     /* Invalid queries for this es_out level */
     case ES_OUT_PRIV_SET_ES:
     case ES_OUT_PRIV_UNSET_ES:
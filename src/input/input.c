@@ -261,6 +261,8 @@ input_thread_t *input_Create( vlc_object_t *p_parent,
     priv->is_stopped = false;
     priv->b_recording = false;
     priv->rate = 1.f;
+    priv->b_live_latency = false;
+    priv->live_rate = 1.f;
     TAB_INIT( priv->i_attachment, priv->attachment );
     priv->p_sout   = NULL;
     priv->b_out_pace_control = priv->type == INPUT_TYPE_THUMBNAILING;
@@ -599,6 +601,80 @@ static void InputSourceStatistics( input_source_t *source, input_item_t *item,
     es_out_SetTimes( out, f_position, i_time, i_normal_time, i_length );
 }
 
+static void LiveLatencySetRate( input_thread_t *p_input, float rate )
+{
+    input_thread_private_t *priv = input_priv(p_input);
+
+    if( rate == priv->live_rate )
+        return;
+
+    priv->live_rate = rate;
+    es_out_SetRate( priv->p_es_out, priv->rate * rate, priv->rate * rate );
+
+    if( priv->stats != NULL )
+        atomic_fetch_add_explicit( &priv->stats->live_rate_changes, 1,
+                                   memory_order_relaxed );
+}
+
+/**
+ * Hold the distance to the live edge by correcting the playback rate.
+ */
+static void MainLoopLiveLatency( input_thread_t *p_input )
+{
+    input_thread_private_t *priv = input_priv(p_input);
+    input_source_t *master = priv->master;
+    vlc_tick_t i_edge, i_buffered;
+
+    if( !priv->b_live_latency )
+        return;
+
+    /* Only live adaptive streams know how far the demuxed data is from the
+     * live edge. The data of other live inputs, that cannot be paced, is
+     * demuxed as soon as it is received. */
+    if( demux_Control( master->p_demux, DEMUX_GET_LIVE_DELAY, &i_edge ) )
+    {
+        if( master->b_can_pace_control )
+            return;
+        i_edge = 0;
+    }
+
+    /* No measure while buffering or timeshifting */
+    if( es_out_GetBufferedDuration( priv->p_es_out, &i_buffered ) )
+    {
+        live_latency_Reset( &priv->live_latency );
+        LiveLatencySetRate( p_input, 1.f );
+        return;
+    }
+
+    float rate = live_latency_Update( &priv->live_latency,
+                                      i_edge + i_buffered );
+    vlc_tick_t i_latency = live_latency_Get( &priv->live_latency );
+
+    /* Unpaced inputs cannot be played faster than they are received
+     * without the timeshift: their latency is only reported. The rate
+     * requested by the user has precedence. */
+    if( !master->b_can_pace_control || priv->rate != 1.f
+     || ( priv->p_sout && !priv->b_out_pace_control ) )
+        rate = 1.f;
+
+    if( rate != priv->live_rate )
+        msg_Dbg( p_input, "live latency %"PRId64" ms (target %"PRId64" ms), "
+                 "rate %.2f", MS_FROM_VLC_TICK(i_latency),
+                 MS_FROM_VLC_TICK(priv->live_latency.target), rate );
+    LiveLatencySetRate( p_input, rate );
+
+    if( priv->stats != NULL )
+    {
+        atomic_store_explicit( &priv->stats->live_latency, i_latency,
+                               memory_order_relaxed );
+        atomic_store_explicit( &priv->stats->live_latency_target,
+                               priv->live_latency.target,
+                               memory_order_relaxed );
+        atomic_store_explicit( &priv->stats->live_rate, priv->live_rate,
+                               memory_order_relaxed );
+    }
+}
+
 /**
  * Update timing infos and statistics.
  */
@@ -606,6 +682,8 @@ static void MainLoopStatistics( input_thread_t *p_input )
 {
     input_thread_private_t *priv = input_priv(p_input);
 
+    MainLoopLiveLatency( p_input );
+
     InputSourceStatistics( priv->master, priv->p_item, priv->p_es_out );
 
     for (size_t i = 0; i < priv->i_slave; i++)
@@ -1215,6 +1293,24 @@ static void UpdatePtsDelay( input_thread_t *p_input )
     es_out_SetJitter( input_priv(p_input)->p_es_out, i_pts_delay, 0, i_cr_average );
 }
 
+static void InitLiveLatency( input_thread_t *p_input )
+{
+    input_thread_private_t *priv = input_priv(p_input);
+
+    vlc_tick_t i_target =
+        VLC_TICK_FROM_MS( var_InheritInteger( p_input, "live-latency" ) );
+    if( i_target <= 0 )
+        return;
+
+    float rate_min = var_InheritFloat( p_input, "live-rate-min" );
+    float rate_max = var_InheritFloat( p_input, "live-rate-max" );
+    rate_min = __MIN( __MAX( rate_min, INPUT_RATE_MIN ), 1.f );
+    rate_max = __MAX( __MIN( rate_max, INPUT_RATE_MAX ), 1.f );
+
+    live_latency_Init( &priv->live_latency, i_target, rate_min, rate_max );
+    priv->b_live_latency = true;
+}
+
 static void InitPrograms( input_thread_t * p_input )
 {
     int i_es_out_mode;
@@ -1362,6 +1458,9 @@ static int Init( input_thread_t * p_input )
                  priv->b_out_pace_control ? "a" : "" );
     }
 
+    if( priv->type == INPUT_TYPE_NONE )
+        InitLiveLatency( p_input );
+
     if (!input_item_IsPreparsed(input_priv(p_input)->p_item))
     {
         vlc_meta_t *p_meta = vlc_meta_New();
@@ -2017,6 +2116,10 @@ static bool Control( input_thread_t *p_input,
 
         case INPUT_CONTROL_SET_RATE:
         {
+            /* The rate requested by the user replaces the live latency
+             * correction */
+            LiveLatencySetRate( p_input, 1.f );
+
             /* Get rate and direction */
             float rate = fabsf( param.val.f_float );
             int i_rate_sign = param.val.f_float < 0 ? -1 : 1;
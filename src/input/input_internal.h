@@ -27,6 +27,7 @@
 #include <vlc_input.h>
 #include "input_interface.h"
 #include "../misc/interrupt.h"
+#include "../clock/live_latency.h"
 #include "./source.h"
 
 struct input_stats;
@@ -451,6 +452,11 @@ typedef struct input_thread_private_t
     bool        b_low_delay;
     vlc_tick_t  i_jitter_max;
 
+    /* Live latency control */
+    bool        b_live_latency;
+    struct live_latency live_latency;
+    float       live_rate; /* correction of the rate, 1 if none */
+
     /* Output */
     bool            b_out_pace_control; /* XXX Move it ot es_sout ? */
     sout_stream_t   *p_sout;            /* Idem ? */
@@ -688,6 +694,10 @@ struct input_stats {
     atomic_uintmax_t displayed_pictures;
     atomic_uintmax_t late_pictures;
     atomic_uintmax_t lost_pictures;
+    _Atomic vlc_tick_t live_latency;
+    _Atomic vlc_tick_t live_latency_target;
+    _Atomic float live_rate;
+    atomic_uintmax_t live_rate_changes;
 };
 
 struct input_stats *input_stats_Create(void);
@@ -0,0 +1,352 @@
+/*****************************************************************************
+ * seekindex.c: persistent time to byte offset index
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <vlc_common.h>
+#include <vlc_configuration.h>
+#include <vlc_fs.h>
+#include <vlc_hash.h>
+#include <vlc_seekindex.h>
+#include <vlc_strings.h>
+
+#include "misc/cachedir.h"
+
+/* Cache file layout, all little endian:
+ *  magic[8], stream size (64), stream mtime (64), entry count (32),
+ *  reserved (32), then count * { time (64), offset (64) } */
+#define SEEKINDEX_MAGIC "VLCSIDX1"
+#define SEEKINDEX_HEADER_SIZE 32
+#define SEEKINDEX_ENTRY_SIZE 16
+#define SEEKINDEX_MAX_ENTRIES (1 << 20)
+/* The least recently written indexes are removed above this total size */
+#define SEEKINDEX_DIR_MAX_SIZE (64 << 20)
+
+struct vlc_seekindex
+{
+    struct vlc_seekindex_entry *entries;
+    size_t count;
+    size_t size;
+    vlc_tick_t interval;
+
+    /* Cache binding */
+    vlc_object_t *obj;
+    char *path;
+    uint64_t stream_size;
+    uint64_t stream_mtime;
+    bool dirty;
+};
+
+vlc_seekindex_t *vlc_seekindex_New(vlc_tick_t interval)
+{
+    vlc_seekindex_t *index = malloc(sizeof (*index));
+    if (unlikely(index == NULL))
+        return NULL;
+
+    index->entries = NULL;
+    index->count = 0;
+    index->size = 0;
+    /* Never store two entries with the same time */
+    index->interval = interval > 0 ? interval : 1;
+    index->obj = NULL;
+    index->path = NULL;
+    index->stream_size = 0;
+    index->stream_mtime = 0;
+    index->dirty = false;
+    return index;
+}
+
+/* Returns the number of entries with a time lower or equal to time */
+static size_t UpperBound(const vlc_seekindex_t *index, vlc_tick_t time)
+{
+    size_t lo = 0, hi = index->count;
+
+    while (lo < hi)
+    {
+        size_t mid = lo + (hi - lo) / 2;
+
+        if (index->entries[mid].time <= time)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+int vlc_seekindex_Add(vlc_seekindex_t *index, vlc_tick_t time,
+                      uint64_t offset)
+{
+    if (time < VLC_TICK_0)
+        return VLC_EGENERIC;
+
+    size_t pos = UpperBound(index, time);
+
+    if (pos > 0)
+    {
+        const struct vlc_seekindex_entry *prev = &index->entries[pos - 1];
+        if (time - prev->time < index->interval || offset < prev->offset)
+            return VLC_EGENERIC;
+    }
+    if (pos < index->count)
+    {
+        const struct vlc_seekindex_entry *next = &index->entries[pos];
+        if (next->time - time < index->interval || offset > next->offset)
+            return VLC_EGENERIC;
+    }
+
+    if (index->count == index->size)
+    {
+        if (index->size >= SEEKINDEX_MAX_ENTRIES)
+            return VLC_EGENERIC;
+
+        size_t size = index->size ? index->size * 2 : 64;
+        struct vlc_seekindex_entry *entries =
+            vlc_reallocarray(index->entries, size, sizeof (*entries));
+        if (unlikely(entries == NULL))
+            return VLC_ENOMEM;
+        index->entries = entries;
+        index->size = size;
+    }
+
+    /* Entries are mostly appended during playback: the move is usually
+     * empty */
+    memmove(&index->entries[pos + 1], &index->entries[pos],
+            (index->count - pos) * sizeof (*index->entries));
+    index->entries[pos].time = time;
+    index->entries[pos].offset = offset;
+    index->count++;
+    index->dirty = true;
+    return VLC_SUCCESS;
+}
+
+int vlc_seekindex_Lookup(const vlc_seekindex_t *index, vlc_tick_t time,
+                         struct vlc_seekindex_entry *before,
+                         struct vlc_seekindex_entry *after)
+{
+    if (index->count == 0)
+        return VLC_EGENERIC;
+
+    size_t pos = UpperBound(index, time);
+
+    if (before != NULL)
+    {
+        if (pos > 0)
+            *before = index->entries[pos - 1];
+        else
+            before->time = VLC_TICK_INVALID;
+    }
+    if (after != NULL)
+    {
+        if (pos < index->count)
+            *after = index->entries[pos];
+        else
+            after->time = VLC_TICK_INVALID;
+    }
+    return VLC_SUCCESS;
+}
+
+size_t vlc_seekindex_Count(const vlc_seekindex_t *index)
+{
+    return index->count;
+}
+
+struct seekindex_prune
+{
+    vlc_object_t *obj;
+    const char *dir;
+};
+
+static void CachePrune(void *data)
+{
+    const struct seekindex_prune *prune = data;
+
+    cachedir_Prune(prune->obj, prune->dir, SEEKINDEX_DIR_MAX_SIZE);
+}
+
+static char *CachePath(vlc_object_t *obj, const char *url, const char *tag)
+{
+    char *cachedir = config_GetUserDir(VLC_CACHE_DIR);
+    if (unlikely(cachedir == NULL))
+        return NULL;
+
+    char *dir;
+    if (asprintf(&dir, "%s" DIR_SEP "seekindex", cachedir) == -1)
+        dir = NULL;
+    free(cachedir);
+    if (unlikely(dir == NULL))
+        return NULL;
+
+    vlc_mkdir_parent(dir, 0700);
+
+    /* Once per process is enough: the indexes are small */
+    static vlc_once_t once = VLC_STATIC_ONCE;
+    struct seekindex_prune prune = { obj, dir };
+    vlc_once(&once, CachePrune, &prune);
+
+    char hash[VLC_HASH_MD5_DIGEST_HEX_SIZE];
+    vlc_hash_md5_t md5;
+    vlc_hash_md5_Init(&md5);
+    vlc_hash_md5_Update(&md5, url, strlen(url));
+    vlc_hash_md5_Update(&md5, "\n", 1);
+    vlc_hash_md5_Update(&md5, tag, strlen(tag));
+    vlc_hash_FinishHex(&md5, hash);
+
+    char *path;
+    if (asprintf(&path, "%s" DIR_SEP "%s", dir, hash) == -1)
+        path = NULL;
+    free(dir);
+    return path;
+}
+
+static void CacheLoad(vlc_seekindex_t *index)
+{
+    FILE *file = vlc_fopen(index->path, "rb");
+    if (file == NULL)
+        return;
+
+    uint8_t header[SEEKINDEX_HEADER_SIZE];
+    if (fread(header, sizeof (header), 1, file) != 1
+     || memcmp(header, SEEKINDEX_MAGIC, 8))
+        goto error;
+
+    /* A different size or modification time means a different file */
+    if (GetQWLE(&header[8]) != index->stream_size
+     || GetQWLE(&header[16]) != index->stream_mtime)
+        goto error;
+
+    uint32_t count = GetDWLE(&header[24]);
+    if (count > SEEKINDEX_MAX_ENTRIES)
+        goto error;
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        uint8_t buf[SEEKINDEX_ENTRY_SIZE];
+
+        if (fread(buf, sizeof (buf), 1, file) != 1)
+            goto error;
+
+        uint64_t offset = GetQWLE(&buf[8]);
+        if (offset >= index->stream_size)
+            goto error;
+        if (vlc_seekindex_Add(index, GetQWLE(&buf[0]), offset) == VLC_ENOMEM)
+            goto error;
+    }
+    fclose(file);
+
+    index->dirty = false;
+    msg_Dbg(index->obj, "loaded %zu seek index entries", index->count);
+    return;
+
+error:
+    fclose(file);
+    index->count = 0;
+    index->dirty = false;
+    msg_Dbg(index->obj, "discarding stale seek index %s", index->path);
+}
+
+static void CacheSave(vlc_seekindex_t *index)
+{
+    char *tmp;
+    if (asprintf(&tmp, "%s.tmp", index->path) == -1)
+        return;
+
+    FILE *file = vlc_fopen(tmp, "wb");
+    if (file == NULL)
+    {
+        msg_Warn(index->obj, "cannot write seek index %s: %s", tmp,
+                 vlc_strerror_c(errno));
+        free(tmp);
+        return;
+    }
+
+    uint8_t header[SEEKINDEX_HEADER_SIZE];
+    memcpy(header, SEEKINDEX_MAGIC, 8);
+    SetQWLE(&header[8], index->stream_size);
+    SetQWLE(&header[16], index->stream_mtime);
+    SetDWLE(&header[24], index->count);
+    SetDWLE(&header[28], 0);
+
+    bool ok = fwrite(header, sizeof (header), 1, file) == 1;
+    for (size_t i = 0; i < index->count && ok; i++)
+    {
+        uint8_t buf[SEEKINDEX_ENTRY_SIZE];
+
+        SetQWLE(&buf[0], index->entries[i].time);
+        SetQWLE(&buf[8], index->entries[i].offset);
+        ok = fwrite(buf, sizeof (buf), 1, file) == 1;
+    }
+    if (fclose(file))
+        ok = false;
+
+    /* Replace atomically so that a concurrent reader never sees a partial
+     * index */
+    if (ok && vlc_rename(tmp, index->path) == 0)
+        msg_Dbg(index->obj, "saved %zu seek index entries", index->count);
+    else
+        vlc_unlink(tmp);
+    free(tmp);
+}
+
+#undef vlc_seekindex_Open
+vlc_seekindex_t *vlc_seekindex_Open(vlc_object_t *obj, stream_t *s,
+                                    const char *tag, vlc_tick_t interval)
+{
+    if (!var_InheritBool(obj, "seek-index-cache") || s->psz_url == NULL)
+        return NULL;
+
+    uint64_t size, mtime;
+    if (vlc_stream_GetSize(s, &size) || size == 0
+     || vlc_stream_GetMTime(s, &mtime))
+        return NULL;
+
+    vlc_seekindex_t *index = vlc_seekindex_New(interval);
+    if (unlikely(index == NULL))
+        return NULL;
+
+    index->path = CachePath(obj, s->psz_url, tag);
+    if (unlikely(index->path == NULL))
+    {
+        vlc_seekindex_Delete(index);
+        return NULL;
+    }
+    index->obj = obj;
+    index->stream_size = size;
+    index->stream_mtime = mtime;
+
+    CacheLoad(index);
+    return index;
+}
+
+void vlc_seekindex_Delete(vlc_seekindex_t *index)
+{
+    if (index->path != NULL && index->dirty)
+        CacheSave(index);
+
+    free(index->path);
+    free(index->entries);
+    free(index);
+}
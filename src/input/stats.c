@@ -68,6 +68,10 @@ struct input_stats *input_stats_Create(void)
     atomic_init(&stats->displayed_pictures, 0);
     atomic_init(&stats->late_pictures, 0);
     atomic_init(&stats->lost_pictures, 0);
+    atomic_init(&stats->live_latency, 0);
+    atomic_init(&stats->live_latency_target, 0);
+    atomic_init(&stats->live_rate, 1.f);
+    atomic_init(&stats->live_rate_changes, 0);
     return stats;
 }
 
@@ -111,6 +115,16 @@ void input_stats_Compute(struct input_stats *stats, input_stats_t *st)
                                                     memory_order_relaxed);
     st->i_lost_pictures = atomic_load_explicit(&stats->lost_pictures,
                                                memory_order_relaxed);
+
+    /* Live latency */
+    st->i_live_latency = atomic_load_explicit(&stats->live_latency,
+                                              memory_order_relaxed);
+    st->i_live_latency_target = atomic_load_explicit(
+                    &stats->live_latency_target, memory_order_relaxed);
+    st->f_live_rate = atomic_load_explicit(&stats->live_rate,
+                                           memory_order_relaxed);
+    st->i_live_rate_changes = atomic_load_explicit(&stats->live_rate_changes,
+                                                   memory_order_relaxed);
 }
 
 /** Update a counter element with new values
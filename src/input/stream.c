@@ -53,6 +53,11 @@ typedef struct stream_priv_t
     uint64_t offset;
     bool eof;
 
+    struct {
+        uint64_t read; /* bytes read from the stream */
+        uint64_t copied; /* bytes copied out of the source blocks */
+    } stats;
+
     /* UTF-16 and UTF-32 file reading */
     struct {
         vlc_iconv_t   conv;
@@ -99,6 +104,8 @@ stream_t *vlc_stream_CustomNew(vlc_object_t *parent,
     priv->peek = NULL;
     priv->offset = 0;
     priv->eof = false;
+    priv->stats.read = 0;
+    priv->stats.copied = 0;
 
     /* UTF16 and UTF32 text file conversion */
     priv->text.conv = (vlc_iconv_t)(-1);
@@ -128,6 +135,11 @@ void stream_CommonDelete(stream_t *s)
     if (priv->text.conv != (vlc_iconv_t)(-1))
         vlc_iconv_close(priv->text.conv);
 
+    if (priv->stats.read > 0)
+        msg_Dbg(s, "%"PRIu64" bytes read, %"PRIu64" bytes copied (%.2f)",
+                priv->stats.read, priv->stats.copied,
+                (double)priv->stats.copied / priv->stats.read);
+
     if (priv->peek != NULL)
         block_Release(priv->peek);
     if (priv->block != NULL)
@@ -415,6 +427,117 @@ char *vlc_stream_ReadLine( stream_t *s )
     return p_line;
 }
 
+/* Source blocks shared by several frames, so that the stream can hand over
+ * parts of them without copying */
+struct vlc_stream_shared
+{
+    block_t *block;
+    atomic_uint refs;
+};
+
+struct vlc_stream_view
+{
+    block_t self;
+    struct vlc_stream_shared *shared;
+};
+
+static void vlc_stream_ViewRelease(block_t *block)
+{
+    struct vlc_stream_view *view =
+        container_of(block, struct vlc_stream_view, self);
+    struct vlc_stream_shared *shared = view->shared;
+
+    if (atomic_fetch_sub_explicit(&shared->refs, 1,
+                                  memory_order_acq_rel) == 1)
+    {
+        block_Release(shared->block);
+        free(shared);
+    }
+    free(view);
+}
+
+static const struct vlc_frame_callbacks vlc_stream_view_cbs =
+{
+    vlc_stream_ViewRelease,
+};
+
+static block_t *vlc_stream_ViewNew(struct vlc_stream_shared *shared,
+                                   uint8_t *buf, size_t len)
+{
+    struct vlc_stream_view *view = malloc(sizeof (*view));
+    if (unlikely(view == NULL))
+        return NULL;
+
+    atomic_fetch_add_explicit(&shared->refs, 1, memory_order_relaxed);
+    view->shared = shared;
+    return vlc_frame_Init(&view->self, &vlc_stream_view_cbs, buf, len);
+}
+
+/* Wraps a source block into a view of its payload, without its head room */
+static block_t *vlc_stream_ShareBlock(block_t *block)
+{
+    struct vlc_stream_shared *shared = malloc(sizeof (*shared));
+    if (unlikely(shared == NULL))
+        return NULL;
+
+    shared->block = block;
+    atomic_init(&shared->refs, 0);
+
+    block_t *view = vlc_stream_ViewNew(shared, block->p_buffer,
+                                       block->i_buffer);
+    if (unlikely(view == NULL))
+        free(shared);
+    return view;
+}
+
+/**
+ * Splits the first len bytes of a block off into a new frame.
+ *
+ * Both frames refer to the buffer of the original block, which is released
+ * along with the last of them.
+ */
+static block_t *vlc_stream_SplitBlock(block_t **restrict pp, size_t len)
+{
+    block_t *block = *pp;
+    struct vlc_stream_shared *shared;
+
+    assert(len < block->i_buffer);
+
+    if (block->cbs != &vlc_stream_view_cbs)
+    {
+        block = vlc_stream_ShareBlock(block);
+        if (unlikely(block == NULL))
+            return NULL;
+        *pp = block;
+    }
+    shared = container_of(block, struct vlc_stream_view, self)->shared;
+
+    block_t *head = vlc_stream_ViewNew(shared, block->p_buffer, len);
+    if (unlikely(head == NULL))
+        return NULL;
+
+    /* The rest must not reuse the bytes handed over as head room */
+    block->p_buffer += len;
+    block->i_buffer -= len;
+    block->i_size -= block->p_buffer - block->p_start;
+    block->p_start = block->p_buffer;
+    return head;
+}
+
+/* Reads the next block from a block source, for the stream to buffer it */
+static block_t *vlc_stream_FetchBlock(stream_t *s)
+{
+    /* Sources with a read callback are always read through it */
+    if ((s->ops != NULL && (s->ops->stream.read != NULL
+                         || s->ops->stream.block == NULL))
+     || (s->ops == NULL && (s->pf_read != NULL || s->pf_block == NULL))
+     || vlc_killed())
+        return NULL;
+
+    bool eof = false;
+    return (s->ops != NULL ? s->ops->stream.block : s->pf_block)(s, &eof);
+}
+
 static ssize_t vlc_stream_CopyBlock(block_t **restrict pp,
                                     void *buf, size_t len)
 {
@@ -469,7 +592,11 @@ static ssize_t vlc_stream_ReadRaw(stream_t *s, void *buf, size_t len)
 
     ret = vlc_stream_CopyBlock(&priv->block, buf, len);
     if (ret >= 0)
+    {
+        if (buf != NULL)
+            priv->stats.copied += ret;
         return ret;
+    }
 
     if ((s->ops != NULL && s->ops->stream.block != NULL) || (s->ops == NULL && s->pf_block != NULL))
     {
@@ -478,7 +605,11 @@ static ssize_t vlc_stream_ReadRaw(stream_t *s, void *buf, size_t len)
         priv->block = (s->ops != NULL ? s->ops->stream.block : s->pf_block)(s, &eof);
         ret = vlc_stream_CopyBlock(&priv->block, buf, len);
         if (ret >= 0)
+        {
+            if (buf != NULL)
+                priv->stats.copied += ret;
             return ret;
+        }
         return eof ? 0 : -1;
     }
 
@@ -494,13 +625,19 @@ ssize_t vlc_stream_ReadPartial(stream_t *s, void *buf, size_t len)
     if (ret >= 0)
     {
         priv->offset += ret;
+        priv->stats.read += ret;
+        if (buf != NULL)
+            priv->stats.copied += ret;
         assert(ret <= (ssize_t)len);
         return ret;
     }
 
     ret = vlc_stream_ReadRaw(s, buf, len);
     if (ret > 0)
+    {
         priv->offset += ret;
+        priv->stats.read += ret;
+    }
     if (ret == 0)
         priv->eof = len != 0;
     assert(ret <= (ssize_t)len);
@@ -542,6 +679,13 @@ ssize_t vlc_stream_Peek(stream_t *s, const uint8_t **restrict bufp, size_t len)
         priv->block = NULL;
     }
 
+    if (peek == NULL && len > 0)
+    {
+        /* Peek into the next source block directly, if it is large enough */
+        peek = vlc_stream_FetchBlock(s);
+        priv->peek = peek;
+    }
+
     if (peek == NULL)
     {
         peek = block_Alloc(len);
@@ -628,7 +772,10 @@ block_t *vlc_stream_ReadBlock(stream_t *s)
     }
 
     if (block != NULL)
+    {
         priv->offset += block->i_buffer;
+        priv->stats.read += block->i_buffer;
+    }
 
     return block;
 }
@@ -678,6 +825,19 @@ int vlc_stream_Seek(stream_t *s, uint64_t offset)
     {
         if (priv->offset == offset)
             return VLC_SUCCESS; /* Nothing to do! */
+
+        block_t *block = priv->block;
+        if (block != NULL && offset > priv->offset
+         && offset < priv->offset + block->i_buffer)
+        {   /* Seeking forward within the current block, as a demuxer
+             * skipping data would, without reading it again */
+            size_t fwd = offset - priv->offset;
+
+            block->p_buffer += fwd;
+            block->i_buffer -= fwd;
+            priv->offset = offset;
+            return VLC_SUCCESS;
+        }
     }
 
     int ret;
@@ -910,11 +1070,59 @@ int vlc_stream_vaControl(stream_t *s, int cmd, va_list args)
                 return s->ops->stream.set_private_id_ca(s, payload);
             }
             return VLC_EGENERIC;
+        case STREAM_CAN_SKIP_CACHE:
+            return VLC_EGENERIC;
         default:
             vlc_assert_unreachable();
     }
 }
 
+/**
+ * Hands over the next bytes of the stream without copying them, if they are
+ * all buffered in one block.
+ */
+static block_t *vlc_stream_ViewBlock( stream_t *s, size_t size )
+{
+    stream_priv_t *priv = stream_priv(s);
+    block_t **pp = (priv->peek != NULL) ? &priv->peek : &priv->block;
+    block_t *block;
+
+    if( size == 0 )
+        return NULL;
+    if( *pp == NULL )
+        *pp = vlc_stream_FetchBlock( s );
+    if( *pp == NULL || (*pp)->i_buffer < size )
+        return NULL;
+
+    if( (*pp)->i_buffer == size )
+    {
+        block = *pp;
+        /* Only hand over the payload: the head room of a source block may
+         * still hold data of the source, such as the mapped file */
+        if( block->p_start != block->p_buffer )
+        {
+            block = vlc_stream_ShareBlock( block );
+            if( unlikely(block == NULL) )
+                return NULL;
+        }
+        *pp = NULL;
+        /* Do not leak the source metadata to the demuxer */
+        block->i_flags = 0;
+        block->i_pts = block->i_dts = VLC_TICK_INVALID;
+        block->i_length = 0;
+    }
+    else
+    {
+        block = vlc_stream_SplitBlock( pp, size );
+        if( unlikely(block == NULL) )
+            return NULL;
+    }
+
+    priv->offset += size;
+    priv->stats.read += size;
+    return block;
+}
+
 /**
  * Read data into a block.
  *
@@ -929,7 +1137,11 @@ block_t *vlc_stream_Block( stream_t *s, size_t size )
     if( unlikely(size > SSIZE_MAX) )
         return NULL;
 
-    block_t *block = block_Alloc( size );
+    block_t *block = vlc_stream_ViewBlock( s, size );
+    if( block != NULL )
+        return block;
+
+    block = block_Alloc( size );
     if( unlikely(block == NULL) )
         return NULL;
 
@@ -406,6 +406,11 @@ static const char *const screensaver_texts[] = {
     "picture quality, for instance deinterlacing, or distort " \
     "the video.")
 
+#define FILTER_THREADS_TEXT N_("Video filter threads")
+#define FILTER_THREADS_LONGTEXT N_( \
+    "Maximum number of threads used by video filters processing pictures " \
+    "in slices. 0 means one per CPU, 1 disables slice threading.")
+
 #define SNAP_PATH_TEXT N_("Video snapshot directory (or filename)")
 #define SNAP_PATH_LONGTEXT N_( \
     "Directory where the video snapshots will be stored.")
@@ -555,6 +560,20 @@ static const char *const fit_descriptions[] = {
     "This defines the maximum input delay jitter that the synchronization " \
     "algorithms should try to compensate (in milliseconds)." )
 
+#define LIVE_LATENCY_TEXT N_("Live latency target (ms)")
+#define LIVE_LATENCY_LONGTEXT N_( \
+    "Distance to the live edge that the playback of live streams should " \
+    "hold, by slightly changing the playback rate (in milliseconds, 0 to " \
+    "disable).")
+
+#define LIVE_RATE_MIN_TEXT N_("Live latency minimum rate")
+#define LIVE_RATE_MIN_LONGTEXT N_( \
+    "Slowest playback rate used to increase the live latency.")
+
+#define LIVE_RATE_MAX_TEXT N_("Live latency maximum rate")
+#define LIVE_RATE_MAX_LONGTEXT N_( \
+    "Fastest playback rate used to reduce the live latency.")
+
 #define CLOCK_MASTER_TEXT N_("Clock master source")
 #define CLOCK_MASTER_LONGTEXT N_( "Select the clock master source:\n" \
     "auto: best clock source, input if the access can't be paced " \
@@ -701,6 +720,11 @@ static const char *const ppsz_prefres[] = {
 #define INPUT_FAST_SEEK_LONGTEXT N_( \
     "Favor speed over precision while seeking" )
 
+#define SEEK_INDEX_CACHE_TEXT N_("Cache seek indexes")
+#define SEEK_INDEX_CACHE_LONGTEXT N_( \
+    "Keep the seek positions found in files without an index in the user " \
+    "cache directory, so that seeking them again is faster." )
+
 #define INPUT_RATE_TEXT N_("Playback speed")
 #define INPUT_RATE_LONGTEXT N_( \
     "This defines the playback speed (nominal speed is 1.0)." )
@@ -1187,7 +1211,21 @@ static const char *const clock_sources_text[] = {
 
 #define PREPARSE_THREADS_TEXT N_( "Preparsing threads" )
 #define PREPARSE_THREADS_LONGTEXT N_( \
-    "Maximum number of threads used to preparse items" )
+    "Maximum number of threads used to preparse local items" )
+
+#define PREPARSE_SHARE_THREADS_TEXT N_( "Network share preparsing threads" )
+#define PREPARSE_SHARE_THREADS_LONGTEXT N_( \
+    "Maximum number of threads used to preparse items from network shares " \
+    "(SMB, NFS, FTP...)" )
+
+#define PREPARSE_REMOTE_THREADS_TEXT N_( "Remote preparsing threads" )
+#define PREPARSE_REMOTE_THREADS_LONGTEXT N_( \
+    "Maximum number of threads used to preparse items from HTTP servers" )
+
+#define PREPARSE_CACHE_TEXT N_( "Cache preparsing results" )
+#define PREPARSE_CACHE_LONGTEXT N_( \
+    "Keep the metadata and tracks of preparsed local files in the user " \
+    "cache directory, so that they are not parsed again until they change." )
 
 #define FETCH_ART_THREADS_TEXT N_( "Fetch-art threads" )
 #define FETCH_ART_THREADS_LONGTEXT N_( \
@@ -1740,6 +1778,9 @@ vlc_module_begin ()
     set_subcategory( SUBCAT_VIDEO_VFILTER )
     add_module_list("video-filter", "video filter", NULL,
                     VIDEO_FILTER_TEXT, VIDEO_FILTER_LONGTEXT)
+    add_integer( "filter-threads", 0, FILTER_THREADS_TEXT,
+                 FILTER_THREADS_LONGTEXT )
+        change_integer_range( 0, 64 )
 
 #if 0
     add_string( "pixel-ratio", "1", PIXEL_RATIO_TEXT, PIXEL_RATIO_TEXT )
@@ -1860,6 +1901,8 @@ vlc_module_begin ()
     add_bool( "input-fast-seek", false,
               INPUT_FAST_SEEK_TEXT, INPUT_FAST_SEEK_LONGTEXT )
         change_safe ()
+    add_bool( "seek-index-cache", true,
+              SEEK_INDEX_CACHE_TEXT, SEEK_INDEX_CACHE_LONGTEXT )
     add_float( "rate", 1.,
                INPUT_RATE_TEXT, INPUT_RATE_LONGTEXT )
 
@@ -1981,6 +2024,18 @@ vlc_module_begin ()
     add_string( "clock-master", "auto",
                  CLOCK_MASTER_TEXT, CLOCK_MASTER_LONGTEXT )
         change_string_list( ppsz_clock_master_values, ppsz_clock_master_descriptions )
+    add_integer( "live-latency", 0, LIVE_LATENCY_TEXT,
+                 LIVE_LATENCY_LONGTEXT )
+        change_integer_range( 0, 60000 )
+        change_safe()
+    add_float( "live-rate-min", .95, LIVE_RATE_MIN_TEXT,
+               LIVE_RATE_MIN_LONGTEXT )
+        change_float_range( .5, 1. )
+        change_safe()
+    add_float( "live-rate-max", 1.05, LIVE_RATE_MAX_TEXT,
+               LIVE_RATE_MAX_LONGTEXT )
+        change_float_range( 1., 2. )
+        change_safe()
 
     add_directory("input-record-path", NULL,
                   INPUT_RECORD_PATH_TEXT, INPUT_RECORD_PATH_LONGTEXT)
@@ -2148,6 +2203,15 @@ vlc_module_begin ()
     add_integer( "preparse-threads", 1, PREPARSE_THREADS_TEXT,
                  PREPARSE_THREADS_LONGTEXT )
 
+    add_integer( "preparse-share-threads", 1, PREPARSE_SHARE_THREADS_TEXT,
+                 PREPARSE_SHARE_THREADS_LONGTEXT )
+
+    add_integer( "preparse-remote-threads", 2, PREPARSE_REMOTE_THREADS_TEXT,
+                 PREPARSE_REMOTE_THREADS_LONGTEXT )
+
+    add_bool( "preparse-cache", true, PREPARSE_CACHE_TEXT,
+              PREPARSE_CACHE_LONGTEXT )
+
     add_integer( "fetch-art-threads", 1, FETCH_ART_THREADS_TEXT,
                  FETCH_ART_THREADS_LONGTEXT )
 
@@ -189,6 +189,8 @@ typedef struct libvlc_priv_t
     struct vlc_medialibrary_t *p_media_library; ///< Media library instance
     struct vlc_thumbnailer_t *p_thumbnailer; ///< Lazily instantiated media thumbnailer
     struct vlc_tracer *tracer; ///< Tracer callbacks
+    struct vlc_executor *filter_executor; ///< Lazily created filter slice pool
+    unsigned filter_threads; ///< Maximum number of filter slice threads
 
     /* Exit callback */
     vlc_exit_t       exit;
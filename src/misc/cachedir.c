@@ -0,0 +1,119 @@
+/*****************************************************************************
+ * cachedir.c: user cache directories maintenance
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/stat.h>
+
+#include <vlc_common.h>
+#include <vlc_fs.h>
+#include <vlc_vector.h>
+
+#include "cachedir.h"
+
+/* Temporary files left behind by a crashed instance, in seconds */
+#define CACHEDIR_TMP_MAX_AGE 3600
+
+struct cache_entry
+{
+    char *path;
+    uint64_t size;
+    time_t mtime;
+};
+
+static int CompareEntries(const void *a, const void *b)
+{
+    const struct cache_entry *ea = a, *eb = b;
+    return (ea->mtime > eb->mtime) - (ea->mtime < eb->mtime);
+}
+
+void cachedir_Prune(vlc_object_t *obj, const char *dir, uint64_t max_size)
+{
+    vlc_DIR *handle = vlc_opendir(dir);
+    if (handle == NULL)
+        return;
+
+    struct VLC_VECTOR(struct cache_entry) entries = VLC_VECTOR_INITIALIZER;
+    uint64_t total = 0;
+    time_t now = time(NULL);
+    const char *name;
+
+    while ((name = vlc_readdir(handle)) != NULL)
+    {
+        if (name[0] == '.')
+            continue;
+
+        char *path;
+        if (asprintf(&path, "%s" DIR_SEP "%s", dir, name) == -1)
+            break;
+
+        struct stat st;
+        if (vlc_stat(path, &st) != 0 || !S_ISREG(st.st_mode))
+        {
+            free(path);
+            continue;
+        }
+
+        /* Cache files are plain hashes, anything else is a temporary file */
+        if (strchr(name, '.') != NULL)
+        {
+            if (now - st.st_mtime > CACHEDIR_TMP_MAX_AGE)
+                vlc_unlink(path);
+            free(path);
+            continue;
+        }
+
+        struct cache_entry entry = { path, st.st_size, st.st_mtime };
+        if (!vlc_vector_push(&entries, entry))
+        {
+            free(path);
+            break;
+        }
+        total += st.st_size;
+    }
+    vlc_closedir(handle);
+
+    if (total > max_size)
+    {
+        /* Leave some room so that the next instances do not prune again */
+        uint64_t target = max_size / 4 * 3;
+        size_t removed = 0;
+
+        qsort(entries.data, entries.size, sizeof (*entries.data),
+              CompareEntries);
+        for (size_t i = 0; i < entries.size && total > target; i++)
+            if (vlc_unlink(entries.data[i].path) == 0)
+            {
+                total -= entries.data[i].size;
+                removed++;
+            }
+        msg_Dbg(obj, "removed %zu old entries from %s", removed, dir);
+    }
+
+    for (size_t i = 0; i < entries.size; i++)
+        free(entries.data[i].path);
+    vlc_vector_destroy(&entries);
+}
@@ -0,0 +1,38 @@
+/*****************************************************************************
+ * cachedir.h: user cache directories maintenance
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef LIBVLC_CACHEDIR_H
+# define LIBVLC_CACHEDIR_H 1
+
+/**
+ * Bounds the size of a cache directory.
+ *
+ * Cache entries are the regular files named without a dot. Their total size
+ * is brought down to 3/4 of \p max_size, removing the least recently written
+ * entries first, when it exceeds \p max_size. Other files are temporary
+ * files: they are removed if they were left behind for more than an hour.
+ *
+ * \param obj object for logging
+ * \param dir cache directory
+ * \param max_size maximum total size of the entries, in bytes
+ */
+void cachedir_Prune(vlc_object_t *obj, const char *dir, uint64_t max_size);
+
+#endif
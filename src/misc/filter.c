@@ -31,6 +31,7 @@
 #include <libvlc.h>
 #include <vlc_filter.h>
 #include <vlc_modules.h>
+#include <vlc_executor.h>
 #include "../misc/variables.h"
 
 /* */
@@ -179,6 +180,120 @@ void filter_DeleteBlend( vlc_blender_t *p_blend )
     vlc_object_delete(p_blend);
 }
 
+/* */
+
+/* Do not split pictures in slices smaller than this many rows */
+#define FILTER_SLICE_MIN_ROWS 32
+#define FILTER_SLICE_MAX 32
+
+struct filter_slice
+{
+    struct vlc_runnable runnable;
+    filter_t *filter;
+    vlc_filter_slice_cb cb;
+    void *opaque;
+    unsigned first, last;
+    vlc_sem_t *done;
+};
+
+static void filter_RunSlice( void *data )
+{
+    struct filter_slice *slice = data;
+
+    slice->cb( slice->filter, slice->opaque, slice->first, slice->last );
+    vlc_sem_post( slice->done );
+}
+
+static vlc_executor_t *filter_GetSliceExecutor( filter_t *p_filter,
+                                                unsigned *threads )
+{
+    libvlc_priv_t *priv = libvlc_priv( vlc_object_instance( p_filter ) );
+    vlc_executor_t *executor;
+
+    vlc_mutex_lock( &priv->lock );
+    if( priv->filter_threads == 0 )
+    {
+        int64_t count = var_InheritInteger( p_filter, "filter-threads" );
+        if( count <= 0 )
+            count = vlc_GetCPUCount();
+        priv->filter_threads = VLC_CLIP( count, 1, FILTER_SLICE_MAX );
+
+        if( priv->filter_threads > 1 )
+        {
+            /* The calling thread always runs one of the slices */
+            priv->filter_executor = vlc_executor_New( priv->filter_threads - 1 );
+            if( priv->filter_executor == NULL )
+                priv->filter_threads = 1;
+        }
+    }
+    executor = priv->filter_executor;
+    *threads = priv->filter_threads;
+    vlc_mutex_unlock( &priv->lock );
+
+    return executor;
+}
+
+void filter_ExecuteSlices( filter_t *p_filter, vlc_filter_slice_cb cb,
+                           void *opaque, unsigned rows, unsigned align )
+{
+    unsigned threads;
+    vlc_executor_t *executor = filter_GetSliceExecutor( p_filter, &threads );
+
+    if( align == 0 )
+        align = 1;
+
+    unsigned count = rows / FILTER_SLICE_MIN_ROWS;
+    if( count > threads )
+        count = threads;
+    if( executor == NULL || count <= 1 )
+    {
+        cb( p_filter, opaque, 0, rows );
+        return;
+    }
+
+    struct filter_slice slices[FILTER_SLICE_MAX];
+    vlc_sem_t done;
+    vlc_sem_init( &done, 0 );
+
+    unsigned step = (rows + count - 1) / count;
+    step = (step + align - 1) / align * align;
+
+    unsigned first = 0;
+    unsigned n = 0;
+    while( first < rows )
+    {
+        struct filter_slice *slice = &slices[n++];
+        slice->filter = p_filter;
+        slice->cb = cb;
+        slice->opaque = opaque;
+        slice->first = first;
+        slice->last = rows - first > step ? first + step : rows;
+        slice->done = &done;
+        slice->runnable.run = filter_RunSlice;
+        slice->runnable.userdata = slice;
+        first = slice->last;
+    }
+
+    for( unsigned i = 1; i < n; i++ )
+        vlc_executor_Submit( executor, &slices[i].runnable );
+
+    cb( p_filter, opaque, slices[0].first, slices[0].last );
+
+    /* Run the slices not picked up by the pool yet on this thread, so that
+     * concurrent filters can never starve each other of pool threads. */
+    unsigned pending = 0;
+    for( unsigned i = 1; i < n; i++ )
+    {
+        if( vlc_executor_Cancel( executor, &slices[i].runnable ) )
+            cb( p_filter, opaque, slices[i].first, slices[i].last );
+        else
+            pending++;
+    }
+
+    while( pending-- > 0 )
+        vlc_sem_wait( &done );
+}
+
 /* */
 #include <vlc_video_splitter.h>
 
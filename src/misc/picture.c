@@ -220,6 +220,7 @@ static bool picture_InitPrivate(const video_format_t *restrict p_fmt,
     }
 
     vlc_atomic_rc_init(&p_picture->refs);
+    priv->gc.recycle = NULL;
     priv->gc.opaque = NULL;
 
     p_picture->p_sys = p_resource->p_sys;
@@ -358,7 +359,10 @@ void picture_Destroy(picture_t *picture)
     priv->gc.destroy(picture);
     vlc_ancillary_array_Clear(&priv->ancillaries);
     video_format_Clean(&picture->format);
-    free(priv);
+    if (priv->gc.recycle != NULL)
+        priv->gc.recycle(picture);
+    else
+        free(priv);
 }
 
 /*****************************************************************************
@@ -440,34 +444,60 @@ static void picture_DestroyClone(picture_t *clone)
     picture_Release(picture);
 }
 
-picture_t *picture_InternalClone(picture_t *picture,
-                                 void (*pf_destroy)(picture_t *), void *opaque)
+static bool picture_InitClonePrivate(picture_priv_t *clone_priv,
+                                     picture_t *picture,
+                                     void (*pf_destroy)(picture_t *),
+                                     void *opaque)
 {
     picture_resource_t res = {
         .p_sys = picture->p_sys,
         .pf_destroy = pf_destroy,
     };
 
+    if (!picture_InitPrivate(&picture->format, clone_priv, &res))
+        return false;
+
+    picture_t *clone = &clone_priv->picture;
+
     for (int i = 0; i < picture->i_planes; i++) {
-        res.p[i].p_pixels = picture->p[i].p_pixels;
-        res.p[i].i_lines = picture->p[i].i_lines;
-        res.p[i].i_pitch = picture->p[i].i_pitch;
+        clone->p[i].p_pixels = picture->p[i].p_pixels;
+        clone->p[i].i_lines = picture->p[i].i_lines;
+        clone->p[i].i_pitch = picture->p[i].i_pitch;
     }
+    clone_priv->gc.opaque = opaque;
 
-    picture_t *clone = picture_NewFromResource(&picture->format, &res);
-    if (likely(clone != NULL)) {
-        picture_priv_t *clone_priv = container_of(clone, picture_priv_t, picture);
-        clone_priv->gc.opaque = opaque;
+    /* The picture context is responsible for potentially holding the
+     * video context attached to the picture if needed. */
+    if (picture->context != NULL)
+        clone->context = picture->context->copy(picture->context);
 
-        /* The picture context is responsible for potentially holding the
-         * video context attached to the picture if needed. */
-        if (picture->context != NULL)
-            clone->context = picture->context->copy(picture->context);
+    picture_Hold(picture);
+    return true;
+}
 
-        picture_Hold(picture);
+picture_t *picture_InternalClone(picture_t *picture,
+                                 void (*pf_destroy)(picture_t *), void *opaque)
+{
+    picture_priv_t *clone_priv = malloc(sizeof (*clone_priv));
+    if (unlikely(clone_priv == NULL))
+        return NULL;
+
+    if (!picture_InitClonePrivate(clone_priv, picture, pf_destroy, opaque)) {
+        free(clone_priv);
+        return NULL;
     }
+    return &clone_priv->picture;
+}
 
-    return clone;
+bool picture_InitClone(picture_priv_t *clone_priv, picture_t *picture,
+                       void (*pf_destroy)(picture_t *),
+                       void (*pf_recycle)(picture_t *), void *opaque)
+{
+    if (!picture_InitClonePrivate(clone_priv, picture, pf_destroy, opaque))
+        return false;
+
+    clone_priv->gc.recycle = pf_recycle;
+    return true;
 }
 
 picture_t *picture_Clone(picture_t *picture)
@@ -30,6 +30,8 @@ typedef struct
     struct
     {
         void (*destroy)(picture_t *);
+        /** Called instead of freeing the picture structure, if not NULL */
+        void (*recycle)(picture_t *);
         void *opaque;
     } gc;
 
@@ -42,3 +44,16 @@ void *picture_Allocate(int *, size_t);
 void picture_Deallocate(int, void *, size_t);
 
 picture_t * picture_InternalClone(picture_t *, void (*pf_destroy)(picture_t *), void *);
+
+/**
+ * Initializes a clone of a picture in caller-provided storage.
+ *
+ * This works as picture_InternalClone(), but does not allocate memory. When
+ * the clone is destroyed, \p pf_recycle is called last instead of freeing
+ * the storage.
+ *
+ * \return true on success, false on error
+ */
+bool picture_InitClone(picture_priv_t *, picture_t *,
+                       void (*pf_destroy)(picture_t *),
+                       void (*pf_recycle)(picture_t *), void *);
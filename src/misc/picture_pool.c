@@ -32,7 +32,6 @@
 #include <stdlib.h>
 
 #include <vlc_common.h>
-#include <vlc_threads.h>
 #include <vlc_picture_pool.h>
 #include <vlc_atomic.h>
 #include "picture.h"
@@ -41,14 +40,21 @@
 
 static_assert ((POOL_MAX & (POOL_MAX - 1)) == 0, "Not a power of two");
 
+struct picture_pool_slot {
+    picture_priv_t clone; /* preallocated clone handed out by the pool */
+    picture_t *picture;
+};
+
 struct picture_pool_t {
-    vlc_mutex_t lock;
-    vlc_cond_t  wait;
+    /* Bit set for each picture available (fast path, lock-free) */
+    _Atomic unsigned long long available;
+    /* Threads sleeping in picture_pool_Wait() (slow path) */
+    atomic_uint waiters;
+    atomic_uint wakeup;
 
-    unsigned long long available;
     vlc_atomic_rc_t    refs;
     unsigned short     picture_count;
-    picture_t  *picture[];
+    struct picture_pool_slot slots[];
 };
 
 static void picture_pool_Destroy(picture_pool_t *pool)
@@ -62,7 +68,7 @@ static void picture_pool_Destroy(picture_pool_t *pool)
 void picture_pool_Release(picture_pool_t *pool)
 {
     for (unsigned i = 0; i < pool->picture_count; i++)
-        picture_Release(pool->picture[i]);
+        picture_Release(pool->slots[i].picture);
     picture_pool_Destroy(pool);
 }
 
@@ -72,32 +78,69 @@ static void picture_pool_ReleaseClone(picture_t *clone)
     uintptr_t sys = (uintptr_t)priv->gc.opaque;
     picture_pool_t *pool = (void *)(sys & ~(POOL_MAX - 1));
     unsigned offset = sys & (POOL_MAX - 1);
-    picture_t *picture = pool->picture[offset];
 
-    picture_Release(picture);
+    picture_Release(pool->slots[offset].picture);
+}
 
-    vlc_mutex_lock(&pool->lock);
-    assert(!(pool->available & (1ULL << offset)));
-    pool->available |= 1ULL << offset;
-    vlc_cond_signal(&pool->wait);
-    vlc_mutex_unlock(&pool->lock);
+static void picture_pool_Put(picture_pool_t *pool, unsigned offset)
+{
+    /* The slot can be reused as soon as its bit is set. */
+    unsigned long long prev = atomic_fetch_or(&pool->available, 1ULL << offset);
+    assert(!(prev & (1ULL << offset)));
+    (void) prev;
+
+    if (atomic_load(&pool->waiters) > 0) {
+        atomic_fetch_add(&pool->wakeup, 1);
+        vlc_atomic_notify_one(&pool->wakeup);
+    }
 
     picture_pool_Destroy(pool);
 }
 
+static void picture_pool_RecycleClone(picture_t *clone)
+{
+    picture_priv_t *priv = (picture_priv_t *)clone;
+    uintptr_t sys = (uintptr_t)priv->gc.opaque;
+
+    picture_pool_Put((void *)(sys & ~(POOL_MAX - 1)), sys & (POOL_MAX - 1));
+}
+
+/* Claims an available picture, returns its offset or -1 if none */
+static int picture_pool_Claim(picture_pool_t *pool)
+{
+    /* Sequentially consistent, so as to pair with picture_pool_Put() */
+    unsigned long long available = atomic_load(&pool->available);
+    int i;
+
+    do {
+        if (available == 0)
+            return -1;
+
+        i = stdc_trailing_zeros(available);
+    } while (!atomic_compare_exchange_weak_explicit(&pool->available,
+                 &available, available & ~(1ULL << i),
+                 memory_order_acquire, memory_order_relaxed));
+
+    return i;
+}
+
 static picture_t *picture_pool_ClonePicture(picture_pool_t *pool,
                                             unsigned offset)
 {
-    picture_t *picture = pool->picture[offset];
+    struct picture_pool_slot *slot = &pool->slots[offset];
     uintptr_t sys = ((uintptr_t)pool) + offset;
 
-    picture_t *clone = picture_InternalClone(picture, picture_pool_ReleaseClone,
-                                 (void*)sys);
-    if (clone != NULL) {
-        assert(!picture_HasChainedPics(clone));
-        vlc_atomic_rc_inc(&pool->refs);
+    vlc_atomic_rc_inc(&pool->refs);
+
+    if (unlikely(!picture_InitClone(&slot->clone, slot->picture,
+                                    picture_pool_ReleaseClone,
+                                    picture_pool_RecycleClone, (void *)sys))) {
+        picture_pool_Put(pool, offset);
+        return NULL;
     }
-    return clone;
+
+    assert(!picture_HasChainedPics(&slot->clone.picture));
+    return &slot->clone.picture;
 }
 
 picture_pool_t *picture_pool_New(unsigned count, picture_t *const *tab)
@@ -106,22 +149,23 @@ picture_pool_t *picture_pool_New(unsigned count, picture_t *const *tab)
         return NULL;
 
     picture_pool_t *pool;
-    size_t size = sizeof (*pool) + count * sizeof (picture_t *);
+    size_t size = sizeof (*pool) + count * sizeof (pool->slots[0]);
 
     size += (-size) & (POOL_MAX - 1);
     pool = aligned_alloc(POOL_MAX, size);
     if (unlikely(pool == NULL))
         return NULL;
 
-    vlc_mutex_init(&pool->lock);
-    vlc_cond_init(&pool->wait);
     if (count == POOL_MAX)
-        pool->available = ~0ULL;
+        atomic_init(&pool->available, ~0ULL);
     else
-        pool->available = (1ULL << count) - 1;
+        atomic_init(&pool->available, (1ULL << count) - 1);
+    atomic_init(&pool->waiters, 0);
+    atomic_init(&pool->wakeup, 0);
     vlc_atomic_rc_init(&pool->refs);
     pool->picture_count = count;
-    memcpy(pool->picture, tab, count * sizeof (picture_t *));
+    for (unsigned i = 0; i < count; i++)
+        pool->slots[i].picture = tab[i];
     return pool;
 }
 
@@ -156,34 +200,38 @@ error:
 
 picture_t *picture_pool_Get(picture_pool_t *pool)
 {
-
-    vlc_mutex_lock(&pool->lock);
     assert(vlc_atomic_rc_get(&pool->refs) > 0);
 
-    if (pool->available == 0)
-    {
-        vlc_mutex_unlock(&pool->lock);
+    int i = picture_pool_Claim(pool);
+    if (i < 0)
         return NULL;
-    }
-
-    int i = stdc_trailing_zeros(pool->available);
-    pool->available &= ~(1ULL << i);
-    vlc_mutex_unlock(&pool->lock);
 
     return picture_pool_ClonePicture(pool, i);
 }
 
 picture_t *picture_pool_Wait(picture_pool_t *pool)
 {
-    vlc_mutex_lock(&pool->lock);
     assert(vlc_atomic_rc_get(&pool->refs) > 0);
 
-    while (pool->available == 0)
-        vlc_cond_wait(&pool->wait, &pool->lock);
+    int i = picture_pool_Claim(pool);
+
+    if (i < 0) {
+        atomic_fetch_add(&pool->waiters, 1);
+
+        for (;;) {
+            unsigned wakeup = atomic_load(&pool->wakeup);
 
-    int i = stdc_trailing_zeros(pool->available);
-    pool->available &= ~(1ULL << i);
-    vlc_mutex_unlock(&pool->lock);
+            /* A release after this point bumps the wake-up counter, so that
+             * the wait below cannot miss it. */
+            i = picture_pool_Claim(pool);
+            if (i >= 0)
+                break;
+
+            vlc_atomic_wait(&pool->wakeup, wakeup);
+        }
+
+        atomic_fetch_sub(&pool->waiters, 1);
+    }
 
     return picture_pool_ClonePicture(pool, i);
 }
@@ -0,0 +1,553 @@
+/*****************************************************************************
+ * cache.c: persistent preparse results
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <vlc_common.h>
+#include <vlc_configuration.h>
+#include <vlc_fs.h>
+#include <vlc_hash.h>
+#include <vlc_input_item.h>
+#include <vlc_memstream.h>
+#include <vlc_meta.h>
+#include <vlc_strings.h>
+#include <vlc_url.h>
+
+#include "cache.h"
+#include "misc/cachedir.h"
+#include "input/item.h"
+
+/* Cache file layout, all little endian:
+ *  magic[8], file size (64), file mtime (64), duration (64),
+ *  attachment count (32), meta count (32), extra meta count (32),
+ *  track count (32), then the meta, extra meta and tracks records.
+ * Strings are a length (32) followed by the bytes, without terminating nul;
+ * NULL strings have the length 0xffffffff. */
+#define PREPARSE_CACHE_MAGIC "VLCPRS01"
+#define PREPARSE_CACHE_HEADER_SIZE 48
+#define PREPARSE_CACHE_MAX_SIZE (1 << 20)
+#define PREPARSE_CACHE_NULL UINT32_MAX
+
+/* The oldest entries are removed above this total size */
+#define PREPARSE_CACHE_DIR_MAX_SIZE (64 << 20)
+
+char *preparse_cache_Open(vlc_object_t *obj)
+{
+    char *cachedir = config_GetUserDir(VLC_CACHE_DIR);
+    if (unlikely(cachedir == NULL))
+        return NULL;
+
+    char *dir;
+    if (asprintf(&dir, "%s" DIR_SEP "preparse", cachedir) == -1)
+        dir = NULL;
+    free(cachedir);
+    if (unlikely(dir == NULL))
+        return NULL;
+
+    if (vlc_mkdir_parent(dir, 0700) != 0 && errno != EEXIST)
+    {
+        msg_Warn(obj, "cannot create preparse cache %s: %s", dir,
+                 vlc_strerror_c(errno));
+        free(dir);
+        return NULL;
+    }
+
+    cachedir_Prune(obj, dir, PREPARSE_CACHE_DIR_MAX_SIZE);
+    return dir;
+}
+
+int preparse_cache_GetKey(const char *dir, const char *uri,
+                          const char *options, struct preparse_cache_key *key)
+{
+    /* Unknown options might change the result */
+    if (options == NULL)
+        return VLC_EGENERIC;
+
+    char *path = vlc_uri2path(uri);
+    if (path == NULL)
+        return VLC_EGENERIC;
+
+    struct stat st;
+    int ret = vlc_stat(path, &st);
+    free(path);
+    if (ret != 0 || !S_ISREG(st.st_mode))
+        return VLC_EGENERIC;
+
+    char hash[VLC_HASH_MD5_DIGEST_HEX_SIZE];
+    vlc_hash_md5_t md5;
+    vlc_hash_md5_Init(&md5);
+    vlc_hash_md5_Update(&md5, uri, strlen(uri));
+    /* Options such as demux or start-time change the preparse result */
+    vlc_hash_md5_Update(&md5, "\n", 1);
+    vlc_hash_md5_Update(&md5, options, strlen(options));
+    vlc_hash_FinishHex(&md5, hash);
+
+    if (asprintf(&key->path, "%s" DIR_SEP "%s", dir, hash) == -1)
+    {
+        key->path = NULL;
+        return VLC_ENOMEM;
+    }
+
+    key->size = st.st_size;
+    key->mtime = st.st_mtime;
+    return VLC_SUCCESS;
+}
+
+void preparse_cache_CleanKey(struct preparse_cache_key *key)
+{
+    free(key->path);
+    key->path = NULL;
+}
+
+/*** Writing ***/
+
+static void WriteU32(struct vlc_memstream *ms, uint32_t value)
+{
+    uint8_t buf[4];
+    SetDWLE(buf, value);
+    vlc_memstream_write(ms, buf, sizeof (buf));
+}
+
+static void WriteU64(struct vlc_memstream *ms, uint64_t value)
+{
+    uint8_t buf[8];
+    SetQWLE(buf, value);
+    vlc_memstream_write(ms, buf, sizeof (buf));
+}
+
+static void WriteString(struct vlc_memstream *ms, const char *str)
+{
+    if (str == NULL)
+    {
+        WriteU32(ms, PREPARSE_CACHE_NULL);
+        return;
+    }
+
+    size_t len = strlen(str);
+    WriteU32(ms, len);
+    vlc_memstream_write(ms, str, len);
+}
+
+static void WriteTrack(struct vlc_memstream *ms,
+                       const struct input_item_es *item_es)
+{
+    const es_format_t *fmt = &item_es->es;
+
+    WriteString(ms, item_es->id);
+    WriteU32(ms, item_es->id_stable);
+    WriteU32(ms, fmt->i_cat);
+    WriteU32(ms, fmt->i_codec);
+    WriteU32(ms, fmt->i_original_fourcc);
+    WriteU32(ms, fmt->i_id);
+    WriteU32(ms, fmt->i_group);
+    WriteU32(ms, fmt->i_priority);
+    WriteU32(ms, fmt->i_bitrate);
+    WriteU32(ms, fmt->i_profile);
+    WriteU32(ms, fmt->i_level);
+    WriteString(ms, fmt->psz_language);
+    WriteString(ms, fmt->psz_description);
+
+    switch (fmt->i_cat)
+    {
+        case VIDEO_ES:
+            WriteU32(ms, fmt->video.i_chroma);
+            WriteU32(ms, fmt->video.i_width);
+            WriteU32(ms, fmt->video.i_height);
+            WriteU32(ms, fmt->video.i_x_offset);
+            WriteU32(ms, fmt->video.i_y_offset);
+            WriteU32(ms, fmt->video.i_visible_width);
+            WriteU32(ms, fmt->video.i_visible_height);
+            WriteU32(ms, fmt->video.i_sar_num);
+            WriteU32(ms, fmt->video.i_sar_den);
+            WriteU32(ms, fmt->video.i_frame_rate);
+            WriteU32(ms, fmt->video.i_frame_rate_base);
+            WriteU32(ms, fmt->video.orientation);
+            WriteU32(ms, fmt->video.projection_mode);
+            break;
+        case AUDIO_ES:
+            WriteU32(ms, fmt->audio.i_format);
+            WriteU32(ms, fmt->audio.i_rate);
+            WriteU32(ms, fmt->audio.i_physical_channels);
+            WriteU32(ms, fmt->audio.i_channels);
+            WriteU32(ms, fmt->audio.i_bitspersample);
+            break;
+        case SPU_ES:
+            WriteString(ms, fmt->subs.psz_encoding);
+            break;
+        default:
+            break;
+    }
+}
+
+void preparse_cache_Save(vlc_object_t *obj,
+                         const struct preparse_cache_key *key,
+                         input_item_t *item, unsigned attachments)
+{
+    struct vlc_memstream ms;
+    if (vlc_memstream_open(&ms))
+        return;
+
+    vlc_mutex_lock(&item->lock);
+
+    char **extras = vlc_meta_CopyExtraNames(item->p_meta);
+    uint32_t meta_count = 0, extra_count = 0;
+
+    for (int i = 0; i < VLC_META_TYPE_COUNT; i++)
+        if (vlc_meta_Get(item->p_meta, i) != NULL)
+            meta_count++;
+    if (extras != NULL)
+        while (extras[extra_count] != NULL)
+            extra_count++;
+
+    vlc_memstream_write(&ms, PREPARSE_CACHE_MAGIC, 8);
+    WriteU64(&ms, key->size);
+    WriteU64(&ms, key->mtime);
+    WriteU64(&ms, item->i_duration);
+    WriteU32(&ms, attachments);
+    WriteU32(&ms, meta_count);
+    WriteU32(&ms, extra_count);
+    WriteU32(&ms, item->es_vec.size);
+
+    for (int i = 0; i < VLC_META_TYPE_COUNT; i++)
+    {
+        const char *value = vlc_meta_Get(item->p_meta, i);
+        if (value == NULL)
+            continue;
+        WriteU32(&ms, i);
+        WriteString(&ms, value);
+    }
+    for (uint32_t i = 0; i < extra_count; i++)
+    {
+        WriteString(&ms, extras[i]);
+        WriteString(&ms, vlc_meta_GetExtra(item->p_meta, extras[i]));
+        free(extras[i]);
+    }
+    free(extras);
+
+    for (size_t i = 0; i < item->es_vec.size; i++)
+        WriteTrack(&ms, &item->es_vec.data[i]);
+
+    vlc_mutex_unlock(&item->lock);
+
+    if (vlc_memstream_close(&ms))
+        return;
+    if (ms.length > PREPARSE_CACHE_MAX_SIZE)
+    {
+        free(ms.ptr);
+        return;
+    }
+
+    /* Each writer has its own temporary file, other instances or tasks may
+     * be saving the same entry */
+    char *tmp;
+    if (asprintf(&tmp, "%s.XXXXXX", key->path) == -1)
+    {
+        free(ms.ptr);
+        return;
+    }
+
+    int fd = vlc_mkstemp(tmp);
+    FILE *file = fd != -1 ? fdopen(fd, "wb") : NULL;
+    if (file == NULL)
+    {
+        msg_Warn(obj, "cannot write preparse cache %s: %s", tmp,
+                 vlc_strerror_c(errno));
+        if (fd != -1)
+        {
+            vlc_close(fd);
+            vlc_unlink(tmp);
+        }
+        free(ms.ptr);
+        free(tmp);
+        return;
+    }
+
+    bool ok = fwrite(ms.ptr, ms.length, 1, file) == 1;
+    if (fclose(file))
+        ok = false;
+    free(ms.ptr);
+
+    /* Replace atomically, other instances may be reading it */
+    if (!ok || vlc_rename(tmp, key->path) != 0)
+        vlc_unlink(tmp);
+    free(tmp);
+}
+
+/*** Reading ***/
+
+struct reader
+{
+    const uint8_t *p;
+    size_t left;
+    bool error;
+};
+
+static const uint8_t *Read(struct reader *r, size_t size)
+{
+    if (r->error || r->left < size)
+    {
+        r->error = true;
+        return NULL;
+    }
+
+    const uint8_t *p = r->p;
+    r->p += size;
+    r->left -= size;
+    return p;
+}
+
+static uint32_t ReadU32(struct reader *r)
+{
+    const uint8_t *p = Read(r, 4);
+    return p != NULL ? GetDWLE(p) : 0;
+}
+
+static uint64_t ReadU64(struct reader *r)
+{
+    const uint8_t *p = Read(r, 8);
+    return p != NULL ? GetQWLE(p) : 0;
+}
+
+static char *ReadString(struct reader *r)
+{
+    uint32_t len = ReadU32(r);
+    if (len == PREPARSE_CACHE_NULL)
+        return NULL;
+
+    const uint8_t *p = Read(r, len);
+    if (p == NULL)
+        return NULL;
+
+    char *str = strndup((const char *)p, len);
+    if (unlikely(str == NULL))
+        r->error = true;
+    return str;
+}
+
+static void ReadTrack(struct reader *r, input_item_t *item)
+{
+    char *id = ReadString(r);
+    bool id_stable = ReadU32(r) != 0;
+    enum es_format_category_e cat = ReadU32(r);
+
+    if (cat != VIDEO_ES && cat != AUDIO_ES && cat != SPU_ES
+     && cat != DATA_ES && cat != UNKNOWN_ES)
+        r->error = true;
+
+    es_format_t fmt;
+    es_format_Init(&fmt, r->error ? UNKNOWN_ES : cat, ReadU32(r));
+    fmt.i_original_fourcc = ReadU32(r);
+    fmt.i_id = ReadU32(r);
+    fmt.i_group = ReadU32(r);
+    fmt.i_priority = ReadU32(r);
+    fmt.i_bitrate = ReadU32(r);
+    fmt.i_profile = ReadU32(r);
+    fmt.i_level = ReadU32(r);
+    fmt.psz_language = ReadString(r);
+    fmt.psz_description = ReadString(r);
+
+    switch (fmt.i_cat)
+    {
+        case VIDEO_ES:
+            fmt.video.i_chroma = ReadU32(r);
+            fmt.video.i_width = ReadU32(r);
+            fmt.video.i_height = ReadU32(r);
+            fmt.video.i_x_offset = ReadU32(r);
+            fmt.video.i_y_offset = ReadU32(r);
+            fmt.video.i_visible_width = ReadU32(r);
+            fmt.video.i_visible_height = ReadU32(r);
+            fmt.video.i_sar_num = ReadU32(r);
+            fmt.video.i_sar_den = ReadU32(r);
+            fmt.video.i_frame_rate = ReadU32(r);
+            fmt.video.i_frame_rate_base = ReadU32(r);
+            fmt.video.orientation = ReadU32(r);
+            fmt.video.projection_mode = ReadU32(r);
+            if (fmt.video.orientation > ORIENT_MAX)
+                r->error = true;
+            break;
+        case AUDIO_ES:
+            fmt.audio.i_format = ReadU32(r);
+            fmt.audio.i_rate = ReadU32(r);
+            fmt.audio.i_physical_channels = ReadU32(r);
+            fmt.audio.i_channels = ReadU32(r);
+            fmt.audio.i_bitspersample = ReadU32(r);
+            break;
+        case SPU_ES:
+            fmt.subs.psz_encoding = ReadString(r);
+            break;
+        default:
+            break;
+    }
+
+    if (!r->error && id != NULL)
+        input_item_UpdateTracksInfo(item, &fmt, id, id_stable);
+    else
+        r->error = true;
+
+    es_format_Clean(&fmt);
+    free(id);
+}
+
+static uint8_t *LoadFile(const char *path, size_t *size)
+{
+    FILE *file = vlc_fopen(path, "rb");
+    if (file == NULL)
+        return NULL;
+
+    uint8_t *buf = NULL;
+    struct stat st;
+    if (fstat(fileno(file), &st) == 0 && st.st_size >= PREPARSE_CACHE_HEADER_SIZE
+     && st.st_size <= PREPARSE_CACHE_MAX_SIZE)
+    {
+        buf = malloc(st.st_size);
+        if (buf != NULL && fread(buf, st.st_size, 1, file) != 1)
+        {
+            free(buf);
+            buf = NULL;
+        }
+        *size = st.st_size;
+    }
+    fclose(file);
+    return buf;
+}
+
+input_item_t *preparse_cache_Load(vlc_object_t *obj,
+                                  const struct preparse_cache_key *key,
+                                  unsigned *attachments)
+{
+    size_t size;
+    uint8_t *buf = LoadFile(key->path, &size);
+    if (buf == NULL)
+        return NULL;
+
+    struct reader r = { buf, size, false };
+    input_item_t *item = NULL;
+
+    const uint8_t *magic = Read(&r, 8);
+    if (magic == NULL || memcmp(magic, PREPARSE_CACHE_MAGIC, 8)
+     || ReadU64(&r) != key->size || ReadU64(&r) != key->mtime)
+    {
+        msg_Dbg(obj, "discarding stale preparse cache %s", key->path);
+        goto out;
+    }
+
+    item = input_item_NewExt(INPUT_ITEM_URI_NOP, NULL, ReadU64(&r),
+                             ITEM_TYPE_FILE, ITEM_LOCAL);
+    if (unlikely(item == NULL))
+        goto out;
+
+    *attachments = ReadU32(&r);
+    uint32_t meta_count = ReadU32(&r);
+    uint32_t extra_count = ReadU32(&r);
+    uint32_t track_count = ReadU32(&r);
+
+    for (uint32_t i = 0; i < meta_count && !r.error; i++)
+    {
+        uint32_t type = ReadU32(&r);
+        char *value = ReadString(&r);
+
+        if (type < VLC_META_TYPE_COUNT && value != NULL)
+            vlc_meta_Set(item->p_meta, type, value);
+        else
+            r.error = true;
+        free(value);
+    }
+    for (uint32_t i = 0; i < extra_count && !r.error; i++)
+    {
+        char *name = ReadString(&r);
+        char *value = ReadString(&r);
+
+        if (name != NULL)
+            vlc_meta_SetExtra(item->p_meta, name, value);
+        else
+            r.error = true;
+        free(name);
+        free(value);
+    }
+    for (uint32_t i = 0; i < track_count && !r.error; i++)
+        ReadTrack(&r, item);
+
+    if (r.error || r.left > 0)
+    {
+        msg_Warn(obj, "discarding corrupted preparse cache %s", key->path);
+        input_item_Release(item);
+        item = NULL;
+    }
+out:
+    free(buf);
+    return item;
+}
+
+void preparse_cache_Apply(input_item_t *dst, input_item_t *src)
+{
+    vlc_mutex_lock(&src->lock);
+    vlc_tick_t duration = src->i_duration;
+    vlc_meta_t *meta = vlc_meta_New();
+    if (likely(meta != NULL))
+        vlc_meta_Merge(meta, src->p_meta);
+
+    es_format_t *fmts = vlc_alloc(src->es_vec.size, sizeof (*fmts));
+    char **ids = vlc_alloc(src->es_vec.size, sizeof (*ids));
+    bool *stables = vlc_alloc(src->es_vec.size, sizeof (*stables));
+    size_t count = 0;
+
+    if (likely(fmts != NULL && ids != NULL && stables != NULL))
+        for (size_t i = 0; i < src->es_vec.size; i++)
+        {
+            const struct input_item_es *item_es = &src->es_vec.data[i];
+
+            ids[count] = strdup(item_es->id);
+            if (unlikely(ids[count] == NULL))
+                continue;
+            es_format_Copy(&fmts[count], &item_es->es);
+            stables[count] = item_es->id_stable;
+            count++;
+        }
+    vlc_mutex_unlock(&src->lock);
+
+    /* Do not hold both items locks at once */
+    input_item_SetDuration(dst, duration);
+    if (likely(meta != NULL))
+    {
+        vlc_mutex_lock(&dst->lock);
+        vlc_meta_Merge(dst->p_meta, meta);
+        vlc_mutex_unlock(&dst->lock);
+        vlc_meta_Delete(meta);
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        input_item_UpdateTracksInfo(dst, &fmts[i], ids[i], stables[i]);
+        es_format_Clean(&fmts[i]);
+        free(ids[i]);
+    }
+    free(stables);
+    free(ids);
+    free(fmts);
+}
@@ -0,0 +1,89 @@
+/*****************************************************************************
+ * cache.h: persistent preparse results
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef _PREPARSER_CACHE_H
+#define _PREPARSER_CACHE_H 1
+
+#include <vlc_input_item.h>
+
+/**
+ * Identifies one version of a local file in the preparse cache.
+ *
+ * The cache file is named after the item URI and input options, and only
+ * answers for the size and modification time it was written for.
+ */
+struct preparse_cache_key
+{
+    char *path; /**< cache file path */
+    uint64_t size;
+    uint64_t mtime;
+};
+
+/**
+ * Opens the preparse cache directory.
+ *
+ * The directory is created if needed, and its oldest entries are removed
+ * when it grows too large.
+ *
+ * @return the cache directory path (to be freed), or NULL on error
+ */
+char *preparse_cache_Open(vlc_object_t *obj);
+
+/**
+ * Gets the cache key of an item URI.
+ *
+ * @param dir cache directory, as returned by preparse_cache_Open()
+ * @param options serialized input options of the item, or NULL if they
+ * could not be serialized (nothing is cached then)
+ * @return VLC_SUCCESS, or an error if the URI is not a regular local file
+ */
+int preparse_cache_GetKey(const char *dir, const char *uri,
+                          const char *options,
+                          struct preparse_cache_key *key);
+
+void preparse_cache_CleanKey(struct preparse_cache_key *key);
+
+/**
+ * Loads a preparse result from the cache.
+ *
+ * The returned item only holds the duration, the meta data and the tracks
+ * found by the preparser. It must be released with input_item_Release().
+ *
+ * @param attachments set to the number of attachments of the item, which
+ * are not stored in the cache
+ * @return the cached result, or NULL if there is none matching the key
+ */
+input_item_t *preparse_cache_Load(vlc_object_t *obj,
+                                  const struct preparse_cache_key *key,
+                                  unsigned *attachments);
+
+/**
+ * Stores the preparse result of an item in the cache.
+ */
+void preparse_cache_Save(vlc_object_t *obj,
+                         const struct preparse_cache_key *key,
+                         input_item_t *item, unsigned attachments);
+
+/**
+ * Copies a preparse result (duration, meta data and tracks) to an item.
+ */
+void preparse_cache_Apply(input_item_t *dst, input_item_t *src);
+
+#endif
@@ -25,18 +25,23 @@
 #include <vlc_common.h>
 #include <vlc_atomic.h>
 #include <vlc_executor.h>
+#include <vlc_memstream.h>
 #include <vlc_preparser.h>
 
 #include "input/input_interface.h"
 #include "input/input_internal.h"
+#include "cache.h"
 #include "fetcher.h"
 
 struct vlc_preparser_t
 {
     vlc_object_t* owner;
     input_fetcher_t* fetcher;
-    vlc_executor_t *executor;
+    vlc_executor_t *executor_local; /**< local files and devices */
+    vlc_executor_t *executor_share; /**< network shares (SMB, NFS, ...) */
+    vlc_executor_t *executor_remote; /**< HTTP servers */
     vlc_tick_t default_timeout;
+    char *cache_dir; /**< NULL if the preparse cache is disabled */
     atomic_bool deactivated;
 
     vlc_mutex_t lock;
@@ -46,7 +51,11 @@ struct vlc_preparser_t
 struct task
 {
     vlc_preparser_t *preparser;
+    vlc_executor_t *executor;
     input_item_t *item;
+    char *uri;
+    char *item_options; /**< input options of the item, NULL on error */
+    bool cacheable;
     input_item_meta_request_option_t options;
     const struct vlc_metadata_cbs *cbs;
     void *userdata;
@@ -54,20 +63,49 @@ struct task
     vlc_tick_t timeout;
 
     input_item_parser_id_t *parser;
+    struct preparse_cache_key key;
+    unsigned attachments;
+    bool subtree;
 
     vlc_sem_t preparse_ended;
     atomic_int preparse_status;
     atomic_bool interrupted;
+    bool canceled; /**< protected by vlc_preparser_t.lock */
 
     struct vlc_runnable runnable; /**< to be passed to the executor */
 
-    struct vlc_list node; /**< node of vlc_preparser_t.submitted_tasks */
+    /** node of vlc_preparser_t.submitted_tasks, or of the leader followers */
+    struct vlc_list node;
+    /** identical requests waiting for the result of this one */
+    struct vlc_list followers;
 };
 
 static void RunnableRun(void *);
 
+/* Serializes the input options of an item, requests for items with different
+ * options can't share their result */
+static char *
+ItemOptions(input_item_t *item)
+{
+    struct vlc_memstream ms;
+    if (vlc_memstream_open(&ms))
+        return NULL;
+
+    /* Length prefixed, so that the result can be compared as a string */
+    vlc_mutex_lock(&item->lock);
+    for (int i = 0; i < item->i_options; i++)
+        vlc_memstream_printf(&ms, "%zu:%02x%s", strlen(item->ppsz_options[i]),
+                             item->optflagv[i], item->ppsz_options[i]);
+    vlc_mutex_unlock(&item->lock);
+
+    if (vlc_memstream_close(&ms))
+        return NULL;
+    return ms.ptr;
+}
+
 static struct task *
-TaskNew(vlc_preparser_t *preparser, input_item_t *item,
+TaskNew(vlc_preparser_t *preparser, vlc_executor_t *executor,
+        input_item_t *item, char *uri, bool cacheable,
         input_item_meta_request_option_t options,
         const struct vlc_metadata_cbs *cbs, void *userdata,
         void *id, vlc_tick_t timeout)
@@ -76,10 +114,17 @@ TaskNew(vlc_preparser_t *preparser, input_item_t *item,
 
     struct task *task = malloc(sizeof(*task));
     if (!task)
+    {
+        free(uri);
         return NULL;
+    }
 
     task->preparser = preparser;
+    task->executor = executor;
     task->item = item;
+    task->uri = uri;
+    task->item_options = ItemOptions(item);
+    task->cacheable = cacheable;
     task->options = options;
     task->cbs = cbs;
     task->userdata = userdata;
@@ -89,39 +134,33 @@ TaskNew(vlc_preparser_t *preparser, input_item_t *item,
     input_item_Hold(item);
 
     task->parser = NULL;
+    task->key.path = NULL;
+    task->attachments = 0;
+    task->subtree = false;
     vlc_sem_init(&task->preparse_ended, 0);
     atomic_init(&task->preparse_status, ITEM_PREPARSE_SKIPPED);
     atomic_init(&task->interrupted, false);
+    task->canceled = false;
 
     task->runnable.run = RunnableRun;
     task->runnable.userdata = task;
 
+    vlc_list_init(&task->followers);
+
     return task;
 }
 
 static void
 TaskDelete(struct task *task)
 {
+    assert(vlc_list_is_empty(&task->followers));
+    preparse_cache_CleanKey(&task->key);
     input_item_Release(task->item);
+    free(task->uri);
+    free(task->item_options);
     free(task);
 }
 
-static void
-PreparserAddTask(vlc_preparser_t *preparser, struct task *task)
-{
-    vlc_mutex_lock(&preparser->lock);
-    vlc_list_append(&task->node, &preparser->submitted_tasks);
-    vlc_mutex_unlock(&preparser->lock);
-}
-
-static void
-PreparserRemoveTask(vlc_preparser_t *preparser, struct task *task)
-{
-    vlc_mutex_lock(&preparser->lock);
-    vlc_list_remove(&task->node);
-    vlc_mutex_unlock(&preparser->lock);
-}
-
 static void
 NotifyPreparseEnded(struct task *task, bool art_fetched)
 {
@@ -140,6 +179,99 @@ NotifyPreparseEnded(struct task *task, bool art_fetched)
     }
 }
 
+static bool
+TaskParses(const struct task *task)
+{
+    return task->options & (META_REQUEST_OPTION_SCOPE_ANY|
+                            META_REQUEST_OPTION_SCOPE_FORCED);
+}
+
+/* Must be called with the preparser lock held */
+static struct task *
+PreparserFindLeader(vlc_preparser_t *preparser, const struct task *task)
+{
+    if (!TaskParses(task))
+        return NULL;
+
+    struct task *leader;
+    vlc_list_foreach(leader, &preparser->submitted_tasks, node)
+        if (!leader->canceled && TaskParses(leader)
+         && leader->executor == task->executor
+         && strcmp(leader->uri, task->uri) == 0
+         && (leader->item == task->item
+          || (leader->item_options != NULL && task->item_options != NULL
+           && strcmp(leader->item_options, task->item_options) == 0)))
+            return leader;
+    return NULL;
+}
+
+static void
+PreparserAddTask(vlc_preparser_t *preparser, struct task *task)
+{
+    vlc_mutex_lock(&preparser->lock);
+
+    /* Parse the same URI and options only once, identical requests share
+     * the result */
+    struct task *leader = PreparserFindLeader(preparser, task);
+    if (leader)
+        vlc_list_append(&task->node, &leader->followers);
+    else
+    {
+        vlc_list_append(&task->node, &preparser->submitted_tasks);
+        vlc_executor_Submit(task->executor, &task->runnable);
+    }
+
+    vlc_mutex_unlock(&preparser->lock);
+}
+
+/* Must be called with the preparser lock held */
+static void
+PreparserResubmitLocked(vlc_preparser_t *preparser, struct task *task)
+{
+    if (atomic_load(&preparser->deactivated))
+    {
+        /* The executors are being deleted */
+        NotifyPreparseEnded(task, false);
+        TaskDelete(task);
+        return;
+    }
+
+    vlc_list_append(&task->node, &preparser->submitted_tasks);
+    vlc_executor_Submit(task->executor, &task->runnable);
+}
+
+/* Submits the followers of a task as requests on their own */
+static void
+SubmitFollowersLocked(vlc_preparser_t *preparser, struct vlc_list *followers)
+{
+    struct task *follower;
+    vlc_list_foreach(follower, followers, node)
+    {
+        vlc_list_remove(&follower->node);
+        PreparserResubmitLocked(preparser, follower);
+    }
+}
+
+static void
+PreparserRemoveTask(vlc_preparser_t *preparser, struct task *task,
+                    struct vlc_list *followers)
+{
+    vlc_mutex_lock(&preparser->lock);
+    vlc_list_remove(&task->node);
+
+    if (task->canceled)
+        /* There is no result to share, parse the followers themselves */
+        SubmitFollowersLocked(preparser, &task->followers);
+
+    struct task *follower;
+    vlc_list_foreach(follower, &task->followers, node)
+    {
+        vlc_list_remove(&follower->node);
+        vlc_list_append(&follower->node, followers);
+    }
+    vlc_mutex_unlock(&preparser->lock);
+}
+
 static void
 OnParserEnded(input_item_t *item, int status, void *task_)
 {
@@ -167,6 +299,8 @@ OnParserSubtreeAdded(input_item_t *item, input_item_node_t *subtree,
     VLC_UNUSED(item);
     struct task *task = task_;
 
+    task->subtree = true;
+
     if (task->cbs && task->cbs->on_subtree_added)
         task->cbs->on_subtree_added(task->item, subtree, task->userdata);
 }
@@ -179,6 +313,7 @@ OnParserAttachmentsAdded(input_item_t *item,
     VLC_UNUSED(item);
     struct task *task = task_;
 
+    task->attachments += count;
     if (task->cbs && task->cbs->on_attachments_added)
         task->cbs->on_attachments_added(task->item, array, count, task->userdata);
 }
@@ -256,45 +391,128 @@ Fetch(struct task *task)
                               &input_fetcher_callbacks, task);
 }
 
+static bool
+CacheLoad(struct task *task)
+{
+    if (!task->cacheable
+     || preparse_cache_GetKey(task->preparser->cache_dir, task->uri,
+                              task->item_options, &task->key) != VLC_SUCCESS)
+        return false;
+
+    unsigned attachments = 0;
+    input_item_t *cached = preparse_cache_Load(task->preparser->owner,
+                                               &task->key, &attachments);
+    if (!cached)
+        return false;
+
+    /* Attachments are not cached, parse again if they are requested */
+    bool hit = attachments == 0 || !task->cbs
+            || !task->cbs->on_attachments_added;
+    if (hit)
+    {
+        preparse_cache_Apply(task->item, cached);
+        task->attachments = attachments;
+        atomic_store_explicit(&task->preparse_status, ITEM_PREPARSE_DONE,
+                              memory_order_relaxed);
+    }
+    input_item_Release(cached);
+    return hit;
+}
+
 static void
-RunnableRun(void *userdata)
+CacheSave(struct task *task)
 {
-    vlc_thread_set_name("vlc-run-prepars");
+    int status = atomic_load_explicit(&task->preparse_status,
+                                      memory_order_relaxed);
 
-    struct task *task = userdata;
-    vlc_preparser_t *preparser = task->preparser;
+    /* Sub items are only reported to the callbacks, they can't be cached */
+    if (task->key.path == NULL || task->subtree
+     || status != ITEM_PREPARSE_DONE)
+        return;
 
-    vlc_tick_t deadline = task->timeout ? vlc_tick_now() + task->timeout
-                                        : VLC_TICK_INVALID;
+    preparse_cache_Save(task->preparser->owner, &task->key, task->item,
+                        task->attachments);
+}
+
+static void
+TaskEnd(struct task *task)
+{
+    if (!atomic_load(&task->interrupted))
+    {
+        int ret = Fetch(task);
+
+        if (ret == VLC_SUCCESS)
+            return; /* Remove the task and notify from the fetcher callback */
+
+        if (!atomic_load(&task->interrupted))
+            SetItemPreparsed(task);
+    }
+
+    NotifyPreparseEnded(task, false);
+    TaskDelete(task);
+}
 
-    if (task->options & (META_REQUEST_OPTION_SCOPE_ANY|
-                         META_REQUEST_OPTION_SCOPE_FORCED))
+static void
+EndFollowers(struct task *leader, struct vlc_list *followers)
+{
+    vlc_preparser_t *preparser = leader->preparser;
+    int status = atomic_load_explicit(&leader->preparse_status,
+                                      memory_order_relaxed);
+
+    struct task *follower;
+    vlc_list_foreach(follower, followers, node)
     {
-        if (atomic_load(&task->interrupted))
+        vlc_list_remove(&follower->node);
+
+        const struct vlc_metadata_cbs *cbs = follower->cbs;
+        bool parse = status == ITEM_PREPARSE_DONE && cbs
+            && ((leader->subtree && cbs->on_subtree_added)
+             || (leader->attachments > 0 && cbs->on_attachments_added));
+        if (parse)
         {
-            PreparserRemoveTask(preparser, task);
-            goto end;
+            /* Sub items and attachments were only reported to the leader */
+            vlc_mutex_lock(&preparser->lock);
+            PreparserResubmitLocked(preparser, follower);
+            vlc_mutex_unlock(&preparser->lock);
+            continue;
         }
 
-        Parse(task, deadline);
+        if (status == ITEM_PREPARSE_DONE && follower->item != leader->item)
+            preparse_cache_Apply(follower->item, leader->item);
+        else if (status == ITEM_PREPARSE_TIMEOUT)
+            atomic_store(&follower->interrupted, true);
+
+        atomic_store_explicit(&follower->preparse_status, status,
+                              memory_order_relaxed);
+        TaskEnd(follower);
     }
+}
 
-    PreparserRemoveTask(preparser, task);
+static void
+RunnableRun(void *userdata)
+{
+    vlc_thread_set_name("vlc-run-prepars");
 
-    if (atomic_load(&task->interrupted))
-        goto end;
+    struct task *task = userdata;
+    vlc_preparser_t *preparser = task->preparser;
 
-    int ret = Fetch(task);
+    vlc_tick_t deadline = task->timeout ? vlc_tick_now() + task->timeout
+                                        : VLC_TICK_INVALID;
 
-    if (ret == VLC_SUCCESS)
-        return; /* Remove the task and notify from the fetcher callback */
+    if (TaskParses(task) && !atomic_load(&task->interrupted)
+     && !CacheLoad(task))
+    {
+        Parse(task, deadline);
+        CacheSave(task);
+    }
 
-    if (!atomic_load(&task->interrupted))
-        SetItemPreparsed(task);
+    struct vlc_list followers;
+    vlc_list_init(&followers);
+    PreparserRemoveTask(preparser, task, &followers);
 
-end:
-    NotifyPreparseEnded(task, false);
-    TaskDelete(task);
+    /* Complete the identical requests before the leader item is released */
+    EndFollowers(task, &followers);
+    TaskEnd(task);
 }
 
 static void
@@ -308,28 +526,43 @@ Interrupt(struct task *task)
     vlc_sem_post(&task->preparse_ended);
 }
 
+static vlc_executor_t *
+ExecutorNew(vlc_object_t *parent, const char *var)
+{
+    int max_threads = var_InheritInteger(parent, var);
+    if (max_threads < 1)
+        max_threads = 1;
+
+    return vlc_executor_New(max_threads);
+}
+
 vlc_preparser_t* vlc_preparser_New( vlc_object_t *parent )
 {
     vlc_preparser_t* preparser = malloc( sizeof *preparser );
     if (!preparser)
         return NULL;
 
-    int max_threads = var_InheritInteger(parent, "preparse-threads");
-    if (max_threads < 1)
-        max_threads = 1;
+    /* Slow network shares and servers must not delay local files */
+    preparser->executor_local = ExecutorNew(parent, "preparse-threads");
+    if (!preparser->executor_local)
+        goto error;
 
-    preparser->executor = vlc_executor_New(max_threads);
-    if (!preparser->executor)
-    {
-        free(preparser);
-        return NULL;
-    }
+    preparser->executor_share = ExecutorNew(parent, "preparse-share-threads");
+    if (!preparser->executor_share)
+        goto error_share;
+
+    preparser->executor_remote =
+        ExecutorNew(parent, "preparse-remote-threads");
+    if (!preparser->executor_remote)
+        goto error_remote;
 
     preparser->default_timeout =
         VLC_TICK_FROM_MS(var_InheritInteger(parent, "preparse-timeout"));
     if (preparser->default_timeout < 0)
         preparser->default_timeout = 0;
 
+    preparser->cache_dir = var_InheritBool(parent, "preparse-cache")
+                         ? preparse_cache_Open(parent) : NULL;
     preparser->owner = parent;
     preparser->fetcher = input_fetcher_New( parent );
     atomic_init( &preparser->deactivated, false );
@@ -341,6 +574,24 @@ vlc_preparser_t* vlc_preparser_New( vlc_object_t *parent )
         msg_Warn( parent, "unable to create art fetcher" );
 
     return preparser;
+
+error_remote:
+    vlc_executor_Delete(preparser->executor_share);
+error_share:
+    vlc_executor_Delete(preparser->executor_local);
+error:
+    free(preparser);
+    return NULL;
+}
+
+static vlc_executor_t *
+PreparserGetExecutor(vlc_preparser_t *preparser, const char *uri, bool net)
+{
+    if (!net)
+        return preparser->executor_local;
+    if (!strncasecmp(uri, "http:", 5) || !strncasecmp(uri, "https:", 6))
+        return preparser->executor_remote;
+    return preparser->executor_share;
 }
 
 int vlc_preparser_Push( vlc_preparser_t *preparser,
@@ -354,10 +605,14 @@ int vlc_preparser_Push( vlc_preparser_t *preparser,
     vlc_mutex_lock( &item->lock );
     enum input_item_type_e i_type = item->i_type;
     int b_net = item->b_net;
+    char *uri = strdup( item->psz_uri );
     if( i_options & META_REQUEST_OPTION_DO_INTERACT )
         item->b_preparse_interact = true;
     vlc_mutex_unlock( &item->lock );
 
+    if( !uri )
+        return VLC_ENOMEM;
+
     if (!(i_options & META_REQUEST_OPTION_SCOPE_FORCED))
     {
         switch( i_type )
@@ -376,6 +631,7 @@ int vlc_preparser_Push( vlc_preparser_t *preparser,
                     if (cbs && cbs->on_preparse_ended)
                         cbs->on_preparse_ended(item, ITEM_PREPARSE_SKIPPED,
                                                cbs_userdata);
+                    free( uri );
                     return VLC_SUCCESS;
                 }
                 /* Continue without parsing (but fetching) */
@@ -385,14 +641,16 @@ int vlc_preparser_Push( vlc_preparser_t *preparser,
 
     vlc_tick_t timeout = timeout_ms == -1 ? preparser->default_timeout
                                           : VLC_TICK_FROM_MS(timeout_ms);
+    vlc_executor_t *executor = PreparserGetExecutor(preparser, uri, b_net);
+    bool cacheable = preparser->cache_dir != NULL && i_type == ITEM_TYPE_FILE
+                  && !b_net;
     struct task *task =
-        TaskNew(preparser, item, i_options, cbs, cbs_userdata, id, timeout);
+        TaskNew(preparser, executor, item, uri, cacheable, i_options, cbs,
+                cbs_userdata, id, timeout);
     if( !task )
         return VLC_ENOMEM;
 
     PreparserAddTask(preparser, task);
-
-    vlc_executor_Submit(preparser->executor, &task->runnable);
     return VLC_SUCCESS;
 }
 
@@ -403,12 +661,23 @@ void vlc_preparser_Cancel( vlc_preparser_t *preparser, void *id )
     struct task *task;
     vlc_list_foreach(task, &preparser->submitted_tasks, node)
     {
+        struct task *follower;
+        vlc_list_foreach(follower, &task->followers, node)
+            if (!id || follower->id == id)
+            {
+                NotifyPreparseEnded(follower, false);
+                vlc_list_remove(&follower->node);
+                TaskDelete(follower);
+            }
+
         if (!id || task->id == id)
         {
+            task->canceled = true;
             bool canceled =
-                vlc_executor_Cancel(preparser->executor, &task->runnable);
+                vlc_executor_Cancel(task->executor, &task->runnable);
             if (canceled)
             {
+                SubmitFollowersLocked(preparser, &task->followers);
                 NotifyPreparseEnded(task, false);
                 vlc_list_remove(&task->node);
                 TaskDelete(task);
@@ -431,12 +700,16 @@ void vlc_preparser_Deactivate( vlc_preparser_t* preparser )
 void vlc_preparser_Delete( vlc_preparser_t *preparser )
 {
     /* In case vlc_preparser_Deactivate() has not been called */
+    atomic_store( &preparser->deactivated, true );
     vlc_preparser_Cancel(preparser, NULL);
 
-    vlc_executor_Delete(preparser->executor);
+    vlc_executor_Delete(preparser->executor_local);
+    vlc_executor_Delete(preparser->executor_share);
+    vlc_executor_Delete(preparser->executor_remote);
 
     if( preparser->fetcher )
         input_fetcher_Delete( preparser->fetcher );
 
+    free( preparser->cache_dir );
     free( preparser );
 }
@@ -22,15 +22,20 @@
 # include "config.h"
 #endif
 
+#include <stdatomic.h>
 #include <stdbool.h>
+#include <stdio.h>
 #undef NDEBUG
 #include <assert.h>
 
 #include <vlc_common.h>
 #include <vlc_es.h>
 #include <vlc_picture_pool.h>
+#include <vlc_threads.h>
 
 #define PICTURES 10
+#define THREADS 8
+#define ITERATIONS 20000
 
 const char vlc_module_name[] = "test_picture_pool";
 
@@ -87,6 +92,96 @@ static void test(bool zombie)
             picture_Release(pics[i]);
 }
 
+struct stress
+{
+    picture_pool_t *pool;
+    bool wait;
+    void *planes[PICTURES];
+    atomic_uint users[PICTURES];
+    atomic_uint failures;
+};
+
+static void *stress_thread(void *data)
+{
+    struct stress *st = data;
+
+    for (unsigned i = 0; i < ITERATIONS; i++) {
+        picture_t *pic = st->wait ? picture_pool_Wait(st->pool)
+                                  : picture_pool_Get(st->pool);
+        if (pic == NULL) {
+            assert(!st->wait);
+            atomic_fetch_add(&st->failures, 1);
+            continue;
+        }
+
+        unsigned index = PICTURES;
+        for (unsigned j = 0; j < PICTURES; j++)
+            if (st->planes[j] == pic->p[0].p_pixels)
+                index = j;
+        assert(index < PICTURES);
+
+        /* No two threads ever get the same picture at the same time */
+        assert(atomic_fetch_add(&st->users[index], 1) == 0);
+        pic->date = i;
+        picture_Hold(pic);
+        picture_Release(pic);
+        assert(pic->date == (vlc_tick_t)i);
+        assert(atomic_fetch_sub(&st->users[index], 1) == 1);
+
+        picture_Release(pic);
+    }
+    return NULL;
+}
+
+/* Many threads contending for fewer pictures than threads */
+static void test_stress(bool wait)
+{
+    struct stress st;
+    vlc_thread_t th[THREADS];
+    picture_t *pics[PICTURES];
+
+    st.pool = picture_pool_NewFromFormat(&fmt, PICTURES / 2);
+    assert(st.pool != NULL);
+    st.wait = wait;
+    atomic_init(&st.failures, 0);
+
+    for (unsigned i = 0; i < PICTURES; i++) {
+        atomic_init(&st.users[i], 0);
+        st.planes[i] = NULL;
+    }
+    for (unsigned i = 0; i < PICTURES / 2; i++) {
+        pics[i] = picture_pool_Get(st.pool);
+        assert(pics[i] != NULL);
+        st.planes[i] = pics[i]->p[0].p_pixels;
+    }
+    for (unsigned i = 0; i < PICTURES / 2; i++)
+        picture_Release(pics[i]);
+
+    vlc_tick_t start = vlc_tick_now();
+
+    for (unsigned i = 0; i < THREADS; i++)
+        assert(!vlc_clone(&th[i], stress_thread, &st));
+    for (unsigned i = 0; i < THREADS; i++)
+        vlc_join(th[i], NULL);
+
+    vlc_tick_t elapsed = vlc_tick_now() - start;
+    printf("%s: %u threads, %u pictures, %.0f pictures/s (%u misses)\n",
+           wait ? "wait" : "get", THREADS, PICTURES / 2,
+           THREADS * ITERATIONS * (double)CLOCK_FREQ / (elapsed ? elapsed : 1),
+           atomic_load(&st.failures));
+
+    /* All pictures came back to the pool */
+    for (unsigned i = 0; i < PICTURES / 2; i++) {
+        pics[i] = picture_pool_Get(st.pool);
+        assert(pics[i] != NULL);
+    }
+    assert(picture_pool_Get(st.pool) == NULL);
+    for (unsigned i = 0; i < PICTURES / 2; i++)
+        picture_Release(pics[i]);
+
+    picture_pool_Release(st.pool);
+}
+
 int main(void)
 {
     video_format_Setup(&fmt, VLC_CODEC_I420, 320, 200, 320, 200, 1, 1);
@@ -98,6 +193,8 @@ int main(void)
 
     test(false);
     test(true);
+    test_stress(false);
+    test_stress(true);
 
     return 0;
 }
@@ -0,0 +1,85 @@
+/*****************************************************************************
+ * seekindex.c: Test for the seek index
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#undef NDEBUG
+
+#include <assert.h>
+
+#include <vlc_common.h>
+#include <vlc_seekindex.h>
+
+const char vlc_module_name[] = "test_seekindex";
+
+#define SEC(s) (VLC_TICK_0 + VLC_TICK_FROM_SEC(s))
+
+static void test_lookup(const vlc_seekindex_t *index, vlc_tick_t time,
+                        vlc_tick_t before, vlc_tick_t after)
+{
+    struct vlc_seekindex_entry b, a;
+
+    int ret = vlc_seekindex_Lookup(index, time, &b, &a);
+    assert(ret == VLC_SUCCESS);
+    assert(b.time == before);
+    assert(a.time == after);
+    if (before != VLC_TICK_INVALID)
+        assert(b.offset == (uint64_t)before * 10);
+    if (after != VLC_TICK_INVALID)
+        assert(a.offset == (uint64_t)after * 10);
+}
+
+int main(void)
+{
+    vlc_seekindex_t *index = vlc_seekindex_New(VLC_TICK_FROM_SEC(1));
+    assert(index != NULL);
+
+    assert(vlc_seekindex_Lookup(index, 0, NULL, NULL) == VLC_EGENERIC);
+
+    /* Out of order insertion, as done while bisecting */
+    const vlc_tick_t times[] = { 50, 10, 30, 20, 40, 5 };
+    for (size_t i = 0; i < ARRAY_SIZE(times); i++)
+    {
+        vlc_tick_t time = SEC(times[i]);
+        assert(vlc_seekindex_Add(index, time, time * 10) == VLC_SUCCESS);
+    }
+    assert(vlc_seekindex_Count(index) == ARRAY_SIZE(times));
+
+    /* Too close to existing entries */
+    assert(vlc_seekindex_Add(index, SEC(10), SEC(10) * 10) == VLC_EGENERIC);
+    vlc_tick_t t = SEC(20) + VLC_TICK_FROM_MS(500);
+    assert(vlc_seekindex_Add(index, t, t * 10) == VLC_EGENERIC);
+    /* Offset not consistent with the neighbours */
+    assert(vlc_seekindex_Add(index, SEC(25), SEC(35) * 10) == VLC_EGENERIC);
+    assert(vlc_seekindex_Add(index, SEC(25), SEC(15) * 10) == VLC_EGENERIC);
+    assert(vlc_seekindex_Add(index, VLC_TICK_INVALID, 0) == VLC_EGENERIC);
+    assert(vlc_seekindex_Count(index) == ARRAY_SIZE(times));
+
+    test_lookup(index, SEC(5), SEC(5), SEC(10));
+    test_lookup(index, SEC(25), SEC(20), SEC(30));
+    test_lookup(index, SEC(30), SEC(30), SEC(40));
+    test_lookup(index, SEC(99), SEC(50), VLC_TICK_INVALID);
+    test_lookup(index, SEC(0), VLC_TICK_INVALID, SEC(5));
+
+    vlc_seekindex_Delete(index);
+    return 0;
+}
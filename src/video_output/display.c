@@ -419,6 +419,22 @@ picture_t *vout_ConvertForDisplay(vout_display_t *vd, picture_t *picture)
     return filter_chain_VideoFilter(osys->converter->filters, picture);
 }
 
+picture_pool_t *vout_display_GetPool(vout_display_t *vd,
+                                     const video_format_t *fmt, unsigned count)
+{
+    vout_display_priv_t *osys = container_of(vd, vout_display_priv_t, display);
+
+    if (vd->ops->get_pool == NULL || osys->converter != NULL)
+        return NULL;
+
+    /* The pictures must reach the display as they are decoded */
+    if (!video_format_IsSameChroma(fmt, vd->fmt)
+     || fmt->i_width != vd->fmt->i_width || fmt->i_height != vd->fmt->i_height)
+        return NULL;
+
+    return vd->ops->get_pool(vd, count);
+}
+
 picture_t *vout_display_Prepare(vout_display_t *vd, picture_t *picture,
                                 const vlc_render_subpicture *subpic, vlc_tick_t date)
 {
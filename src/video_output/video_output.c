@@ -2315,6 +2315,22 @@ error_display:
     return -1;
 }
 
+picture_pool_t *vout_GetDisplayPool(vout_thread_t *vout,
+                                    const video_format_t *fmt, unsigned count)
+{
+    vout_thread_sys_t *sys = VOUT_THREAD_TO_SYS(vout);
+    picture_pool_t *pool = NULL;
+
+    if (sys->dummy)
+        return NULL;
+
+    vlc_queuedmutex_lock(&sys->display_lock);
+    if (sys->display != NULL)
+        pool = vout_display_GetPool(sys->display, fmt, count);
+    vlc_queuedmutex_unlock(&sys->display_lock);
+    return pool;
+}
+
 vlc_decoder_device *vout_GetDevice(vout_thread_t *vout)
 {
     vlc_decoder_device *dec_device = NULL;
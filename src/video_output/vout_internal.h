@@ -25,6 +25,7 @@
 #define LIBVLC_VOUT_INTERNAL_H 1
 
 #include <vlc_vout_display.h>
+#include <vlc_picture_pool.h>
 #include <vlc_clock.h>
 
 typedef struct input_thread_t input_thread_t;
@@ -57,6 +58,19 @@ vout_thread_t *vout_CreateDummy(vlc_object_t *obj) VLC_USED;
  */
 vlc_decoder_device *vout_GetDevice(vout_thread_t *vout);
 
+/**
+ * Gets pictures to decode into from the display.
+ *
+ * The display provides them if it can show them without copying their content.
+ *
+ * \param vout the video output, started with the format of the pictures
+ * \param fmt format of the decoded pictures
+ * \param count number of pictures
+ * \return a picture pool or NULL if the display does not provide pictures
+ */
+picture_pool_t *vout_GetDisplayPool(vout_thread_t *vout,
+                                    const video_format_t *fmt, unsigned count);
+
 /**
  * Returns a suitable vout or release the given one.
  *
@@ -24,11 +24,14 @@
 #define LIBVLC_VOUT_WRAPPER_H 1
 
 #include <vlc_vout_display.h>
+#include <vlc_picture_pool.h>
 
 /* XXX DO NOT use it outside the vout module wrapper XXX */
 struct vout_crop;
 
 picture_t * vout_ConvertForDisplay(vout_display_t *, picture_t *);
+picture_pool_t *vout_display_GetPool(vout_display_t *, const video_format_t *,
+                                     unsigned count);
 void vout_FilterFlush(vout_display_t *);
 
 void vout_SetDisplayFitting(vout_display_t *, enum vlc_video_fitting);
@@ -30,6 +30,7 @@
 #include <vlc_threads.h>
 #include <vlc_fs.h>
 #include <vlc_input_item.h>
+#include <vlc_url.h>
 
 static void media_parse_ended(const libvlc_event_t *event, void *user_data)
 {
@@ -258,6 +259,144 @@ static void test_input_metadata_timeout(libvlc_instance_t *vlc, int timeout,
     vlc_close(p_pipe[1]);
 }
 
+static void input_item_preparse_shared( input_item_t *item,
+                                        enum input_item_preparse_status status,
+                                        void *user_data )
+{
+    VLC_UNUSED(item);
+    vlc_sem_t *p_sem = user_data;
+
+    assert( status == ITEM_PREPARSE_DONE );
+    vlc_sem_post(p_sem);
+}
+
+static size_t input_item_track_count(input_item_t *item)
+{
+    vlc_mutex_lock(&item->lock);
+    size_t count = item->es_vec.size;
+    vlc_mutex_unlock(&item->lock);
+    return count;
+}
+
+/* Returns the only entry of the preparse cache, or NULL if it is empty */
+static char *preparse_cache_entry(const char *cachedir)
+{
+    char *dir;
+    int ret = asprintf(&dir, "%s/vlc/preparse", cachedir);
+    assert(ret != -1);
+
+    vlc_DIR *handle = vlc_opendir(dir);
+    assert(handle != NULL);
+
+    char *path = NULL;
+    const char *name;
+    while ((name = vlc_readdir(handle)) != NULL)
+    {
+        if (name[0] == '.')
+            continue;
+        assert(path == NULL);
+        ret = asprintf(&path, "%s/%s", dir, name);
+        assert(ret != -1);
+    }
+    vlc_closedir(handle);
+    free(dir);
+    return path;
+}
+
+static void test_input_metadata_shared(void)
+{
+    test_log ("test_input_metadata_shared\n");
+
+    /* Use a private preparse cache, with a new instance that did not parse
+     * the sample yet */
+    char cachedir[] = "/tmp/vlc-test-preparse-XXXXXX";
+    assert(mkdtemp(cachedir) != NULL);
+
+    const char *env = getenv("XDG_CACHE_HOME");
+    char *old_env = env != NULL ? strdup(env) : NULL;
+    setenv("XDG_CACHE_HOME", cachedir, 1);
+
+    libvlc_instance_t *vlc = libvlc_new(test_defaults_nargs,
+                                        test_defaults_args);
+    assert(vlc != NULL);
+
+    char *uri = vlc_path2uri(SRCDIR"/samples/image.jpg", NULL);
+    assert(uri != NULL);
+
+    /* Identical requests in flight, for the same item and for another item
+     * with the same URI, then a request answered by the preparse cache */
+    input_item_t *items[4];
+    items[0] = input_item_NewFile(uri, "shared", 0, ITEM_LOCAL);
+    assert(items[0] != NULL);
+    items[1] = input_item_Hold(items[0]);
+    items[2] = input_item_NewFile(uri, "shared copy", 0, ITEM_LOCAL);
+    assert(items[2] != NULL);
+    items[3] = input_item_NewFile(uri, "cached", 0, ITEM_LOCAL);
+    assert(items[3] != NULL);
+    free(uri);
+
+    vlc_sem_t sem;
+    vlc_sem_init (&sem, 0);
+    const struct vlc_metadata_cbs cbs = {
+        .on_preparse_ended = input_item_preparse_shared,
+    };
+
+    for (size_t i = 0; i < ARRAY_SIZE(items) - 1; i++)
+    {
+        int i_ret = libvlc_MetadataRequest(vlc->p_libvlc_int, items[i],
+                                           META_REQUEST_OPTION_SCOPE_LOCAL,
+                                           &cbs, &sem, -1, vlc);
+        assert(i_ret == 0);
+    }
+    for (size_t i = 0; i < ARRAY_SIZE(items) - 1; i++)
+        vlc_sem_wait(&sem);
+
+    /* The result was saved once */
+    char *entry = preparse_cache_entry(cachedir);
+    assert(entry != NULL);
+    struct stat saved;
+    assert(vlc_stat(entry, &saved) == 0);
+
+    int i_ret = libvlc_MetadataRequest(vlc->p_libvlc_int, items[3],
+                                       META_REQUEST_OPTION_SCOPE_LOCAL,
+                                       &cbs, &sem, -1, vlc);
+    assert(i_ret == 0);
+    vlc_sem_wait(&sem);
+
+    /* Answered from the cache: a new parsing would have replaced the file */
+    struct stat loaded;
+    assert(vlc_stat(entry, &loaded) == 0);
+    assert(loaded.st_ino == saved.st_ino);
+
+    size_t count = input_item_track_count(items[0]);
+    assert(count > 0);
+    for (size_t i = 0; i < ARRAY_SIZE(items); i++)
+    {
+        assert(input_item_IsPreparsed(items[i]));
+        assert(input_item_track_count(items[i]) == count);
+        input_item_Release(items[i]);
+    }
+
+    libvlc_release(vlc);
+
+    if (old_env != NULL)
+        setenv("XDG_CACHE_HOME", old_env, 1);
+    else
+        unsetenv("XDG_CACHE_HOME");
+    free(old_env);
+
+    /* Clean the private cache */
+    char *dir = strrchr(entry, '/');
+    vlc_unlink(entry);
+    *dir = '\0';
+    rmdir(entry); /* preparse */
+    dir = strrchr(entry, '/');
+    *dir = '\0';
+    rmdir(entry); /* vlc */
+    rmdir(cachedir);
+    free(entry);
+}
+
 static struct
 {
     const char *file;
@@ -470,6 +609,7 @@ int main(int i_argc, char *ppsz_argv[])
 
     test_input_metadata_timeout (vlc, 100, 0);
     test_input_metadata_timeout (vlc, 0, 100);
+    test_input_metadata_shared ();
 
     libvlc_release (vlc);
 
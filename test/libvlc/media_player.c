@@ -659,6 +659,176 @@ static void test_media_player_multiple_instance(const char** argv, int argc)
     libvlc_media_player_release(player2);
 }
 
+#define VBUF_COUNT 32
+#define VBUF_WIDTH 640
+#define VBUF_HEIGHT 480
+#define VBUF_SIZE (VBUF_WIDTH * VBUF_HEIGHT * 3 / 2)
+
+struct vbuf_ctx
+{
+    vlc_mutex_t lock;
+    vlc_sem_t displayed;
+    void *buffers[VBUF_COUNT];
+    bool used[VBUF_COUNT];
+    void *fallback;
+    unsigned acquired;
+    unsigned released;
+    unsigned direct;
+    unsigned copied;
+    bool cleaned;
+};
+
+static void vbuf_planes(void *buffer, void **planes)
+{
+    uint8_t *p = buffer;
+    planes[0] = p;
+    planes[1] = p + VBUF_WIDTH * VBUF_HEIGHT;
+    planes[2] = p + VBUF_WIDTH * VBUF_HEIGHT * 5 / 4;
+}
+
+static unsigned vbuf_format(void **opaque, char *chroma,
+                            unsigned *width, unsigned *height,
+                            unsigned *pitches, unsigned *lines)
+{
+    (void) opaque;
+    /* The mock video track is I420 with the same dimensions */
+    assert(!strcmp(chroma, "I420"));
+    assert(width[0] == VBUF_WIDTH && height[0] == VBUF_HEIGHT);
+
+    pitches[0] = VBUF_WIDTH;
+    pitches[1] = pitches[2] = VBUF_WIDTH / 2;
+    lines[0] = VBUF_HEIGHT;
+    lines[1] = lines[2] = VBUF_HEIGHT / 2;
+    return VBUF_COUNT;
+}
+
+static void vbuf_cleanup(void *opaque)
+{
+    struct vbuf_ctx *ctx = opaque;
+
+    vlc_mutex_lock(&ctx->lock);
+    assert(ctx->acquired == ctx->released);
+    ctx->cleaned = true;
+    vlc_mutex_unlock(&ctx->lock);
+}
+
+static void *vbuf_acquire(void *opaque, void **planes)
+{
+    struct vbuf_ctx *ctx = opaque;
+    void *buffer = NULL;
+
+    vlc_mutex_lock(&ctx->lock);
+    for (size_t i = 0; i < VBUF_COUNT; i++)
+        if (!ctx->used[i])
+        {
+            ctx->used[i] = true;
+            ctx->acquired++;
+            buffer = ctx->buffers[i];
+            break;
+        }
+    vlc_mutex_unlock(&ctx->lock);
+
+    if (buffer != NULL)
+        vbuf_planes(buffer, planes);
+    return buffer;
+}
+
+static void vbuf_release(void *opaque, void *buffer)
+{
+    struct vbuf_ctx *ctx = opaque;
+
+    vlc_mutex_lock(&ctx->lock);
+    size_t i = 0;
+    while (i < VBUF_COUNT && ctx->buffers[i] != buffer)
+        i++;
+    assert(i < VBUF_COUNT && ctx->used[i]);
+    ctx->used[i] = false;
+    ctx->released++;
+    vlc_mutex_unlock(&ctx->lock);
+}
+
+static void *vbuf_lock(void *opaque, void **planes)
+{
+    struct vbuf_ctx *ctx = opaque;
+
+    vbuf_planes(ctx->fallback, planes);
+    return NULL;
+}
+
+static void vbuf_display(void *opaque, void *picture)
+{
+    struct vbuf_ctx *ctx = opaque;
+
+    vlc_mutex_lock(&ctx->lock);
+    if (picture == NULL)
+        ctx->copied++;
+    else
+    {
+        size_t i = 0;
+        while (i < VBUF_COUNT && ctx->buffers[i] != picture)
+            i++;
+        /* Only buffers held by LibVLC can be displayed */
+        assert(i < VBUF_COUNT && ctx->used[i]);
+        if (++ctx->direct == 3)
+            vlc_sem_post(&ctx->displayed);
+    }
+    vlc_mutex_unlock(&ctx->lock);
+}
+
+/* Pictures are decoded into the application buffers */
+static void test_media_player_buffer_callbacks(const char** argv, int argc)
+{
+    char file[sizeof("mock://video_track_count=1;audio_track_count=0;"
+                     "video_width=xxxx;video_height=xxxx")];
+    sprintf(file, "mock://video_track_count=1;audio_track_count=0;"
+            "video_width=%u;video_height=%u", VBUF_WIDTH, VBUF_HEIGHT);
+
+    test_log ("Testing video buffer callbacks\n");
+
+    struct vbuf_ctx ctx = { .acquired = 0 };
+    vlc_mutex_init(&ctx.lock);
+    vlc_sem_init(&ctx.displayed, 0);
+    for (size_t i = 0; i < VBUF_COUNT; i++)
+    {
+        ctx.buffers[i] = aligned_alloc(32, VBUF_SIZE);
+        assert(ctx.buffers[i] != NULL);
+    }
+    ctx.fallback = aligned_alloc(32, VBUF_SIZE);
+    assert(ctx.fallback != NULL);
+
+    libvlc_instance_t *vlc = libvlc_new(argc, argv);
+    assert(vlc != NULL);
+
+    libvlc_media_t *md = libvlc_media_new_location(file);
+    assert(md != NULL);
+
+    libvlc_media_player_t *mp = libvlc_media_player_new_from_media(vlc, md);
+    assert(mp != NULL);
+    libvlc_media_release(md);
+
+    libvlc_video_set_callbacks(mp, vbuf_lock, NULL, vbuf_display, &ctx);
+    libvlc_video_set_format_callbacks(mp, vbuf_format, vbuf_cleanup);
+    libvlc_video_set_buffer_callbacks(mp, vbuf_acquire, vbuf_release);
+
+    libvlc_media_player_play(mp);
+    vlc_sem_wait(&ctx.displayed);
+
+    libvlc_media_player_stop_async(mp);
+    libvlc_media_player_release(mp);
+    libvlc_release(vlc);
+
+    /* No picture was copied, and every buffer was given back */
+    assert(ctx.copied == 0);
+    assert(ctx.direct >= 3);
+    assert(ctx.acquired > 0 && ctx.acquired <= VBUF_COUNT);
+    assert(ctx.released == ctx.acquired);
+    assert(ctx.cleaned);
+
+    for (size_t i = 0; i < VBUF_COUNT; i++)
+        free(ctx.buffers[i]);
+    free(ctx.fallback);
+}
+
 int main (void)
 {
     test_init();
@@ -669,6 +839,7 @@ int main (void)
     test_media_player_tracks (test_defaults_args, test_defaults_nargs);
     test_media_player_programs (test_defaults_args, test_defaults_nargs);
     test_media_player_multiple_instance (test_defaults_args, test_defaults_nargs);
+    test_media_player_buffer_callbacks (test_defaults_args, test_defaults_nargs);
 
     return 0;
 }
@@ -41,7 +41,10 @@
 #include <vlc_filter.h>
 
 #include <vlc_media_library.h>
+#include <vlc_url.h>
 #include <ftw.h>
+#include <limits.h>
+#include <sys/stat.h>
 
 #include "../lib/libvlc_internal.h"
 
@@ -59,6 +62,103 @@ static void ValidateThumbnail(void *data, const vlc_ml_event_t *event)
     vlc_sem_post(sem);
 }
 
+#define DISCOVERY_DIRS 20
+#define DISCOVERY_FILES 50
+
+static char *discovery_dir;
+
+struct discovery_ctx
+{
+    vlc_sem_t sem;
+    atomic_bool completed;
+};
+
+static void ValidateDiscovery(void *data, const vlc_ml_event_t *event)
+{
+    struct discovery_ctx *ctx = data;
+
+    switch (event->i_type)
+    {
+        case VLC_ML_EVENT_DISCOVERY_COMPLETED:
+            atomic_store(&ctx->completed, true);
+            break;
+        case VLC_ML_EVENT_BACKGROUND_IDLE_CHANGED:
+            /* The discovered files are parsed once discovery is over */
+            if (event->background_idle_changed.b_idle &&
+                atomic_load(&ctx->completed))
+                vlc_sem_post(&ctx->sem);
+            break;
+    }
+}
+
+/* Writes a short silent WAV file */
+static void CreateDiscoveryFile(const char *path)
+{
+    static const uint8_t header[44] = {
+        'R', 'I', 'F', 'F', 0x64, 0x06, 0x00, 0x00, 'W', 'A', 'V', 'E',
+        'f', 'm', 't', ' ', 0x10, 0x00, 0x00, 0x00,
+        0x01, 0x00, 0x01, 0x00,             /* PCM, mono */
+        0x40, 0x1f, 0x00, 0x00,             /* 8000 Hz */
+        0x80, 0x3e, 0x00, 0x00,             /* 16000 bytes/s */
+        0x02, 0x00, 0x10, 0x00,             /* 16 bits */
+        'd', 'a', 't', 'a', 0x40, 0x06, 0x00, 0x00, /* 100 ms */
+    };
+    static const uint8_t silence[0x640];
+
+    FILE *file = fopen(path, "wb");
+    assert(file != NULL);
+    assert(fwrite(header, sizeof (header), 1, file) == 1);
+    assert(fwrite(silence, sizeof (silence), 1, file) == 1);
+    fclose(file);
+}
+
+/* Creates a tree of media files, as a small library would have */
+static char *CreateDiscoveryTree(const char *tempdir)
+{
+    char *root;
+    if (asprintf(&root, "%s/library", tempdir) < 0)
+        return NULL;
+    assert(mkdir(root, 0700) == 0);
+
+    for (unsigned i = 0; i < DISCOVERY_DIRS; i++)
+    {
+        char path[PATH_MAX];
+
+        snprintf(path, sizeof (path), "%s/album%02u", root, i);
+        assert(mkdir(path, 0700) == 0);
+        for (unsigned j = 0; j < DISCOVERY_FILES; j++)
+        {
+            snprintf(path, sizeof (path), "%s/album%02u/track%02u.wav",
+                     root, i, j);
+            CreateDiscoveryFile(path);
+        }
+    }
+    return root;
+}
+
+static void TestDiscovery(vlc_medialibrary_t *ml)
+{
+    char *mrl = vlc_path2uri(discovery_dir, NULL);
+    assert(mrl != NULL);
+
+    struct discovery_ctx ctx;
+    vlc_sem_init(&ctx.sem, 0);
+    atomic_init(&ctx.completed, false);
+
+    vlc_ml_event_callback_t *listener =
+        vlc_ml_event_register_callback(ml, ValidateDiscovery, &ctx);
+
+    assert(vlc_ml_add_folder(ml, mrl) == VLC_SUCCESS);
+    vlc_sem_wait(&ctx.sem);
+
+    vlc_ml_event_unregister_callback(ml, listener);
+    free(mrl);
+
+    /* Every file of the tree is in the library */
+    size_t count = vlc_ml_count_audio_media(ml, NULL);
+    assert(count == DISCOVERY_DIRS * DISCOVERY_FILES);
+}
+
 static int OpenIntf(vlc_object_t *root)
 {
     vlc_medialibrary_t *ml = vlc_ml_instance_get(root);
@@ -68,6 +168,8 @@ static int OpenIntf(vlc_object_t *root)
         return VLC_SUCCESS;
     }
 
+    TestDiscovery(ml);
+
     #define MOCK_URL "mock://video_track_count=1;length=100000000;" \
                      "video_width=800;video_height=600"
     vlc_ml_media_t *media = vlc_ml_new_external_media(ml, MOCK_URL);
@@ -118,6 +220,9 @@ int main(void)
     fprintf(stderr, "Using VLC_USERDATA_PATH directory %s\n", tempdir);
     setenv("VLC_USERDATA_PATH", tempdir, 1);
 
+    discovery_dir = CreateDiscoveryTree(tempdir);
+    assert(discovery_dir != NULL);
+
     test_init();
 
     const char * const args[] = {
@@ -131,6 +236,7 @@ int main(void)
     libvlc_InternalPlay(vlc->p_libvlc_int);
 
     libvlc_release(vlc);
+    free(discovery_dir);
 
     /* Remove temporary directory */
     nftw(tempdir, cleanup_tmpdir, FOPEN_MAX, FTW_DEPTH | FTW_MOUNT | FTW_PHYS);
@@ -0,0 +1,319 @@
+/*****************************************************************************
+ * ts_cbr.c: constant bitrate TS muxer test
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <vlc_common.h>
+
+#include <vlc_block.h>
+#include <vlc_demux.h>
+#include <vlc_es_out.h>
+#include <vlc_sout.h>
+#include <vlc_stream.h>
+
+#include "../../libvlc/test.h"
+#include "../lib/libvlc_internal.h"
+
+#define MUXRATE 4000000 /* bits/s */
+#define DURATION VLC_TICK_FROM_SEC(10)
+#define PACKET_TIME vlc_tick_from_samples(188 * 8, MUXRATE)
+
+struct output
+{
+    uint8_t *data;
+    size_t size;
+    size_t alloc;
+};
+
+static ssize_t AccessOutWrite(sout_access_out_t *access, block_t *block)
+{
+    struct output *out = access->p_sys;
+    ssize_t written = 0;
+
+    for (block_t *b = block; b != NULL; b = b->p_next)
+    {
+        if (out->size + b->i_buffer > out->alloc)
+        {
+            out->alloc = (out->size + b->i_buffer) * 2;
+            out->data = realloc(out->data, out->alloc);
+            assert(out->data != NULL);
+        }
+        memcpy(&out->data[out->size], b->p_buffer, b->i_buffer);
+        out->size += b->i_buffer;
+        written += b->i_buffer;
+    }
+    block_ChainRelease(block);
+    return written;
+}
+
+static sout_access_out_t *CreateAccessOut(vlc_object_t *parent,
+                                          struct output *out)
+{
+    sout_access_out_t *access = vlc_object_create(parent, sizeof(*access));
+    if (unlikely(access == NULL))
+        return NULL;
+
+    access->psz_access = strdup("mock");
+    if (unlikely(access->psz_access == NULL))
+    {
+        vlc_object_delete(access);
+        return NULL;
+    }
+
+    access->p_cfg = NULL;
+    access->p_module = NULL;
+    access->p_sys = out;
+    access->psz_path = NULL;
+
+    access->pf_control = NULL;
+    access->pf_read = NULL;
+    access->pf_seek = NULL;
+    access->pf_write = AccessOutWrite;
+    return access;
+}
+
+static void SendFrame(sout_mux_t *mux, sout_input_t *input, vlc_tick_t dts,
+                      vlc_tick_t length, size_t size, bool key)
+{
+    block_t *block = block_Alloc(size);
+    assert(block != NULL);
+    memset(block->p_buffer, 0x42, size);
+    block->i_dts = block->i_pts = dts;
+    block->i_length = length;
+    if (key)
+        block->i_flags |= BLOCK_FLAG_TYPE_I;
+
+    int status = sout_MuxSendBuffer(mux, input, block);
+    assert(status == VLC_SUCCESS);
+}
+
+/* Muxes 25fps variable size video and 48kHz MPEG audio */
+static int Mux(vlc_object_t *obj, struct output *out)
+{
+    sout_access_out_t *access = CreateAccessOut(obj, out);
+    assert(access != NULL);
+
+    char *muxname;
+    int ret = asprintf(&muxname, "ts{muxrate=%d}", MUXRATE);
+    assert(ret != -1);
+    sout_mux_t *mux = sout_MuxNew(access, muxname);
+    free(muxname);
+    if (mux == NULL)
+    {
+        sout_AccessOutDelete(access);
+        return 77;
+    }
+
+    es_format_t fmt;
+    es_format_Init(&fmt, VIDEO_ES, VLC_CODEC_MPGV);
+    fmt.video.i_width = fmt.video.i_visible_width = 720;
+    fmt.video.i_height = fmt.video.i_visible_height = 576;
+    sout_input_t *video = sout_MuxAddStream(mux, &fmt);
+    assert(video != NULL);
+
+    es_format_Init(&fmt, AUDIO_ES, VLC_CODEC_MPGA);
+    fmt.audio.i_rate = 48000;
+    fmt.audio.i_channels = 2;
+    sout_input_t *audio = sout_MuxAddStream(mux, &fmt);
+    assert(audio != NULL);
+
+    /* Disable mux caching. */
+    mux->b_waiting_stream = false;
+
+    const vlc_tick_t frame = VLC_TICK_FROM_MS(40);
+    const vlc_tick_t aframe = VLC_TICK_FROM_MS(24);
+    vlc_tick_t adts = VLC_TICK_0;
+    for (vlc_tick_t dts = VLC_TICK_0; dts < VLC_TICK_0 + DURATION; dts += frame)
+    {
+        unsigned n = (dts - VLC_TICK_0) / frame;
+        /* ~2.5Mbps with an I frame every 12 frames */
+        SendFrame(mux, video, dts, frame, n % 12 ? 9000 : 40000, n % 12 == 0);
+        for (; adts < dts + frame; adts += aframe)
+            SendFrame(mux, audio, adts, aframe, 576, true);
+    }
+
+    sout_MuxDeleteStream(mux, audio);
+    sout_MuxDeleteStream(mux, video);
+    sout_MuxDelete(mux);
+    sout_AccessOutDelete(access);
+    return 0;
+}
+
+struct pcr_check
+{
+    struct es_out_t out;
+    stream_t *stream;
+    vlc_tick_t first_pcr;
+    uint64_t first_pos;
+    vlc_tick_t max_jitter;
+    unsigned count;
+};
+
+static es_out_id_t *EsOutAdd(es_out_t *out, input_source_t *in,
+                             const es_format_t *fmt)
+{
+    (void) out; (void) in; (void) fmt;
+    return malloc(1);
+}
+
+static int EsOutSend(es_out_t *out, es_out_id_t *id, block_t *block)
+{
+    (void) out; (void) id;
+    block_Release(block);
+    return VLC_SUCCESS;
+}
+
+static void EsOutDelete(es_out_t *out, es_out_id_t *id)
+{
+    (void) out;
+    free(id);
+}
+
+/* Compares the PCR to the position of the packet in the stream */
+static void CheckPCR(struct pcr_check *check, vlc_tick_t pcr)
+{
+    uint64_t pos = vlc_stream_Tell(check->stream);
+
+    check->count++;
+    /* Use the second PCR as reference, the demuxer may shift the first one
+     * to its queued data */
+    if (check->count <= 2)
+    {
+        check->first_pcr = pcr;
+        check->first_pos = pos;
+        return;
+    }
+
+    vlc_tick_t expected = check->first_pcr +
+        vlc_tick_from_samples((pos - check->first_pos) * 8, MUXRATE);
+    vlc_tick_t jitter = llabs(pcr - expected);
+    if (jitter > check->max_jitter)
+        check->max_jitter = jitter;
+}
+
+static int EsOutControl(es_out_t *out, input_source_t *in, int query,
+                        va_list args)
+{
+    (void) in;
+    struct pcr_check *check = container_of(out, struct pcr_check, out);
+
+    switch (query)
+    {
+        case ES_OUT_SET_GROUP_PCR:
+        {
+            (void) va_arg(args, int);
+            CheckPCR(check, va_arg(args, vlc_tick_t));
+            break;
+        }
+        case ES_OUT_GET_ES_STATE:
+            (void) va_arg(args, es_out_id_t *);
+            *va_arg(args, bool *) = true;
+            break;
+        case ES_OUT_GET_EMPTY:
+            *va_arg(args, bool *) = true;
+            break;
+        default:
+            return VLC_EGENERIC;
+    }
+    return VLC_SUCCESS;
+}
+
+static void EsOutDestroy(es_out_t *out)
+{
+    (void) out;
+}
+
+static const struct es_out_callbacks es_out_cbs =
+{
+    .add = EsOutAdd,
+    .send = EsOutSend,
+    .del = EsOutDelete,
+    .control = EsOutControl,
+    .destroy = EsOutDestroy,
+};
+
+/* Reads the multiplex back through the TS demuxer */
+static void Analyze(vlc_object_t *obj, const struct output *out)
+{
+    /* Constant bitrate: every packet is there, including the stuffing */
+    assert(out->size > 0 && out->size % 188 == 0);
+
+    unsigned nulls = 0;
+    for (size_t i = 0; i < out->size; i += 188)
+    {
+        const uint8_t *p = &out->data[i];
+
+        assert(p[0] == 0x47);
+        if (((p[1] & 0x1f) << 8 | p[2]) == 0x1fff)
+            nulls++;
+    }
+    assert(nulls > 0);
+
+    /* The output covers the input duration at the mux rate */
+    vlc_tick_t duration = vlc_tick_from_samples(out->size * 8, MUXRATE);
+    assert(duration > DURATION - VLC_TICK_FROM_SEC(1));
+    assert(duration < DURATION + VLC_TICK_FROM_SEC(1));
+
+    stream_t *s = vlc_stream_MemoryNew(obj, out->data, out->size, true);
+    assert(s != NULL);
+
+    struct pcr_check check = {
+        .out = { .cbs = &es_out_cbs },
+        .stream = s,
+    };
+    demux_t *demux = demux_New(obj, "ts", "vlc://nop", s, &check.out);
+    assert(demux != NULL);
+
+    while (demux_Demux(demux) == VLC_DEMUXER_SUCCESS);
+
+    demux_Delete(demux);
+    vlc_stream_Delete(s);
+
+    /* PCRs every 70ms, minus the data still buffered in the muxer */
+    assert(check.count >= DURATION / VLC_TICK_FROM_MS(100));
+    /* PCRs match the position of their packet: the demuxer reports them
+     * with a 90kHz precision, after reading a packet or a few */
+    assert(check.max_jitter <= 4 * PACKET_TIME);
+}
+
+int main(void)
+{
+    test_init();
+
+    const char *const args[] = {
+        "-vvv",
+    };
+    libvlc_instance_t *vlc = libvlc_new(ARRAY_SIZE(args), args);
+    if (vlc == NULL)
+        return 1;
+
+    vlc_object_t *obj = VLC_OBJECT(vlc->p_libvlc_int);
+    struct output out = { NULL, 0, 0 };
+
+    int ret = Mux(obj, &out);
+    if (ret == 0)
+        Analyze(obj, &out);
+
+    free(out.data);
+    libvlc_release(vlc);
+    return ret;
+}
@@ -172,6 +172,10 @@ static vlc_frame_t *EncodeVideo(encoder_t *enc, picture_t *pic)
 
     assert(pic->format.i_chroma == enc->fmt_in.video.i_chroma);
     vlc_frame_t *frame = vlc_frame_Alloc(4);
+    assert(frame != NULL);
+    frame->i_pts = frame->i_dts = pic->date;
+    /* Tell the encoders apart from their output */
+    SetDWBE(frame->p_buffer, pic->format.i_visible_width);
 
     struct transcode_scenario *scenario = &transcode_scenarios[current_scenario];
     if (scenario->encoder_encode != NULL)
@@ -241,13 +245,134 @@ static int OpenErrorChecker(vlc_object_t *obj)
     return VLC_SUCCESS;
 }
 
+/* Relabels the raw video as compressed video, in GOPs of GOP_SIZE frames
+ * reordered as a decoder would receive them. Every other GOP is open: it
+ * starts with leading pictures, shown before their keyframe. */
+#define GOP_SIZE 5
+
+struct gop_maker
+{
+    void *video_id;
+    vlc_frame_t *frames[GOP_SIZE];
+    size_t count;
+    unsigned gop;
+};
+
+static void *GopMakerAdd(sout_stream_t *stream, const es_format_t *fmt,
+                         const char *es_id)
+{
+    struct gop_maker *sys = stream->p_sys;
+
+    if (fmt->i_cat != VIDEO_ES)
+        return sout_StreamIdAdd(stream->p_next, fmt, es_id);
+
+    es_format_t copy;
+    es_format_Copy(&copy, fmt);
+    copy.i_codec = VLC_CODEC_H264;
+    copy.b_packetized = true;
+    sys->video_id = sout_StreamIdAdd(stream->p_next, &copy, es_id);
+    es_format_Clean(&copy);
+    return sys->video_id;
+}
+
+static void GopMakerDel(sout_stream_t *stream, void *id)
+{
+    struct gop_maker *sys = stream->p_sys;
+
+    if (id == sys->video_id)
+    {
+        for (size_t i = 0; i < sys->count; i++)
+            vlc_frame_Release(sys->frames[i]);
+        sys->count = 0;
+        sys->video_id = NULL;
+    }
+    sout_StreamIdDel(stream->p_next, id);
+}
+
+static int GopMakerSend(sout_stream_t *stream, void *id, vlc_frame_t *f)
+{
+    struct gop_maker *sys = stream->p_sys;
+
+    if (id != sys->video_id)
+        return sout_StreamIdSend(stream->p_next, id, f);
+
+    assert(f->p_next == NULL);
+    sys->frames[sys->count++] = f;
+    if (sys->count < GOP_SIZE)
+        return VLC_SUCCESS;
+    sys->count = 0;
+
+    /* Decode order, as indexes in display order */
+    static const unsigned closed_order[GOP_SIZE] = { 0, 2, 1, 4, 3 };
+    static const unsigned open_order[GOP_SIZE] = { 2, 0, 1, 4, 3 };
+    const bool closed = sys->gop++ % 2 == 0;
+    const unsigned *order = closed ? closed_order : open_order;
+    const vlc_tick_t first = sys->frames[0]->i_pts;
+    const vlc_tick_t step = sys->frames[1]->i_pts - first;
+
+    struct transcode_scenario *scenario = &transcode_scenarios[current_scenario];
+    int ret = VLC_SUCCESS;
+    for (unsigned i = 0; i < GOP_SIZE; i++)
+    {
+        vlc_frame_t *frame = sys->frames[order[i]];
+
+        /* Two frames of reordering delay */
+        frame->i_dts = first + ((vlc_tick_t)i - 2) * step;
+        frame->i_flags &= ~VLC_FRAME_FLAG_TYPE_MASK;
+        if (i == 0)
+        {
+            frame->i_flags |= VLC_FRAME_FLAG_TYPE_I;
+            if (scenario->report_keyframe != NULL)
+                scenario->report_keyframe(frame->i_pts, closed);
+        }
+        else
+            frame->i_flags |= order[i] < order[0] || order[i] < order[i - 1]
+                            ? VLC_FRAME_FLAG_TYPE_B : VLC_FRAME_FLAG_TYPE_P;
+
+        if (ret == VLC_SUCCESS)
+            ret = sout_StreamIdSend(stream->p_next, id, frame);
+        else
+            vlc_frame_Release(frame);
+    }
+    return ret;
+}
+
+static void GopMakerClose(sout_stream_t *stream)
+{
+    free(stream->p_sys);
+}
+
+static int OpenGopMaker(vlc_object_t *obj)
+{
+    sout_stream_t *stream = (sout_stream_t *)obj;
+
+    struct gop_maker *sys = calloc(1, sizeof(*sys));
+    if (sys == NULL)
+        return VLC_ENOMEM;
+
+    static const struct sout_stream_operations ops = {
+        .add = GopMakerAdd,
+        .del = GopMakerDel,
+        .send = GopMakerSend,
+        .close = GopMakerClose,
+    };
+    stream->p_sys = sys;
+    stream->ops = &ops;
+    return VLC_SUCCESS;
+}
+
 static int OutputCheckerSend(sout_stream_t *stream, void *id, vlc_frame_t *f)
 {
-    (void)stream; (void)id;
+    (void)stream;
     struct transcode_scenario *scenario = &transcode_scenarios[current_scenario];
 
-    assert(scenario->report_output != NULL);
-    scenario->report_output(f);
+    if (scenario->report_es_output != NULL)
+        scenario->report_es_output(id, f);
+    else
+    {
+        assert(scenario->report_output != NULL);
+        scenario->report_output(f);
+    }
 
     vlc_frame_ChainRelease(f);
 
@@ -257,12 +382,18 @@ static int OutputCheckerSend(sout_stream_t *stream, void *id, vlc_frame_t *f)
 static void *OutputCheckerAdd(sout_stream_t *stream, const es_format_t *fmt,
                               const char *es_id)
 {
-    (void)stream; (void)fmt; (void)es_id;
-    return (void*)0x42;
+    (void)stream; (void)fmt;
+    /* The ES ID is the stream ID */
+    char *id = strdup(es_id != NULL ? es_id : "");
+    assert(id != NULL);
+    return id;
 }
 
 static void OutputCheckerDel(sout_stream_t *stream, void *id)
-    { (void)stream; (void)id; }
+{
+    (void)stream;
+    free(id);
+}
 
 static int OpenOutputChecker(vlc_object_t *obj)
 {
@@ -368,6 +499,11 @@ vlc_module_begin()
         set_capability("sout filter", 0)
         add_shortcut("error_checker")
 
+    add_submodule()
+        set_callback(OpenGopMaker)
+        set_capability("sout filter", 0)
+        add_shortcut("gop_maker")
+
     add_submodule()
         set_callback(OpenOutputChecker)
         set_capability("sout output", 0)
@@ -37,6 +37,9 @@ struct transcode_scenario {
     void (*converter_setup)(filter_t *);
     void (*report_error)(sout_stream_t *);
     void (*report_output)(const vlc_frame_t *);
+    /* Reports the output with its ES, instead of report_output */
+    void (*report_es_output)(const char *es_id, const vlc_frame_t *);
+    void (*report_keyframe)(vlc_tick_t pts, bool closed);
 };
 
 
@@ -36,10 +36,25 @@ static struct scenario_data
     vlc_sem_t wait_stop;
     struct vlc_video_context *decoder_vctx;
     unsigned output_frame_count;
+    unsigned rendition_frame_count;
     bool converter_opened;
     bool encoder_opened;
+    unsigned encoder_count;
     bool encoder_closed;
     bool error_reported;
+    vlc_tick_t last_dts;
+
+    /* Compressed segments */
+    vlc_mutex_t lock;
+    vlc_tick_t closed_keyframes[256]; /**< ring of the last ones */
+    unsigned closed_keyframe_count;
+    unsigned open_keyframe_count;
+    struct {
+        const decoder_t *dec;
+        bool started;
+    } decoders[64];
+    unsigned decoder_count;
+    unsigned segment_count;
 } scenario_data;
 
 static void decoder_fixed_size(decoder_t *dec, vlc_fourcc_t chroma,
@@ -94,6 +109,67 @@ picture_context_copy(struct picture_context_t *ctx)
     return copy;
 }
 
+static void report_keyframe(vlc_tick_t pts, bool closed)
+{
+    vlc_mutex_lock(&scenario_data.lock);
+    if (closed)
+    {
+        const size_t size = ARRAY_SIZE(scenario_data.closed_keyframes);
+        scenario_data.closed_keyframes[
+            scenario_data.closed_keyframe_count++ % size] = pts;
+    }
+    else
+        scenario_data.open_keyframe_count++;
+    vlc_mutex_unlock(&scenario_data.lock);
+}
+
+static void decoder_segment_i420_800_600(decoder_t *dec)
+{
+    decoder_i420_800_600(dec);
+
+    /* Each segment is decoded by a new decoder, which may reuse the address
+     * of a deleted one */
+    vlc_mutex_lock(&scenario_data.lock);
+    unsigned i = 0;
+    while (i < scenario_data.decoder_count && scenario_data.decoders[i].dec != dec)
+        i++;
+    if (i == scenario_data.decoder_count)
+    {
+        assert(i < ARRAY_SIZE(scenario_data.decoders));
+        scenario_data.decoders[scenario_data.decoder_count++].dec = dec;
+    }
+    scenario_data.decoders[i].started = false;
+    vlc_mutex_unlock(&scenario_data.lock);
+}
+
+static int decoder_decode_segment(decoder_t *dec, picture_t *pic)
+{
+    vlc_mutex_lock(&scenario_data.lock);
+    unsigned i = 0;
+    while (scenario_data.decoders[i].dec != dec)
+    {
+        i++;
+        assert(i < scenario_data.decoder_count);
+    }
+
+    if (!scenario_data.decoders[i].started)
+    {
+        /* Segments only start at the keyframe of a closed GOP */
+        const size_t size = ARRAY_SIZE(scenario_data.closed_keyframes);
+        size_t count = __MIN(scenario_data.closed_keyframe_count, size);
+        bool found = false;
+        for (size_t j = 0; j < count && !found; j++)
+            found = scenario_data.closed_keyframes[j] == pic->date;
+        assert(found);
+
+        scenario_data.decoders[i].started = true;
+        scenario_data.segment_count++;
+    }
+    vlc_mutex_unlock(&scenario_data.lock);
+
+    return decoder_decode_dummy(dec, pic);
+}
+
 static int decoder_decode_vctx(decoder_t *dec, picture_t *pic)
 {
     struct vlc_video_context *vctx = dec->p_sys;
@@ -194,6 +270,38 @@ static void encoder_i420_800_600_no_vctx(encoder_t *enc)
 }
 #endif
 
+static void encoder_ladder_800_600_400_300(encoder_t *enc)
+{
+    /* The main encoder is opened first, then the rendition one */
+    const unsigned width = scenario_data.encoder_count == 0 ? 800 : 400;
+    const unsigned height = scenario_data.encoder_count == 0 ? 600 : 300;
+
+    assert(scenario_data.encoder_count < 2);
+    assert(enc->fmt_in.video.i_visible_width == width);
+    assert(enc->fmt_in.video.i_visible_height == height);
+    enc->fmt_in.video.i_chroma
+        = enc->fmt_in.i_codec
+        = VLC_CODEC_I420;
+    scenario_data.encoder_count++;
+    scenario_data.encoder_opened = true;
+}
+
+static void encoder_segments_i420_800_600(encoder_t *enc)
+{
+    static vlc_mutex_t lock = VLC_STATIC_MUTEX;
+
+    /* Each segment is encoded by its own encoder, on a worker thread */
+    assert(enc->fmt_in.video.i_visible_width == 800);
+    assert(enc->fmt_in.video.i_visible_height == 600);
+    enc->fmt_in.video.i_chroma
+        = enc->fmt_in.i_codec
+        = VLC_CODEC_I420;
+    vlc_mutex_lock(&lock);
+    scenario_data.encoder_count++;
+    scenario_data.encoder_opened = true;
+    vlc_mutex_unlock(&lock);
+}
+
 static void encoder_encode_dummy(encoder_t *enc, picture_t *pic)
 {
     (void)enc; (void)pic;
@@ -216,6 +324,68 @@ static void wait_output_10_frames_reported(const vlc_frame_t *out)
         vlc_sem_post(&scenario_data.wait_stop);
 }
 
+static void wait_output_20_frames_reported(const vlc_frame_t *out)
+{
+    for (; out != NULL; out = out->p_next )
+        if (++scenario_data.output_frame_count == 20)
+            vlc_sem_post(&scenario_data.wait_stop);
+}
+
+static void wait_output_20_frames_per_rendition(const char *es_id,
+                                                const vlc_frame_t *out)
+{
+    /* Each rendition has its own ES, with "/renditionN" appended */
+    const char *suffix = strrchr(es_id, '/');
+    const bool rendition = suffix != NULL && !strcmp(suffix, "/rendition1");
+    unsigned *count = rendition ? &scenario_data.rendition_frame_count
+                                : &scenario_data.output_frame_count;
+
+    for (; out != NULL; out = out->p_next )
+    {
+        assert(out->i_buffer == 4);
+        assert(GetDWBE(out->p_buffer) == (rendition ? 400 : 800));
+        if (++*count == 20 && scenario_data.output_frame_count >= 20
+         && scenario_data.rendition_frame_count >= 20)
+        {
+            /* One encoder for the main rendition, one for the other */
+            assert(scenario_data.encoder_count == 2);
+            vlc_sem_post(&scenario_data.wait_stop);
+        }
+    }
+}
+
+static void wait_output_20_frames_in_order(const vlc_frame_t *out)
+{
+    for (; out != NULL; out = out->p_next )
+    {
+        /* The segments are sent in order */
+        assert(out->i_dts > scenario_data.last_dts);
+        scenario_data.last_dts = out->i_dts;
+
+        if (++scenario_data.output_frame_count == 20)
+        {
+            /* 200ms segments at 25fps: at least 4 segments are done */
+            assert(scenario_data.encoder_count >= 4);
+            vlc_sem_post(&scenario_data.wait_stop);
+        }
+    }
+}
+
+static void wait_output_20_frames_segmented(const vlc_frame_t *out)
+{
+    for (; out != NULL; out = out->p_next )
+        if (++scenario_data.output_frame_count == 20)
+        {
+            vlc_mutex_lock(&scenario_data.lock);
+            /* 400ms between closed GOPs at 25fps: at least 2 segments are
+             * done, and the open GOPs were not cut */
+            assert(scenario_data.segment_count >= 2);
+            assert(scenario_data.open_keyframe_count > 0);
+            vlc_mutex_unlock(&scenario_data.lock);
+            vlc_sem_post(&scenario_data.wait_stop);
+        }
+}
+
 static void wait_output_reported(const vlc_frame_t *out)
 {
     (void)out;
@@ -241,6 +411,18 @@ static void converter_fixed_size(filter_t *filter, vlc_fourcc_t chroma_in,
     scenario_data.converter_opened = true;
 }
 
+static void converter_i420_800_600_to_400_300(filter_t *filter)
+{
+    assert(filter->fmt_in.video.i_visible_width == 800);
+    assert(filter->fmt_in.video.i_visible_height == 600);
+    assert(filter->fmt_out.video.i_visible_width == 400);
+    assert(filter->fmt_out.video.i_visible_height == 300);
+    assert(filter->fmt_in.video.i_chroma == VLC_CODEC_I420);
+    assert(filter->fmt_out.video.i_chroma == VLC_CODEC_I420);
+
+    scenario_data.converter_opened = true;
+}
+
 static void converter_i420_to_nv12_800_600(filter_t *filter)
     { converter_fixed_size(filter, VLC_CODEC_I420, VLC_CODEC_NV12, 800, 600); }
 
@@ -356,6 +538,42 @@ struct transcode_scenario transcode_scenarios[] =
     .encoder_close = encoder_close,
     .converter_setup = converter_nv12_to_i420_800_600_vctx,
     .report_output = wait_output_10_frames_reported,
+},{
+    /* Make sure the ladder renditions are scaled from the decoded pictures
+     * and encoded next to the main one. */
+    .source = source_800_600,
+    .sout = "sout=#transcode{ladder=400x300}:output_checker",
+    .decoder_setup = decoder_i420_800_600,
+    .decoder_decode = decoder_decode_dummy,
+    .encoder_setup = encoder_ladder_800_600_400_300,
+    .encoder_encode = encoder_encode_dummy,
+    .encoder_close = encoder_close,
+    .converter_setup = converter_i420_800_600_to_400_300,
+    .report_es_output = wait_output_20_frames_per_rendition,
+},{
+    /* Make sure the video is transcoded in parallel segments, each with its
+     * own encoder, and that they are sent in order. */
+    .source = source_800_600,
+    .sout = "sout=#transcode{segments=4,segment-length=200}:output_checker",
+    .decoder_setup = decoder_i420_800_600,
+    .decoder_decode = decoder_decode_dummy,
+    .encoder_setup = encoder_segments_i420_800_600,
+    .encoder_encode = encoder_encode_dummy,
+    .encoder_close = encoder_close,
+    .report_output = wait_output_20_frames_in_order,
+},{
+    /* Make sure compressed video is only cut into segments at the keyframes
+     * of closed GOPs, and not at the ones followed by leading pictures. */
+    .source = source_800_600,
+    .sout = "sout=#gop_maker:transcode{segments=4,segment-length=200}"
+            ":output_checker",
+    .decoder_setup = decoder_segment_i420_800_600,
+    .decoder_decode = decoder_decode_segment,
+    .encoder_setup = encoder_segments_i420_800_600,
+    .encoder_encode = encoder_encode_dummy,
+    .encoder_close = encoder_close,
+    .report_output = wait_output_20_frames_segmented,
+    .report_keyframe = report_keyframe,
 },{
     /* Ensure that error are correctly forwarded back to the stream output
      * pipeline. */
@@ -372,8 +590,16 @@ void transcode_scenario_init(void)
 {
     scenario_data.decoder_vctx = NULL;
     scenario_data.output_frame_count = 0;
+    scenario_data.rendition_frame_count = 0;
     scenario_data.converter_opened = false;
     scenario_data.encoder_opened = false;
+    scenario_data.encoder_count = 0;
+    scenario_data.last_dts = VLC_TICK_INVALID;
+    vlc_mutex_init(&scenario_data.lock);
+    scenario_data.closed_keyframe_count = 0;
+    scenario_data.open_keyframe_count = 0;
+    scenario_data.decoder_count = 0;
+    scenario_data.segment_count = 0;
     vlc_sem_init(&scenario_data.wait_stop, 0);
 }
 
@@ -0,0 +1,191 @@
+/*****************************************************************************
+ * freetype.c: text layout cache test and subtitle burn-in benchmark
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <vlc_common.h>
+
+#include <vlc_filter.h>
+#include <vlc_modules.h>
+#include <vlc_subpicture.h>
+#include <vlc_text_style.h>
+
+#include "../../libvlc/test.h"
+#include "../lib/libvlc_internal.h"
+
+/* Each subtitle stays on screen for that many frames (2 s at 25 fps) */
+#define FRAMES_PER_SUB 50
+
+static const char *const subtitles[] =
+{
+    "Previously, on the test suite...",
+    "I told you the glyphs\nwould be cached.",
+    "Les sous-titres incrustés ne changent\npas d'une image à l'autre.",
+    "Previously, on the test suite...",
+    "This line is long enough that it has to be wrapped by the layout, "
+    "since it does not fit within the width of the video.",
+};
+
+static filter_t *CreateRenderer(vlc_object_t *obj, int cache)
+{
+    var_SetInteger(obj, "freetype-layout-cache", cache);
+
+    filter_t *filter = vlc_object_create(obj, sizeof (*filter));
+    assert(filter != NULL);
+
+    es_format_Init(&filter->fmt_in, VIDEO_ES, 0);
+    es_format_Init(&filter->fmt_out, VIDEO_ES, 0);
+    filter->fmt_out.video.i_width          =
+    filter->fmt_out.video.i_visible_width  = 1920;
+    filter->fmt_out.video.i_height         =
+    filter->fmt_out.video.i_visible_height = 1080;
+
+    filter->p_module = module_need(filter, "text renderer", "freetype", true);
+    if (filter->p_module == NULL)
+    {
+        vlc_object_delete(filter);
+        return NULL;
+    }
+    return filter;
+}
+
+static void DeleteRenderer(filter_t *filter)
+{
+    filter_Close(filter);
+    module_unneed(filter, filter->p_module);
+    es_format_Clean(&filter->fmt_in);
+    es_format_Clean(&filter->fmt_out);
+    vlc_object_delete(filter);
+}
+
+static subpicture_region_t *RenderText(filter_t *filter, const char *text)
+{
+    static const vlc_fourcc_t chromas[] = { VLC_CODEC_RGBA, 0 };
+
+    subpicture_region_t *in = subpicture_region_NewText();
+    assert(in != NULL);
+    in->p_text = text_segment_New(text);
+    assert(in->p_text != NULL);
+    in->text_flags |= SUBPICTURE_ALIGN_BOTTOM;
+
+    subpicture_region_t *out = filter->ops->render(filter, in, chromas);
+    subpicture_region_Delete(in);
+    return out;
+}
+
+static bool RegionEquals(const subpicture_region_t *a,
+                         const subpicture_region_t *b)
+{
+    const picture_t *pa = a->p_picture, *pb = b->p_picture;
+
+    if (a->fmt.i_chroma != b->fmt.i_chroma
+     || a->fmt.i_visible_width != b->fmt.i_visible_width
+     || a->fmt.i_visible_height != b->fmt.i_visible_height)
+        return false;
+
+    for (int i = 0; i < pa->i_planes; i++)
+        for (int y = 0; y < pa->p[i].i_visible_lines; y++)
+            if (memcmp(&pa->p[i].p_pixels[y * pa->p[i].i_pitch],
+                       &pb->p[i].p_pixels[y * pb->p[i].i_pitch],
+                       pa->p[i].i_visible_pitch))
+                return false;
+    return true;
+}
+
+/* Renders the subtitles as a burn-in filter would, once per video frame */
+static vlc_tick_t BurnIn(filter_t *filter, subpicture_region_t **last)
+{
+    vlc_tick_t start = vlc_tick_now();
+
+    for (size_t i = 0; i < ARRAY_SIZE(subtitles); i++)
+        for (unsigned j = 0; j < FRAMES_PER_SUB; j++)
+        {
+            subpicture_region_t *region = RenderText(filter, subtitles[i]);
+            assert(region != NULL);
+
+            if (j == FRAMES_PER_SUB - 1)
+            {
+                /* Cached and uncached layouts render the same pixels */
+                if (last[i] != NULL)
+                {
+                    assert(RegionEquals(last[i], region));
+                    subpicture_region_Delete(last[i]);
+                }
+                last[i] = region;
+            }
+            else
+                subpicture_region_Delete(region);
+        }
+
+    return vlc_tick_now() - start;
+}
+
+int main(void)
+{
+    test_init();
+
+    const char *const args[] = {
+        "-v",
+    };
+    libvlc_instance_t *vlc = libvlc_new(ARRAY_SIZE(args), args);
+    if (vlc == NULL)
+        return 1;
+
+    vlc_object_t *obj = VLC_OBJECT(vlc->p_libvlc_int);
+    var_Create(obj, "freetype-layout-cache", VLC_VAR_INTEGER);
+
+    subpicture_region_t *last[ARRAY_SIZE(subtitles)] = { NULL };
+    int ret = 77;
+
+    filter_t *filter = CreateRenderer(obj, 0);
+    if (filter == NULL)
+        goto out;
+
+    /* Without any usable font, there is nothing to render */
+    subpicture_region_t *probe = RenderText(filter, subtitles[0]);
+    if (probe == NULL)
+    {
+        DeleteRenderer(filter);
+        goto out;
+    }
+    subpicture_region_Delete(probe);
+
+    vlc_tick_t uncached = BurnIn(filter, last);
+    DeleteRenderer(filter);
+
+    filter = CreateRenderer(obj, 32);
+    assert(filter != NULL);
+    vlc_tick_t cached = BurnIn(filter, last);
+    DeleteRenderer(filter);
+
+    const unsigned frames = ARRAY_SIZE(subtitles) * FRAMES_PER_SUB;
+    printf("%u frames: %6.0f subtitles/s, %6.0f subtitles/s cached (x%.2f)\n",
+           frames, frames * (double)CLOCK_FREQ / uncached,
+           frames * (double)CLOCK_FREQ / cached, (double)uncached / cached);
+    ret = 0;
+out:
+    for (size_t i = 0; i < ARRAY_SIZE(subtitles); i++)
+        if (last[i] != NULL)
+            subpicture_region_Delete(last[i]);
+    libvlc_release(vlc);
+    return ret;
+}
@@ -0,0 +1,199 @@
+/*****************************************************************************
+ * swscale.c: slice threaded scaling test and benchmark
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <vlc_common.h>
+
+#include <vlc_filter.h>
+#include <vlc_modules.h>
+#include <vlc_picture.h>
+
+#include "../../libvlc/test.h"
+#include "../lib/libvlc_internal.h"
+
+#define FRAMES 8
+
+struct scenario
+{
+    vlc_fourcc_t chroma_in;
+    unsigned width_in, height_in;
+    vlc_fourcc_t chroma_out;
+    unsigned width_out, height_out;
+};
+
+static const struct scenario scenarios[] =
+{
+    /* Transcode ladders */
+    { VLC_CODEC_I420, 3840, 2160, VLC_CODEC_I420, 1920, 1080 },
+    { VLC_CODEC_I420, 3840, 2160, VLC_CODEC_I420, 1280,  720 },
+    { VLC_CODEC_I420, 1920, 1080, VLC_CODEC_I420,  640,  360 },
+    /* Display */
+    { VLC_CODEC_I420, 1920, 1080, VLC_CODEC_RGBA, 2560, 1440 },
+    { VLC_CODEC_I420, 1280,  720, VLC_CODEC_RGBA, 1280,  720 },
+};
+
+static filter_t *CreateScaler(vlc_object_t *obj, const struct scenario *sc,
+                              int threads)
+{
+    var_SetInteger(obj, "swscale-threads", threads);
+
+    filter_t *filter = vlc_object_create(obj, sizeof (*filter));
+    assert(filter != NULL);
+
+    es_format_Init(&filter->fmt_in, VIDEO_ES, sc->chroma_in);
+    video_format_Setup(&filter->fmt_in.video, sc->chroma_in,
+                       sc->width_in, sc->height_in,
+                       sc->width_in, sc->height_in, 1, 1);
+    es_format_Init(&filter->fmt_out, VIDEO_ES, sc->chroma_out);
+    video_format_Setup(&filter->fmt_out.video, sc->chroma_out,
+                       sc->width_out, sc->height_out,
+                       sc->width_out, sc->height_out, 1, 1);
+
+    filter->p_module = module_need(filter, "video converter", "swscale",
+                                   true);
+    if (filter->p_module == NULL)
+    {
+        es_format_Clean(&filter->fmt_in);
+        es_format_Clean(&filter->fmt_out);
+        vlc_object_delete(filter);
+        return NULL;
+    }
+    return filter;
+}
+
+static void DeleteScaler(filter_t *filter)
+{
+    filter_Close(filter);
+    module_unneed(filter, filter->p_module);
+    es_format_Clean(&filter->fmt_in);
+    es_format_Clean(&filter->fmt_out);
+    vlc_object_delete(filter);
+}
+
+static picture_t *CreateSource(const struct scenario *sc)
+{
+    picture_t *pic = picture_New(sc->chroma_in, sc->width_in, sc->height_in,
+                                 1, 1);
+    assert(pic != NULL);
+
+    /* Gradients, so that every slice has different content */
+    for (int i = 0; i < pic->i_planes; i++)
+    {
+        plane_t *p = &pic->p[i];
+        for (int y = 0; y < p->i_visible_lines; y++)
+            for (int x = 0; x < p->i_visible_pitch; x++)
+                p->p_pixels[y * p->i_pitch + x] = (x + 3 * y + 50 * i) & 0xff;
+    }
+    return pic;
+}
+
+/* Scales the source, returns the last output and the elapsed time */
+static picture_t *Run(vlc_object_t *obj, const struct scenario *sc,
+                      int threads, picture_t *src, vlc_tick_t *elapsed)
+{
+    filter_t *filter = CreateScaler(obj, sc, threads);
+    if (filter == NULL)
+        return NULL;
+
+    picture_t *out = NULL;
+    vlc_tick_t start = vlc_tick_now();
+
+    for (unsigned i = 0; i < FRAMES; i++)
+    {
+        if (out != NULL)
+            picture_Release(out);
+        out = filter->ops->filter_video(filter, picture_Hold(src));
+        assert(out != NULL);
+    }
+
+    *elapsed = vlc_tick_now() - start;
+    DeleteScaler(filter);
+    return out;
+}
+
+static bool PictureEquals(const picture_t *a, const picture_t *b)
+{
+    assert(a->i_planes == b->i_planes);
+    for (int i = 0; i < a->i_planes; i++)
+    {
+        const plane_t *pa = &a->p[i], *pb = &b->p[i];
+
+        for (int y = 0; y < pa->i_visible_lines; y++)
+            if (memcmp(&pa->p_pixels[y * pa->i_pitch],
+                       &pb->p_pixels[y * pb->i_pitch], pa->i_visible_pitch))
+                return false;
+    }
+    return true;
+}
+
+static int Bench(vlc_object_t *obj, const struct scenario *sc)
+{
+    picture_t *src = CreateSource(sc);
+    vlc_tick_t single, multi;
+
+    picture_t *ref = Run(obj, sc, 1, src, &single);
+    if (ref == NULL)
+    {
+        picture_Release(src);
+        return 77;
+    }
+    picture_t *out = Run(obj, sc, 0, src, &multi);
+    assert(out != NULL);
+
+    printf("%4.4s %4ux%-4u -> %4.4s %4ux%-4u: %6.1f fps, "
+           "%6.1f fps threaded (x%.2f)\n",
+           (const char *)&sc->chroma_in, sc->width_in, sc->height_in,
+           (const char *)&sc->chroma_out, sc->width_out, sc->height_out,
+           FRAMES * (double)CLOCK_FREQ / single,
+           FRAMES * (double)CLOCK_FREQ / multi, (double)single / multi);
+
+    /* Slices do not change the result */
+    assert(PictureEquals(ref, out));
+
+    picture_Release(out);
+    picture_Release(ref);
+    picture_Release(src);
+    return 0;
+}
+
+int main(void)
+{
+    test_init();
+
+    const char *const args[] = {
+        "-v",
+    };
+    libvlc_instance_t *vlc = libvlc_new(ARRAY_SIZE(args), args);
+    if (vlc == NULL)
+        return 1;
+
+    vlc_object_t *obj = VLC_OBJECT(vlc->p_libvlc_int);
+    var_Create(obj, "swscale-threads", VLC_VAR_INTEGER);
+
+    int ret = 0;
+    for (size_t i = 0; i < ARRAY_SIZE(scenarios) && ret == 0; i++)
+        ret = Bench(obj, &scenarios[i]);
+
+    libvlc_release(vlc);
+    return ret;
+}
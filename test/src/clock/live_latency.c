@@ -0,0 +1,102 @@
+/*****************************************************************************
+ * clock/live_latency.c: test for the live latency controller
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#undef NDEBUG
+
+#include <assert.h>
+
+#include <vlc_common.h>
+
+#include "../../../src/clock/live_latency.h"
+
+const char vlc_module_name[] = "test_live_latency";
+
+#define TARGET VLC_TICK_FROM_SEC(3)
+#define STEP VLC_TICK_FROM_MS(250) /* input statistics period */
+
+/* Plays at the rate returned by the controller, returns the latency reached
+ * after the given duration */
+static vlc_tick_t play(struct live_latency *ctl, vlc_tick_t latency,
+                       vlc_tick_t duration, float *rate_min, float *rate_max)
+{
+    float rate = 1.f;
+
+    for (vlc_tick_t t = 0; t < duration; t += STEP)
+    {
+        /* the live edge progresses in real time, the playback at the rate */
+        latency -= (vlc_tick_t)(STEP * (rate - 1.f));
+        rate = live_latency_Update(ctl, latency);
+        if (rate < *rate_min)
+            *rate_min = rate;
+        if (rate > *rate_max)
+            *rate_max = rate;
+    }
+    return latency;
+}
+
+int main(void)
+{
+    struct live_latency ctl;
+    float rate_min, rate_max;
+    vlc_tick_t latency;
+
+    live_latency_Init(&ctl, TARGET, .95f, 1.05f);
+    assert(live_latency_Get(&ctl) == VLC_TICK_INVALID);
+
+    /* Small errors are tolerated */
+    assert(live_latency_Update(&ctl, TARGET + VLC_TICK_FROM_MS(100)) == 1.f);
+    assert(live_latency_Update(&ctl, TARGET - VLC_TICK_FROM_MS(100)) == 1.f);
+    assert(live_latency_Get(&ctl) != VLC_TICK_INVALID);
+
+    /* Catch up after a 4s stall, within the band */
+    live_latency_Reset(&ctl);
+    rate_min = rate_max = 1.f;
+    latency = play(&ctl, TARGET + VLC_TICK_FROM_SEC(4),
+                   VLC_TICK_FROM_SEC(300), &rate_min, &rate_max);
+    assert(rate_max == 1.05f);
+    assert(rate_min == 1.f);
+    assert(latency < TARGET + TARGET / 8 && latency > TARGET - TARGET / 8);
+    assert(ctl.rate == 1.f);
+
+    /* Slow down when too close to the live edge */
+    live_latency_Reset(&ctl);
+    rate_min = rate_max = 1.f;
+    latency = play(&ctl, TARGET / 2, VLC_TICK_FROM_SEC(300),
+                   &rate_min, &rate_max);
+    assert(rate_min < 1.f && rate_min >= .95f);
+    assert(rate_max == 1.f);
+    assert(latency < TARGET + TARGET / 8 && latency > TARGET - TARGET / 8);
+
+    /* The rate is held until the latency is close to the target */
+    live_latency_Init(&ctl, TARGET, .95f, 1.05f);
+    assert(live_latency_Update(&ctl, TARGET + VLC_TICK_FROM_SEC(1)) > 1.f);
+    for (int i = 0; i < 16; i++)
+        live_latency_Update(&ctl, TARGET + TARGET / 10);
+    assert(ctl.rate > 1.f);
+    for (int i = 0; i < 16; i++)
+        live_latency_Update(&ctl, TARGET);
+    assert(ctl.rate == 1.f);
+
+    return 0;
+}
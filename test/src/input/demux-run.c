@@ -53,6 +53,8 @@ struct test_es_out_t
 {
     struct es_out_t out;
     struct es_out_id_t *ids;
+    uintmax_t blocks;
+    uintmax_t bytes;
 #ifdef HAVE_DECODERS
     vlc_object_t *parent;
 #endif
@@ -107,6 +109,8 @@ static int EsOutSend(es_out_t *out, es_out_id_t *id, block_t *block)
 
     //debug("[%p] Sent    ES: %zu\n", (void *)idd, block->i_buffer);
     EsOutCheckId(ctx, id);
+    ctx->blocks++;
+    ctx->bytes += block->i_buffer;
 #ifdef HAVE_DECODERS
     if (id->decoder)
         test_decoder_process(id->decoder, block);
@@ -229,6 +233,8 @@ static es_out_t *test_es_out_create(vlc_object_t *parent)
     }
 
     ctx->ids = NULL;
+    ctx->blocks = 0;
+    ctx->bytes = 0;
 
     es_out_t *out = &ctx->out;
     out->cbs = &es_out_cbs;
@@ -302,6 +308,7 @@ static int demux_process_stream(const struct vlc_run_args *args, stream_t *s)
 
     uintmax_t i = 0;
     int val;
+    vlc_tick_t start = vlc_tick_now();
 
     while ((val = demux_Demux(demux)) == VLC_DEMUXER_SUCCESS)
     {
@@ -327,6 +334,21 @@ static int demux_process_stream(const struct vlc_run_args *args, stream_t *s)
         i++;
     }
 
+    if (args->benchmark)
+    {
+        const struct test_es_out_t *ctx = (struct test_es_out_t *) out;
+        vlc_tick_t time = vlc_tick_now() - start;
+        uint64_t read = vlc_stream_Tell(s);
+
+        printf("Demuxed %" PRIu64 " bytes into %" PRIuMAX " blocks (%"
+               PRIuMAX " bytes) in %f s\n", read, ctx->blocks, ctx->bytes,
+               secf_from_vlc_tick(time));
+        if (time > 0)
+            printf("Speed is: %f MiB/s, %f blocks/s\n",
+                   (double) read / (1 << 20) / time * CLOCK_FREQ,
+                   (double) ctx->blocks / time * CLOCK_FREQ);
+    }
+
     demux_Delete(demux);
     es_out_Delete(out);
 
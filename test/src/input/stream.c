@@ -184,7 +184,8 @@ stream_close( struct reader *p_reader )
 }
 
 static struct reader *
-stream_open( const char *psz_url )
+stream_open( const char *psz_url, const char *psz_name,
+             const char *psz_block_size, const char *psz_mmap_size )
 {
     libvlc_instance_t *p_vlc;
     struct reader *p_reader;
@@ -196,6 +197,12 @@ stream_open( const char *psz_url )
         "--no-media-library",
         "--vout=dummy",
         "--aout=dummy",
+        "--file-block-size",
+        psz_block_size,
+#ifdef HAVE_MMAP
+        "--file-mmap-size",
+        psz_mmap_size,
+#endif
     };
 
     p_reader = calloc( 1, sizeof(struct reader) );
@@ -218,7 +225,7 @@ stream_open( const char *psz_url )
     p_reader->pf_tell = stream_tell;
     p_reader->pf_seek = stream_seek;
     p_reader->p_data = p_vlc;
-    p_reader->psz_name = "stream";
+    p_reader->psz_name = psz_name;
     return p_reader;
 }
 
@@ -343,6 +350,90 @@ test( struct reader **pp_readers, unsigned int i_readers, const char *psz_md5 )
 }
 
 #ifndef TEST_NET
+/* Checks the block functions against the byte functions, as demuxers
+ * reading whole frames or small packets would use them */
+static void
+test_blocks( struct reader *p_reader, uint64_t i_size )
+{
+    stream_t *s = p_reader->u.s;
+
+    /* Random seeks, with a peek as a demuxer looking for a header would */
+    unsigned int seed = 54321;
+    for( unsigned i = 0; i < 1000; i++ )
+    {
+        const uint8_t *p_peek;
+        uint64_t i_offset = rand_r( &seed ) % i_size;
+
+        assert( vlc_stream_Seek( s, i_offset ) == 0 );
+        assert( vlc_stream_Peek( s, &p_peek, 188 ) ==
+                (ssize_t)__MIN( 188, i_size - i_offset ) );
+    }
+
+    uint64_t i_read = 0;
+    block_t *p_block;
+    vlc_hash_md5_t md5;
+    char psz_md5[VLC_HASH_MD5_DIGEST_HEX_SIZE];
+
+    assert( vlc_stream_Seek( s, 0 ) == 0 );
+    vlc_hash_md5_Init( &md5 );
+    while( ( p_block = vlc_stream_ReadBlock( s ) ) != NULL )
+    {
+        i_read += p_block->i_buffer;
+        vlc_hash_md5_Update( &md5, p_block->p_buffer, p_block->i_buffer );
+        block_Release( p_block );
+    }
+    assert( i_read == i_size );
+    vlc_hash_FinishHex( &md5, psz_md5 );
+
+    /* Keep a few packets around, as the TS demuxer would */
+    block_t *pp_packets[8] = { NULL };
+    char psz_packets_md5[VLC_HASH_MD5_DIGEST_HEX_SIZE];
+
+    assert( vlc_stream_Seek( s, 0 ) == 0 );
+    i_read = 0;
+    vlc_hash_md5_Init( &md5 );
+    for( unsigned i = 0; ( p_block = vlc_stream_Block( s, 188 ) ) != NULL;
+         i++ )
+    {
+        assert( p_block->i_buffer == __MIN( 188, i_size - i_read ) );
+        i_read += p_block->i_buffer;
+        vlc_hash_md5_Update( &md5, p_block->p_buffer, p_block->i_buffer );
+        if( pp_packets[i % 8] != NULL )
+            block_Release( pp_packets[i % 8] );
+        pp_packets[i % 8] = p_block;
+    }
+    for( unsigned i = 0; i < 8; i++ )
+        if( pp_packets[i] != NULL )
+            block_Release( pp_packets[i] );
+    assert( i_read == i_size );
+    vlc_hash_FinishHex( &md5, psz_packets_md5 );
+    assert( strcmp( psz_md5, psz_packets_md5 ) == 0 );
+}
+
+/* Reports the block read throughput, for information only */
+static void
+report_throughput( struct reader *p_reader )
+{
+    stream_t *s = p_reader->u.s;
+    uint64_t i_read = 0;
+    block_t *p_block;
+
+    if( vlc_stream_Seek( s, 0 ) )
+        return;
+
+    vlc_tick_t i_start = vlc_tick_now();
+    while( ( p_block = vlc_stream_ReadBlock( s ) ) != NULL )
+    {
+        i_read += p_block->i_buffer;
+        block_Release( p_block );
+    }
+    vlc_tick_t i_elapsed = vlc_tick_now() - i_start;
+
+    printf( "%s: %"PRIu64" bytes at %.1f MiB/s\n", p_reader->psz_name,
+            i_read, i_read * (double)CLOCK_FREQ / (i_elapsed ? i_elapsed : 1)
+                    / (1 << 20) );
+}
+
 static void
 fill_rand( int i_fd, size_t i_size )
 {
@@ -371,7 +462,7 @@ fill_rand( int i_fd, size_t i_size )
 int
 main( void )
 {
-    struct reader *pp_readers[3];
+    struct reader *pp_readers[4];
 
     test_init();
 
@@ -388,10 +479,18 @@ main( void )
     assert( asprintf( &psz_url, "file://%s", psz_tmp_path ) != -1 );
 
     assert( ( pp_readers[0] = libc_open( psz_tmp_path ) ) );
-    assert( ( pp_readers[1] = stream_open( psz_url ) ) );
-
-    test( pp_readers, 2, NULL );
-    for( unsigned int i = 0; i < 2; ++i )
+    assert( ( pp_readers[1] = stream_open( psz_url, "stream", "0", "0" ) ) );
+    assert( ( pp_readers[2] = stream_open( psz_url, "block stream",
+                                           "64", "0" ) ) );
+    assert( ( pp_readers[3] = stream_open( psz_url, "mmap stream",
+                                           "64", "1" ) ) );
+
+    test( pp_readers, 4, NULL );
+    for( unsigned int i = 1; i < 4; ++i )
+        test_blocks( pp_readers[i], RAND_FILE_SIZE );
+    for( unsigned int i = 1; i < 4; ++i )
+        report_throughput( pp_readers[i] );
+    for( unsigned int i = 0; i < 4; ++i )
         pp_readers[i]->pf_close( pp_readers[i] );
     free( psz_url );
 
@@ -400,7 +499,7 @@ main( void )
 
     test_log( "Testing http url with stream...\n" );
     alarm( 0 );
-    if( !( pp_readers[0] = stream_open( HTTP_URL ) ) )
+    if( !( pp_readers[0] = stream_open( HTTP_URL, "stream", "0", "0" ) ) )
     {
         test_log( "WARNING: can't test http url" );
         return 0;